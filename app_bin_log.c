@@ -0,0 +1,323 @@
+/******************************************************************************
+* File Name: app_bin_log.c
+*
+* Description: This file implements the binary output mode. Events are sent
+*              as compact records, framed with Consistent Overhead Byte
+*              Stuffing (COBS) so that a zero byte marks the frame boundary
+*              and protected by a CRC. Text printed in between is ignored
+*              by the decoder.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_bin_log.h"
+#include "app_bt_utils.h"
+#include "app_uart_tx.h"
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#include <string.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* type, seq, time(4) */
+#define BIN_LOG_HEADER_LEN              (6u)
+#define BIN_LOG_CRC_LEN                 (2u)
+#define BIN_LOG_MAX_RECORD              (BIN_LOG_HEADER_LEN + BIN_LOG_MAX_PAYLOAD + \
+                                         BIN_LOG_CRC_LEN)
+/* COBS adds one byte per 254 bytes plus one, and the frame two delimiters */
+#define BIN_LOG_MAX_FRAME               (BIN_LOG_MAX_RECORD + 2u + 2u)
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static uint8_t bin_log_seq;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static uint32_t bin_log_cobs_encode(const uint8_t *p_in, uint32_t len, uint8_t *p_out);
+static void bin_log_put_u16(uint8_t *p_buf, uint16_t value);
+static void bin_log_put_u32(uint8_t *p_buf, uint32_t value);
+
+/*******************************************************************************
+* Function Name: app_bin_log_record()
+********************************************************************************
+* Summary:
+*   Builds a record, encodes it with COBS and writes it to the debug UART.
+*   The frame starts and ends with a zero byte, so text printed before it
+*   cannot corrupt the record.
+*
+* Parameters:
+*   bin_log_type_t type: Record type
+*   const uint8_t *p_payload: Record payload
+*   uint32_t len: Payload length, up to BIN_LOG_MAX_PAYLOAD
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bin_log_record(bin_log_type_t type, const uint8_t *p_payload, uint32_t len)
+{
+    uint8_t record[BIN_LOG_MAX_RECORD];
+    uint8_t frame[BIN_LOG_MAX_FRAME];
+    size_t frame_len;
+    uint16_t crc;
+
+    if (len > BIN_LOG_MAX_PAYLOAD)
+    {
+        return;
+    }
+
+    record[0] = (uint8_t)type;
+    record[1] = bin_log_seq++;
+    bin_log_put_u32(&record[2], (uint32_t)(local_time_us() / 1000u));
+    memcpy(&record[BIN_LOG_HEADER_LEN], p_payload, len);
+    len += BIN_LOG_HEADER_LEN;
+    crc = calc_crc16_ccitt(record, len);
+    bin_log_put_u16(&record[len], crc);
+    len += BIN_LOG_CRC_LEN;
+
+    frame[0] = 0;
+    frame_len = 1u + bin_log_cobs_encode(record, len, &frame[1]);
+    frame[frame_len++] = 0;
+
+#if (ENABLE_UART_TX_ASYNC)
+    app_uart_tx_write(frame, (uint32_t)frame_len, false);
+#else
+    cyhal_uart_write(&cy_retarget_io_uart_obj, frame, &frame_len);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: app_bin_log_connect()
+********************************************************************************
+* Summary:
+*   Sends a connection record.
+*
+* Parameters:
+*   uint16_t conn_id: Connection ID
+*   const uint8_t *p_bd_addr: Address of the peer
+*   uint8_t addr_type: Address type of the peer
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bin_log_connect(uint16_t conn_id, const uint8_t *p_bd_addr, uint8_t addr_type)
+{
+    uint8_t payload[9];
+
+    bin_log_put_u16(&payload[0], conn_id);
+    memcpy(&payload[2], p_bd_addr, 6u);
+    payload[8] = addr_type;
+    app_bin_log_record(BIN_LOG_CONNECT, payload, sizeof(payload));
+}
+
+/*******************************************************************************
+* Function Name: app_bin_log_disconnect()
+********************************************************************************
+* Summary:
+*   Sends a disconnection record.
+*
+* Parameters:
+*   uint16_t conn_id: Connection ID
+*   uint16_t reason: wiced_bt_gatt_disconn_reason_t of the disconnection
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bin_log_disconnect(uint16_t conn_id, uint16_t reason)
+{
+    uint8_t payload[4];
+
+    bin_log_put_u16(&payload[0], conn_id);
+    bin_log_put_u16(&payload[2], reason);
+    app_bin_log_record(BIN_LOG_DISCONNECT, payload, sizeof(payload));
+}
+
+/*******************************************************************************
+* Function Name: app_bin_log_discovery()
+********************************************************************************
+* Summary:
+*   Sends a discovery result record.
+*
+* Parameters:
+*   uint16_t conn_id: Connection ID
+*   uint16_t uuid: UUID of the service, characteristic or descriptor found
+*   uint16_t handle: Start handle of a service, otherwise attribute handle
+*   uint16_t handle2: End handle of a service, value handle of a
+*                     characteristic, 0 for a descriptor
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bin_log_discovery(uint16_t conn_id, uint16_t uuid, uint16_t handle,
+                           uint16_t handle2)
+{
+    uint8_t payload[8];
+
+    bin_log_put_u16(&payload[0], conn_id);
+    bin_log_put_u16(&payload[2], uuid);
+    bin_log_put_u16(&payload[4], handle);
+    bin_log_put_u16(&payload[6], handle2);
+    app_bin_log_record(BIN_LOG_DISCOVERY, payload, sizeof(payload));
+}
+
+/*******************************************************************************
+* Function Name: app_bin_log_time()
+********************************************************************************
+* Summary:
+*   Sends a received time record. The Current Time value is sent as received
+*   (10 bytes), followed by the estimated error of the server time.
+*
+* Parameters:
+*   uint16_t conn_id: Connection ID
+*   const uint8_t *p_value: Current Time characteristic value
+*   uint16_t len: Length of the value, at least 10
+*   uint32_t error_us: Estimated error of the server time
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bin_log_time(uint16_t conn_id, const uint8_t *p_value, uint16_t len,
+                      uint32_t error_us)
+{
+    uint8_t payload[16];
+
+    if (len < 10u)
+    {
+        return;
+    }
+    bin_log_put_u16(&payload[0], conn_id);
+    memcpy(&payload[2], p_value, 10u);
+    bin_log_put_u32(&payload[12], error_us);
+    app_bin_log_record(BIN_LOG_TIME, payload, sizeof(payload));
+}
+
+/*******************************************************************************
+* Function Name: bin_log_cobs_encode()
+********************************************************************************
+* Summary:
+*   Encodes a buffer with COBS. The output contains no zero bytes.
+*
+* Parameters:
+*   const uint8_t *p_in: Data to encode
+*   uint32_t len: Length of the data
+*   uint8_t *p_out: Encoded data, at least len + len / 254 + 1 bytes
+*
+* Return:
+*   uint32_t: Length of the encoded data
+*
+*******************************************************************************/
+static uint32_t bin_log_cobs_encode(const uint8_t *p_in, uint32_t len, uint8_t *p_out)
+{
+    uint32_t code_index = 0;
+    uint32_t out_index = 1;
+    uint8_t code = 1;
+    uint32_t index;
+
+    for (index = 0; index < len; index++)
+    {
+        if (0 == p_in[index])
+        {
+            p_out[code_index] = code;
+            code_index = out_index++;
+            code = 1;
+        }
+        else
+        {
+            p_out[out_index++] = p_in[index];
+            code++;
+            if (0xFF == code)
+            {
+                p_out[code_index] = code;
+                code_index = out_index++;
+                code = 1;
+            }
+        }
+    }
+    p_out[code_index] = code;
+
+    return out_index;
+}
+
+/*******************************************************************************
+* Function Name: bin_log_put_u16()
+********************************************************************************
+* Summary:
+*   Stores a 16-bit value little endian.
+*
+* Parameters:
+*   uint8_t *p_buf: Destination
+*   uint16_t value: Value
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void bin_log_put_u16(uint8_t *p_buf, uint16_t value)
+{
+    p_buf[0] = (uint8_t)value;
+    p_buf[1] = (uint8_t)(value >> 8u);
+}
+
+/*******************************************************************************
+* Function Name: bin_log_put_u32()
+********************************************************************************
+* Summary:
+*   Stores a 32-bit value little endian.
+*
+* Parameters:
+*   uint8_t *p_buf: Destination
+*   uint32_t value: Value
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void bin_log_put_u32(uint8_t *p_buf, uint32_t value)
+{
+    bin_log_put_u16(&p_buf[0], (uint16_t)value);
+    bin_log_put_u16(&p_buf[2], (uint16_t)(value >> 16u));
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,90 @@
+/******************************************************************************
+* File Name: app_bin_log.h
+*
+* Description: This file contains macros, enumerations and function prototypes
+*              used in app_bin_log.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BIN_LOG_H__
+#define __APP_BIN_LOG_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 1 to send connections, discovery results and received times as
+ * COBS framed binary records instead of text. Decode them on the host with
+ * tools/cts_bin_decode.py */
+#ifndef ENABLE_BINARY_OUTPUT
+#define ENABLE_BINARY_OUTPUT            (0u)
+#endif
+
+/* Largest record payload */
+#define BIN_LOG_MAX_PAYLOAD             (24u)
+
+/*******************************************************************************
+*        Enumerations
+*******************************************************************************/
+/* Record types. A record is: type, sequence number, 32-bit local time in ms,
+ * payload and CRC-16/CCITT-FALSE of all previous bytes, little endian */
+typedef enum
+{
+    BIN_LOG_CONNECT    = 0x01,      /* conn_id(2) bd_addr(6) addr_type(1) */
+    BIN_LOG_DISCONNECT = 0x02,      /* conn_id(2) reason(2) */
+    BIN_LOG_DISCOVERY  = 0x03,      /* conn_id(2) uuid(2) handle(2) handle2(2) */
+    BIN_LOG_TIME       = 0x04,      /* conn_id(2) current_time(10) error_us(4) */
+} bin_log_type_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+void app_bin_log_record(bin_log_type_t type, const uint8_t *p_payload, uint32_t len);
+void app_bin_log_connect(uint16_t conn_id, const uint8_t *p_bd_addr, uint8_t addr_type);
+void app_bin_log_disconnect(uint16_t conn_id, uint16_t reason);
+void app_bin_log_discovery(uint16_t conn_id, uint16_t uuid, uint16_t handle,
+                           uint16_t handle2);
+void app_bin_log_time(uint16_t conn_id, const uint8_t *p_value, uint16_t len,
+                      uint32_t error_us);
+
+#endif      /* __APP_BIN_LOG_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,500 @@
+/******************************************************************************
+* File Name: app_bt_adv.c
+*
+* Description: This file implements the advertising schedule of the CTS client.
+*              A high duty burst is followed by low duty advertising, after
+*              which advertising stops or sleeps and starts again. The time
+*              spent in each advertising mode is counted.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_bt_adv.h"
+#include "app_cts_server.h"
+#include "app_bt_utils.h"
+#include <task.h>
+#include <timers.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Advertising schedules. The stack advertises at the high duty interval for
+ * the high duty duration, then at the low duty interval for the low duty
+ * duration, and reports every change with BTM_BLE_ADVERT_STATE_CHANGED_EVT */
+static const adv_profile_params_t adv_profiles[ADV_PROFILE_COUNT] =
+{
+    [ADV_PROFILE_FAST] =
+    {
+        .name = "FAST",
+        .high_duty_min_interval = ADV_SLOTS(30),
+        .high_duty_max_interval = ADV_SLOTS(30),
+        .high_duty_duration     = 60,
+        .low_duty_min_interval  = ADV_SLOTS(100),
+        .low_duty_max_interval  = ADV_SLOTS(150),
+        .low_duty_duration      = 300,
+    },
+    [ADV_PROFILE_BALANCED] =
+    {
+        .name = "BALANCED",
+        .high_duty_min_interval = ADV_SLOTS(30),
+        .high_duty_max_interval = ADV_SLOTS(30),
+        .high_duty_duration     = 30,
+        .low_duty_min_interval  = ADV_SLOTS(1280),
+        .low_duty_max_interval  = ADV_SLOTS(1280),
+        .low_duty_duration      = 300,
+    },
+    [ADV_PROFILE_LOW_POWER] =
+    {
+        .name = "LOW_POWER",
+        .high_duty_min_interval = ADV_SLOTS(60),
+        .high_duty_max_interval = ADV_SLOTS(60),
+        .high_duty_duration     = 10,
+        .low_duty_min_interval  = ADV_SLOTS(2560),
+        .low_duty_max_interval  = ADV_SLOTS(2560),
+        .low_duty_duration      = 120,
+    },
+};
+
+/* RAM copies of the Bluetooth configuration so that the advertising settings
+ * can be changed at run time. The stack keeps the pointer passed at init */
+static wiced_bt_cfg_settings_t            adv_cfg_settings;
+static wiced_bt_cfg_ble_t                 adv_cfg_ble;
+static wiced_bt_cfg_gatt_t                adv_cfg_gatt;
+static wiced_bt_cfg_ble_advert_settings_t adv_cfg_advert;
+
+static adv_profile_t                      adv_profile = ADV_PROFILE;
+static adv_stats_t                        adv_stats;
+
+/* Current mode and when it was entered */
+static adv_mode_t                         adv_mode = ADV_MODE_OFF;
+static TickType_t                         adv_mode_tick;
+
+/* Set by app_bt_adv_stop() so that the following OFF is not a timeout */
+static bool                               adv_stop_requested;
+
+/* Restarts advertising ADV_SLEEP_S after a schedule timed out */
+static TimerHandle_t                      adv_sleep_timer;
+static StaticTimer_t                      adv_sleep_timer_buffer;
+static app_bt_adv_restart_t               adv_restart;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void adv_sleep_timer_callback(TimerHandle_t timer);
+static adv_mode_t adv_mode_from_state(wiced_bt_ble_advert_mode_t state);
+static bool adv_phase_expired(adv_mode_t mode, uint32_t elapsed_ms);
+
+/*******************************************************************************
+* Function Name: app_bt_adv_cfg_init()
+********************************************************************************
+* Summary:
+*   Creates a RAM copy of the Bluetooth configuration with the advertising
+*   settings of the selected profile and the connection limits of the
+*   application. The returned pointer must be passed to wiced_bt_stack_init().
+*
+* Parameters:
+*   const wiced_bt_cfg_settings_t *p_cfg: Generated configuration
+*
+* Return:
+*   const wiced_bt_cfg_settings_t*: Configuration to use
+*
+*******************************************************************************/
+const wiced_bt_cfg_settings_t *app_bt_adv_cfg_init(const wiced_bt_cfg_settings_t *p_cfg)
+{
+    memcpy(&adv_cfg_settings, p_cfg, sizeof(adv_cfg_settings));
+    memcpy(&adv_cfg_ble, p_cfg->p_ble_cfg, sizeof(adv_cfg_ble));
+    if (NULL != p_cfg->p_ble_cfg->p_ble_advert_cfg)
+    {
+        memcpy(&adv_cfg_advert, p_cfg->p_ble_cfg->p_ble_advert_cfg,
+               sizeof(adv_cfg_advert));
+    }
+
+    adv_cfg_ble.p_ble_advert_cfg = &adv_cfg_advert;
+    adv_cfg_settings.p_ble_cfg = &adv_cfg_ble;
+
+    /* One link per time source and per peer of the CTS server */
+    memcpy(&adv_cfg_gatt, p_cfg->p_gatt_cfg, sizeof(adv_cfg_gatt));
+    adv_cfg_gatt.client_max_links = CTS_MAX_CONNECTIONS;
+    adv_cfg_gatt.server_max_links = CTS_MAX_LINKS;
+    adv_cfg_ble.ble_max_simultaneous_links = CTS_MAX_LINKS;
+    adv_cfg_settings.p_gatt_cfg = &adv_cfg_gatt;
+
+    app_bt_adv_set_profile(adv_profile);
+    return &adv_cfg_settings;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_adv_set_profile()
+********************************************************************************
+* Summary:
+*   Selects the advertising schedule used when advertising starts next.
+*
+* Parameters:
+*   adv_profile_t profile: Profile to use
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_adv_set_profile(adv_profile_t profile)
+{
+    const adv_profile_params_t *p_params;
+
+    if (profile >= ADV_PROFILE_COUNT)
+    {
+        return;
+    }
+    adv_profile = profile;
+    p_params = &adv_profiles[profile];
+
+    adv_cfg_advert.high_duty_min_interval = p_params->high_duty_min_interval;
+    adv_cfg_advert.high_duty_max_interval = p_params->high_duty_max_interval;
+    adv_cfg_advert.high_duty_duration     = p_params->high_duty_duration;
+    adv_cfg_advert.low_duty_min_interval  = p_params->low_duty_min_interval;
+    adv_cfg_advert.low_duty_max_interval  = p_params->low_duty_max_interval;
+    adv_cfg_advert.low_duty_duration      = p_params->low_duty_duration;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_adv_init()
+********************************************************************************
+* Summary:
+*   Creates the sleep timer. Call once the Bluetooth stack is enabled.
+*
+* Parameters:
+*   app_bt_adv_restart_t restart: Requests a call of app_bt_adv_start() in
+*                                 the application task when a sleep ends
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_adv_init(app_bt_adv_restart_t restart)
+{
+    adv_restart = restart;
+    adv_mode = ADV_MODE_OFF;
+    adv_mode_tick = xTaskGetTickCount();
+
+    if ((NULL == adv_sleep_timer) && (0u != ADV_SLEEP_S))
+    {
+        adv_sleep_timer = xTimerCreateStatic("adv", pdMS_TO_TICKS(ADV_SLEEP_S * 1000u),
+                                             pdFALSE, NULL, adv_sleep_timer_callback,
+                                             &adv_sleep_timer_buffer);
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_bt_adv_start()
+********************************************************************************
+* Summary:
+*   Starts a new advertising schedule with the high duty burst.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   wiced_result_t: Result of wiced_bt_start_advertisements()
+*
+*******************************************************************************/
+wiced_result_t app_bt_adv_start(void)
+{
+    wiced_result_t result;
+
+    if (NULL != adv_sleep_timer)
+    {
+        (void)xTimerStop(adv_sleep_timer, 0);
+    }
+    adv_stop_requested = false;
+
+    result = wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_HIGH, 0, NULL);
+    if (WICED_BT_SUCCESS != result)
+    {
+        printf("Failed to start advertisement! Error code: %X \n",
+               (unsigned int)result);
+    }
+    else
+    {
+        adv_stats.schedules++;
+        printf("Advertising, profile %s: %u s at %u ms, then %u s at %u ms\n",
+               adv_profiles[adv_profile].name,
+               (unsigned int)adv_cfg_advert.high_duty_duration,
+               (unsigned int)((adv_cfg_advert.high_duty_min_interval * 5u) / 8u),
+               (unsigned int)adv_cfg_advert.low_duty_duration,
+               (unsigned int)((adv_cfg_advert.low_duty_min_interval * 5u) / 8u));
+    }
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_adv_stop()
+********************************************************************************
+* Summary:
+*   Stops advertising and any pending restart.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_adv_stop(void)
+{
+    if (NULL != adv_sleep_timer)
+    {
+        (void)xTimerStop(adv_sleep_timer, 0);
+    }
+    adv_stop_requested = true;
+    (void)wiced_bt_start_advertisements(BTM_BLE_ADVERT_OFF, 0, NULL);
+}
+
+/*******************************************************************************
+* Function Name: app_bt_adv_state_changed()
+********************************************************************************
+* Summary:
+*   Handles BTM_BLE_ADVERT_STATE_CHANGED_EVT. The time since the last change
+*   is added to the mode that ended. When advertising stops at the end of the
+*   schedule, the sleep timer is started if ADV_SLEEP_S is set.
+*
+* Parameters:
+*   wiced_bt_ble_advert_mode_t state: New advertising state
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_adv_state_changed(wiced_bt_ble_advert_mode_t state)
+{
+    TickType_t now = xTaskGetTickCount();
+    uint32_t elapsed_ms = (now - adv_mode_tick) * portTICK_PERIOD_MS;
+    adv_mode_t mode = adv_mode_from_state(state);
+    adv_mode_t previous = adv_mode;
+
+    printf("Advertisement State Change: %s\n", get_bt_advert_mode_name(state));
+
+    adv_stats.time_ms[previous] += elapsed_ms;
+    adv_mode = mode;
+    adv_mode_tick = now;
+
+    if ((ADV_MODE_OFF != mode) || (ADV_MODE_OFF == previous))
+    {
+        return;
+    }
+
+    /* Advertising also stops when a central connects. Only an OFF at the end
+     * of the last phase of the schedule is a timeout */
+    if (adv_stop_requested || (!adv_phase_expired(previous, elapsed_ms)))
+    {
+        printf("Advertisement stopped\n");
+        return;
+    }
+
+    adv_stats.timeouts++;
+    if (NULL != adv_sleep_timer)
+    {
+        printf("Advertisement timed out, restarting in %u s\n",
+               (unsigned int)ADV_SLEEP_S);
+        (void)xTimerReset(adv_sleep_timer, 0);
+    }
+    else
+    {
+        printf("Advertisement timed out, press the user button to restart\n");
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_bt_adv_connection_up()
+********************************************************************************
+* Summary:
+*   Counts a connection made while advertising and cancels a pending restart.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_adv_connection_up(void)
+{
+    if (NULL != adv_sleep_timer)
+    {
+        (void)xTimerStop(adv_sleep_timer, 0);
+    }
+    adv_stats.connections++;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_adv_get_stats()
+********************************************************************************
+* Summary:
+*   Copies the advertising statistics, including the time spent in the
+*   current mode so far.
+*
+* Parameters:
+*   adv_stats_t *p_stats: Destination
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_adv_get_stats(adv_stats_t *p_stats)
+{
+    memcpy(p_stats, &adv_stats, sizeof(*p_stats));
+    p_stats->time_ms[adv_mode] += (xTaskGetTickCount() - adv_mode_tick) *
+                                  portTICK_PERIOD_MS;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_adv_print_stats()
+********************************************************************************
+* Summary:
+*   Prints the time spent in each advertising mode and the schedule counts.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_adv_print_stats(void)
+{
+    adv_stats_t stats;
+
+    app_bt_adv_get_stats(&stats);
+    printf("Advertising: high duty %lu s, low duty %lu s, off %lu s, "
+           "%lu schedules, %lu timeouts, %lu connections\n",
+           (unsigned long)(stats.time_ms[ADV_MODE_HIGH] / 1000u),
+           (unsigned long)(stats.time_ms[ADV_MODE_LOW] / 1000u),
+           (unsigned long)(stats.time_ms[ADV_MODE_OFF] / 1000u),
+           (unsigned long)stats.schedules,
+           (unsigned long)stats.timeouts,
+           (unsigned long)stats.connections);
+}
+
+/*******************************************************************************
+* Function Name: adv_sleep_timer_callback()
+********************************************************************************
+* Summary:
+*   Sleep timer expiry, runs in the FreeRTOS timer task.
+*
+* Parameters:
+*   TimerHandle_t timer: Not used
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void adv_sleep_timer_callback(TimerHandle_t timer)
+{
+    (void)timer;
+
+    if (NULL != adv_restart)
+    {
+        adv_restart();
+    }
+}
+
+/*******************************************************************************
+* Function Name: adv_mode_from_state()
+********************************************************************************
+* Summary:
+*   Maps an advertising state of the stack to the mode time is counted for.
+*
+* Parameters:
+*   wiced_bt_ble_advert_mode_t state: Advertising state
+*
+* Return:
+*   adv_mode_t: Mode
+*
+*******************************************************************************/
+static adv_mode_t adv_mode_from_state(wiced_bt_ble_advert_mode_t state)
+{
+    switch (state)
+    {
+        case BTM_BLE_ADVERT_DIRECTED_HIGH:
+        case BTM_BLE_ADVERT_UNDIRECTED_HIGH:
+        case BTM_BLE_ADVERT_NONCONN_HIGH:
+        case BTM_BLE_ADVERT_DISCOVERABLE_HIGH:
+            return ADV_MODE_HIGH;
+
+        case BTM_BLE_ADVERT_DIRECTED_LOW:
+        case BTM_BLE_ADVERT_UNDIRECTED_LOW:
+        case BTM_BLE_ADVERT_NONCONN_LOW:
+        case BTM_BLE_ADVERT_DISCOVERABLE_LOW:
+            return ADV_MODE_LOW;
+
+        default:
+            return ADV_MODE_OFF;
+    }
+}
+
+/*******************************************************************************
+* Function Name: adv_phase_expired()
+********************************************************************************
+* Summary:
+*   Checks whether a phase that just ended ran for its configured duration.
+*
+* Parameters:
+*   adv_mode_t mode: Phase that ended
+*   uint32_t elapsed_ms: Time spent in the phase
+*
+* Return:
+*   bool: true if the phase ended on its timeout
+*
+*******************************************************************************/
+static bool adv_phase_expired(adv_mode_t mode, uint32_t elapsed_ms)
+{
+    uint32_t duration_ms;
+
+    if (ADV_MODE_HIGH == mode)
+    {
+        duration_ms = (uint32_t)adv_cfg_advert.high_duty_duration * 1000u;
+    }
+    else
+    {
+        duration_ms = (uint32_t)adv_cfg_advert.low_duty_duration * 1000u;
+    }
+
+    return (0u != duration_ms) && ((elapsed_ms + ADV_TIMEOUT_MARGIN_MS) >= duration_ms);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,139 @@
+/******************************************************************************
+* File Name: app_bt_adv.h
+*
+* Description: This file contains macros, enumerations, structures and function
+*              prototypes used in app_bt_adv.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BT_ADV_H__
+#define __APP_BT_ADV_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+#include "wiced_bt_cfg.h"
+#include <FreeRTOS.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Advertising schedule used when advertising starts. See adv_profile_t */
+#ifndef ADV_PROFILE
+#define ADV_PROFILE                     (ADV_PROFILE_BALANCED)
+#endif
+
+/* Time advertising stays off after a schedule ended without a connection,
+ * in seconds, before the next schedule starts. 0 waits for the user button */
+#ifndef ADV_SLEEP_S
+#define ADV_SLEEP_S                     (0u)
+#endif
+
+/* Advertising intervals are in units of 0.625 ms, durations in seconds */
+#define ADV_SLOTS(ms)                   ((uint16_t)(((ms) * 8u) / 5u))
+
+/* A phase that ends this close to its duration has timed out */
+#define ADV_TIMEOUT_MARGIN_MS           (1000u)
+
+/*******************************************************************************
+*        Enumerations
+*******************************************************************************/
+/* Advertising schedules: a high duty burst, then low duty advertising */
+typedef enum
+{
+    ADV_PROFILE_FAST,           /* Long burst, short low duty interval */
+    ADV_PROFILE_BALANCED,       /* 30 s burst, then 1.28 s interval for 5 min */
+    ADV_PROFILE_LOW_POWER,      /* Short burst, then 2.56 s interval */
+    ADV_PROFILE_COUNT
+} adv_profile_t;
+
+/* Advertising modes time is counted for */
+typedef enum
+{
+    ADV_MODE_HIGH,
+    ADV_MODE_LOW,
+    ADV_MODE_OFF,
+    ADV_MODE_COUNT
+} adv_mode_t;
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+typedef struct
+{
+    const char *name;
+    uint16_t    high_duty_min_interval;
+    uint16_t    high_duty_max_interval;
+    uint16_t    high_duty_duration;     /* 0 advertises until stopped */
+    uint16_t    low_duty_min_interval;
+    uint16_t    low_duty_max_interval;
+    uint16_t    low_duty_duration;      /* 0 skips low duty advertising */
+} adv_profile_params_t;
+
+/* Time spent in each mode since start-up and the schedules run */
+typedef struct
+{
+    uint32_t time_ms[ADV_MODE_COUNT];
+    uint32_t schedules;             /* Schedules started */
+    uint32_t timeouts;              /* Schedules that ended without a
+                                     * connection */
+    uint32_t connections;
+} adv_stats_t;
+
+/* Requests an app_bt_adv_start() from the application task after a sleep */
+typedef void (*app_bt_adv_restart_t)(void);
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+const wiced_bt_cfg_settings_t *app_bt_adv_cfg_init(const wiced_bt_cfg_settings_t *p_cfg);
+void app_bt_adv_set_profile(adv_profile_t profile);
+void app_bt_adv_init(app_bt_adv_restart_t restart);
+
+wiced_result_t app_bt_adv_start(void);
+void app_bt_adv_stop(void);
+
+void app_bt_adv_state_changed(wiced_bt_ble_advert_mode_t mode);
+void app_bt_adv_connection_up(void);
+
+void app_bt_adv_get_stats(adv_stats_t *p_stats);
+void app_bt_adv_print_stats(void);
+
+#endif      /* __APP_BT_ADV_H__ */
+
+/* [] END OF FILE */
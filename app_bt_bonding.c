@@ -0,0 +1,785 @@
+/******************************************************************************
+* File Name: app_bt_bonding.c
+*
+* Description: This file implements the bond store used by the CTS client. It
+*              keeps the local identity keys, the link keys of bonded
+*              servers and the CTS handles discovered on them so that a
+*              reconnection to a bonded server does not need service
+*              discovery or a CCCD write.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_bt_bonding.h"
+#include "app_bt_utils.h"
+#include "cybsp.h"
+#include <FreeRTOS.h>
+#include <semphr.h>
+#if !defined(BOND_STORE_FILE)
+#include "mtb_kvstore.h"
+#include "cy_serial_flash_qspi.h"
+#include "cycfg_qspi_memslot.h"
+#endif
+#include <string.h>
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* RAM copy of the bond store. Nothing is written back before the image in
+ * non-volatile memory was loaded, so that an empty store never replaces it */
+static bond_store_t bond_store;
+static bool         bond_store_loaded;
+
+/* The stack thread saves keys while the application task reads and
+ * updates the CTS cache, so every access after the load takes this mutex */
+static SemaphoreHandle_t bond_store_mutex;
+static StaticSemaphore_t bond_store_mutex_buf;
+
+/* Changes not written yet. The callbacks only update the store in RAM; the
+ * image is written by app_bt_bond_flush() from a copy, so neither the stack
+ * thread nor the mutex waits for the flash */
+static bool                        bond_store_dirty;
+static bool                        bond_store_flush_requested;
+static app_bt_bond_flush_request_t bond_store_flush_request;
+static bond_store_t                bond_store_image;
+
+#if !defined(BOND_STORE_FILE)
+/* kv-store on the external QSPI flash, set up on first use */
+static mtb_kvstore_t    bond_kvstore;
+static mtb_kvstore_bd_t bond_kvstore_bd;
+static bool             bond_kvstore_ready;
+#endif
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static uint16_t bond_store_crc(const bond_store_t *p_store);
+static void     bond_store_commit(void);
+static bond_info_t *bond_store_alloc(const uint8_t *bd_addr);
+static bond_info_t *bond_store_find(const uint8_t *bd_addr);
+static void     bond_store_lock(void);
+static void     bond_store_unlock(void);
+#if !defined(BOND_STORE_FILE)
+static bool      bond_kvstore_init(void);
+static cy_rslt_t bond_bd_read(void *context, uint32_t addr, uint32_t length,
+                              uint8_t *buf);
+static cy_rslt_t bond_bd_program(void *context, uint32_t addr, uint32_t length,
+                                 const uint8_t *buf);
+static cy_rslt_t bond_bd_erase(void *context, uint32_t addr, uint32_t length);
+static uint32_t  bond_bd_read_size(void *context, uint32_t addr);
+static uint32_t  bond_bd_program_size(void *context, uint32_t addr);
+static uint32_t  bond_bd_erase_size(void *context, uint32_t addr);
+#endif
+
+/*******************************************************************************
+* Function Name: app_bt_bond_load()
+********************************************************************************
+* Summary:
+*   Loads the bond store from non-volatile memory. Called before
+*   wiced_bt_stack_init(), as the stack asks for the local identity keys
+*   before BTM_ENABLED_EVT. An invalid or outdated image is discarded.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   bool: true if a valid image was loaded
+*
+*******************************************************************************/
+bool app_bt_bond_load(void)
+{
+    bool valid = app_bt_bond_nv_read(&bond_store, sizeof(bond_store)) &&
+                 (BOND_STORE_MAGIC == bond_store.magic) &&
+                 (BOND_STORE_VERSION == bond_store.version) &&
+                 (bond_store_crc(&bond_store) == bond_store.crc);
+
+    if (!valid)
+    {
+        memset(&bond_store, 0, sizeof(bond_store));
+        bond_store.magic = BOND_STORE_MAGIC;
+        bond_store.version = BOND_STORE_VERSION;
+        printf("Bond store empty or invalid, starting without bonds\n");
+    }
+    bond_store_loaded = true;
+    bond_store_mutex = xSemaphoreCreateMutexStatic(&bond_store_mutex_buf);
+    return valid;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_bond_init()
+********************************************************************************
+* Summary:
+*   Adds the bonded servers of the loaded store to the address resolution
+*   database and sets how store changes get written. Called once the stack
+*   is enabled. Changes made before are written now.
+*
+* Parameters:
+*   app_bt_bond_flush_request_t flush_request: Gets app_bt_bond_flush()
+*                                              called
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_bond_init(app_bt_bond_flush_request_t flush_request)
+{
+    uint32_t index;
+    uint32_t bonded = 0;
+
+    bond_store_lock();
+    bond_store_flush_request = flush_request;
+    for (index = 0; index < BOND_MAX_DEVICES; index++)
+    {
+        if (bond_store.devices[index].in_use)
+        {
+            wiced_bt_dev_add_device_to_address_resolution_db(
+                &bond_store.devices[index].link_keys);
+            bonded++;
+        }
+    }
+    bond_store_unlock();
+    printf("Bond store loaded, %lu bonded server(s)\n", (unsigned long)bonded);
+}
+
+/*******************************************************************************
+* Function Name: app_bt_bond_save_local_keys()
+********************************************************************************
+* Summary:
+*   Saves the local identity keys generated by the stack.
+*
+* Parameters:
+*   const wiced_bt_local_identity_keys_t *p_keys: Keys to save
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS once stored
+*
+*******************************************************************************/
+wiced_result_t app_bt_bond_save_local_keys(const wiced_bt_local_identity_keys_t *p_keys)
+{
+    bond_store_lock();
+    memcpy(&bond_store.local_keys, p_keys, sizeof(bond_store.local_keys));
+    bond_store.local_keys_valid = true;
+    bond_store_commit();
+    bond_store_unlock();
+    return WICED_BT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_bond_get_local_keys()
+********************************************************************************
+* Summary:
+*   Provides the stored local identity keys to the stack. Returning an error
+*   makes the stack generate new keys.
+*
+* Parameters:
+*   wiced_bt_local_identity_keys_t *p_keys: Buffer to fill
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS if keys are available, else WICED_BT_ERROR
+*
+*******************************************************************************/
+wiced_result_t app_bt_bond_get_local_keys(wiced_bt_local_identity_keys_t *p_keys)
+{
+    wiced_result_t result = WICED_BT_ERROR;
+
+    bond_store_lock();
+    if (bond_store.local_keys_valid)
+    {
+        memcpy(p_keys, &bond_store.local_keys, sizeof(bond_store.local_keys));
+        result = WICED_BT_SUCCESS;
+    }
+    bond_store_unlock();
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_bond_save_link_keys()
+********************************************************************************
+* Summary:
+*   Saves the link keys of a newly bonded (or re-paired) server. Cached CTS
+*   handles are kept if the server was already known.
+*
+* Parameters:
+*   const wiced_bt_device_link_keys_t *p_keys: Link keys reported by the stack
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS once stored
+*
+*******************************************************************************/
+wiced_result_t app_bt_bond_save_link_keys(const wiced_bt_device_link_keys_t *p_keys)
+{
+    bond_info_t *p_bond;
+
+    bond_store_lock();
+    p_bond = bond_store_find(p_keys->bd_addr);
+    if (NULL == p_bond)
+    {
+        p_bond = bond_store_alloc(p_keys->bd_addr);
+    }
+
+    memcpy(&p_bond->link_keys, p_keys, sizeof(p_bond->link_keys));
+    bond_store_commit();
+    bond_store_unlock();
+
+    printf("Bonding information saved for BDA ");
+    print_bd_address((uint8_t *)p_keys->bd_addr);
+    return WICED_BT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_bond_get_link_keys()
+********************************************************************************
+* Summary:
+*   Looks up the link keys for the address set in p_keys.
+*
+* Parameters:
+*   wiced_bt_device_link_keys_t *p_keys: bd_addr is the input, filled on success
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS if the server is bonded, else
+*                   WICED_BT_ERROR
+*
+*******************************************************************************/
+wiced_result_t app_bt_bond_get_link_keys(wiced_bt_device_link_keys_t *p_keys)
+{
+    wiced_result_t result = WICED_BT_ERROR;
+    bond_info_t *p_bond;
+
+    bond_store_lock();
+    p_bond = bond_store_find(p_keys->bd_addr);
+    if (NULL != p_bond)
+    {
+        memcpy(p_keys, &p_bond->link_keys, sizeof(p_bond->link_keys));
+        result = WICED_BT_SUCCESS;
+    }
+    bond_store_unlock();
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_bond_find()
+********************************************************************************
+* Summary:
+*   Copies the bond entry of a server, so that the caller does not share the
+*   store with the stack thread.
+*
+* Parameters:
+*   const uint8_t *bd_addr: Address of the server
+*   bond_info_t *p_bond: Filled with the bond entry, NULL to only check for
+*                        the bond
+*
+* Return:
+*   bool: true if the server is bonded
+*
+*******************************************************************************/
+bool app_bt_bond_find(const uint8_t *bd_addr, bond_info_t *p_bond)
+{
+    bond_info_t *p_entry;
+
+    bond_store_lock();
+    p_entry = bond_store_find(bd_addr);
+    if ((NULL != p_entry) && (NULL != p_bond))
+    {
+        memcpy(p_bond, p_entry, sizeof(*p_bond));
+    }
+    bond_store_unlock();
+    return (NULL != p_entry);
+}
+
+/*******************************************************************************
+* Function Name: bond_store_find()
+********************************************************************************
+* Summary:
+*   Finds the bond entry of a server. Called with the store locked.
+*
+* Parameters:
+*   const uint8_t *bd_addr: Address of the server
+*
+* Return:
+*   bond_info_t*: Bond entry or NULL if the server is not bonded
+*
+*******************************************************************************/
+static bond_info_t *bond_store_find(const uint8_t *bd_addr)
+{
+    uint32_t index;
+
+    for (index = 0; index < BOND_MAX_DEVICES; index++)
+    {
+        if ((bond_store.devices[index].in_use) &&
+            (0 == memcmp(bond_store.devices[index].link_keys.bd_addr, bd_addr,
+                         BD_ADDR_LEN)))
+        {
+            return &bond_store.devices[index];
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_bond_update_cts_cache()
+********************************************************************************
+* Summary:
+*   Records the CTS handles and the CCCD state of a bonded server. The store is
+*   only written when something changed. Servers that are not bonded are
+*   ignored.
+*
+* Parameters:
+*   const uint8_t *bd_addr: Address of the server
+*   const cts_discovery_data_t *p_handles: Discovered CTS handles
+*   bool notify_enabled: Current CCCD state
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_bond_update_cts_cache(const uint8_t *bd_addr,
+                                  const cts_discovery_data_t *p_handles,
+                                  bool notify_enabled)
+{
+    bond_info_t *p_bond;
+
+    bond_store_lock();
+    p_bond = bond_store_find(bd_addr);
+    if ((NULL != p_bond) &&
+        ((0 != memcmp(&p_bond->cts_handles, p_handles, sizeof(*p_handles))) ||
+         (p_bond->notify_enabled != notify_enabled)))
+    {
+        memcpy(&p_bond->cts_handles, p_handles, sizeof(p_bond->cts_handles));
+        p_bond->notify_enabled = notify_enabled;
+        bond_store_commit();
+    }
+    bond_store_unlock();
+}
+
+/*******************************************************************************
+* Function Name: bond_store_lock()
+********************************************************************************
+* Summary:
+*   Takes the bond store mutex. The load runs before the scheduler starts
+*   and creates it, so nothing is locked before.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void bond_store_lock(void)
+{
+    if (NULL != bond_store_mutex)
+    {
+        (void)xSemaphoreTake(bond_store_mutex, portMAX_DELAY);
+    }
+}
+
+/*******************************************************************************
+* Function Name: bond_store_unlock()
+********************************************************************************
+* Summary:
+*   Gives the bond store mutex back. If the store changed, the write is
+*   requested once the mutex is free, so that the request may wait for the
+*   application task while the task takes the mutex.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void bond_store_unlock(void)
+{
+    bool request = (bond_store_dirty) && (!bond_store_flush_requested) &&
+                   (NULL != bond_store_flush_request);
+
+    /* Claimed under the mutex so that only one request is made */
+    bond_store_flush_requested |= request;
+    if (NULL != bond_store_mutex)
+    {
+        (void)xSemaphoreGive(bond_store_mutex);
+    }
+    if ((request) && (!bond_store_flush_request()))
+    {
+        bond_store_lock();
+        bond_store_flush_requested = false;
+        if (NULL != bond_store_mutex)
+        {
+            (void)xSemaphoreGive(bond_store_mutex);
+        }
+        printf("Bond store write not scheduled, retried on the next change\n");
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_bt_bond_flush()
+********************************************************************************
+* Summary:
+*   Writes the changed bond store to non-volatile memory. A copy is taken
+*   under the mutex and written without it, so the stack thread can read and
+*   update the store meanwhile; a change during the write is written by the
+*   next flush. Called from the application task.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_bond_flush(void)
+{
+    bool write;
+
+    bond_store_lock();
+    write = bond_store_dirty;
+    if (write)
+    {
+        bond_store.crc = bond_store_crc(&bond_store);
+        memcpy(&bond_store_image, &bond_store, sizeof(bond_store_image));
+        bond_store_dirty = false;
+    }
+    bond_store_flush_requested = false;
+    bond_store_unlock();
+
+    if ((write) && (!app_bt_bond_nv_write(&bond_store_image, sizeof(bond_store_image))))
+    {
+        printf("Bond store write failed!\n");
+    }
+}
+
+/*******************************************************************************
+* Function Name: bond_store_alloc()
+********************************************************************************
+* Summary:
+*   Returns a free bond entry, replacing the least recently bonded server if
+*   the store is full.
+*
+* Parameters:
+*   const uint8_t *bd_addr: Address of the new server
+*
+* Return:
+*   bond_info_t*: Cleared bond entry
+*
+*******************************************************************************/
+static bond_info_t *bond_store_alloc(const uint8_t *bd_addr)
+{
+    uint32_t index;
+    bond_info_t *p_bond = &bond_store.devices[0];
+
+    for (index = 0; index < BOND_MAX_DEVICES; index++)
+    {
+        if (!bond_store.devices[index].in_use)
+        {
+            p_bond = &bond_store.devices[index];
+            break;
+        }
+        if (bond_store.devices[index].sequence < p_bond->sequence)
+        {
+            p_bond = &bond_store.devices[index];
+        }
+    }
+
+    if (p_bond->in_use)
+    {
+        printf("Bond store full, removing BDA ");
+        print_bd_address(p_bond->link_keys.bd_addr);
+        wiced_bt_dev_delete_bonded_device(p_bond->link_keys.bd_addr);
+    }
+
+    memset(p_bond, 0, sizeof(*p_bond));
+    memcpy(p_bond->link_keys.bd_addr, bd_addr, BD_ADDR_LEN);
+    p_bond->in_use = true;
+    p_bond->sequence = ++bond_store.sequence;
+    return p_bond;
+}
+
+/*******************************************************************************
+* Function Name: bond_store_crc()
+********************************************************************************
+* Summary:
+*   Calculates the CRC over the bond store contents following the header.
+*
+* Parameters:
+*   const bond_store_t *p_store: Bond store image
+*
+* Return:
+*   uint16_t: CRC-16/CCITT of the image
+*
+*******************************************************************************/
+static uint16_t bond_store_crc(const bond_store_t *p_store)
+{
+    return calc_crc16_ccitt((const uint8_t *)&p_store->local_keys,
+                            sizeof(*p_store) - offsetof(bond_store_t, local_keys));
+}
+
+/*******************************************************************************
+* Function Name: bond_store_commit()
+********************************************************************************
+* Summary:
+*   Marks the bond store as changed. bond_store_unlock() then requests the
+*   write, which app_bt_bond_flush() does outside the stack thread. Does
+*   nothing until app_bt_bond_load() ran. Called with the store locked.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void bond_store_commit(void)
+{
+    if (bond_store_loaded)
+    {
+        bond_store_dirty = true;
+    }
+}
+
+#if defined(BOND_STORE_FILE)
+/*******************************************************************************
+* Function Name: app_bt_bond_nv_read()
+********************************************************************************
+* Summary:
+*   File backed bond store for host builds. BOND_STORE_FILE is the path of the
+*   file holding the image.
+*
+* Parameters:
+*   void *p_data: Buffer for the image
+*   uint32_t len: Size of the image
+*
+* Return:
+*   bool: true if a complete image was read
+*
+*******************************************************************************/
+CY_WEAK bool app_bt_bond_nv_read(void *p_data, uint32_t len)
+{
+    FILE *p_file = fopen(BOND_STORE_FILE, "rb");
+    bool result = false;
+
+    if (NULL != p_file)
+    {
+        result = (len == fread(p_data, 1, len, p_file));
+        fclose(p_file);
+    }
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_bond_nv_write()
+********************************************************************************
+* Summary:
+*   Writes the bond store image to BOND_STORE_FILE.
+*
+* Parameters:
+*   const void *p_data: Image to write
+*   uint32_t len: Size of the image
+*
+* Return:
+*   bool: true if the complete image was written
+*
+*******************************************************************************/
+CY_WEAK bool app_bt_bond_nv_write(const void *p_data, uint32_t len)
+{
+    FILE *p_file = fopen(BOND_STORE_FILE, "wb");
+    bool result = false;
+
+    if (NULL != p_file)
+    {
+        result = (len == fwrite(p_data, 1, len, p_file));
+        fclose(p_file);
+    }
+    return result;
+}
+#else
+/*******************************************************************************
+* Function Name: app_bt_bond_nv_read()
+********************************************************************************
+* Summary:
+*   Default bond store backend. Reads the image from the kv-store.
+*
+* Parameters:
+*   void *p_data: Buffer for the image
+*   uint32_t len: Size of the image
+*
+* Return:
+*   bool: true if a complete image was read
+*
+*******************************************************************************/
+CY_WEAK bool app_bt_bond_nv_read(void *p_data, uint32_t len)
+{
+    uint32_t size = len;
+
+    if (!bond_kvstore_init())
+    {
+        return false;
+    }
+    return (CY_RSLT_SUCCESS == mtb_kvstore_read(&bond_kvstore, BOND_STORE_KV_KEY,
+                                                (uint8_t *)p_data, &size)) &&
+           (size == len);
+}
+
+/*******************************************************************************
+* Function Name: app_bt_bond_nv_write()
+********************************************************************************
+* Summary:
+*   Default bond store backend. Writes the image to the kv-store.
+*
+* Parameters:
+*   const void *p_data: Image to write
+*   uint32_t len: Size of the image
+*
+* Return:
+*   bool: true if the image was written
+*
+*******************************************************************************/
+CY_WEAK bool app_bt_bond_nv_write(const void *p_data, uint32_t len)
+{
+    if (!bond_kvstore_init())
+    {
+        return false;
+    }
+    return (CY_RSLT_SUCCESS == mtb_kvstore_write(&bond_kvstore, BOND_STORE_KV_KEY,
+                                                 (const uint8_t *)p_data, len));
+}
+
+/*******************************************************************************
+* Function Name: bond_kvstore_init()
+********************************************************************************
+* Summary:
+*   Opens the QSPI flash and the kv-store in its last BOND_STORE_KV_SECTORS
+*   erase sectors. A failure is retried on the next access.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   bool: true if the kv-store is usable
+*
+*******************************************************************************/
+static bool bond_kvstore_init(void)
+{
+    uint32_t flash_size;
+    uint32_t length;
+
+    if (bond_kvstore_ready)
+    {
+        return true;
+    }
+
+    if (CY_RSLT_SUCCESS != cy_serial_flash_qspi_init(smifMemConfigs[0],
+                                                      CYBSP_QSPI_D0, CYBSP_QSPI_D1,
+                                                      CYBSP_QSPI_D2, CYBSP_QSPI_D3,
+                                                      NC, NC, NC, NC,
+                                                      CYBSP_QSPI_SCK, CYBSP_QSPI_SS,
+                                                      BOND_STORE_QSPI_FREQ_HZ))
+    {
+        printf("Bond store: QSPI flash init failed\n");
+        return false;
+    }
+
+    bond_kvstore_bd.read         = bond_bd_read;
+    bond_kvstore_bd.program      = bond_bd_program;
+    bond_kvstore_bd.erase        = bond_bd_erase;
+    bond_kvstore_bd.read_size    = bond_bd_read_size;
+    bond_kvstore_bd.program_size = bond_bd_program_size;
+    bond_kvstore_bd.erase_size   = bond_bd_erase_size;
+    bond_kvstore_bd.context      = NULL;
+
+    flash_size = (uint32_t)cy_serial_flash_qspi_get_size();
+    length = (uint32_t)cy_serial_flash_qspi_get_erase_size(flash_size - 1u) *
+             BOND_STORE_KV_SECTORS;
+    if (CY_RSLT_SUCCESS != mtb_kvstore_init(&bond_kvstore, flash_size - length,
+                                            length, &bond_kvstore_bd))
+    {
+        printf("Bond store: kv-store init failed\n");
+        return false;
+    }
+    bond_kvstore_ready = true;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: bond_bd_read() ... bond_bd_erase_size()
+********************************************************************************
+* Summary:
+*   Block device of the kv-store: thin wrappers of the serial-flash library.
+*   Reads have no alignment, program and erase use the sizes of the flash.
+*
+*******************************************************************************/
+static cy_rslt_t bond_bd_read(void *context, uint32_t addr, uint32_t length,
+                              uint8_t *buf)
+{
+    (void)context;
+    return cy_serial_flash_qspi_read(addr, length, buf);
+}
+
+static cy_rslt_t bond_bd_program(void *context, uint32_t addr, uint32_t length,
+                                 const uint8_t *buf)
+{
+    (void)context;
+    return cy_serial_flash_qspi_write(addr, length, buf);
+}
+
+static cy_rslt_t bond_bd_erase(void *context, uint32_t addr, uint32_t length)
+{
+    (void)context;
+    return cy_serial_flash_qspi_erase(addr, length);
+}
+
+static uint32_t bond_bd_read_size(void *context, uint32_t addr)
+{
+    (void)context;
+    (void)addr;
+    return 1u;
+}
+
+static uint32_t bond_bd_program_size(void *context, uint32_t addr)
+{
+    (void)context;
+    return (uint32_t)cy_serial_flash_qspi_get_prog_size(addr);
+}
+
+static uint32_t bond_bd_erase_size(void *context, uint32_t addr)
+{
+    (void)context;
+    return (uint32_t)cy_serial_flash_qspi_get_erase_size(addr);
+}
+#endif /* BOND_STORE_FILE */
+
+/* [] END OF FILE */
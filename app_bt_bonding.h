@@ -0,0 +1,143 @@
+/******************************************************************************
+* File Name: app_bt_bonding.h
+*
+* Description: This file contains macros, structures and function prototypes
+*              used by app_bt_bonding.c to store bonding information and
+*              the cached CTS handles of bonded servers.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BT_BONDING_H__
+#define __APP_BT_BONDING_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "cts_client.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 0 to disable pairing/bonding with the CTS server */
+#ifndef ENABLE_BONDING
+#define ENABLE_BONDING                  (1u)
+#endif
+
+/* Set to 0 to trust the cached handles of a bonded server without checking
+ * its Database Hash, and to ignore Service Changed indications */
+#ifndef ENABLE_ROBUST_CACHING
+#define ENABLE_ROBUST_CACHING           (ENABLE_BONDING)
+#endif
+
+/* Number of bonded servers remembered. The oldest entry is replaced when the
+ * store is full */
+#ifndef BOND_MAX_DEVICES
+#define BOND_MAX_DEVICES                (4u)
+#endif
+
+/* Bond store layout identification. Bump the version whenever
+ * bond_store_t changes so that stale images are discarded */
+#define BOND_STORE_MAGIC                (0x43545342u) /* "CTSB" */
+#define BOND_STORE_VERSION              (4u)
+
+/* Default backend: a kv-store in the last BOND_STORE_KV_SECTORS erase
+ * sectors of the external QSPI flash. Keep them outside the application
+ * image. Host builds define BOND_STORE_FILE instead */
+#ifndef BOND_STORE_KV_SECTORS
+#define BOND_STORE_KV_SECTORS           (2u)
+#endif
+#define BOND_STORE_KV_KEY               "bond_store"
+#ifndef BOND_STORE_QSPI_FREQ_HZ
+#define BOND_STORE_QSPI_FREQ_HZ         (50000000lu)
+#endif
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* Information remembered per bonded server */
+typedef struct
+{
+    wiced_bt_device_link_keys_t link_keys;
+    cts_discovery_data_t        cts_handles;
+    bool                        notify_enabled;
+    bool                        in_use;
+    uint32_t                    sequence;
+} bond_info_t;
+
+/* Image of the bond store as kept in non-volatile memory */
+typedef struct
+{
+    uint32_t                       magic;
+    uint16_t                       version;
+    uint16_t                       crc;
+    wiced_bt_local_identity_keys_t local_keys;
+    bool                           local_keys_valid;
+    uint32_t                       sequence;
+    bond_info_t                    devices[BOND_MAX_DEVICES];
+} bond_store_t;
+
+/* Called when the bond store changed, from the thread that changed it. It
+ * must get app_bt_bond_flush() called in a task that may wait for the
+ * flash, and returns false if that could not be arranged */
+typedef bool (*app_bt_bond_flush_request_t)(void);
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+bool app_bt_bond_load(void);
+void app_bt_bond_init(app_bt_bond_flush_request_t flush_request);
+void app_bt_bond_flush(void);
+
+wiced_result_t app_bt_bond_save_local_keys(const wiced_bt_local_identity_keys_t *p_keys);
+wiced_result_t app_bt_bond_get_local_keys(wiced_bt_local_identity_keys_t *p_keys);
+
+wiced_result_t app_bt_bond_save_link_keys(const wiced_bt_device_link_keys_t *p_keys);
+wiced_result_t app_bt_bond_get_link_keys(wiced_bt_device_link_keys_t *p_keys);
+
+bool app_bt_bond_find(const uint8_t *bd_addr, bond_info_t *p_bond);
+void app_bt_bond_update_cts_cache(const uint8_t *bd_addr,
+                                  const cts_discovery_data_t *p_handles,
+                                  bool notify_enabled);
+
+/* Non-volatile backend. The default implementations are weak and may be
+ * overridden for another memory */
+bool app_bt_bond_nv_read(void *p_data, uint32_t len);
+bool app_bt_bond_nv_write(const void *p_data, uint32_t len);
+
+#endif      /* __APP_BT_BONDING_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,738 @@
+/******************************************************************************
+* File Name: app_bt_discovery.c
+*
+* Description: This file implements a GATT discovery engine driven by a
+*              table of services, characteristics and descriptors. It
+*              fills a handle map per connection with as few discovery
+*              procedures as the server layout allows.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_bt_discovery.h"
+#include "wiced_bt_uuid.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define DISC_NO_CHAR                    (-1)
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Descriptor UUIDs in the order of the APP_BT_DISC_DESC_ bits */
+static const uint16_t disc_desc_uuid[APP_BT_DISC_DESC_TYPES] =
+{
+    UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
+    UUID_DESCRIPTOR_CHARACTERISTIC_USER_DESCRIPTION,
+    UUID_DESCRIPTOR_CHARACTERISTIC_PRESENTATION_FORMAT,
+};
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static uint32_t disc_char_base(const app_bt_disc_t *p_disc, uint32_t service);
+static int32_t  disc_service_of(const app_bt_disc_t *p_disc, uint16_t handle);
+static uint8_t  disc_wanted_descriptors(app_bt_disc_t *p_disc, uint32_t service,
+                                        uint32_t index);
+static wiced_bt_gatt_status_t disc_send(app_bt_disc_t *p_disc, uint8_t discovery_type,
+                                        uint16_t start_handle, uint16_t end_handle,
+                                        uint16_t uuid16);
+static void disc_close_char(app_bt_disc_t *p_disc, uint16_t next_decl_handle);
+static bool disc_send_char_range(app_bt_disc_t *p_disc);
+static bool disc_send_descriptors(app_bt_disc_t *p_disc);
+static bool disc_next(app_bt_disc_t *p_disc);
+
+/*******************************************************************************
+* Function Name: app_bt_disc_start()
+********************************************************************************
+* Summary:
+*   Clears the handle map of a connection and starts the discovery of the
+*   services in a table. A single service is looked up by its UUID, several
+*   services are found with one discovery of all primary services.
+*
+* Parameters:
+*   app_bt_disc_t *p_disc: Handle map of the connection
+*   uint16_t conn_id: Connection ID
+*   const app_bt_disc_service_t *p_table: Services to discover
+*   uint8_t num_services: Number of services in the table
+*
+* Return:
+*   wiced_bt_gatt_status_t: Status of the first discovery request
+*
+*******************************************************************************/
+wiced_bt_gatt_status_t app_bt_disc_start(app_bt_disc_t *p_disc, uint16_t conn_id,
+                                         const app_bt_disc_service_t *p_table,
+                                         uint8_t num_services)
+{
+    wiced_bt_gatt_status_t gatt_status;
+
+    memset(p_disc, 0, sizeof(*p_disc));
+    if ((0u == num_services) || (num_services > APP_BT_DISC_MAX_SERVICES))
+    {
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+    }
+    p_disc->p_table = p_table;
+    p_disc->num_services = num_services;
+    if (disc_char_base(p_disc, num_services) > APP_BT_DISC_MAX_CHARS)
+    {
+        p_disc->num_services = 0;
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+    }
+    p_disc->conn_id = conn_id;
+    p_disc->open_char = DISC_NO_CHAR;
+    p_disc->state = APP_BT_DISC_SERVICES;
+
+    if (1u == num_services)
+    {
+        gatt_status = disc_send(p_disc, GATT_DISCOVER_SERVICES_BY_UUID, 0x0001, 0xFFFF,
+                                p_table[0].uuid16);
+    }
+    else
+    {
+        gatt_status = disc_send(p_disc, GATT_DISCOVER_SERVICES_ALL, 0x0001, 0xFFFF, 0);
+    }
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        p_disc->state = APP_BT_DISC_IDLE;
+    }
+    return gatt_status;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_disc_result()
+********************************************************************************
+* Summary:
+*   Adds a discovered service, characteristic or descriptor to the handle map
+*   if the table asks for it.
+*
+* Parameters:
+*   app_bt_disc_t *p_disc: Handle map of the connection
+*   uint8_t discovery_type: wiced_bt_gatt_discovery_type_t of the result
+*   uint16_t uuid16: UUID of the attribute, 0 for 128-bit UUIDs
+*   uint16_t handle: Service start, characteristic declaration or descriptor
+*                    handle
+*   uint16_t end_handle: Service end or characteristic value handle
+*   uint8_t properties: Characteristic properties
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_disc_result(app_bt_disc_t *p_disc, uint8_t discovery_type, uint16_t uuid16,
+                        uint16_t handle, uint16_t end_handle, uint8_t properties)
+{
+    app_bt_disc_char_handles_t *p_char;
+    const app_bt_disc_service_t *p_service;
+    uint32_t service;
+    uint32_t index;
+    uint32_t base;
+    int32_t  found;
+
+    switch (discovery_type)
+    {
+        case GATT_DISCOVER_SERVICES_ALL:
+        case GATT_DISCOVER_SERVICES_BY_UUID:
+            for (service = 0; service < p_disc->num_services; service++)
+            {
+                /* The first instance of a service is used */
+                if ((uuid16 == p_disc->p_table[service].uuid16) &&
+                    (0u == p_disc->services[service].start_handle))
+                {
+                    p_disc->services[service].start_handle = handle;
+                    p_disc->services[service].end_handle = end_handle;
+                    break;
+                }
+            }
+            break;
+
+        case GATT_DISCOVER_CHARACTERISTICS:
+            /* The next declaration ends the descriptors of the previous one */
+            disc_close_char(p_disc, handle);
+            found = disc_service_of(p_disc, handle);
+            if (found < 0)
+            {
+                break;
+            }
+            p_service = &p_disc->p_table[found];
+            base = disc_char_base(p_disc, (uint32_t)found);
+            for (index = 0; index < p_service->num_chars; index++)
+            {
+                p_char = &p_disc->chars[base + index];
+                if ((uuid16 == p_service->p_chars[index].uuid16) && (0u == p_char->decl_handle))
+                {
+                    p_char->decl_handle = handle;
+                    p_char->val_handle = end_handle;
+                    p_char->properties = properties;
+                    p_disc->open_char = (int8_t)(base + index);
+                    break;
+                }
+            }
+            break;
+
+        case GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS:
+            for (service = 0; service < p_disc->num_services; service++)
+            {
+                base = disc_char_base(p_disc, service);
+                for (index = 0; index < p_disc->p_table[service].num_chars; index++)
+                {
+                    p_char = &p_disc->chars[base + index];
+                    if ((0u == p_char->val_handle) || (handle <= p_char->val_handle) ||
+                        (handle > p_char->end_handle))
+                    {
+                        continue;
+                    }
+                    for (found = 0; found < (int32_t)APP_BT_DISC_DESC_TYPES; found++)
+                    {
+                        if ((uuid16 == disc_desc_uuid[found]) &&
+                            (0u != (p_disc->p_table[service].p_chars[index].descriptors &
+                                    (1u << found))))
+                        {
+                            p_char->desc_handle[found] = handle;
+                        }
+                    }
+                    return;
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_bt_disc_complete()
+********************************************************************************
+* Summary:
+*   Handles the end of a discovery procedure and sends the next one.
+*
+* Parameters:
+*   app_bt_disc_t *p_disc: Handle map of the connection
+*   uint8_t discovery_type: wiced_bt_gatt_discovery_type_t of the procedure
+*   uint8_t status: wiced_bt_gatt_status_t of the procedure
+*
+* Return:
+*   bool: true when the discovery is finished and the handle map is complete
+*
+*******************************************************************************/
+bool app_bt_disc_complete(app_bt_disc_t *p_disc, uint8_t discovery_type, uint8_t status)
+{
+    if (WICED_BT_GATT_SUCCESS != status)
+    {
+        /* What was found so far is kept */
+        printf("Discovery type %d ended with status %d\n", discovery_type, status);
+    }
+
+    switch (p_disc->state)
+    {
+        case APP_BT_DISC_SERVICES:
+            p_disc->state = APP_BT_DISC_CHARACTERISTICS;
+            p_disc->range_end = 0;
+            return disc_next(p_disc);
+
+        case APP_BT_DISC_CHARACTERISTICS:
+            disc_close_char(p_disc, 0);
+            return disc_next(p_disc);
+
+        case APP_BT_DISC_DESCRIPTORS:
+            p_disc->state = APP_BT_DISC_DONE;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_bt_disc_service_found()
+********************************************************************************
+* Summary:
+*   Checks if a service of the table was found.
+*
+* Parameters:
+*   const app_bt_disc_t *p_disc: Handle map of the connection
+*   uint16_t service_uuid16: Service UUID
+*
+* Return:
+*   bool: true if the server has the service
+*
+*******************************************************************************/
+bool app_bt_disc_service_found(const app_bt_disc_t *p_disc, uint16_t service_uuid16)
+{
+    uint32_t service;
+
+    for (service = 0; service < p_disc->num_services; service++)
+    {
+        if (service_uuid16 == p_disc->p_table[service].uuid16)
+        {
+            return (0u != p_disc->services[service].start_handle);
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_disc_find_char()
+********************************************************************************
+* Summary:
+*   Looks up the handles of a characteristic in the handle map.
+*
+* Parameters:
+*   const app_bt_disc_t *p_disc: Handle map of the connection
+*   uint16_t service_uuid16: Service UUID
+*   uint16_t char_uuid16: Characteristic UUID
+*
+* Return:
+*   const app_bt_disc_char_handles_t *: Handles, NULL if not found
+*
+*******************************************************************************/
+const app_bt_disc_char_handles_t *app_bt_disc_find_char(const app_bt_disc_t *p_disc,
+                                                        uint16_t service_uuid16,
+                                                        uint16_t char_uuid16)
+{
+    const app_bt_disc_service_t *p_service;
+    uint32_t service;
+    uint32_t index;
+    uint32_t base;
+
+    for (service = 0; service < p_disc->num_services; service++)
+    {
+        p_service = &p_disc->p_table[service];
+        if (service_uuid16 != p_service->uuid16)
+        {
+            continue;
+        }
+        base = disc_char_base(p_disc, service);
+        for (index = 0; index < p_service->num_chars; index++)
+        {
+            if ((char_uuid16 == p_service->p_chars[index].uuid16) &&
+                (0u != p_disc->chars[base + index].val_handle))
+            {
+                return &p_disc->chars[base + index];
+            }
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_disc_print()
+********************************************************************************
+* Summary:
+*   Prints the handle map and the number of discovery procedures it took.
+*
+* Parameters:
+*   const app_bt_disc_t *p_disc: Handle map of the connection
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_disc_print(const app_bt_disc_t *p_disc)
+{
+    const app_bt_disc_service_t *p_service;
+    const app_bt_disc_char_handles_t *p_char;
+    uint32_t services_found = 0;
+    uint32_t chars_found = 0;
+    uint32_t service;
+    uint32_t index;
+    uint32_t base;
+
+    for (service = 0; service < p_disc->num_services; service++)
+    {
+        p_service = &p_disc->p_table[service];
+        if (0u == p_disc->services[service].start_handle)
+        {
+            printf("Service 0x%04X not found\n", p_service->uuid16);
+            continue;
+        }
+        services_found++;
+        printf("Service 0x%04X: handles %d-%d\n", p_service->uuid16,
+               p_disc->services[service].start_handle,
+               p_disc->services[service].end_handle);
+
+        base = disc_char_base(p_disc, service);
+        for (index = 0; index < p_service->num_chars; index++)
+        {
+            p_char = &p_disc->chars[base + index];
+            if (0u == p_char->val_handle)
+            {
+                printf("  0x%04X not found\n", p_service->p_chars[index].uuid16);
+                continue;
+            }
+            chars_found++;
+            printf("  0x%04X: value %d, CCCD %d, description %d, format %d\n",
+                   p_service->p_chars[index].uuid16, p_char->val_handle,
+                   p_char->desc_handle[0], p_char->desc_handle[1], p_char->desc_handle[2]);
+        }
+    }
+
+    printf("Conn %d: %lu of %u services and %lu of %lu characteristics in %u "
+           "discovery request(s)\n", p_disc->conn_id, (unsigned long)services_found,
+           p_disc->num_services, (unsigned long)chars_found,
+           (unsigned long)disc_char_base(p_disc, p_disc->num_services), p_disc->requests);
+}
+
+/*******************************************************************************
+* Function Name: disc_char_base()
+********************************************************************************
+* Summary:
+*   Returns the position of the first characteristic of a service in the
+*   handle map, which is the number of characteristics before it.
+*
+* Parameters:
+*   const app_bt_disc_t *p_disc: Handle map of the connection
+*   uint32_t service: Index of the service in the table
+*
+* Return:
+*   uint32_t: Index into p_disc->chars
+*
+*******************************************************************************/
+static uint32_t disc_char_base(const app_bt_disc_t *p_disc, uint32_t service)
+{
+    uint32_t base = 0;
+    uint32_t index;
+
+    for (index = 0; index < service; index++)
+    {
+        base += p_disc->p_table[index].num_chars;
+    }
+    return base;
+}
+
+/*******************************************************************************
+* Function Name: disc_service_of()
+********************************************************************************
+* Summary:
+*   Finds the wanted service that contains a handle.
+*
+* Parameters:
+*   const app_bt_disc_t *p_disc: Handle map of the connection
+*   uint16_t handle: Attribute handle
+*
+* Return:
+*   int32_t: Index of the service in the table, -1 if none
+*
+*******************************************************************************/
+static int32_t disc_service_of(const app_bt_disc_t *p_disc, uint16_t handle)
+{
+    uint32_t service;
+
+    for (service = 0; service < p_disc->num_services; service++)
+    {
+        if ((0u != p_disc->services[service].start_handle) &&
+            (handle >= p_disc->services[service].start_handle) &&
+            (handle <= p_disc->services[service].end_handle))
+        {
+            return (int32_t)service;
+        }
+    }
+    return -1;
+}
+
+/*******************************************************************************
+* Function Name: disc_wanted_descriptors()
+********************************************************************************
+* Summary:
+*   Returns the descriptors still to be discovered for a characteristic. A
+*   characteristic without the notify or indicate property has no CCCD. If a
+*   CCCD is the only wanted descriptor and the characteristic has exactly one
+*   descriptor handle, that handle is the mandatory CCCD and is taken without
+*   asking the server.
+*
+* Parameters:
+*   app_bt_disc_t *p_disc: Handle map of the connection
+*   uint32_t service: Index of the service in the table
+*   uint32_t index: Index of the characteristic in the service
+*
+* Return:
+*   uint8_t: APP_BT_DISC_DESC_ bits
+*
+*******************************************************************************/
+static uint8_t disc_wanted_descriptors(app_bt_disc_t *p_disc, uint32_t service,
+                                       uint32_t index)
+{
+    app_bt_disc_char_handles_t *p_char =
+        &p_disc->chars[disc_char_base(p_disc, service) + index];
+    uint8_t wanted = p_disc->p_table[service].p_chars[index].descriptors;
+
+    if ((0u == p_char->val_handle) || (p_char->end_handle <= p_char->val_handle))
+    {
+        return 0;
+    }
+    if (0u == (p_char->properties &
+               (GATT_CHAR_PROPERTIES_BIT_NOTIFY | GATT_CHAR_PROPERTIES_BIT_INDICATE)))
+    {
+        wanted &= (uint8_t)~APP_BT_DISC_DESC_CCCD;
+    }
+    else if ((APP_BT_DISC_DESC_CCCD == wanted) &&
+             (p_char->end_handle == (p_char->val_handle + 1u)))
+    {
+        p_char->desc_handle[0] = p_char->end_handle;
+        wanted = 0;
+    }
+    return wanted;
+}
+
+/*******************************************************************************
+* Function Name: disc_send()
+********************************************************************************
+* Summary:
+*   Sends a discovery request and counts it.
+*
+* Parameters:
+*   app_bt_disc_t *p_disc: Handle map of the connection
+*   uint8_t discovery_type: wiced_bt_gatt_discovery_type_t
+*   uint16_t start_handle, end_handle: Handle range
+*   uint16_t uuid16: Service UUID for GATT_DISCOVER_SERVICES_BY_UUID
+*
+* Return:
+*   wiced_bt_gatt_status_t: Status of the request
+*
+*******************************************************************************/
+static wiced_bt_gatt_status_t disc_send(app_bt_disc_t *p_disc, uint8_t discovery_type,
+                                        uint16_t start_handle, uint16_t end_handle,
+                                        uint16_t uuid16)
+{
+    wiced_bt_gatt_discovery_param_t discovery_setup = {0};
+    wiced_bt_gatt_status_t gatt_status;
+
+    discovery_setup.s_handle = start_handle;
+    discovery_setup.e_handle = end_handle;
+    if (0u != uuid16)
+    {
+        discovery_setup.uuid.len = LEN_UUID_16;
+        discovery_setup.uuid.uu.uuid16 = uuid16;
+    }
+
+    gatt_status = wiced_bt_gatt_client_send_discover(p_disc->conn_id,
+                                                     (wiced_bt_gatt_discovery_type_t)discovery_type,
+                                                     &discovery_setup);
+    p_disc->requests++;
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("GATT discovery type %d failed! Error code = %d\n", discovery_type,
+               gatt_status);
+    }
+    return gatt_status;
+}
+
+/*******************************************************************************
+* Function Name: disc_close_char()
+********************************************************************************
+* Summary:
+*   Sets the last descriptor handle of the characteristic found last. It ends
+*   before the next characteristic declaration or with its service.
+*
+* Parameters:
+*   app_bt_disc_t *p_disc: Handle map of the connection
+*   uint16_t next_decl_handle: Next declaration, 0 at the end of the range
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void disc_close_char(app_bt_disc_t *p_disc, uint16_t next_decl_handle)
+{
+    app_bt_disc_char_handles_t *p_char;
+    int32_t service;
+
+    if (DISC_NO_CHAR == p_disc->open_char)
+    {
+        return;
+    }
+    p_char = &p_disc->chars[p_disc->open_char];
+    p_disc->open_char = DISC_NO_CHAR;
+
+    service = disc_service_of(p_disc, p_char->val_handle);
+    p_char->end_handle = (service < 0) ? p_char->val_handle :
+                         p_disc->services[service].end_handle;
+    if ((0u != next_decl_handle) && (next_decl_handle <= p_char->end_handle))
+    {
+        p_char->end_handle = next_decl_handle - 1u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: disc_send_char_range()
+********************************************************************************
+* Summary:
+*   Sends the characteristic discovery for the next found service. Services
+*   that follow each other without a gap are discovered with one request.
+*
+* Parameters:
+*   app_bt_disc_t *p_disc: Handle map of the connection
+*
+* Return:
+*   bool: true if a request was sent
+*
+*******************************************************************************/
+static bool disc_send_char_range(app_bt_disc_t *p_disc)
+{
+    uint16_t start_handle = 0;
+    uint16_t end_handle = 0;
+    uint32_t service;
+    bool     extended = true;
+
+    /* Lowest service after the range discovered last */
+    for (service = 0; service < p_disc->num_services; service++)
+    {
+        if ((p_disc->services[service].start_handle > p_disc->range_end) &&
+            ((0u == start_handle) || (p_disc->services[service].start_handle < start_handle)))
+        {
+            start_handle = p_disc->services[service].start_handle;
+            end_handle = p_disc->services[service].end_handle;
+        }
+    }
+    if (0u == start_handle)
+    {
+        return false;
+    }
+
+    while (extended && (end_handle < 0xFFFFu))
+    {
+        extended = false;
+        for (service = 0; service < p_disc->num_services; service++)
+        {
+            if (p_disc->services[service].start_handle == (end_handle + 1u))
+            {
+                end_handle = p_disc->services[service].end_handle;
+                extended = true;
+            }
+        }
+    }
+
+    p_disc->range_end = end_handle;
+    if (WICED_BT_GATT_SUCCESS != disc_send(p_disc, GATT_DISCOVER_CHARACTERISTICS,
+                                           start_handle, end_handle, 0))
+    {
+        /* Try the next range instead */
+        return disc_send_char_range(p_disc);
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: disc_send_descriptors()
+********************************************************************************
+* Summary:
+*   Sends one descriptor discovery that spans the descriptors of all
+*   characteristics that still need one. Descriptors in between that belong
+*   to other characteristics are ignored.
+*
+* Parameters:
+*   app_bt_disc_t *p_disc: Handle map of the connection
+*
+* Return:
+*   bool: true if a request was sent
+*
+*******************************************************************************/
+static bool disc_send_descriptors(app_bt_disc_t *p_disc)
+{
+    const app_bt_disc_char_handles_t *p_char;
+    uint16_t start_handle = 0xFFFF;
+    uint16_t end_handle = 0;
+    uint32_t service;
+    uint32_t index;
+    uint32_t base;
+
+    for (service = 0; service < p_disc->num_services; service++)
+    {
+        base = disc_char_base(p_disc, service);
+        for (index = 0; index < p_disc->p_table[service].num_chars; index++)
+        {
+            if (0u == disc_wanted_descriptors(p_disc, service, index))
+            {
+                continue;
+            }
+            p_char = &p_disc->chars[base + index];
+            if ((p_char->val_handle + 1u) < start_handle)
+            {
+                start_handle = p_char->val_handle + 1u;
+            }
+            if (p_char->end_handle > end_handle)
+            {
+                end_handle = p_char->end_handle;
+            }
+        }
+    }
+
+    if (0u == end_handle)
+    {
+        return false;
+    }
+    return (WICED_BT_GATT_SUCCESS == disc_send(p_disc, GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS,
+                                               start_handle, end_handle, 0));
+}
+
+/*******************************************************************************
+* Function Name: disc_next()
+********************************************************************************
+* Summary:
+*   Sends the next request of the characteristic or descriptor stage, moving
+*   on to the next stage when there is nothing left to ask for.
+*
+* Parameters:
+*   app_bt_disc_t *p_disc: Handle map of the connection
+*
+* Return:
+*   bool: true if the discovery is finished
+*
+*******************************************************************************/
+static bool disc_next(app_bt_disc_t *p_disc)
+{
+    if (APP_BT_DISC_CHARACTERISTICS == p_disc->state)
+    {
+        if (disc_send_char_range(p_disc))
+        {
+            return false;
+        }
+        p_disc->state = APP_BT_DISC_DESCRIPTORS;
+        if (disc_send_descriptors(p_disc))
+        {
+            return false;
+        }
+    }
+    p_disc->state = APP_BT_DISC_DONE;
+    return true;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,146 @@
+/******************************************************************************
+* File Name: app_bt_discovery.h
+*
+* Description: This file contains macros, structures and function prototypes
+*              used in app_bt_discovery.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BT_DISCOVERY_H__
+#define __APP_BT_DISCOVERY_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_gatt.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Size of the handle map of a connection */
+#ifndef APP_BT_DISC_MAX_SERVICES
+#define APP_BT_DISC_MAX_SERVICES        (4u)
+#endif
+#ifndef APP_BT_DISC_MAX_CHARS
+#define APP_BT_DISC_MAX_CHARS           (10u)
+#endif
+
+/* Descriptors wanted for a characteristic, see app_bt_disc_char_t */
+#define APP_BT_DISC_DESC_CCCD           (0x01u)     /* 0x2902 */
+#define APP_BT_DISC_DESC_USER_DESC      (0x02u)     /* 0x2901 */
+#define APP_BT_DISC_DESC_FORMAT         (0x04u)     /* 0x2904 */
+#define APP_BT_DISC_DESC_TYPES          (3u)
+
+/*******************************************************************************
+*        Enumerations
+*******************************************************************************/
+typedef enum
+{
+    APP_BT_DISC_IDLE,
+    APP_BT_DISC_SERVICES,
+    APP_BT_DISC_CHARACTERISTICS,
+    APP_BT_DISC_DESCRIPTORS,
+    APP_BT_DISC_DONE,
+} app_bt_disc_state_t;
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* A characteristic to discover and the descriptors wanted for it */
+typedef struct
+{
+    uint16_t uuid16;
+    uint8_t  descriptors;           /* APP_BT_DISC_DESC_ bits */
+} app_bt_disc_char_t;
+
+/* A service to discover. The table of services is constant and shared by
+ * all connections */
+typedef struct
+{
+    uint16_t                 uuid16;
+    const app_bt_disc_char_t *p_chars;
+    uint8_t                  num_chars;
+} app_bt_disc_service_t;
+
+/* Handles found for a characteristic, 0 if not found */
+typedef struct
+{
+    uint16_t decl_handle;
+    uint16_t val_handle;
+    uint16_t end_handle;            /* Last handle of its descriptors */
+    uint8_t  properties;
+    uint16_t desc_handle[APP_BT_DISC_DESC_TYPES];
+} app_bt_disc_char_handles_t;
+
+/* Handle map and procedure state of one connection. The characteristics of
+ * all services are kept in table order */
+typedef struct
+{
+    const app_bt_disc_service_t *p_table;
+    uint8_t  num_services;
+    uint8_t  state;                 /* app_bt_disc_state_t */
+    uint16_t conn_id;
+    uint16_t requests;              /* GATT discovery procedures sent */
+    uint16_t range_end;             /* End of the range being discovered */
+    int8_t   open_char;             /* Characteristic waiting for its end */
+    struct
+    {
+        uint16_t start_handle;
+        uint16_t end_handle;
+    } services[APP_BT_DISC_MAX_SERVICES];
+    app_bt_disc_char_handles_t chars[APP_BT_DISC_MAX_CHARS];
+} app_bt_disc_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+wiced_bt_gatt_status_t app_bt_disc_start(app_bt_disc_t *p_disc, uint16_t conn_id,
+                                         const app_bt_disc_service_t *p_table,
+                                         uint8_t num_services);
+void app_bt_disc_result(app_bt_disc_t *p_disc, uint8_t discovery_type, uint16_t uuid16,
+                        uint16_t handle, uint16_t end_handle, uint8_t properties);
+bool app_bt_disc_complete(app_bt_disc_t *p_disc, uint8_t discovery_type, uint8_t status);
+bool app_bt_disc_service_found(const app_bt_disc_t *p_disc, uint16_t service_uuid16);
+const app_bt_disc_char_handles_t *app_bt_disc_find_char(const app_bt_disc_t *p_disc,
+                                                        uint16_t service_uuid16,
+                                                        uint16_t char_uuid16);
+void app_bt_disc_print(const app_bt_disc_t *p_disc);
+
+#endif      /* __APP_BT_DISCOVERY_H__ */
+
+/* [] END OF FILE */
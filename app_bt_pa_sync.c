@@ -0,0 +1,495 @@
+/******************************************************************************
+* File Name: app_bt_pa_sync.c
+*
+* Description: This file implements connectionless time reception. The
+*              client synchronizes to the periodic advertising train of a
+*              broadcaster and takes the Current Time from the Service Data
+*              of every report it receives, so that one broadcaster serves
+*              any number of clients.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_bt_pa_sync.h"
+#include "app_bt_utils.h"
+#include "cts_broadcast.h"
+#include <stdio.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* data_status of a periodic advertising report */
+#define PA_DATA_COMPLETE                (0u)
+
+/* The stack takes the sync timeout in units of 10 ms */
+#define PA_SYNC_TIMEOUT_UNITS           ((uint16_t)(PA_SYNC_TIMEOUT_MS / 10u))
+
+/* No Constant Tone Extension type is excluded */
+#define PA_SYNC_CTE_ANY                 (0u)
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static wiced_bt_device_address_t pa_sync_addr = PA_SYNC_BROADCASTER_ADDR;
+
+static wiced_bt_ble_periodic_adv_sync_handle_t pa_sync_handle;
+static bool            pa_synced;
+static bool            pa_sync_pending;
+static pa_sync_stats_t pa_sync_stats;
+
+/* Set while a scan this module started runs. Any other scan, such as the
+ * server scan in central mode, lets the controller find the train too, and
+ * is never stopped here */
+static bool            pa_sync_scanning;
+
+/* Retry of a failed sync, with its backoff */
+static TimerHandle_t          pa_sync_retry_timer;
+static StaticTimer_t          pa_sync_retry_timer_buffer;
+static uint32_t               pa_sync_retry_ms = PA_SYNC_RETRY_MIN_MS;
+static app_bt_pa_sync_retry_t pa_sync_retry;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void pa_sync_scan_callback(wiced_bt_ble_scan_results_t *p_scan_result,
+                                  uint8_t *p_adv_data);
+static void pa_sync_scan_stop(void);
+static void pa_sync_schedule_retry(void);
+static void pa_sync_retry_timer_callback(TimerHandle_t timer);
+
+/*******************************************************************************
+* Function Name: app_bt_pa_sync_init()
+********************************************************************************
+* Summary:
+*   Creates the timer that retries a failed sync.
+*
+* Parameters:
+*   app_bt_pa_sync_retry_t retry: Requests a call of app_bt_pa_sync_start()
+*                                 in the application task
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_pa_sync_init(app_bt_pa_sync_retry_t retry)
+{
+    pa_sync_retry = retry;
+    if (NULL == pa_sync_retry_timer)
+    {
+        pa_sync_retry_timer = xTimerCreateStatic("pa_sync", pdMS_TO_TICKS(PA_SYNC_RETRY_MIN_MS),
+                                                 pdFALSE, NULL, pa_sync_retry_timer_callback,
+                                                 &pa_sync_retry_timer_buffer);
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_bt_pa_sync_start()
+********************************************************************************
+* Summary:
+*   Requests a sync to the periodic advertising train of the broadcaster and
+*   scans until the controller has found it. The controller learns the
+*   timing of the train from the SyncInfo of the broadcaster's extended
+*   advertising, which it only receives while scanning. A request the stack
+*   refuses is retried with backoff.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   wiced_result_t: Result of wiced_bt_ble_create_sync_to_periodic_adv()
+*
+*******************************************************************************/
+wiced_result_t app_bt_pa_sync_start(void)
+{
+    wiced_result_t result;
+
+    if (pa_synced || pa_sync_pending)
+    {
+        return WICED_BT_BUSY;
+    }
+
+    result = wiced_bt_ble_create_sync_to_periodic_adv(WICED_BT_BLE_IGNORE_SYNC_TO_PERIODIC_ADV_LIST,
+                                                      PA_SYNC_SID,
+                                                      PA_SYNC_BROADCASTER_ADDR_TYPE,
+                                                      pa_sync_addr, PA_SYNC_SKIP,
+                                                      PA_SYNC_TIMEOUT_UNITS,
+                                                      PA_SYNC_CTE_ANY);
+    if ((WICED_BT_SUCCESS != result) && (WICED_BT_PENDING != result))
+    {
+        printf("Failed to sync to the time broadcaster! Error code: %X \n",
+               (unsigned int)result);
+        pa_sync_schedule_retry();
+        return result;
+    }
+    pa_sync_pending = true;
+
+    app_bt_pa_sync_scan_resume();
+    printf("Looking for the periodic advertising of time broadcaster ");
+    print_bd_address(pa_sync_addr);
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_pa_sync_stop()
+********************************************************************************
+* Summary:
+*   Cancels a pending sync or a retry, or terminates the sync to the
+*   broadcaster.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_pa_sync_stop(void)
+{
+    if (NULL != pa_sync_retry_timer)
+    {
+        (void)xTimerStop(pa_sync_retry_timer, 0);
+    }
+    if (pa_sync_pending)
+    {
+        pa_sync_pending = false;
+        (void)wiced_bt_ble_cancel_create_sync_to_periodic_adv();
+        pa_sync_scan_stop();
+    }
+    if (pa_synced)
+    {
+        pa_synced = false;
+        (void)wiced_bt_ble_terminate_sync_to_periodic_adv(pa_sync_handle);
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_bt_pa_sync_established()
+********************************************************************************
+* Summary:
+*   Handles BTM_BLE_PERIODIC_ADV_SYNC_ESTABLISHED_EVENT. Scanning is no longer
+*   needed once the controller follows the train. A failed sync is retried
+*   with backoff.
+*
+* Parameters:
+*   const wiced_bt_ble_periodic_adv_sync_established_event_data_t *p_data:
+*       Event data
+*
+* Return:
+*   bool: true if the client is now synchronized to the broadcaster
+*
+*******************************************************************************/
+bool app_bt_pa_sync_established(
+    const wiced_bt_ble_periodic_adv_sync_established_event_data_t *p_data)
+{
+    pa_sync_pending = false;
+    pa_sync_scan_stop();
+
+    if (WICED_BT_SUCCESS != p_data->status)
+    {
+        printf("Periodic advertising sync failed, status %u, retry in %lu ms\n",
+               (unsigned int)p_data->status, (unsigned long)pa_sync_retry_ms);
+        pa_sync_stats.failures++;
+        pa_sync_schedule_retry();
+        return false;
+    }
+
+    pa_sync_handle = p_data->sync_handle;
+    pa_synced = true;
+    pa_sync_retry_ms = PA_SYNC_RETRY_MIN_MS;
+    pa_sync_stats.syncs++;
+    /* The interval is in units of 1.25 ms */
+    printf("Synced to time broadcaster, SID %u, interval %lu ms, %s PHY\n",
+           (unsigned int)p_data->adv_sid,
+           (unsigned long)(((uint32_t)p_data->periodic_adv_int * 5u) / 4u),
+           get_bt_phy_name(p_data->adv_phy));
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_pa_sync_report()
+********************************************************************************
+* Summary:
+*   Handles BTM_BLE_PERIODIC_ADV_REPORT_EVENT and finds the Current Time in
+*   the report. Runs in the Bluetooth stack task.
+*
+* Parameters:
+*   const wiced_bt_ble_periodic_adv_report_event_data_t *p_report: Report
+*   uint16_t *p_time_len: Length of the Current Time value
+*
+* Return:
+*   const uint8_t*: Current Time value in the report, NULL if there is none
+*
+*******************************************************************************/
+const uint8_t *app_bt_pa_sync_report(
+    const wiced_bt_ble_periodic_adv_report_event_data_t *p_report, uint16_t *p_time_len)
+{
+    const uint8_t *p_time;
+
+    if ((!pa_synced) || (p_report->sync_handle != pa_sync_handle))
+    {
+        return NULL;
+    }
+    pa_sync_stats.reports++;
+
+    /* The time must not be taken from a report that was cut short */
+    if (PA_DATA_COMPLETE != p_report->data_status)
+    {
+        pa_sync_stats.incomplete++;
+        return NULL;
+    }
+
+    p_time = cts_broadcast_find_time(p_report->p_data, p_report->data_length, p_time_len);
+    if (NULL != p_time)
+    {
+        pa_sync_stats.time_reports++;
+    }
+    return p_time;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_pa_sync_lost()
+********************************************************************************
+* Summary:
+*   Handles BTM_BLE_PERIODIC_ADV_SYNC_LOST_EVENT and looks for the train
+*   again.
+*
+* Parameters:
+*   wiced_bt_ble_periodic_adv_sync_handle_t sync_handle: Sync that was lost
+*
+* Return:
+*   bool: true if it was the sync to the broadcaster
+*
+*******************************************************************************/
+bool app_bt_pa_sync_lost(wiced_bt_ble_periodic_adv_sync_handle_t sync_handle)
+{
+    if ((!pa_synced) || (sync_handle != pa_sync_handle))
+    {
+        return false;
+    }
+    pa_synced = false;
+    pa_sync_stats.losses++;
+    printf("Time broadcaster lost\n");
+    app_bt_pa_sync_print_stats();
+
+    (void)app_bt_pa_sync_start();
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_pa_sync_scan_release()
+********************************************************************************
+* Summary:
+*   Stops the scan of a pending sync, so that the server scan of the central
+*   mode can take the scanner. The pending sync then uses that scan.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_pa_sync_scan_release(void)
+{
+    pa_sync_scan_stop();
+}
+
+/*******************************************************************************
+* Function Name: app_bt_pa_sync_scan_resume()
+********************************************************************************
+* Summary:
+*   Starts a scan for a pending sync if no other scan runs.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_pa_sync_scan_resume(void)
+{
+    wiced_result_t result;
+
+    if ((!pa_sync_pending) || (pa_sync_scanning) ||
+        (BTM_BLE_SCAN_TYPE_NONE != wiced_bt_ble_get_current_scan_state()))
+    {
+        return;
+    }
+    result = wiced_bt_ble_scan(BTM_BLE_SCAN_TYPE_HIGH_DUTY, WICED_TRUE, pa_sync_scan_callback);
+    pa_sync_scanning = ((WICED_BT_SUCCESS == result) || (WICED_BT_PENDING == result));
+}
+
+/*******************************************************************************
+* Function Name: app_bt_pa_sync_scan_stopped()
+********************************************************************************
+* Summary:
+*   Handles the end of a scan, of this module or of the server scan, and
+*   scans again while the sync is pending.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_pa_sync_scan_stopped(void)
+{
+    pa_sync_scanning = false;
+    app_bt_pa_sync_scan_resume();
+}
+
+/*******************************************************************************
+* Function Name: app_bt_pa_sync_print_stats()
+********************************************************************************
+* Summary:
+*   Prints the sync and report counters.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_pa_sync_print_stats(void)
+{
+    printf("Broadcast: %lu syncs, %lu failed, %lu lost, %lu reports, %lu with time, "
+           "%lu incomplete\n",
+           (unsigned long)pa_sync_stats.syncs, (unsigned long)pa_sync_stats.failures,
+           (unsigned long)pa_sync_stats.losses,
+           (unsigned long)pa_sync_stats.reports,
+           (unsigned long)pa_sync_stats.time_reports,
+           (unsigned long)pa_sync_stats.incomplete);
+}
+
+/*******************************************************************************
+* Function Name: pa_sync_scan_callback()
+********************************************************************************
+* Summary:
+*   Scan results while the sync is pending. The controller finds the train by
+*   itself, the reports are not needed.
+*
+* Parameters:
+*   wiced_bt_ble_scan_results_t *p_scan_result: Advertiser information
+*   uint8_t *p_adv_data: Advertising data
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void pa_sync_scan_callback(wiced_bt_ble_scan_results_t *p_scan_result,
+                                  uint8_t *p_adv_data)
+{
+    (void)p_scan_result;
+    (void)p_adv_data;
+}
+
+/*******************************************************************************
+* Function Name: pa_sync_scan_stop()
+********************************************************************************
+* Summary:
+*   Stops the scan if this module started it. A scan of another module keeps
+*   running.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void pa_sync_scan_stop(void)
+{
+    if (pa_sync_scanning)
+    {
+        pa_sync_scanning = false;
+        (void)wiced_bt_ble_scan(BTM_BLE_SCAN_TYPE_NONE, WICED_TRUE, pa_sync_scan_callback);
+    }
+}
+
+/*******************************************************************************
+* Function Name: pa_sync_schedule_retry()
+********************************************************************************
+* Summary:
+*   Starts the retry timer with the current backoff and doubles the backoff
+*   for the next failure.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void pa_sync_schedule_retry(void)
+{
+    if (NULL == pa_sync_retry_timer)
+    {
+        return;
+    }
+    (void)xTimerChangePeriod(pa_sync_retry_timer, pdMS_TO_TICKS(pa_sync_retry_ms), 0);
+    pa_sync_retry_ms = ((pa_sync_retry_ms * 2u) < PA_SYNC_RETRY_MAX_MS) ?
+                       (pa_sync_retry_ms * 2u) : PA_SYNC_RETRY_MAX_MS;
+}
+
+/*******************************************************************************
+* Function Name: pa_sync_retry_timer_callback()
+********************************************************************************
+* Summary:
+*   Runs in the FreeRTOS timer task when a failed sync is due to be retried.
+*
+* Parameters:
+*   TimerHandle_t timer: Retry timer
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void pa_sync_retry_timer_callback(TimerHandle_t timer)
+{
+    (void)timer;
+
+    if (NULL != pa_sync_retry)
+    {
+        pa_sync_retry();
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,127 @@
+/******************************************************************************
+* File Name: app_bt_pa_sync.h
+*
+* Description: This file contains macros, structures and function prototypes
+*              used in app_bt_pa_sync.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BT_PA_SYNC_H__
+#define __APP_BT_PA_SYNC_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+#include <FreeRTOS.h>
+#include <timers.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Broadcaster of the Current Time: its address, address type and the
+ * Advertising SID of its periodic advertising train */
+#ifndef PA_SYNC_BROADCASTER_ADDR
+#define PA_SYNC_BROADCASTER_ADDR        { 0x00, 0xA0, 0x50, 0x00, 0x00, 0x01 }
+#endif
+#ifndef PA_SYNC_BROADCASTER_ADDR_TYPE
+#define PA_SYNC_BROADCASTER_ADDR_TYPE   (BLE_ADDR_RANDOM)
+#endif
+#ifndef PA_SYNC_SID
+#define PA_SYNC_SID                     (0u)
+#endif
+
+/* Periodic advertising events the controller may skip after one it
+ * received. A larger skip saves receive time and needs a longer timeout */
+#ifndef PA_SYNC_SKIP
+#define PA_SYNC_SKIP                    (4u)
+#endif
+
+/* Sync is lost when no event is received for this long */
+#ifndef PA_SYNC_TIMEOUT_MS
+#define PA_SYNC_TIMEOUT_MS              (10000u)
+#endif
+
+/* A failed sync is retried after PA_SYNC_RETRY_MIN_MS, doubled on every
+ * further failure up to PA_SYNC_RETRY_MAX_MS */
+#ifndef PA_SYNC_RETRY_MIN_MS
+#define PA_SYNC_RETRY_MIN_MS            (1000u)
+#endif
+#ifndef PA_SYNC_RETRY_MAX_MS
+#define PA_SYNC_RETRY_MAX_MS            (60000u)
+#endif
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+typedef struct
+{
+    uint32_t syncs;                 /* Syncs established */
+    uint32_t failures;              /* Syncs that failed and are retried */
+    uint32_t losses;                /* Syncs lost */
+    uint32_t reports;               /* Periodic advertising reports */
+    uint32_t time_reports;          /* Reports that carried the time */
+    uint32_t incomplete;            /* Reports with truncated data */
+} pa_sync_stats_t;
+
+/* Called from the timer task when a failed sync is due to be retried. It
+ * must get app_bt_pa_sync_start() called */
+typedef void (*app_bt_pa_sync_retry_t)(void);
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+void app_bt_pa_sync_init(app_bt_pa_sync_retry_t retry);
+wiced_result_t app_bt_pa_sync_start(void);
+void app_bt_pa_sync_stop(void);
+
+/* The scanner is shared with the server scan of the central mode */
+void app_bt_pa_sync_scan_release(void);
+void app_bt_pa_sync_scan_resume(void);
+void app_bt_pa_sync_scan_stopped(void);
+
+bool app_bt_pa_sync_established(
+    const wiced_bt_ble_periodic_adv_sync_established_event_data_t *p_data);
+const uint8_t *app_bt_pa_sync_report(
+    const wiced_bt_ble_periodic_adv_report_event_data_t *p_report, uint16_t *p_time_len);
+bool app_bt_pa_sync_lost(wiced_bt_ble_periodic_adv_sync_handle_t sync_handle);
+
+void app_bt_pa_sync_print_stats(void);
+
+#endif      /* __APP_BT_PA_SYNC_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,558 @@
+/******************************************************************************
+* File Name: app_bt_scan.c
+*
+* Description: This file implements the central role of the CTS client. It
+*              scans for advertisers that list the Current Time Service UUID,
+*              connects to them directly and reports the scan-to-connect
+*              latency and the CPU load of the scan result handling.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_bt_scan.h"
+#include "app_cts_server.h"
+#include "app_bt_utils.h"
+#include "wiced_bt_gatt.h"
+#include "wiced_bt_uuid.h"
+#include <task.h>
+#include <string.h>
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Scan window and interval profiles. High duty scanning runs first, then the
+ * stack falls back to low duty scanning until the low duty duration ends */
+static const scan_profile_params_t scan_profiles[SCAN_PROFILE_COUNT] =
+{
+    [SCAN_PROFILE_FAST] =
+    {
+        .name = "FAST",
+        .high_duty_scan_interval = SCAN_SLOTS(60),
+        .high_duty_scan_window   = SCAN_SLOTS(60),
+        .high_duty_scan_duration = 30,
+        .low_duty_scan_interval  = SCAN_SLOTS(60),
+        .low_duty_scan_window    = SCAN_SLOTS(30),
+        .low_duty_scan_duration  = 60,
+    },
+    [SCAN_PROFILE_BALANCED] =
+    {
+        .name = "BALANCED",
+        .high_duty_scan_interval = SCAN_SLOTS(60),
+        .high_duty_scan_window   = SCAN_SLOTS(30),
+        .high_duty_scan_duration = 10,
+        .low_duty_scan_interval  = SCAN_SLOTS(1280),
+        .low_duty_scan_window    = SCAN_SLOTS(128),
+        .low_duty_scan_duration  = 120,
+    },
+    [SCAN_PROFILE_LOW_POWER] =
+    {
+        .name = "LOW_POWER",
+        .high_duty_scan_interval = SCAN_SLOTS(640),
+        .high_duty_scan_window   = SCAN_SLOTS(64),
+        .high_duty_scan_duration = 10,
+        .low_duty_scan_interval  = SCAN_SLOTS(2560),
+        .low_duty_scan_window    = SCAN_SLOTS(64),
+        .low_duty_scan_duration  = 300,
+    },
+};
+
+/* RAM copies of the Bluetooth configuration so that the scan settings can be
+ * changed at run time. The stack keeps the pointer passed at init */
+static wiced_bt_cfg_settings_t          scan_cfg_settings;
+static wiced_bt_cfg_ble_t               scan_cfg_ble;
+static wiced_bt_cfg_gatt_t              scan_cfg_gatt;
+static wiced_bt_cfg_ble_scan_settings_t scan_cfg_scan;
+
+static scan_profile_t                   scan_profile = SCAN_PROFILE;
+static scan_stats_t                     scan_stats;
+
+/* Servers connected through the scan, all zero for a free entry. Their
+ * advertising is ignored while they are connected */
+static wiced_bt_device_address_t        scan_connected[CTS_MAX_CONNECTIONS];
+static const wiced_bt_device_address_t  scan_addr_none;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void scan_result_callback(wiced_bt_ble_scan_results_t *p_scan_result,
+                                 uint8_t *p_adv_data);
+static bool scan_adv_has_cts_uuid(uint8_t *p_adv_data);
+static wiced_bt_device_address_t *scan_connected_find(const uint8_t *bd_addr);
+static void scan_stats_snapshot(scan_stats_t *p_stats);
+
+/*******************************************************************************
+* Function Name: app_bt_scan_cfg_init()
+********************************************************************************
+* Summary:
+*   Creates a RAM copy of the Bluetooth configuration with the scan settings
+*   of the selected profile and the connection limits of the application.
+*   The returned pointer must be passed to wiced_bt_stack_init().
+*
+* Parameters:
+*   const wiced_bt_cfg_settings_t *p_cfg: Generated configuration
+*
+* Return:
+*   const wiced_bt_cfg_settings_t*: Configuration to use
+*
+*******************************************************************************/
+const wiced_bt_cfg_settings_t *app_bt_scan_cfg_init(const wiced_bt_cfg_settings_t *p_cfg)
+{
+    memcpy(&scan_cfg_settings, p_cfg, sizeof(scan_cfg_settings));
+    memcpy(&scan_cfg_ble, p_cfg->p_ble_cfg, sizeof(scan_cfg_ble));
+    if (NULL != p_cfg->p_ble_cfg->p_ble_scan_cfg)
+    {
+        memcpy(&scan_cfg_scan, p_cfg->p_ble_cfg->p_ble_scan_cfg,
+               sizeof(scan_cfg_scan));
+    }
+    scan_cfg_scan.scan_mode = BTM_BLE_SCAN_MODE_PASSIVE;
+
+    scan_cfg_ble.p_ble_scan_cfg = &scan_cfg_scan;
+    scan_cfg_settings.p_ble_cfg = &scan_cfg_ble;
+
+    /* One link per time source and per peer of the CTS server */
+    memcpy(&scan_cfg_gatt, p_cfg->p_gatt_cfg, sizeof(scan_cfg_gatt));
+    scan_cfg_gatt.client_max_links = CTS_MAX_CONNECTIONS;
+    scan_cfg_gatt.server_max_links = CTS_MAX_LINKS;
+    scan_cfg_ble.ble_max_simultaneous_links = CTS_MAX_LINKS;
+    scan_cfg_settings.p_gatt_cfg = &scan_cfg_gatt;
+
+    app_bt_scan_set_profile(scan_profile);
+    return &scan_cfg_settings;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_scan_set_profile()
+********************************************************************************
+* Summary:
+*   Selects the scan window and interval profile for the next scan.
+*
+* Parameters:
+*   scan_profile_t profile: Profile to use
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_scan_set_profile(scan_profile_t profile)
+{
+    const scan_profile_params_t *p_params;
+
+    if (profile >= SCAN_PROFILE_COUNT)
+    {
+        return;
+    }
+    scan_profile = profile;
+    p_params = &scan_profiles[profile];
+
+    scan_cfg_scan.high_duty_scan_interval = p_params->high_duty_scan_interval;
+    scan_cfg_scan.high_duty_scan_window   = p_params->high_duty_scan_window;
+    scan_cfg_scan.high_duty_scan_duration = p_params->high_duty_scan_duration;
+    scan_cfg_scan.low_duty_scan_interval  = p_params->low_duty_scan_interval;
+    scan_cfg_scan.low_duty_scan_window    = p_params->low_duty_scan_window;
+    scan_cfg_scan.low_duty_scan_duration  = p_params->low_duty_scan_duration;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_scan_start()
+********************************************************************************
+* Summary:
+*   Starts high duty scanning with duplicate filtering done in the controller,
+*   so that each advertiser is reported only once per scan.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   wiced_result_t: Result of wiced_bt_ble_scan()
+*
+*******************************************************************************/
+wiced_result_t app_bt_scan_start(void)
+{
+    wiced_result_t result;
+
+    if (app_bt_scan_connecting())
+    {
+        return WICED_BT_BUSY;
+    }
+
+    taskENTER_CRITICAL();
+    memset(&scan_stats, 0, sizeof(scan_stats));
+    scan_stats.scan_start_tick = xTaskGetTickCount();
+    taskEXIT_CRITICAL();
+
+    result = wiced_bt_ble_scan(BTM_BLE_SCAN_TYPE_HIGH_DUTY, WICED_TRUE,
+                               scan_result_callback);
+    if ((WICED_BT_SUCCESS != result) && (WICED_BT_PENDING != result))
+    {
+        printf("Failed to start scan! Error code: %X \n", (unsigned int)result);
+    }
+    else
+    {
+        printf("Scanning for CTS servers, profile %s\n",
+               scan_profiles[scan_profile].name);
+    }
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: app_bt_scan_stop()
+********************************************************************************
+* Summary:
+*   Stops scanning.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_scan_stop(void)
+{
+    wiced_bt_ble_scan(BTM_BLE_SCAN_TYPE_NONE, WICED_TRUE, scan_result_callback);
+}
+
+/*******************************************************************************
+* Function Name: app_bt_scan_state_changed()
+********************************************************************************
+* Summary:
+*   Handles BTM_BLE_SCAN_STATE_CHANGED_EVT. When scanning stops, the number of
+*   advertising reports and the CPU load caused by handling them is printed.
+*
+* Parameters:
+*   wiced_bt_ble_scan_type_t state: New scan state
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_scan_state_changed(wiced_bt_ble_scan_type_t state)
+{
+    scan_stats_t stats;
+    uint32_t elapsed_ms;
+    uint32_t load;
+
+    switch (state)
+    {
+        case BTM_BLE_SCAN_TYPE_HIGH_DUTY:
+            printf("Scan State Change: High duty scan\n");
+            break;
+
+        case BTM_BLE_SCAN_TYPE_LOW_DUTY:
+            printf("Scan State Change: Low duty scan\n");
+            break;
+
+        default:
+            scan_stats_snapshot(&stats);
+            elapsed_ms = (xTaskGetTickCount() - stats.scan_start_tick) *
+                         portTICK_PERIOD_MS;
+            /* Load in hundredths of a percent: us / (ms * 1000) * 10000 */
+            load = (elapsed_ms) ?
+                   (uint32_t)((stats.callback_time_us * 10u) / elapsed_ms) : 0u;
+            printf("Scan stopped after %lu ms: %lu adv reports, %lu CTS server(s), "
+                   "scan callback CPU load %lu.%02lu%%\n",
+                   (unsigned long)elapsed_ms,
+                   (unsigned long)stats.adv_reports,
+                   (unsigned long)stats.cts_matches,
+                   (unsigned long)(load / 100u), (unsigned long)(load % 100u));
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_bt_scan_connection_up()
+********************************************************************************
+* Summary:
+*   Reports the scan-to-connect latency when the connection to the server
+*   the scanner is connecting to is established. That server is skipped by
+*   later scans while it stays connected. Links to other addresses leave the
+*   pending connection alone.
+*
+* Parameters:
+*   const uint8_t *bd_addr: Address of the connected time source
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_scan_connection_up(const uint8_t *bd_addr)
+{
+    TickType_t now = xTaskGetTickCount();
+    wiced_bt_device_address_t *p_entry;
+    scan_stats_t stats;
+
+    taskENTER_CRITICAL();
+    stats = scan_stats;
+    if ((!stats.connect_pending) ||
+        (0 != memcmp(stats.pending_addr, bd_addr, BD_ADDR_LEN)))
+    {
+        taskEXIT_CRITICAL();
+        return;
+    }
+    scan_stats.connect_pending = false;
+    p_entry = scan_connected_find(scan_addr_none);
+    if (NULL != p_entry)
+    {
+        memcpy(*p_entry, bd_addr, BD_ADDR_LEN);
+    }
+    taskEXIT_CRITICAL();
+
+    printf("Scan to connect latency: %lu ms (scan to match %lu ms, "
+           "match to connect %lu ms)\n",
+           (unsigned long)((now - stats.scan_start_tick) * portTICK_PERIOD_MS),
+           (unsigned long)((stats.match_tick - stats.scan_start_tick) *
+                           portTICK_PERIOD_MS),
+           (unsigned long)((now - stats.match_tick) * portTICK_PERIOD_MS));
+}
+
+/*******************************************************************************
+* Function Name: app_bt_scan_connection_down()
+********************************************************************************
+* Summary:
+*   Handles a disconnection. A failed connection attempt to the server found
+*   by the scan clears the pending connection; the disconnection of an
+*   established link only makes its server eligible for the scan again.
+*
+* Parameters:
+*   const uint8_t *bd_addr: Address of the server
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_bt_scan_connection_down(const uint8_t *bd_addr)
+{
+    wiced_bt_device_address_t *p_entry;
+
+    taskENTER_CRITICAL();
+    if ((scan_stats.connect_pending) &&
+        (0 == memcmp(scan_stats.pending_addr, bd_addr, BD_ADDR_LEN)))
+    {
+        scan_stats.connect_pending = false;
+    }
+    else
+    {
+        p_entry = scan_connected_find(bd_addr);
+        if (NULL != p_entry)
+        {
+            memset(*p_entry, 0, BD_ADDR_LEN);
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+* Function Name: app_bt_scan_connecting()
+********************************************************************************
+* Summary:
+*   Tells if the scan stopped to connect to a server that was found.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   bool: true while the connection to a scanned server is pending
+*
+*******************************************************************************/
+bool app_bt_scan_connecting(void)
+{
+    bool pending;
+
+    taskENTER_CRITICAL();
+    pending = scan_stats.connect_pending;
+    taskEXIT_CRITICAL();
+    return pending;
+}
+
+/*******************************************************************************
+* Function Name: scan_result_callback()
+********************************************************************************
+* Summary:
+*   Handles advertising reports. The first advertiser that lists the Current
+*   Time Service UUID and is not connected yet stops the scan and a
+*   connection is requested to it.
+*
+* Parameters:
+*   wiced_bt_ble_scan_results_t *p_scan_result: Advertiser information, NULL
+*                                               when the scan completes
+*   uint8_t *p_adv_data: Advertising data
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void scan_result_callback(wiced_bt_ble_scan_results_t *p_scan_result,
+                                 uint8_t *p_adv_data)
+{
+    uint32_t start_cycles = cycle_counter_get();
+    bool connect = false;
+    bool cts_server;
+
+    if ((NULL == p_scan_result) || (NULL == p_adv_data))
+    {
+        return;
+    }
+    cts_server = scan_adv_has_cts_uuid(p_adv_data);
+
+    taskENTER_CRITICAL();
+    scan_stats.adv_reports++;
+    if ((!scan_stats.connect_pending) && (cts_server) &&
+        (NULL == scan_connected_find(p_scan_result->remote_bd_addr)))
+    {
+        scan_stats.cts_matches++;
+        scan_stats.match_tick = xTaskGetTickCount();
+        scan_stats.connect_pending = true;
+        memcpy(scan_stats.pending_addr, p_scan_result->remote_bd_addr,
+               BD_ADDR_LEN);
+        connect = true;
+    }
+    taskEXIT_CRITICAL();
+
+    if (connect)
+    {
+        printf("CTS server found, RSSI %d, BDA ", p_scan_result->rssi);
+        print_bd_address(p_scan_result->remote_bd_addr);
+
+        /* The controller cannot scan and initiate at the same time */
+        app_bt_scan_stop();
+        if (!wiced_bt_gatt_le_connect(p_scan_result->remote_bd_addr,
+                                      p_scan_result->ble_addr_type,
+                                      BLE_CONN_MODE_HIGH_DUTY, WICED_TRUE))
+        {
+            printf("Connection request failed\n");
+            taskENTER_CRITICAL();
+            scan_stats.connect_pending = false;
+            taskEXIT_CRITICAL();
+        }
+    }
+
+    taskENTER_CRITICAL();
+    scan_stats.callback_time_us += CYCLES_TO_US(cycle_counter_get() - start_cycles);
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+* Function Name: scan_connected_find()
+********************************************************************************
+* Summary:
+*   Looks up a server in the list of servers connected through the scan.
+*   Must be called inside a critical section.
+*
+* Parameters:
+*   const uint8_t *bd_addr: Address of the server, scan_addr_none to find a
+*                           free entry
+*
+* Return:
+*   wiced_bt_device_address_t *: Matching entry, NULL if there is none
+*
+*******************************************************************************/
+static wiced_bt_device_address_t *scan_connected_find(const uint8_t *bd_addr)
+{
+    uint32_t index;
+
+    for (index = 0; index < CTS_MAX_CONNECTIONS; index++)
+    {
+        if (0 == memcmp(scan_connected[index], bd_addr, BD_ADDR_LEN))
+        {
+            return &scan_connected[index];
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: scan_stats_snapshot()
+********************************************************************************
+* Summary:
+*   Copies the scan statistics, which the scan callback updates in the stack
+*   thread.
+*
+* Parameters:
+*   scan_stats_t *p_stats: Copy of the statistics
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void scan_stats_snapshot(scan_stats_t *p_stats)
+{
+    taskENTER_CRITICAL();
+    *p_stats = scan_stats;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+* Function Name: scan_adv_has_cts_uuid()
+********************************************************************************
+* Summary:
+*   Checks the complete and partial 16-bit service UUID lists of the
+*   advertising data for the Current Time Service.
+*
+* Parameters:
+*   uint8_t *p_adv_data: Advertising data
+*
+* Return:
+*   bool: true if the advertiser lists the Current Time Service
+*
+*******************************************************************************/
+static bool scan_adv_has_cts_uuid(uint8_t *p_adv_data)
+{
+    static const uint8_t uuid_types[] = { BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE,
+                                          BTM_BLE_ADVERT_TYPE_16SRV_PARTIAL };
+    uint8_t *p_uuids;
+    uint8_t len = 0;
+    uint32_t type;
+    uint32_t offset;
+
+    for (type = 0; type < sizeof(uuid_types); type++)
+    {
+        p_uuids = wiced_bt_ble_check_advertising_data(p_adv_data,
+                                                      uuid_types[type], &len);
+        for (offset = 0; (NULL != p_uuids) && (offset + 1u < len); offset += 2u)
+        {
+            if (UUID_SERVICE_CURRENT_TIME ==
+                (uint16_t)(p_uuids[offset] | (p_uuids[offset + 1u] << 8)))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* [] END OF FILE */
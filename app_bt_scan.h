@@ -0,0 +1,121 @@
+/******************************************************************************
+* File Name: app_bt_scan.h
+*
+* Description: This file contains macros, structures and function prototypes
+*              used by app_bt_scan.c, which implements the central role
+*              scanner that finds and connects to CTS servers.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BT_SCAN_H__
+#define __APP_BT_SCAN_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+#include "wiced_bt_cfg.h"
+#include <FreeRTOS.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Scan profile used when scanning starts. See scan_profile_t */
+#ifndef SCAN_PROFILE
+#define SCAN_PROFILE                    (SCAN_PROFILE_BALANCED)
+#endif
+
+/* Scan intervals and windows are in units of 0.625 ms, durations in seconds */
+#define SCAN_SLOTS(ms)                  ((uint16_t)(((ms) * 8u) / 5u))
+
+/*******************************************************************************
+*        Enumerations
+*******************************************************************************/
+/* Scan window and interval profiles */
+typedef enum
+{
+    SCAN_PROFILE_FAST,          /* 100% duty cycle, lowest latency */
+    SCAN_PROFILE_BALANCED,      /* 50% duty cycle, then 10% */
+    SCAN_PROFILE_LOW_POWER,     /* 10% duty cycle, then 2.5% */
+    SCAN_PROFILE_COUNT
+} scan_profile_t;
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+typedef struct
+{
+    const char *name;
+    uint16_t    high_duty_scan_interval;
+    uint16_t    high_duty_scan_window;
+    uint16_t    high_duty_scan_duration;
+    uint16_t    low_duty_scan_interval;
+    uint16_t    low_duty_scan_window;
+    uint16_t    low_duty_scan_duration;
+} scan_profile_params_t;
+
+/* Statistics of the current/last scan and the server it connects to. The
+ * scan callback updates them in the stack thread, the application task
+ * takes a copy under a critical section */
+typedef struct
+{
+    TickType_t scan_start_tick;
+    TickType_t match_tick;
+    uint32_t   adv_reports;
+    uint32_t   cts_matches;
+    uint64_t   callback_time_us;
+    bool       connect_pending;
+    wiced_bt_device_address_t pending_addr;
+} scan_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+const wiced_bt_cfg_settings_t *app_bt_scan_cfg_init(const wiced_bt_cfg_settings_t *p_cfg);
+void app_bt_scan_set_profile(scan_profile_t profile);
+
+wiced_result_t app_bt_scan_start(void);
+void app_bt_scan_stop(void);
+
+void app_bt_scan_state_changed(wiced_bt_ble_scan_type_t state);
+void app_bt_scan_connection_up(const uint8_t *bd_addr);
+void app_bt_scan_connection_down(const uint8_t *bd_addr);
+bool app_bt_scan_connecting(void);
+
+#endif      /* __APP_BT_SCAN_H__ */
+
+/* [] END OF FILE */
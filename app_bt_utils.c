@@ -45,6 +45,8 @@
 #include "app_bt_utils.h"
 #include "wiced_bt_dev.h"
 #include "wiced_bt_gatt.h"
+#include <FreeRTOS.h>
+#include <task.h>
 
 /****************************************************************************
  *                              FUNCTION DEFINITIONS
@@ -196,6 +198,34 @@ const char *get_bt_advert_mode_name(wiced_bt_ble_advert_mode_t mode)
     return "UNKNOWN_MODE";
 }
 
+/*******************************************************************************
+* Function Name: get_bt_phy_name
+********************************************************************************
+* Summary:
+* The function converts a PHY value of the PHY update event to a short name.
+*
+* Parameters:
+*  uint8_t phy: APP_BT_PHY_1M, APP_BT_PHY_2M or APP_BT_PHY_CODED
+*
+* Return:
+*  const char *: PHY name
+*
+*******************************************************************************/
+const char *get_bt_phy_name(uint8_t phy)
+{
+    switch (phy)
+    {
+        case APP_BT_PHY_1M:
+            return "1M";
+        case APP_BT_PHY_2M:
+            return "2M";
+        case APP_BT_PHY_CODED:
+            return "Coded";
+        default:
+            return "UNKNOWN_PHY";
+    }
+}
+
 /*******************************************************************************
 * Function Name: get_bt_gatt_disconn_reason_name
 ********************************************************************************
@@ -347,4 +377,133 @@ const char *get_bt_smp_status_name(wiced_bt_smp_status_t status)
 
     return "UNKNOWN_STATUS";
 }
+
+/*******************************************************************************
+* Function Name: calc_crc16_ccitt
+********************************************************************************
+* Summary:
+* The function calculates the CRC-16/CCITT-FALSE (polynomial 0x1021, initial
+* value 0xFFFF) of a buffer. It is used to validate data kept in memory or
+* sent over the debug UART.
+*
+* Parameters:
+*  const uint8_t *p_data: Data to protect
+*  uint32_t len: Number of bytes
+*
+* Return:
+*  uint16_t: CRC of the data
+*
+*******************************************************************************/
+uint16_t calc_crc16_ccitt(const uint8_t *p_data, uint32_t len)
+{
+    uint16_t crc = 0xFFFF;
+    uint32_t index;
+    uint8_t bit;
+
+    for (index = 0; index < len; index++)
+    {
+        crc ^= (uint16_t)p_data[index] << 8;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/*******************************************************************************
+* Function Name: cycle_counter_init
+********************************************************************************
+* Summary:
+* The function enables the free running CPU cycle counter (DWT CYCCNT) used to
+* time short code paths. Use CYCLES_TO_US() to convert the difference of two
+* cycle_counter_get() values. The counter wraps, so it is only suited for
+* intervals shorter than 2^32 CPU cycles.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void cycle_counter_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*******************************************************************************
+* Function Name: cycle_counter_get
+********************************************************************************
+* Summary:
+* The function returns the current value of the CPU cycle counter.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint32_t: CPU cycles since cycle_counter_init()
+*
+*******************************************************************************/
+uint32_t cycle_counter_get(void)
+{
+    return DWT->CYCCNT;
+}
+
+/*******************************************************************************
+* Function Name: local_time_us
+********************************************************************************
+* Summary:
+* The function returns the local monotonic time in microseconds. The RTOS tick
+* count, extended to 64 bits, gives the milliseconds and the SysTick down
+* counter the time within the current tick. Unlike the cycle counter this
+* keeps counting across tickless idle, where the tick count is corrected on
+* wake-up. If SysTick does not drive the RTOS tick, the resolution falls back
+* to one tick.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint64_t: Microseconds since the scheduler started
+*
+*******************************************************************************/
+uint64_t local_time_us(void)
+{
+    static uint32_t last_tick = 0;
+    static uint64_t tick_high = 0;
+    uint32_t tick;
+    uint32_t reload;
+    uint32_t count;
+    uint32_t sub_tick_us = 0;
+    uint64_t result;
+
+    taskENTER_CRITICAL();
+    tick = (uint32_t)xTaskGetTickCount();
+    count = SysTick->VAL;
+    reload = SysTick->LOAD;
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+    {
+        /* SysTick wrapped but the tick interrupt has not run yet */
+        tick++;
+        count = SysTick->VAL;
+    }
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) && (0u != reload))
+    {
+        sub_tick_us = (uint32_t)(((uint64_t)(reload - count) *
+                                  (1000000u / configTICK_RATE_HZ)) / (reload + 1u));
+    }
+
+    if (tick < last_tick)
+    {
+        tick_high += (1ull << 32);
+    }
+    last_tick = tick;
+    result = ((tick_high | tick) * (1000000u / configTICK_RATE_HZ)) + sub_tick_us;
+    taskEXIT_CRITICAL();
+
+    return result;
+}
 /* [] END OF FILE */
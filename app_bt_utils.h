@@ -47,6 +47,7 @@
  ******************************************************************************/
 #include "wiced_bt_dev.h"
 #include "wiced_bt_gatt.h"
+#include "cybsp.h"
 #include <stdio.h>
 
 /******************************************************************************
@@ -56,6 +57,14 @@
 
 #define FROM_BIT16_TO_8(val)            ((uint8_t)(((val) >> 8 )& 0xff))
 
+/* PHY values of BTM_BLE_PHY_UPDATE_EVT, as defined by HCI */
+#define APP_BT_PHY_1M                   (1u)
+#define APP_BT_PHY_2M                   (2u)
+#define APP_BT_PHY_CODED                (3u)
+
+/* Converts a difference of cycle_counter_get() values to microseconds */
+#define CYCLES_TO_US(cycles)            ((uint32_t)(((uint64_t)(cycles) * 1000000u) / SystemCoreClock))
+
 /****************************************************************************
  *                              FUNCTION DECLARATIONS
  ***************************************************************************/
@@ -73,4 +82,14 @@ const char *get_bt_gatt_status_name(wiced_bt_gatt_status_t gatt_status);
 
 const char *get_bt_smp_status_name(wiced_bt_smp_status_t status);
 
+const char *get_bt_phy_name(uint8_t phy);
+
+uint16_t calc_crc16_ccitt(const uint8_t *p_data, uint32_t len);
+
+void cycle_counter_init(void);
+
+uint32_t cycle_counter_get(void);
+
+uint64_t local_time_us(void);
+
 #endif      /*__APP_BT_UTILS_H__ */
@@ -0,0 +1,395 @@
+/******************************************************************************
+* File Name: app_cmd.c
+*
+* Description: This file implements a line based command interface on the
+*              debug UART, for scripted control of the client. Received
+*              characters are queued by the UART interrupt and parsed by a
+*              low priority task. Commands that use the CTS state are
+*              posted to the application task, so the Bluetooth stack
+*              thread never waits for them.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_cmd.h"
+#include "app_uart_tx.h"
+#include "app_metrics.h"
+#include "cts_client.h"
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <stdio.h>
+#include <string.h>
+
+#if (ENABLE_UART_COMMANDS)
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Commands handled by the command task itself, after the app_cmd_t ones */
+#define CMD_HELP                        (APP_CMD_COUNT)
+#define CMD_METRICS                     (APP_CMD_COUNT + 1u)
+#define CMD_METRICS_RESET               (APP_CMD_COUNT + 2u)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+typedef struct
+{
+    const char *name;
+    uint8_t     cmd;                /* app_cmd_t or CMD_ */
+    const char *help;
+} cmd_entry_t;
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static const cmd_entry_t cmd_table[] =
+{
+#if (ENABLE_CENTRAL_MODE)
+    { "adv start", APP_CMD_ADV_START,   "start scanning for servers" },
+    { "adv stop",  APP_CMD_ADV_STOP,    "stop scanning" },
+#else
+    { "adv start", APP_CMD_ADV_START,   "start advertising" },
+    { "adv stop",  APP_CMD_ADV_STOP,    "stop advertising" },
+#endif
+    { "sub",       APP_CMD_SUBSCRIBE,   "enable notifications on all servers" },
+    { "unsub",     APP_CMD_UNSUBSCRIBE, "disable notifications on all servers" },
+    { "read",      APP_CMD_READ_TIME,   "read the Current Time of all servers" },
+    { "metrics",   CMD_METRICS,         "print the metrics" },
+    { "reset",     CMD_METRICS_RESET,   "reset the metrics counters" },
+    { "help",      CMD_HELP,            "list the commands" },
+};
+
+/* Characters from the receive interrupt to the command task */
+static QueueHandle_t cmd_rx_queue;
+static StaticQueue_t cmd_rx_queue_buf;
+static uint8_t cmd_rx_queue_storage[APP_CMD_RX_QUEUE_LEN];
+
+/* Characters lost on a full queue, written by the receive interrupt */
+static volatile uint32_t cmd_rx_dropped;
+
+/* Stack and control block of the command task */
+static StackType_t  cmd_task_stack[APP_CMD_TASK_STACK_SIZE];
+static StaticTask_t cmd_task_tcb;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void cmd_task(void *pvParameters);
+static void cmd_execute(const char *p_line);
+static const char *cmd_name(uint8_t cmd);
+#if !(ENABLE_UART_TX_ASYNC)
+static void cmd_uart_event_callback(void *callback_arg, cyhal_uart_event_t event);
+#endif
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: app_cmd_init()
+********************************************************************************
+* Summary:
+*   Creates the command task and its receive queue and enables the receive
+*   interrupt of the retarget-io UART. With ENABLE_UART_TX_ASYNC the transmit
+*   event handler of app_uart_tx.c forwards receive events, as the HAL has
+*   one event handler per UART.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_cmd_init(void)
+{
+    cmd_rx_queue = xQueueCreateStatic(APP_CMD_RX_QUEUE_LEN, sizeof(uint8_t),
+                                      cmd_rx_queue_storage, &cmd_rx_queue_buf);
+    if ((NULL == cmd_rx_queue) ||
+        (NULL == xTaskCreateStatic(cmd_task, "app_cmd", APP_CMD_TASK_STACK_SIZE, NULL,
+                                   APP_CMD_TASK_PRIORITY, cmd_task_stack,
+                                   &cmd_task_tcb)))
+    {
+        printf("Failed to create the command task\n");
+        return;
+    }
+#if !(ENABLE_UART_TX_ASYNC)
+    cyhal_uart_register_callback(&cy_retarget_io_uart_obj, cmd_uart_event_callback, NULL);
+#endif
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_RX_NOT_EMPTY,
+                            APP_CMD_INTR_PRIORITY, true);
+}
+
+/*******************************************************************************
+* Function Name: app_cmd_rx_isr()
+********************************************************************************
+* Summary:
+*   Moves the received characters to the command task. Characters that do not
+*   fit in the queue are dropped, the interrupt never waits.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_cmd_rx_isr(void)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    uint8_t rx_char;
+
+    while ((0u != cyhal_uart_readable(&cy_retarget_io_uart_obj)) &&
+           (CY_RSLT_SUCCESS == cyhal_uart_getc(&cy_retarget_io_uart_obj, &rx_char, 0)))
+    {
+        if (pdTRUE != xQueueSendFromISR(cmd_rx_queue, &rx_char,
+                                        &higher_priority_task_woken))
+        {
+            cmd_rx_dropped++;
+        }
+    }
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/*******************************************************************************
+* Function Name: app_cmd_reply()
+********************************************************************************
+* Summary:
+*   Prints the result of a command as "CMD <name> OK" or "CMD <name> FAILED",
+*   for scripts waiting on the command.
+*
+* Parameters:
+*   app_cmd_t cmd: Command that ran
+*   bool ok: true if the command was carried out
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_cmd_reply(app_cmd_t cmd, bool ok)
+{
+    printf("CMD %s %s\n", cmd_name((uint8_t)cmd), ok ? "OK" : "FAILED");
+}
+
+/*******************************************************************************
+* Function Name: cmd_task()
+********************************************************************************
+* Summary:
+*   Collects received characters into a line and runs the line on a carriage
+*   return or line feed. Too long lines are discarded.
+*
+* Parameters:
+*   void *pvParameters: Not used
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void cmd_task(void *pvParameters)
+{
+    char line[APP_CMD_LINE_LEN + 1u];
+    uint32_t len = 0;
+    bool overflow = false;
+    uint8_t rx_char;
+
+    for (;;)
+    {
+        if (pdTRUE != xQueueReceive(cmd_rx_queue, &rx_char, portMAX_DELAY))
+        {
+            continue;
+        }
+        if (('\r' == rx_char) || ('\n' == rx_char))
+        {
+            if (overflow)
+            {
+                printf("CMD line too long\n");
+            }
+            else if (0u != len)
+            {
+                /* Trailing blanks are ignored */
+                while ((0u != len) && (' ' == line[len - 1u]))
+                {
+                    len--;
+                }
+                line[len] = '\0';
+                cmd_execute(line);
+            }
+            len = 0;
+            overflow = false;
+        }
+        else if (len < APP_CMD_LINE_LEN)
+        {
+            line[len++] = (char)rx_char;
+        }
+        else
+        {
+            overflow = true;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: cmd_execute()
+********************************************************************************
+* Summary:
+*   Runs a command line. The metrics commands run in the command task, as a
+*   snapshot takes no lock. The other commands are posted to the application
+*   task without waiting, a full queue is reported as busy.
+*
+* Parameters:
+*   const char *p_line: Command line without the line end
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void cmd_execute(const char *p_line)
+{
+    app_event_t app_event;
+    uint32_t index;
+
+    for (index = 0; index < (sizeof(cmd_table) / sizeof(cmd_table[0])); index++)
+    {
+        if (0 == strcmp(p_line, cmd_table[index].name))
+        {
+            break;
+        }
+    }
+    if (index == (sizeof(cmd_table) / sizeof(cmd_table[0])))
+    {
+        printf("CMD unknown '%s', try help\n", p_line);
+        return;
+    }
+
+    switch (cmd_table[index].cmd)
+    {
+        case CMD_HELP:
+            for (index = 0; index < (sizeof(cmd_table) / sizeof(cmd_table[0])); index++)
+            {
+                printf("  %-10s %s\n", cmd_table[index].name, cmd_table[index].help);
+            }
+            break;
+
+        case CMD_METRICS:
+#if (ENABLE_METRICS)
+            app_metrics_print();
+#endif
+            printf("CMD metrics %s\n", (ENABLE_METRICS) ? "OK" : "FAILED");
+            break;
+
+        case CMD_METRICS_RESET:
+#if (ENABLE_METRICS)
+            app_metrics_reset();
+#endif
+            printf("CMD reset %s\n", (ENABLE_METRICS) ? "OK" : "FAILED");
+            break;
+
+        default:
+            memset(&app_event, 0, sizeof(app_event));
+            app_event.type = APP_EVENT_COMMAND;
+            app_event.op = cmd_table[index].cmd;
+            if (pdTRUE != xQueueSend(app_event_queue, &app_event, 0))
+            {
+                printf("CMD %s BUSY\n", cmd_table[index].name);
+            }
+            break;
+    }
+    if (0u != cmd_rx_dropped)
+    {
+        printf("CMD %lu characters dropped\n", (unsigned long)cmd_rx_dropped);
+        cmd_rx_dropped = 0;
+    }
+}
+
+/*******************************************************************************
+* Function Name: cmd_name()
+********************************************************************************
+* Summary:
+*   Looks up the name of a command.
+*
+* Parameters:
+*   uint8_t cmd: app_cmd_t or CMD_ value
+*
+* Return:
+*   const char *: Command name
+*
+*******************************************************************************/
+static const char *cmd_name(uint8_t cmd)
+{
+    uint32_t index;
+
+    for (index = 0; index < (sizeof(cmd_table) / sizeof(cmd_table[0])); index++)
+    {
+        if (cmd == cmd_table[index].cmd)
+        {
+            return cmd_table[index].name;
+        }
+    }
+    return "?";
+}
+
+#if !(ENABLE_UART_TX_ASYNC)
+/*******************************************************************************
+* Function Name: cmd_uart_event_callback()
+********************************************************************************
+* Summary:
+*   UART event handler when app_uart_tx.c does not register one.
+*
+* Parameters:
+*   void *callback_arg: Not used
+*   cyhal_uart_event_t event: UART events
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void cmd_uart_event_callback(void *callback_arg, cyhal_uart_event_t event)
+{
+    if (0 != (event & CYHAL_UART_IRQ_RX_NOT_EMPTY))
+    {
+        app_cmd_rx_isr();
+    }
+}
+#endif
+
+#endif /* ENABLE_UART_COMMANDS */
+
+/* [] END OF FILE */
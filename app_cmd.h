@@ -0,0 +1,103 @@
+/******************************************************************************
+* File Name: app_cmd.h
+*
+* Description: This file contains macros, enumerations and function prototypes
+*              used in app_cmd.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_CMD_H__
+#define __APP_CMD_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 0 to ignore input on the debug UART */
+#ifndef ENABLE_UART_COMMANDS
+#define ENABLE_UART_COMMANDS            (1u)
+#endif
+
+/* The command task runs just above the idle task, below the application
+ * task and the Bluetooth stack */
+#define APP_CMD_TASK_PRIORITY           (tskIDLE_PRIORITY + 1)
+#define APP_CMD_TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 4)
+
+/* Received characters buffered for the command task, and the longest
+ * command line */
+#ifndef APP_CMD_RX_QUEUE_LEN
+#define APP_CMD_RX_QUEUE_LEN            (64u)
+#endif
+#define APP_CMD_LINE_LEN                (32u)
+
+/* Interrupt priority of the receive interrupt */
+#define APP_CMD_INTR_PRIORITY           (7u)
+
+/*******************************************************************************
+*        Enumerations
+*******************************************************************************/
+/* Commands run by the application task, in the op of APP_EVENT_COMMAND */
+typedef enum
+{
+    APP_CMD_ADV_START,
+    APP_CMD_ADV_STOP,
+    APP_CMD_SUBSCRIBE,
+    APP_CMD_UNSUBSCRIBE,
+    APP_CMD_READ_TIME,
+    APP_CMD_COUNT,
+} app_cmd_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/* Creates the command task and enables the receive interrupt. Must be called
+ * after app_uart_tx_init() and after the application task queue exists */
+void app_cmd_init(void);
+
+/* Called by the UART event handler when data was received */
+void app_cmd_rx_isr(void);
+
+/* Prints the result of a command run by the application task */
+void app_cmd_reply(app_cmd_t cmd, bool ok);
+
+#endif      /* __APP_CMD_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,970 @@
+/******************************************************************************
+* File Name: app_cts_server.c
+*
+* Description: This file serves the fused time as a Current Time Service, so
+*              that a synchronized client relays the time to its own peers.
+*              Notifications are encoded once and the same buffer is passed
+*              to the stack for every subscribed peer.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_cts_server.h"
+
+#if (ENABLE_CTS_SERVER)
+#include "app_bt_utils.h"
+#include "cts_calendar.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Handles of the database */
+enum
+{
+    CTS_SERVER_HDLS_GAP = 0x0001,
+    CTS_SERVER_HDLC_DEVICE_NAME,
+    CTS_SERVER_HDLC_DEVICE_NAME_VALUE,
+    CTS_SERVER_HDLC_APPEARANCE,
+    CTS_SERVER_HDLC_APPEARANCE_VALUE,
+    CTS_SERVER_HDLS_CTS,
+    CTS_SERVER_HDLC_CURRENT_TIME,
+    CTS_SERVER_HDLC_CURRENT_TIME_VALUE,
+    CTS_SERVER_HDLD_CURRENT_TIME_CCCD,
+};
+
+/* Device name and appearance (Generic Clock), as in design.cybt */
+#define CTS_SERVER_DEVICE_NAME          "CTS Client"
+#define CTS_SERVER_APPEARANCE           (0x0100u)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* A peer connected to the server, with its CCCD value */
+typedef struct
+{
+    uint16_t conn_id;               /* 0 for a free entry */
+    uint8_t  cccd[2];
+} cts_server_peer_t;
+
+/* Value passed to the stack. in_flight counts the sends the stack has not
+ * reported with GATT_APP_BUFFER_TRANSMITTED_EVT yet, plus one while the
+ * application task fills or sends it */
+typedef struct
+{
+    uint8_t           value[CTS_SERVER_BUFFER_LEN];
+    volatile uint32_t in_flight;
+} cts_server_buffer_t;
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* GAP and Current Time Service. The generated database of design.cybt has
+ * GAP only, this one replaces it */
+static const uint8_t cts_server_db[] =
+{
+    PRIMARY_SERVICE_UUID16(CTS_SERVER_HDLS_GAP, UUID_SERVICE_GAP),
+        CHARACTERISTIC_UUID16(CTS_SERVER_HDLC_DEVICE_NAME,
+                              CTS_SERVER_HDLC_DEVICE_NAME_VALUE,
+                              UUID_CHARACTERISTIC_DEVICE_NAME,
+                              GATTDB_CHAR_PROP_READ, GATTDB_PERM_READABLE),
+        CHARACTERISTIC_UUID16(CTS_SERVER_HDLC_APPEARANCE,
+                              CTS_SERVER_HDLC_APPEARANCE_VALUE,
+                              UUID_CHARACTERISTIC_APPEARANCE,
+                              GATTDB_CHAR_PROP_READ, GATTDB_PERM_READABLE),
+
+    PRIMARY_SERVICE_UUID16(CTS_SERVER_HDLS_CTS, UUID_SERVICE_CURRENT_TIME),
+        CHARACTERISTIC_UUID16(CTS_SERVER_HDLC_CURRENT_TIME,
+                              CTS_SERVER_HDLC_CURRENT_TIME_VALUE,
+                              UUID_CHARACTERISTIC_CURRENT_TIME,
+                              GATTDB_CHAR_PROP_READ | GATTDB_CHAR_PROP_NOTIFY,
+                              GATTDB_PERM_READABLE),
+            CHAR_DESCRIPTOR_UUID16_WRITABLE(CTS_SERVER_HDLD_CURRENT_TIME_CCCD,
+                                            UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
+                                            GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_REQ),
+};
+
+static const uint8_t cts_server_device_name[] = CTS_SERVER_DEVICE_NAME;
+static const uint8_t cts_server_appearance[] =
+{
+    (uint8_t)CTS_SERVER_APPEARANCE, (uint8_t)(CTS_SERVER_APPEARANCE >> 8u)
+};
+static const uint8_t cts_server_cccd_off[2] = { 0 };
+
+static cts_server_peer_t   cts_server_peers[CTS_SERVER_MAX_PEERS];
+static cts_server_buffer_t cts_server_buffers[CTS_SERVER_BUFFERS];
+static cts_server_stats_t  cts_server_stats;
+
+/* Notifies on the fused time every CTS_SERVER_NOTIFY_PERIOD_MS */
+static cts_alarm_t         cts_server_alarm;
+
+/* Fused offset when the subscribed peers were last notified */
+static bool                cts_server_served;
+static int64_t             cts_server_served_offset_ms;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void cts_server_alarm_callback(cts_alarm_t *p_alarm);
+static void cts_server_notify(uint8_t adjust_reason);
+static bool cts_server_encode_time(uint8_t adjust_reason, uint8_t *p_value);
+static wiced_bt_gatt_status_t cts_server_get_value(uint16_t conn_id, uint16_t handle,
+                                                   uint8_t *p_scratch,
+                                                   const uint8_t **pp_value,
+                                                   uint16_t *p_len);
+static void cts_server_read(const app_event_t *p_event);
+static void cts_server_read_by_type(const app_event_t *p_event);
+static void cts_server_write(const app_event_t *p_event);
+static cts_server_peer_t *cts_server_find_peer(uint16_t conn_id, bool create);
+static cts_server_buffer_t *cts_server_buffer_claim(void);
+static void cts_server_buffer_release(cts_server_buffer_t *p_buffer);
+
+/*******************************************************************************
+* Function Name: app_cts_server_init()
+********************************************************************************
+* Summary:
+*   Registers the database with the Current Time Service. Notifications
+*   start once the fused time is valid.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   wiced_bt_gatt_status_t: Status of wiced_bt_gatt_db_init()
+*
+*******************************************************************************/
+wiced_bt_gatt_status_t app_cts_server_init(void)
+{
+    memset(cts_server_peers, 0, sizeof(cts_server_peers));
+    memset(cts_server_buffers, 0, sizeof(cts_server_buffers));
+    memset(&cts_server_stats, 0, sizeof(cts_server_stats));
+    cts_server_served = false;
+    cts_alarm_setup(&cts_server_alarm, cts_server_alarm_callback, NULL);
+
+    return wiced_bt_gatt_db_init(cts_server_db, (uint16_t)sizeof(cts_server_db), NULL);
+}
+
+/*******************************************************************************
+* Function Name: app_cts_server_copy_request()
+********************************************************************************
+* Summary:
+*   Copies an attribute request into an event for the application task,
+*   which owns the fused time and answers the request.
+*
+* Parameters:
+*   const wiced_bt_gatt_attribute_request_t *p_request: Request of the stack
+*   app_event_t *p_event: Event to fill
+*
+* Return:
+*   bool: false if the request needs no answer
+*
+*******************************************************************************/
+bool app_cts_server_copy_request(const wiced_bt_gatt_attribute_request_t *p_request,
+                                 app_event_t *p_event)
+{
+    p_event->type = APP_EVENT_ATTRIBUTE_REQUEST;
+    p_event->conn_id = p_request->conn_id;
+    p_event->op = (uint8_t)p_request->opcode;
+
+    switch (p_request->opcode)
+    {
+        case GATT_REQ_READ:
+        case GATT_REQ_READ_BLOB:
+            p_event->data.request.handle = p_request->data.read_req.handle;
+            p_event->data.request.offset = p_request->data.read_req.offset;
+            break;
+
+        case GATT_REQ_READ_BY_TYPE:
+            p_event->data.request.handle = p_request->data.read_by_type.s_handle;
+            p_event->data.request.end_handle = p_request->data.read_by_type.e_handle;
+            p_event->data.request.uuid16 =
+                (LEN_UUID_16 == p_request->data.read_by_type.uuid.len) ?
+                p_request->data.read_by_type.uuid.uu.uuid16 : 0u;
+            p_event->data.request.len = p_request->len_requested;
+            break;
+
+        case GATT_REQ_WRITE:
+        case GATT_CMD_WRITE:
+            /* The full length is kept so that longer values are rejected */
+            p_event->data.request.handle = p_request->data.write_req.handle;
+            p_event->data.request.offset = p_request->data.write_req.offset;
+            p_event->data.request.len = p_request->data.write_req.val_len;
+            memcpy(p_event->data.request.value, p_request->data.write_req.p_val,
+                   (p_request->data.write_req.val_len < APP_EVENT_VALUE_LEN) ?
+                   p_request->data.write_req.val_len : APP_EVENT_VALUE_LEN);
+            break;
+
+        case GATT_REQ_MTU:
+            p_event->data.request.len = p_request->data.remote_mtu;
+            break;
+
+        default:
+            /* Confirmations, the server sends no indications */
+            return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: app_cts_server_buffer_transmitted()
+********************************************************************************
+* Summary:
+*   Releases a buffer once the stack has sent it to one peer. Called from
+*   the GATT callback for every GATT_APP_BUFFER_TRANSMITTED_EVT.
+*
+* Parameters:
+*   void *p_app_ctxt: Context passed with the buffer, NULL for other users
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_cts_server_buffer_transmitted(void *p_app_ctxt)
+{
+    uint32_t index;
+
+    for (index = 0; index < CTS_SERVER_BUFFERS; index++)
+    {
+        if (p_app_ctxt == &cts_server_buffers[index])
+        {
+            cts_server_buffer_release(&cts_server_buffers[index]);
+            break;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_cts_server_request()
+********************************************************************************
+* Summary:
+*   Answers an attribute request copied by app_cts_server_copy_request().
+*
+* Parameters:
+*   const app_event_t *p_event: Attribute request event
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_cts_server_request(const app_event_t *p_event)
+{
+    switch (p_event->op)
+    {
+        case GATT_REQ_READ:
+        case GATT_REQ_READ_BLOB:
+            cts_server_read(p_event);
+            break;
+
+        case GATT_REQ_READ_BY_TYPE:
+            cts_server_read_by_type(p_event);
+            break;
+
+        case GATT_REQ_WRITE:
+        case GATT_CMD_WRITE:
+            cts_server_write(p_event);
+            break;
+
+        case GATT_REQ_MTU:
+            (void)wiced_bt_gatt_server_send_mtu_rsp(p_event->conn_id,
+                                                    p_event->data.request.len,
+                                                    CTS_SERVER_MTU);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_cts_server_time_updated()
+********************************************************************************
+* Summary:
+*   Called after a sample was added to the fusion. Starts the periodic
+*   notifications with the first fused time, and notifies the subscribed
+*   peers at once when the fused time stepped.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_cts_server_time_updated(void)
+{
+    cts_fusion_result_t result;
+    uint64_t epoch_ms;
+    uint64_t next_ms;
+
+    if (!cts_fusion_get_result(&result))
+    {
+        return;
+    }
+
+    if (!cts_server_alarm.started &&
+        cts_fusion_get_time_ms(cts_fusion_local_ms(), &epoch_ms))
+    {
+        /* Notify on the period boundaries of the fused time, the start of
+         * every minute by default */
+        next_ms = ((epoch_ms / CTS_SERVER_NOTIFY_PERIOD_MS) + 1u) *
+                  CTS_SERVER_NOTIFY_PERIOD_MS;
+        (void)cts_alarm_start_at(&cts_server_alarm, next_ms,
+                                 CTS_SERVER_NOTIFY_PERIOD_MS);
+    }
+
+    /* The first fused time is a reference update for the peers as well */
+    if (!cts_server_served ||
+        (llabs(result.offset_ms - cts_server_served_offset_ms) > CTS_SERVER_STEP_MS))
+    {
+        cts_server_stats.steps++;
+        cts_server_notify(EXTERNAL_REFERENCE_TIME_UPDATE);
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_cts_server_connected()
+********************************************************************************
+* Summary:
+*   Takes a peer entry for a link that connected to the server. Only these
+*   peers can subscribe.
+*
+* Parameters:
+*   uint16_t conn_id: Connection ID of the peer
+*
+* Return:
+*   bool: false if all CTS_SERVER_MAX_PEERS entries are taken
+*
+*******************************************************************************/
+bool app_cts_server_connected(uint16_t conn_id)
+{
+    return (NULL != cts_server_find_peer(conn_id, true));
+}
+
+/*******************************************************************************
+* Function Name: app_cts_server_disconnected()
+********************************************************************************
+* Summary:
+*   Forgets a disconnected peer and its subscription.
+*
+* Parameters:
+*   uint16_t conn_id: Connection ID of the peer
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_cts_server_disconnected(uint16_t conn_id)
+{
+    cts_server_peer_t *p_peer = cts_server_find_peer(conn_id, false);
+
+    if (NULL != p_peer)
+    {
+        memset(p_peer, 0, sizeof(*p_peer));
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_cts_server_peer_count()
+********************************************************************************
+* Summary:
+*   Returns the number of peers connected to the server.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   uint32_t: Connected peers
+*
+*******************************************************************************/
+uint32_t app_cts_server_peer_count(void)
+{
+    uint32_t index;
+    uint32_t count = 0;
+
+    for (index = 0; index < CTS_SERVER_MAX_PEERS; index++)
+    {
+        if (0 != cts_server_peers[index].conn_id)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: app_cts_server_print_stats()
+********************************************************************************
+* Summary:
+*   Prints the notification and read counts of the server.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_cts_server_print_stats(void)
+{
+    printf("CTS server: %lu values notified as %lu notifications (%lu steps), "
+           "%lu failed, %lu without buffer, %lu reads, %lu subscriptions\n",
+           (unsigned long)cts_server_stats.notify_rounds,
+           (unsigned long)cts_server_stats.notifications,
+           (unsigned long)cts_server_stats.steps,
+           (unsigned long)cts_server_stats.notify_failed,
+           (unsigned long)cts_server_stats.no_buffer,
+           (unsigned long)cts_server_stats.reads,
+           (unsigned long)cts_server_stats.subscriptions);
+}
+
+/*******************************************************************************
+* Function Name: cts_server_alarm_callback()
+********************************************************************************
+* Summary:
+*   Notifies the subscribed peers on every period of the fused time.
+*
+* Parameters:
+*   cts_alarm_t *p_alarm: Notification alarm
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void cts_server_alarm_callback(cts_alarm_t *p_alarm)
+{
+    (void)p_alarm;
+    cts_server_notify(0u);
+}
+
+/*******************************************************************************
+* Function Name: cts_server_notify()
+********************************************************************************
+* Summary:
+*   Encodes the fused time once and sends the same buffer to every peer that
+*   enabled notifications. The stack keeps a reference to the buffer per
+*   peer and reports each with GATT_APP_BUFFER_TRANSMITTED_EVT.
+*
+* Parameters:
+*   uint8_t adjust_reason: Adjust Reason field of the value
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void cts_server_notify(uint8_t adjust_reason)
+{
+    cts_server_buffer_t *p_buffer;
+    cts_fusion_result_t result;
+    wiced_bt_gatt_status_t gatt_status;
+    uint32_t index;
+
+    if (!cts_fusion_get_result(&result))
+    {
+        return;
+    }
+    cts_server_served = true;
+    cts_server_served_offset_ms = result.offset_ms;
+
+    p_buffer = cts_server_buffer_claim();
+    if (NULL == p_buffer)
+    {
+        /* Slow peers still hold both buffers */
+        cts_server_stats.no_buffer++;
+        return;
+    }
+    (void)cts_server_encode_time(adjust_reason, p_buffer->value);
+    cts_server_stats.notify_rounds++;
+
+    for (index = 0; index < CTS_SERVER_MAX_PEERS; index++)
+    {
+        if ((0 == cts_server_peers[index].conn_id) ||
+            (0 == (cts_server_peers[index].cccd[0] & GATT_CLIENT_CONFIG_NOTIFICATION)))
+        {
+            continue;
+        }
+
+        /* Counted before the send, the stack may report the transmission
+         * before the call returns */
+        taskENTER_CRITICAL();
+        p_buffer->in_flight++;
+        taskEXIT_CRITICAL();
+        gatt_status = wiced_bt_gatt_server_send_notification(cts_server_peers[index].conn_id,
+                                                             CTS_SERVER_HDLC_CURRENT_TIME_VALUE,
+                                                             CTS_CURRENT_TIME_LEN,
+                                                             p_buffer->value, p_buffer);
+        if (WICED_BT_GATT_SUCCESS == gatt_status)
+        {
+            cts_server_stats.notifications++;
+        }
+        else
+        {
+            cts_server_buffer_release(p_buffer);
+            cts_server_stats.notify_failed++;
+        }
+    }
+    cts_server_buffer_release(p_buffer);
+}
+
+/*******************************************************************************
+* Function Name: cts_server_encode_time()
+********************************************************************************
+* Summary:
+*   Writes the fused time as a Current Time value. Without a fused time the
+*   date and time fields are 0 (unknown).
+*
+* Parameters:
+*   uint8_t adjust_reason: Adjust Reason field of the value
+*   uint8_t *p_value: Buffer of CTS_CURRENT_TIME_LEN bytes
+*
+* Return:
+*   bool: true if a fused time was available
+*
+*******************************************************************************/
+static bool cts_server_encode_time(uint8_t adjust_reason, uint8_t *p_value)
+{
+    uint64_t epoch_ms;
+    uint32_t ms_of_day;
+    int32_t days;
+    int32_t year;
+    uint32_t month;
+    uint32_t day;
+
+    memset(p_value, 0, CTS_CURRENT_TIME_LEN);
+    if (!cts_fusion_get_time_ms(cts_fusion_local_ms(), &epoch_ms))
+    {
+        return false;
+    }
+
+    days = (int32_t)(epoch_ms / CTS_ALARM_MS_PER_DAY);
+    ms_of_day = (uint32_t)(epoch_ms % CTS_ALARM_MS_PER_DAY);
+    cts_civil_from_days(days, &year, &month, &day);
+
+    p_value[0] = (uint8_t)year;
+    p_value[1] = (uint8_t)((uint32_t)year >> 8u);
+    p_value[2] = (uint8_t)month;
+    p_value[3] = (uint8_t)day;
+    p_value[4] = (uint8_t)(ms_of_day / 3600000u);
+    p_value[5] = (uint8_t)((ms_of_day / 60000u) % 60u);
+    p_value[6] = (uint8_t)((ms_of_day / 1000u) % 60u);
+    p_value[7] = cts_weekday_from_days(days);
+    p_value[8] = (uint8_t)(((ms_of_day % 1000u) * 256u) / 1000u);
+    p_value[9] = adjust_reason;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: cts_server_get_value()
+********************************************************************************
+* Summary:
+*   Returns the value of a readable attribute. The Current Time is encoded
+*   into the scratch buffer, the other values are returned in place.
+*
+* Parameters:
+*   uint16_t conn_id: Peer, for its CCCD
+*   uint16_t handle: Attribute handle
+*   uint8_t *p_scratch: Buffer of CTS_CURRENT_TIME_LEN bytes
+*   const uint8_t **pp_value: Value
+*   uint16_t *p_len: Length of the value
+*
+* Return:
+*   wiced_bt_gatt_status_t: Error to send to the peer, or success
+*
+*******************************************************************************/
+static wiced_bt_gatt_status_t cts_server_get_value(uint16_t conn_id, uint16_t handle,
+                                                   uint8_t *p_scratch,
+                                                   const uint8_t **pp_value,
+                                                   uint16_t *p_len)
+{
+    cts_server_peer_t *p_peer;
+
+    switch (handle)
+    {
+        case CTS_SERVER_HDLC_DEVICE_NAME_VALUE:
+            *pp_value = cts_server_device_name;
+            *p_len = (uint16_t)(sizeof(cts_server_device_name) - 1u);
+            break;
+
+        case CTS_SERVER_HDLC_APPEARANCE_VALUE:
+            *pp_value = cts_server_appearance;
+            *p_len = (uint16_t)sizeof(cts_server_appearance);
+            break;
+
+        case CTS_SERVER_HDLC_CURRENT_TIME_VALUE:
+            (void)cts_server_encode_time(0u, p_scratch);
+            *pp_value = p_scratch;
+            *p_len = CTS_CURRENT_TIME_LEN;
+            cts_server_stats.reads++;
+            break;
+
+        case CTS_SERVER_HDLD_CURRENT_TIME_CCCD:
+            p_peer = cts_server_find_peer(conn_id, false);
+            *pp_value = (NULL != p_peer) ? p_peer->cccd : cts_server_cccd_off;
+            *p_len = 2u;
+            break;
+
+        default:
+            return WICED_BT_GATT_INVALID_HANDLE;
+    }
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cts_server_read()
+********************************************************************************
+* Summary:
+*   Answers a read or read blob request.
+*
+* Parameters:
+*   const app_event_t *p_event: Attribute request event
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void cts_server_read(const app_event_t *p_event)
+{
+    cts_server_buffer_t *p_buffer;
+    const uint8_t *p_value = NULL;
+    uint16_t len = 0;
+    uint16_t handle = p_event->data.request.handle;
+    uint16_t offset = p_event->data.request.offset;
+    wiced_bt_gatt_opcode_t opcode = (wiced_bt_gatt_opcode_t)p_event->op;
+    wiced_bt_gatt_status_t gatt_status;
+
+    /* The response is sent from the buffer after this function returns */
+    p_buffer = cts_server_buffer_claim();
+    if (NULL == p_buffer)
+    {
+        cts_server_stats.no_buffer++;
+        (void)wiced_bt_gatt_server_send_error_rsp(p_event->conn_id, opcode, handle,
+                                                  WICED_BT_GATT_INSUF_RESOURCE);
+        return;
+    }
+
+    gatt_status = cts_server_get_value(p_event->conn_id, handle, p_buffer->value,
+                                       &p_value, &len);
+    if ((WICED_BT_GATT_SUCCESS == gatt_status) && (offset > len))
+    {
+        gatt_status = WICED_BT_GATT_INVALID_OFFSET;
+    }
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        cts_server_buffer_release(p_buffer);
+        (void)wiced_bt_gatt_server_send_error_rsp(p_event->conn_id, opcode, handle,
+                                                  gatt_status);
+        return;
+    }
+
+    if (p_value != p_buffer->value)
+    {
+        /* A constant or per peer value, the buffer is not needed */
+        cts_server_buffer_release(p_buffer);
+        p_buffer = NULL;
+    }
+    gatt_status = wiced_bt_gatt_server_send_read_handle_rsp(p_event->conn_id, opcode,
+                                                            (uint16_t)(len - offset),
+                                                            (uint8_t *)&p_value[offset],
+                                                            p_buffer);
+    if ((WICED_BT_GATT_SUCCESS != gatt_status) && (NULL != p_buffer))
+    {
+        cts_server_buffer_release(p_buffer);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cts_server_read_by_type()
+********************************************************************************
+* Summary:
+*   Answers a read by type request with the first matching value in the
+*   handle range, which is enough for the Device Name and Current Time.
+*
+* Parameters:
+*   const app_event_t *p_event: Attribute request event
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void cts_server_read_by_type(const app_event_t *p_event)
+{
+    static const struct
+    {
+        uint16_t handle;
+        uint16_t uuid16;
+    } types[] =
+    {
+        { CTS_SERVER_HDLC_DEVICE_NAME_VALUE,  UUID_CHARACTERISTIC_DEVICE_NAME },
+        { CTS_SERVER_HDLC_APPEARANCE_VALUE,   UUID_CHARACTERISTIC_APPEARANCE },
+        { CTS_SERVER_HDLC_CURRENT_TIME_VALUE, UUID_CHARACTERISTIC_CURRENT_TIME },
+    };
+    cts_server_buffer_t *p_buffer;
+    uint8_t scratch[CTS_CURRENT_TIME_LEN];
+    const uint8_t *p_value = NULL;
+    uint16_t len = 0;
+    uint16_t rsp_size;
+    uint8_t pair_len = 0;
+    int used = 0;
+    uint32_t index;
+    wiced_bt_gatt_opcode_t opcode = (wiced_bt_gatt_opcode_t)p_event->op;
+    wiced_bt_gatt_status_t gatt_status;
+
+    for (index = 0; index < (sizeof(types) / sizeof(types[0])); index++)
+    {
+        if ((types[index].uuid16 == p_event->data.request.uuid16) &&
+            (types[index].handle >= p_event->data.request.handle) &&
+            (types[index].handle <= p_event->data.request.end_handle))
+        {
+            break;
+        }
+    }
+    if (index == (sizeof(types) / sizeof(types[0])))
+    {
+        (void)wiced_bt_gatt_server_send_error_rsp(p_event->conn_id, opcode,
+                                                  p_event->data.request.handle,
+                                                  WICED_BT_GATT_ATTRIBUTE_NOT_FOUND);
+        return;
+    }
+
+    p_buffer = cts_server_buffer_claim();
+    if (NULL == p_buffer)
+    {
+        cts_server_stats.no_buffer++;
+        (void)wiced_bt_gatt_server_send_error_rsp(p_event->conn_id, opcode,
+                                                  p_event->data.request.handle,
+                                                  WICED_BT_GATT_INSUF_RESOURCE);
+        return;
+    }
+
+    (void)cts_server_get_value(p_event->conn_id, types[index].handle, scratch,
+                               &p_value, &len);
+    rsp_size = (p_event->data.request.len < CTS_SERVER_BUFFER_LEN) ?
+               p_event->data.request.len : CTS_SERVER_BUFFER_LEN;
+    used = wiced_bt_gatt_put_read_by_type_rsp_in_stream(p_buffer->value, rsp_size,
+                                                        &pair_len, types[index].handle,
+                                                        len, p_value);
+    if (0 == used)
+    {
+        gatt_status = WICED_BT_GATT_INSUF_RESOURCE;
+    }
+    else
+    {
+        gatt_status = wiced_bt_gatt_server_send_read_by_type_rsp(p_event->conn_id, opcode,
+                                                                 pair_len, (uint16_t)used,
+                                                                 p_buffer->value, p_buffer);
+    }
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        cts_server_buffer_release(p_buffer);
+        (void)wiced_bt_gatt_server_send_error_rsp(p_event->conn_id, opcode,
+                                                  p_event->data.request.handle,
+                                                  gatt_status);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cts_server_write()
+********************************************************************************
+* Summary:
+*   Answers a write request. Only the CCCD of the Current Time is writable.
+*
+* Parameters:
+*   const app_event_t *p_event: Attribute request event
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void cts_server_write(const app_event_t *p_event)
+{
+    cts_server_peer_t *p_peer = NULL;
+    uint16_t handle = p_event->data.request.handle;
+    wiced_bt_gatt_opcode_t opcode = (wiced_bt_gatt_opcode_t)p_event->op;
+    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_SUCCESS;
+
+    if (CTS_SERVER_HDLD_CURRENT_TIME_CCCD != handle)
+    {
+        gatt_status = WICED_BT_GATT_WRITE_NOT_PERMIT;
+    }
+    else if (0 != p_event->data.request.offset)
+    {
+        gatt_status = WICED_BT_GATT_INVALID_OFFSET;
+    }
+    else if (2u != p_event->data.request.len)
+    {
+        gatt_status = WICED_BT_GATT_INVALID_ATTR_LEN;
+    }
+    else
+    {
+        /* A time source link is not a peer of the server */
+        p_peer = cts_server_find_peer(p_event->conn_id, false);
+        if (NULL == p_peer)
+        {
+            gatt_status = WICED_BT_GATT_WRITE_NOT_PERMIT;
+        }
+    }
+
+    if (NULL != p_peer)
+    {
+        if ((0 == (p_peer->cccd[0] & GATT_CLIENT_CONFIG_NOTIFICATION)) &&
+            (0 != (p_event->data.request.value[0] & GATT_CLIENT_CONFIG_NOTIFICATION)))
+        {
+            cts_server_stats.subscriptions++;
+        }
+        memcpy(p_peer->cccd, p_event->data.request.value, sizeof(p_peer->cccd));
+        printf("CTS server: notifications %s for connection ID '%d'\n",
+               (0 != (p_peer->cccd[0] & GATT_CLIENT_CONFIG_NOTIFICATION)) ?
+               "enabled" : "disabled", p_event->conn_id);
+    }
+
+    if (GATT_CMD_WRITE == opcode)
+    {
+        /* No response to a write command */
+    }
+    else if (WICED_BT_GATT_SUCCESS == gatt_status)
+    {
+        (void)wiced_bt_gatt_server_send_write_rsp(p_event->conn_id, opcode, handle);
+    }
+    else
+    {
+        (void)wiced_bt_gatt_server_send_error_rsp(p_event->conn_id, opcode, handle,
+                                                  gatt_status);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cts_server_find_peer()
+********************************************************************************
+* Summary:
+*   Finds the entry of a peer.
+*
+* Parameters:
+*   uint16_t conn_id: Connection ID of the peer
+*   bool create: Take a free entry if the peer has none
+*
+* Return:
+*   cts_server_peer_t*: Entry of the peer, NULL if none
+*
+*******************************************************************************/
+static cts_server_peer_t *cts_server_find_peer(uint16_t conn_id, bool create)
+{
+    cts_server_peer_t *p_free = NULL;
+    uint32_t index;
+
+    for (index = 0; index < CTS_SERVER_MAX_PEERS; index++)
+    {
+        if (conn_id == cts_server_peers[index].conn_id)
+        {
+            return &cts_server_peers[index];
+        }
+        if ((NULL == p_free) && (0 == cts_server_peers[index].conn_id))
+        {
+            p_free = &cts_server_peers[index];
+        }
+    }
+
+    if (!create || (NULL == p_free))
+    {
+        return NULL;
+    }
+    memset(p_free, 0, sizeof(*p_free));
+    p_free->conn_id = conn_id;
+    return p_free;
+}
+
+/*******************************************************************************
+* Function Name: cts_server_buffer_claim()
+********************************************************************************
+* Summary:
+*   Takes a buffer the stack no longer uses. The caller holds one reference
+*   until it calls cts_server_buffer_release().
+*
+* Parameters:
+*   None
+*
+* Return:
+*   cts_server_buffer_t*: Free buffer, NULL if all are in flight
+*
+*******************************************************************************/
+static cts_server_buffer_t *cts_server_buffer_claim(void)
+{
+    cts_server_buffer_t *p_buffer = NULL;
+    uint32_t index;
+
+    taskENTER_CRITICAL();
+    for (index = 0; index < CTS_SERVER_BUFFERS; index++)
+    {
+        if (0u == cts_server_buffers[index].in_flight)
+        {
+            p_buffer = &cts_server_buffers[index];
+            p_buffer->in_flight = 1u;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return p_buffer;
+}
+
+/*******************************************************************************
+* Function Name: cts_server_buffer_release()
+********************************************************************************
+* Summary:
+*   Drops one reference to a buffer. Called from the application task and
+*   from the GATT callback.
+*
+* Parameters:
+*   cts_server_buffer_t *p_buffer: Buffer
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void cts_server_buffer_release(cts_server_buffer_t *p_buffer)
+{
+    taskENTER_CRITICAL();
+    if (0u != p_buffer->in_flight)
+    {
+        p_buffer->in_flight--;
+    }
+    taskEXIT_CRITICAL();
+}
+
+#endif /* ENABLE_CTS_SERVER */
+
+/* [] END OF FILE */
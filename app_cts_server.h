@@ -0,0 +1,127 @@
+/******************************************************************************
+* File Name: app_cts_server.h
+*
+* Description: This file contains macros, structures and function prototypes
+*              used in app_cts_server.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_CTS_SERVER_H__
+#define __APP_CTS_SERVER_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_client.h"
+#include "cts_alarm.h"
+#include "wiced_bt_gatt.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 1 to serve the fused time as a Current Time Service to the peers
+ * that connect, so that one synchronized device relays the time to others */
+#ifndef ENABLE_CTS_SERVER
+#define ENABLE_CTS_SERVER               (0u)
+#endif
+
+#if (ENABLE_CTS_SERVER) && !(ENABLE_CTS_ALARMS)
+#error "ENABLE_CTS_SERVER needs ENABLE_CTS_ALARMS (and ENABLE_TIME_FUSION)"
+#endif
+
+/* Subscribed peers are notified on every period of the fused time, and at
+ * once when the fused time steps by more than CTS_SERVER_STEP_MS */
+#ifndef CTS_SERVER_NOTIFY_PERIOD_MS
+#define CTS_SERVER_NOTIFY_PERIOD_MS     (60000u)
+#endif
+#ifndef CTS_SERVER_STEP_MS
+#define CTS_SERVER_STEP_MS              (1000u)
+#endif
+
+/* Peers that can be connected to the server at the same time. They are
+ * tracked here and take no time source slot of the client */
+#ifndef CTS_SERVER_MAX_PEERS
+#define CTS_SERVER_MAX_PEERS            (3u)
+#endif
+
+/* Links the stack is configured for: the time sources and the peers of the
+ * server. Overrides the connection limits of design.cybt */
+#define CTS_MAX_LINKS                   (CTS_MAX_CONNECTIONS + \
+                                         ((ENABLE_CTS_SERVER) ? CTS_SERVER_MAX_PEERS : 0u))
+
+/* Response and notification buffers. A buffer is shared by all the peers a
+ * value goes to and is reused once the stack has sent it to every peer */
+#define CTS_SERVER_BUFFERS              (2u)
+#define CTS_SERVER_BUFFER_LEN           (22u)
+
+/* ATT MTU of the server, as set in design.cybt */
+#define CTS_SERVER_MTU                  (23u)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+typedef struct
+{
+    uint32_t notifications;         /* Notifications passed to the stack */
+    uint32_t notify_rounds;         /* Values encoded for notification */
+    uint32_t notify_failed;         /* Notifications the stack refused */
+    uint32_t steps;                 /* Rounds sent for a step of the time */
+    uint32_t reads;                 /* Current Time reads */
+    uint32_t no_buffer;             /* Values dropped, all buffers in flight */
+    uint32_t subscriptions;         /* CCCD writes enabling notifications */
+} cts_server_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+wiced_bt_gatt_status_t app_cts_server_init(void);
+
+/* Called from the GATT callback */
+bool app_cts_server_copy_request(const wiced_bt_gatt_attribute_request_t *p_request,
+                                 app_event_t *p_event);
+void app_cts_server_buffer_transmitted(void *p_app_ctxt);
+
+/* Called from the application task */
+void app_cts_server_request(const app_event_t *p_event);
+void app_cts_server_time_updated(void);
+bool app_cts_server_connected(uint16_t conn_id);
+void app_cts_server_disconnected(uint16_t conn_id);
+uint32_t app_cts_server_peer_count(void);
+void app_cts_server_print_stats(void);
+
+#endif      /* __APP_CTS_SERVER_H__ */
+
+/* [] END OF FILE */
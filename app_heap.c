@@ -0,0 +1,250 @@
+/******************************************************************************
+* File Name: app_heap.c
+*
+* Description: This file checks the heap use of the application. In the
+*              zero-heap profile every heap allocation after the Bluetooth
+*              stack has started asserts, and the peak heap use tells how far
+*              configTOTAL_HEAP_SIZE can shrink.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_heap.h"
+#include "cyhal.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdbool.h>
+#include <stdio.h>
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+#include <malloc.h>
+#endif
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static bool         heap_locked;
+static uint32_t     early_allocs;       /* Allocations before app_heap_lock() */
+static uint32_t     early_bytes;
+static uint32_t     late_allocs;        /* Allocations after app_heap_lock() */
+static uint32_t     late_bytes;
+static size_t       late_size;          /* Size of the last late allocation */
+static TaskHandle_t late_task;          /* Task that made it */
+
+/* pvPortMalloc() use: live blocks with their size, the bytes in use and
+ * their peak, with and without the block overhead of heap_4 */
+static void        *heap_block[APP_HEAP_TRACK_BLOCKS];
+static size_t       heap_block_size[APP_HEAP_TRACK_BLOCKS];
+static uint32_t     heap_untracked;     /* Blocks that found the table full */
+static size_t       heap_in_use;
+static size_t       heap_peak;
+static size_t       heap4_in_use;
+static size_t       heap4_peak;
+
+/*******************************************************************************
+* Function Name: app_heap_lock()
+********************************************************************************
+* Summary:
+*   Marks the end of start-up. Called once the application has been
+*   initialized in BTM_ENABLED_EVT.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_heap_lock(void)
+{
+    heap_locked = true;
+}
+
+/*******************************************************************************
+* Function Name: app_heap_trace_malloc()
+********************************************************************************
+* Summary:
+*   Counts a heap allocation and adds it to the bytes in use. In the
+*   zero-heap profile an allocation after app_heap_lock() asserts; late_size
+*   and late_task tell the debugger what was allocated and by whom. Called
+*   by pvPortMalloc with the scheduler suspended, so this must not print or
+*   block.
+*
+* Parameters:
+*   void *p_block : Allocated block, NULL if the allocation failed
+*   size_t size   : Requested size
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_heap_trace_malloc(void *p_block, size_t size)
+{
+    uint32_t index;
+
+    if (NULL != p_block)
+    {
+        for (index = 0; index < APP_HEAP_TRACK_BLOCKS; index++)
+        {
+            if (NULL == heap_block[index])
+            {
+                heap_block[index] = p_block;
+                heap_block_size[index] = size;
+                break;
+            }
+        }
+        if (APP_HEAP_TRACK_BLOCKS == index)
+        {
+            heap_untracked++;
+        }
+        heap_in_use += size;
+        heap4_in_use += APP_HEAP_HEAP4_HEADER +
+                        ((size + APP_HEAP_HEAP4_ALIGN - 1u) & ~(size_t)(APP_HEAP_HEAP4_ALIGN - 1u));
+        if (heap_in_use > heap_peak)
+        {
+            heap_peak = heap_in_use;
+        }
+        if (heap4_in_use > heap4_peak)
+        {
+            heap4_peak = heap4_in_use;
+        }
+    }
+
+    if (!heap_locked)
+    {
+        early_allocs++;
+        early_bytes += size;
+        return;
+    }
+
+    late_allocs++;
+    late_bytes += size;
+    late_size = size;
+    late_task = (taskSCHEDULER_NOT_STARTED != xTaskGetSchedulerState()) ?
+                xTaskGetCurrentTaskHandle() : NULL;
+#if (ENABLE_ZERO_HEAP)
+    CY_ASSERT(0);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: app_heap_trace_free()
+********************************************************************************
+* Summary:
+*   Removes a freed block from the bytes in use. A block that did not fit in
+*   the table stays counted, so the figures are then an upper bound. Called
+*   by vPortFree with the scheduler suspended.
+*
+* Parameters:
+*   void *p_block : Freed block
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_heap_trace_free(void *p_block)
+{
+    uint32_t index;
+    size_t size;
+
+    for (index = 0; (NULL != p_block) && (index < APP_HEAP_TRACK_BLOCKS); index++)
+    {
+        if (p_block == heap_block[index])
+        {
+            size = heap_block_size[index];
+            heap_block[index] = NULL;
+            heap_in_use -= size;
+            heap4_in_use -= APP_HEAP_HEAP4_HEADER +
+                            ((size + APP_HEAP_HEAP4_ALIGN - 1u) & ~(size_t)(APP_HEAP_HEAP4_ALIGN - 1u));
+            break;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_heap_report()
+********************************************************************************
+* Summary:
+*   Prints the pvPortMalloc() use and its peak and, in the zero-heap
+*   profile, the allocations made before and after start-up. heap_3 takes
+*   its memory from the C library and ignores configTOTAL_HEAP_SIZE; the
+*   peak with the heap_4 block headers is the size heap_4 would need. The
+*   C library heap, which also holds the library's own allocations, is
+*   printed on its own.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_heap_report(void)
+{
+    size_t in_use;
+    size_t peak;
+    size_t peak4;
+    uint32_t untracked;
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+    struct mallinfo info = mallinfo();
+#endif
+
+    /* The hooks run with the scheduler suspended, take a consistent copy */
+    vTaskSuspendAll();
+    in_use = heap_in_use;
+    peak = heap_peak;
+    peak4 = heap4_peak;
+    untracked = heap_untracked;
+    (void)xTaskResumeAll();
+
+    printf("Heap: pvPortMalloc %lu bytes in use, peak %lu (%lu with heap_4 "
+           "headers) of configTOTAL_HEAP_SIZE %lu bytes%s\n",
+           (unsigned long)in_use, (unsigned long)peak, (unsigned long)peak4,
+           (unsigned long)configTOTAL_HEAP_SIZE,
+           (0u != untracked) ? ", upper bound" : "");
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+    printf("Heap: C library %lu bytes in use, %lu bytes taken from the system\n",
+           (unsigned long)info.uordblks, (unsigned long)info.arena);
+#endif
+#if (ENABLE_ZERO_HEAP)
+    printf("Heap: %lu allocations (%lu bytes) at start-up, %lu (%lu bytes) after\n",
+           (unsigned long)early_allocs, (unsigned long)early_bytes,
+           (unsigned long)late_allocs, (unsigned long)late_bytes);
+#endif
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,87 @@
+/******************************************************************************
+* File Name: app_heap.h
+*
+* Description: This file contains macros and function prototypes used in
+*              app_heap.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_HEAP_H__
+#define __APP_HEAP_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stddef.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 1 for the zero-heap profile: any heap allocation after the
+ * Bluetooth stack has started asserts */
+#ifndef ENABLE_ZERO_HEAP
+#define ENABLE_ZERO_HEAP                (0u)
+#endif
+
+/* Live pvPortMalloc() blocks whose size is kept to track the peak use.
+ * heap_3 reports no size when a block is freed */
+#ifndef APP_HEAP_TRACK_BLOCKS
+#define APP_HEAP_TRACK_BLOCKS           (32u)
+#endif
+
+/* Block header and alignment of heap_4, to tell the configTOTAL_HEAP_SIZE
+ * it would need for the peak */
+#define APP_HEAP_HEAP4_ALIGN            (8u)
+#define APP_HEAP_HEAP4_HEADER           (8u)
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/* Marks the end of start-up. Later heap allocations assert in the
+ * zero-heap profile */
+void app_heap_lock(void);
+
+/* Called by traceMALLOC and traceFREE in FreeRTOSConfig.h for every heap
+ * allocation and free */
+void app_heap_trace_malloc(void *p_block, size_t size);
+void app_heap_trace_free(void *p_block);
+
+/* Prints the pvPortMalloc() use, its peak and the allocations seen */
+void app_heap_report(void);
+
+#endif      /* __APP_HEAP_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,375 @@
+/******************************************************************************
+* File Name: app_latency.c
+*
+* Description: This file times the path from a user button press to the
+*              response of the notification CCCD write. Every stage is
+*              stamped with the CPU cycle counter, except the wait for the
+*              response, where the CPU may sleep and the local time is used.
+*              The last traces give the percentiles of every interval.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_latency.h"
+#include "app_bt_utils.h"
+#include <stdio.h>
+#include <string.h>
+
+#if (ENABLE_LATENCY_TRACE)
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* Stages of the trace in progress */
+typedef struct
+{
+    uint32_t isr_cycles;
+    uint32_t queued_cycles;
+    uint32_t task_cycles;
+    uint32_t write_cycles;
+    uint32_t written_cycles;
+    uint64_t written_us;
+    uint32_t pending;               /* CCCD write responses still expected */
+    uint32_t writes;
+    bool     recording;             /* Button handler of this trace runs */
+    bool     first_write;
+} latency_trace_t;
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Written by the button interrupt, read by the application task */
+static volatile uint32_t isr_exit_cycles;
+
+/* Only used from the application task */
+static latency_trace_t trace;
+static uint32_t latency_us[LATENCY_INTERVAL_COUNT][LATENCY_TRACE_SAMPLES];
+static uint32_t trace_count;
+static uint32_t trace_overlapped;
+static uint32_t trace_aborted;
+
+static const char *const interval_name[LATENCY_INTERVAL_COUNT] =
+{
+    "isr", "wake", "app", "stack", "air", "deliver", "total",
+};
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static uint32_t latency_percentile(const uint32_t *p_sorted, uint32_t count,
+                                   uint32_t percent);
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: app_latency_isr_exit()
+********************************************************************************
+* Summary:
+*   Stamps the end of the button interrupt handler, after the event is queued.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_latency_isr_exit(void)
+{
+    isr_exit_cycles = cycle_counter_get();
+}
+
+/*******************************************************************************
+* Function Name: app_latency_start()
+********************************************************************************
+* Summary:
+*   Starts a trace when the application task handles a button press. A press
+*   while the responses of the previous one are outstanding is not traced.
+*
+* Parameters:
+*   uint32_t isr_cycles: Cycle count at the button interrupt entry
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_latency_start(uint32_t isr_cycles)
+{
+    uint32_t now = cycle_counter_get();
+    uint32_t queued = isr_exit_cycles;
+
+    if (0 != trace.pending)
+    {
+        trace_overlapped++;
+        trace.recording = false;
+        return;
+    }
+
+    memset(&trace, 0, sizeof(trace));
+    trace.isr_cycles = isr_cycles;
+    trace.task_cycles = now;
+    /* A later press may have overwritten the exit stamp */
+    if ((uint32_t)(queued - isr_cycles) > (uint32_t)(now - isr_cycles))
+    {
+        queued = isr_cycles;
+    }
+    trace.queued_cycles = queued;
+    trace.recording = true;
+    trace.first_write = true;
+}
+
+/*******************************************************************************
+* Function Name: app_latency_write_begin()
+********************************************************************************
+* Summary:
+*   Stamps the call of wiced_bt_gatt_client_send_write() for the first CCCD
+*   write of the traced press.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_latency_write_begin(void)
+{
+    if (trace.recording && trace.first_write)
+    {
+        trace.write_cycles = cycle_counter_get();
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_latency_write_end()
+********************************************************************************
+* Summary:
+*   Stamps the return of wiced_bt_gatt_client_send_write() for the first CCCD
+*   write of the traced press and counts the responses to wait for.
+*
+* Parameters:
+*   bool sent: true if the stack accepted the write
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_latency_write_end(bool sent)
+{
+    if (!trace.recording)
+    {
+        return;
+    }
+    if (trace.first_write)
+    {
+        trace.written_cycles = cycle_counter_get();
+        trace.written_us = local_time_us();
+        trace.first_write = false;
+    }
+    if (sent)
+    {
+        trace.pending++;
+        trace.writes++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_latency_response()
+********************************************************************************
+* Summary:
+*   Counts a CCCD write response. The last response of the traced press
+*   completes the trace, which is printed and kept for the percentiles.
+*
+* Parameters:
+*   uint32_t arrival_cycles: Cycle count in the GATT callback
+*   uint64_t arrival_us: Local time in the GATT callback
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_latency_response(uint32_t arrival_cycles, uint64_t arrival_us)
+{
+    uint32_t done_cycles = cycle_counter_get();
+    uint32_t sample[LATENCY_INTERVAL_COUNT];
+    uint32_t slot;
+    uint32_t index;
+
+    if ((0 == trace.pending) || (0 != --trace.pending))
+    {
+        return;
+    }
+    trace.recording = false;
+
+    sample[LATENCY_ISR]     = CYCLES_TO_US(trace.queued_cycles - trace.isr_cycles);
+    sample[LATENCY_WAKE]    = CYCLES_TO_US(trace.task_cycles - trace.queued_cycles);
+    sample[LATENCY_APP]     = CYCLES_TO_US(trace.write_cycles - trace.task_cycles);
+    sample[LATENCY_STACK]   = CYCLES_TO_US(trace.written_cycles - trace.write_cycles);
+    /* The cycle counter stops while the CPU sleeps between connection
+     * events, so the wait for the response uses the local time */
+    sample[LATENCY_AIR]     = (arrival_us > trace.written_us) ?
+                              (uint32_t)(arrival_us - trace.written_us) : 0u;
+    sample[LATENCY_DELIVER] = CYCLES_TO_US(done_cycles - arrival_cycles);
+    sample[LATENCY_TOTAL]   = 0;
+    for (index = 0; index < LATENCY_TOTAL; index++)
+    {
+        sample[LATENCY_TOTAL] += sample[index];
+    }
+
+    slot = trace_count % LATENCY_TRACE_SAMPLES;
+    for (index = 0; index < LATENCY_INTERVAL_COUNT; index++)
+    {
+        latency_us[index][slot] = sample[index];
+    }
+    trace_count++;
+
+    printf("Button to CCCD response: isr %lu, wake %lu, app %lu, stack %lu, "
+           "air %lu, deliver %lu, total %lu us (%lu writes)\n",
+           (unsigned long)sample[LATENCY_ISR], (unsigned long)sample[LATENCY_WAKE],
+           (unsigned long)sample[LATENCY_APP], (unsigned long)sample[LATENCY_STACK],
+           (unsigned long)sample[LATENCY_AIR], (unsigned long)sample[LATENCY_DELIVER],
+           (unsigned long)sample[LATENCY_TOTAL], (unsigned long)trace.writes);
+
+    if (0 == (trace_count % LATENCY_TRACE_REPORT_EVERY))
+    {
+        app_latency_report();
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_latency_abort()
+********************************************************************************
+* Summary:
+*   Drops the trace in progress, for example when a server disconnects before
+*   it responds.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_latency_abort(void)
+{
+    if (0 != trace.pending)
+    {
+        trace_aborted++;
+    }
+    trace.pending = 0;
+    trace.recording = false;
+}
+
+/*******************************************************************************
+* Function Name: app_latency_report()
+********************************************************************************
+* Summary:
+*   Prints the median, 90th percentile and maximum of every interval over the
+*   last LATENCY_TRACE_SAMPLES traces.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_latency_report(void)
+{
+    uint32_t sorted[LATENCY_TRACE_SAMPLES];
+    uint32_t count;
+    uint32_t interval;
+    uint32_t i;
+    uint32_t j;
+    uint32_t value;
+
+    if (0 == trace_count)
+    {
+        return;
+    }
+    count = (trace_count < LATENCY_TRACE_SAMPLES) ? trace_count : LATENCY_TRACE_SAMPLES;
+
+    printf("Button to CCCD latency over %lu traces (%lu overlapped, %lu aborted):\n",
+           (unsigned long)count, (unsigned long)trace_overlapped,
+           (unsigned long)trace_aborted);
+    for (interval = 0; interval < LATENCY_INTERVAL_COUNT; interval++)
+    {
+        /* Insertion sort, the sample count is small */
+        for (i = 0; i < count; i++)
+        {
+            value = latency_us[interval][i];
+            for (j = i; (j > 0) && (sorted[j - 1] > value); j--)
+            {
+                sorted[j] = sorted[j - 1];
+            }
+            sorted[j] = value;
+        }
+        printf("  %-8s p50 %7lu  p90 %7lu  max %7lu us\n", interval_name[interval],
+               (unsigned long)latency_percentile(sorted, count, 50),
+               (unsigned long)latency_percentile(sorted, count, 90),
+               (unsigned long)sorted[count - 1]);
+    }
+}
+
+/*******************************************************************************
+* Function Name: latency_percentile()
+********************************************************************************
+* Summary:
+*   Returns a percentile of sorted samples, using the nearest rank.
+*
+* Parameters:
+*   const uint32_t *p_sorted: Samples in ascending order
+*   uint32_t count: Number of samples, at least 1
+*   uint32_t percent: Percentile
+*
+* Return:
+*   uint32_t: Sample at the percentile
+*
+*******************************************************************************/
+static uint32_t latency_percentile(const uint32_t *p_sorted, uint32_t count,
+                                   uint32_t percent)
+{
+    uint32_t rank = ((count * percent) + 99u) / 100u;
+
+    return p_sorted[(rank > 0u) ? (rank - 1u) : 0u];
+}
+
+#endif /* ENABLE_LATENCY_TRACE */
+
+/* [] END OF FILE */
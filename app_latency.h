@@ -0,0 +1,110 @@
+/******************************************************************************
+* File Name: app_latency.h
+*
+* Description: This file contains macros, enumerations and function prototypes
+*              used in app_latency.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_LATENCY_H__
+#define __APP_LATENCY_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 0 to stop timing the path from a button press to the response of
+ * the notification CCCD write */
+#ifndef ENABLE_LATENCY_TRACE
+#define ENABLE_LATENCY_TRACE            (1u)
+#endif
+
+/* Traces kept for the percentiles, and traces between two summaries */
+#ifndef LATENCY_TRACE_SAMPLES
+#define LATENCY_TRACE_SAMPLES           (32u)
+#endif
+#ifndef LATENCY_TRACE_REPORT_EVERY
+#define LATENCY_TRACE_REPORT_EVERY      (16u)
+#endif
+
+/*******************************************************************************
+*        Enumerations
+*******************************************************************************/
+/* Intervals between the stages of a trace */
+typedef enum
+{
+    LATENCY_ISR,        /* Interrupt entry until the event is queued */
+    LATENCY_WAKE,       /* Queued until the application task runs the handler */
+    LATENCY_APP,        /* Handler until the first CCCD write is sent */
+    LATENCY_STACK,      /* Time spent in wiced_bt_gatt_client_send_write() */
+    LATENCY_AIR,        /* Write sent until the last response reaches the
+                         * GATT callback: controller, air and server */
+    LATENCY_DELIVER,    /* GATT callback until the application task */
+    LATENCY_TOTAL,
+    LATENCY_INTERVAL_COUNT,
+} latency_interval_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/* Called at the end of the button interrupt handler */
+void app_latency_isr_exit(void);
+
+/* Starts a trace from the cycle count at the button interrupt entry */
+void app_latency_start(uint32_t isr_cycles);
+
+/* Called around every CCCD write of the traced button press */
+void app_latency_write_begin(void);
+void app_latency_write_end(bool sent);
+
+/* Called for every CCCD write response with the cycle count and local time
+ * of its GATT callback. The last response completes the trace */
+void app_latency_response(uint32_t arrival_cycles, uint64_t arrival_us);
+
+/* Drops a trace whose responses will not arrive */
+void app_latency_abort(void);
+
+/* Prints the median, 90th percentile and maximum of every interval */
+void app_latency_report(void);
+
+#endif      /* __APP_LATENCY_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,363 @@
+/******************************************************************************
+* File Name: app_metrics.c
+*
+* Description: This file contains the metrics registry: fixed slots of counters
+*              and gauges updated with atomic operations, so the Bluetooth
+*              stack callbacks update them without a lock.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_metrics.h"
+#include "app_bt_utils.h"
+#include "wiced_bt_gatt.h"
+#include "cy_syslib.h"
+#include <stdio.h>
+
+#if (ENABLE_METRICS)
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Slot access. GCC and armclang have atomic builtins; other toolchains
+ * update a slot in a short critical section, and aligned 32-bit loads and
+ * stores are single accesses on Cortex-M */
+#if defined(__GNUC__)
+#define METRIC_ADD(p_slot, value)       ((void)__atomic_fetch_add((p_slot), (value), __ATOMIC_RELAXED))
+#define METRIC_STORE(p_slot, value)     __atomic_store_n((p_slot), (value), __ATOMIC_RELAXED)
+#define METRIC_LOAD(p_slot)             __atomic_load_n((p_slot), __ATOMIC_RELAXED)
+#else
+#define METRIC_ADD(p_slot, value)                                   \
+    do {                                                            \
+        uint32_t metric_saved = Cy_SysLib_EnterCriticalSection();   \
+        *(p_slot) += (value);                                       \
+        Cy_SysLib_ExitCriticalSection(metric_saved);                \
+    } while (0)
+#define METRIC_STORE(p_slot, value)     (*(p_slot) = (value))
+#define METRIC_LOAD(p_slot)             (*(p_slot))
+#endif
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Updated from the stack callbacks and the application task with atomic
+ * operations only */
+static volatile uint32_t metric_counter[METRIC_COUNTER_COUNT];
+static volatile int32_t  metric_gauge[METRIC_GAUGE_COUNT];
+static volatile uint32_t metric_disconnect_reason[METRICS_DISCONNECT_REASONS];
+
+/* Disconnection reasons with a slot of their own. The last slot counts the
+ * others */
+static const uint16_t disconnect_reason_code[METRICS_DISCONNECT_REASONS - 1u] =
+{
+    GATT_CONN_UNKNOWN,
+    GATT_CONN_L2C_FAILURE,
+    GATT_CONN_TIMEOUT,
+    GATT_CONN_TERMINATE_PEER_USER,
+    GATT_CONN_TERMINATE_LOCAL_HOST,
+    GATT_CONN_FAIL_ESTABLISH,
+    GATT_CONN_LMP_TIMEOUT,
+    GATT_CONN_CANCEL,
+};
+
+static const char *const counter_name[METRIC_COUNTER_COUNT] =
+{
+    "connects", "disconnects", "discovery_failures", "cccd_write_failures",
+    "notifications", "decode_errors",
+};
+
+static const char *const gauge_name[METRIC_GAUGE_COUNT] =
+{
+    "connections", "queue_peak",
+};
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: app_metrics_inc()
+********************************************************************************
+* Summary:
+*   Increments a counter.
+*
+* Parameters:
+*   metric_counter_t counter: Counter to increment
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_metrics_inc(metric_counter_t counter)
+{
+    if (counter < METRIC_COUNTER_COUNT)
+    {
+        METRIC_ADD(&metric_counter[counter], 1u);
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_metrics_disconnect()
+********************************************************************************
+* Summary:
+*   Counts a disconnection in the total and in the slot of its reason.
+*
+* Parameters:
+*   uint16_t reason: wiced_bt_gatt_disconn_reason_t of the disconnection
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_metrics_disconnect(uint16_t reason)
+{
+    uint32_t slot;
+
+    for (slot = 0; slot < (METRICS_DISCONNECT_REASONS - 1u); slot++)
+    {
+        if (disconnect_reason_code[slot] == reason)
+        {
+            break;
+        }
+    }
+    METRIC_ADD(&metric_disconnect_reason[slot], 1u);
+    app_metrics_inc(METRIC_DISCONNECTS);
+}
+
+/*******************************************************************************
+* Function Name: app_metrics_gauge_set()
+********************************************************************************
+* Summary:
+*   Sets a gauge to a value.
+*
+* Parameters:
+*   metric_gauge_t gauge: Gauge to set
+*   int32_t value: New value
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_metrics_gauge_set(metric_gauge_t gauge, int32_t value)
+{
+    if (gauge < METRIC_GAUGE_COUNT)
+    {
+        METRIC_STORE(&metric_gauge[gauge], value);
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_metrics_gauge_add()
+********************************************************************************
+* Summary:
+*   Adds a positive or negative delta to a gauge.
+*
+* Parameters:
+*   metric_gauge_t gauge: Gauge to change
+*   int32_t delta: Value to add
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_metrics_gauge_add(metric_gauge_t gauge, int32_t delta)
+{
+    if (gauge < METRIC_GAUGE_COUNT)
+    {
+        METRIC_ADD(&metric_gauge[gauge], delta);
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_metrics_gauge_max()
+********************************************************************************
+* Summary:
+*   Raises a gauge to a value if the value is higher, for peak values.
+*
+* Parameters:
+*   metric_gauge_t gauge: Gauge to raise
+*   int32_t value: Value seen
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_metrics_gauge_max(metric_gauge_t gauge, int32_t value)
+{
+#if defined(__GNUC__)
+    int32_t current;
+
+    if (gauge >= METRIC_GAUGE_COUNT)
+    {
+        return;
+    }
+    current = METRIC_LOAD(&metric_gauge[gauge]);
+    /* A failed exchange reloads current, retry until the gauge is at least
+     * the value */
+    while ((value > current) &&
+           (!__atomic_compare_exchange_n(&metric_gauge[gauge], &current, value, true,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED)))
+    {
+    }
+#else
+    uint32_t saved;
+
+    if (gauge >= METRIC_GAUGE_COUNT)
+    {
+        return;
+    }
+    saved = Cy_SysLib_EnterCriticalSection();
+    if (value > metric_gauge[gauge])
+    {
+        metric_gauge[gauge] = value;
+    }
+    Cy_SysLib_ExitCriticalSection(saved);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: app_metrics_reset()
+********************************************************************************
+* Summary:
+*   Clears the counters, the disconnection reasons and the queue peak. The
+*   number of links up is a level and is kept. An update racing with the
+*   reset is either counted or cleared, never corrupted.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_metrics_reset(void)
+{
+    uint32_t index;
+
+    for (index = 0; index < METRIC_COUNTER_COUNT; index++)
+    {
+        METRIC_STORE(&metric_counter[index], 0u);
+    }
+    for (index = 0; index < METRICS_DISCONNECT_REASONS; index++)
+    {
+        METRIC_STORE(&metric_disconnect_reason[index], 0u);
+    }
+    METRIC_STORE(&metric_gauge[METRIC_GAUGE_QUEUE_PEAK], 0);
+}
+
+/*******************************************************************************
+* Function Name: app_metrics_snapshot()
+********************************************************************************
+* Summary:
+*   Copies every slot of the registry with an atomic load. No lock is taken,
+*   so the stack callbacks are never delayed by a snapshot.
+*
+* Parameters:
+*   app_metrics_snapshot_t *p_snapshot: Copy to fill
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_metrics_snapshot(app_metrics_snapshot_t *p_snapshot)
+{
+    uint32_t index;
+
+    for (index = 0; index < METRIC_COUNTER_COUNT; index++)
+    {
+        p_snapshot->counter[index] = METRIC_LOAD(&metric_counter[index]);
+    }
+    for (index = 0; index < METRIC_GAUGE_COUNT; index++)
+    {
+        p_snapshot->gauge[index] = METRIC_LOAD(&metric_gauge[index]);
+    }
+    for (index = 0; index < METRICS_DISCONNECT_REASONS; index++)
+    {
+        p_snapshot->disconnect_reason[index] =
+            METRIC_LOAD(&metric_disconnect_reason[index]);
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_metrics_print()
+********************************************************************************
+* Summary:
+*   Prints the counters, the gauges and the disconnection reasons seen.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_metrics_print(void)
+{
+    app_metrics_snapshot_t snapshot;
+    uint32_t index;
+
+    app_metrics_snapshot(&snapshot);
+
+    printf("Metrics:");
+    for (index = 0; index < METRIC_COUNTER_COUNT; index++)
+    {
+        printf(" %s %lu", counter_name[index], (unsigned long)snapshot.counter[index]);
+    }
+    for (index = 0; index < METRIC_GAUGE_COUNT; index++)
+    {
+        printf(" %s %ld", gauge_name[index], (long)snapshot.gauge[index]);
+    }
+    printf("\n");
+
+    for (index = 0; index < METRICS_DISCONNECT_REASONS; index++)
+    {
+        if (0u == snapshot.disconnect_reason[index])
+        {
+            continue;
+        }
+        printf("  disconnect %s: %lu\n",
+               (index < (METRICS_DISCONNECT_REASONS - 1u)) ?
+               get_bt_gatt_disconn_reason_name(
+                   (wiced_bt_gatt_disconn_reason_t)disconnect_reason_code[index]) :
+               "OTHER",
+               (unsigned long)snapshot.disconnect_reason[index]);
+    }
+}
+
+#endif /* ENABLE_METRICS */
+
+/* [] END OF FILE */
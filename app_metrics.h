@@ -0,0 +1,127 @@
+/******************************************************************************
+* File Name: app_metrics.h
+*
+* Description: This file contains macros, enumerations, structures and function
+*              prototypes used in app_metrics.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_METRICS_H__
+#define __APP_METRICS_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 0 to stop counting connection, discovery and notification events */
+#ifndef ENABLE_METRICS
+#define ENABLE_METRICS                  (1u)
+#endif
+
+/* Disconnection reasons counted on their own, see app_metrics.c. Other
+ * reasons share the last slot */
+#define METRICS_DISCONNECT_REASONS      (9u)
+
+/*******************************************************************************
+*        Enumerations
+*******************************************************************************/
+/* Counters, only ever incremented */
+typedef enum
+{
+    METRIC_CONNECTS,                /* Links established */
+    METRIC_DISCONNECTS,             /* Links lost, per reason in the snapshot */
+    METRIC_DISCOVERY_FAILURES,      /* Discovery requests or procedures that
+                                     * failed, or no CTS with notifications */
+    METRIC_CCCD_WRITE_FAILURES,     /* Notification CCCD writes not sent or
+                                     * rejected by the server */
+    METRIC_NOTIFICATIONS,           /* Notifications received by the GATT
+                                     * callback */
+    METRIC_DECODE_ERRORS,           /* Current Time values that did not decode */
+    METRIC_COUNTER_COUNT,
+} metric_counter_t;
+
+/* Gauges, set to the current value */
+typedef enum
+{
+    METRIC_GAUGE_CONNECTIONS,       /* Links up */
+    METRIC_GAUGE_QUEUE_PEAK,        /* Most events waiting in the application
+                                     * task queue */
+    METRIC_GAUGE_COUNT,
+} metric_gauge_t;
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* Copy of the registry. Every slot is read atomically, but slots updated
+ * while the copy is taken may be from before or after the update */
+typedef struct
+{
+    uint32_t counter[METRIC_COUNTER_COUNT];
+    int32_t  gauge[METRIC_GAUGE_COUNT];
+    uint32_t disconnect_reason[METRICS_DISCONNECT_REASONS];
+} app_metrics_snapshot_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/* Increments a counter. Safe from any task, callback or interrupt */
+void app_metrics_inc(metric_counter_t counter);
+
+/* Counts a disconnection with its wiced_bt_gatt_disconn_reason_t */
+void app_metrics_disconnect(uint16_t reason);
+
+/* Sets, adds to or raises a gauge. Safe from any task, callback or
+ * interrupt */
+void app_metrics_gauge_set(metric_gauge_t gauge, int32_t value);
+void app_metrics_gauge_add(metric_gauge_t gauge, int32_t delta);
+void app_metrics_gauge_max(metric_gauge_t gauge, int32_t value);
+
+/* Clears the counters and the peak gauges. Level gauges keep their value */
+void app_metrics_reset(void);
+
+/* Copies the registry without taking a lock */
+void app_metrics_snapshot(app_metrics_snapshot_t *p_snapshot);
+
+/* Prints a snapshot of the registry */
+void app_metrics_print(void);
+
+#endif      /* __APP_METRICS_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,495 @@
+/******************************************************************************
+* File Name: app_trace.c
+*
+* Description: This file records FreeRTOS task switches, queue operations,
+*              interrupts and the GATT event handlers into a ring of 8-byte
+*              events stamped with the CPU cycle counter. The dump is printed
+*              as hex lines that tools/cts_trace_to_json.py converts to a
+*              Chrome trace for Perfetto or chrome://tracing.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_trace.h"
+#include "app_bt_utils.h"
+#include "app_uart_tx.h"
+#include <task.h>
+#include <stdio.h>
+
+#if (ENABLE_TRACE_RECORDER)
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define TRACE_RING_MASK                 (TRACE_RING_EVENTS - 1u)
+#define TRACE_EVENTS_PER_LINE           (8u)
+#define TRACE_EVENT_LEN                 (8u)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+typedef struct
+{
+    uint32_t cycles;
+    uint8_t  type;                  /* trace_event_type_t */
+    uint8_t  id;
+    uint16_t arg;
+} trace_event_t;
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static trace_event_t    trace_ring[TRACE_RING_EVENTS];
+static uint32_t         trace_head;             /* Events recorded */
+static volatile bool    trace_running = true;
+
+static TaskHandle_t     trace_task[TRACE_MAX_TASKS];
+static uint32_t         trace_task_count;
+static QueueHandle_t    trace_queue[TRACE_MAX_QUEUES];
+static const char      *trace_queue_name[TRACE_MAX_QUEUES];
+static uint32_t         trace_queue_count;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void trace_record(trace_event_type_t type, uint8_t id, uint32_t arg);
+static uint8_t trace_task_id(void *p_task);
+static uint8_t trace_queue_id(void *p_queue);
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: trace_record()
+********************************************************************************
+* Summary:
+*   Adds an event to the ring. Called from tasks, interrupts and the context
+*   switch, so the ring is updated with interrupts masked.
+*
+* Parameters:
+*   trace_event_type_t type: Event type
+*   uint8_t id: Task, queue, interrupt or span
+*   uint32_t arg: Argument, saturated to 16 bits
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void trace_record(trace_event_type_t type, uint8_t id, uint32_t arg)
+{
+    UBaseType_t mask;
+    trace_event_t *p_event;
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    if (trace_running)
+    {
+        p_event = &trace_ring[trace_head & TRACE_RING_MASK];
+        p_event->cycles = cycle_counter_get();
+        p_event->type = (uint8_t)type;
+        p_event->id = id;
+        p_event->arg = (arg > UINT16_MAX) ? UINT16_MAX : (uint16_t)arg;
+        trace_head++;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/*******************************************************************************
+* Function Name: trace_task_id()
+********************************************************************************
+* Summary:
+*   Returns the trace id of a task. A task gets the next id the first time it
+*   is seen, kept in its FreeRTOS task number.
+*
+* Parameters:
+*   void *p_task: Task handle
+*
+* Return:
+*   uint8_t: Task id, 0 if all ids are in use
+*
+*******************************************************************************/
+static uint8_t trace_task_id(void *p_task)
+{
+    UBaseType_t mask;
+    UBaseType_t id = uxTaskGetTaskNumber((TaskHandle_t)p_task);
+
+    if ((0u == id) && (trace_task_count < TRACE_MAX_TASKS))
+    {
+        mask = taskENTER_CRITICAL_FROM_ISR();
+        id = uxTaskGetTaskNumber((TaskHandle_t)p_task);
+        if ((0u == id) && (trace_task_count < TRACE_MAX_TASKS))
+        {
+            trace_task[trace_task_count++] = (TaskHandle_t)p_task;
+            id = trace_task_count;
+            vTaskSetTaskNumber((TaskHandle_t)p_task, id);
+        }
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+    }
+    return (uint8_t)id;
+}
+
+/*******************************************************************************
+* Function Name: trace_queue_id()
+********************************************************************************
+* Summary:
+*   Returns the trace id of a queue, semaphore or mutex. A queue gets the next
+*   id the first time it is seen, kept in its FreeRTOS queue number.
+*
+* Parameters:
+*   void *p_queue: Queue handle
+*
+* Return:
+*   uint8_t: Queue id, 0 if all ids are in use
+*
+*******************************************************************************/
+static uint8_t trace_queue_id(void *p_queue)
+{
+    UBaseType_t mask;
+    UBaseType_t id = uxQueueGetQueueNumber((QueueHandle_t)p_queue);
+
+    if ((0u == id) && (trace_queue_count < TRACE_MAX_QUEUES))
+    {
+        mask = taskENTER_CRITICAL_FROM_ISR();
+        id = uxQueueGetQueueNumber((QueueHandle_t)p_queue);
+        if ((0u == id) && (trace_queue_count < TRACE_MAX_QUEUES))
+        {
+            trace_queue[trace_queue_count++] = (QueueHandle_t)p_queue;
+            id = trace_queue_count;
+            vQueueSetQueueNumber((QueueHandle_t)p_queue, id);
+        }
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+    }
+    return (uint8_t)id;
+}
+
+/*******************************************************************************
+* Function Name: app_trace_task_switched_in()
+********************************************************************************
+* Summary:
+*   traceTASK_SWITCHED_IN() hook, called in the context switch.
+*
+* Parameters:
+*   void *p_task: Task that starts running
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_task_switched_in(void *p_task)
+{
+    trace_record(TRACE_TASK_IN, trace_task_id(p_task), 0);
+}
+
+/*******************************************************************************
+* Function Name: app_trace_task_switched_out()
+********************************************************************************
+* Summary:
+*   traceTASK_SWITCHED_OUT() hook, called in the context switch.
+*
+* Parameters:
+*   void *p_task: Task that stops running
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_task_switched_out(void *p_task)
+{
+    trace_record(TRACE_TASK_OUT, trace_task_id(p_task), 0);
+}
+
+/*******************************************************************************
+* Function Name: app_trace_queue_send()
+********************************************************************************
+* Summary:
+*   traceQUEUE_SEND() hook. It runs before the message is added, as do the
+*   other queue hooks before the queue updates its message count.
+*
+* Parameters:
+*   void *p_queue: Queue, semaphore or mutex
+*   uint32_t waiting: Messages in the queue
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_queue_send(void *p_queue, uint32_t waiting)
+{
+    trace_record(TRACE_QUEUE_SEND, trace_queue_id(p_queue), waiting);
+}
+
+/*******************************************************************************
+* Function Name: app_trace_queue_send_from_isr()
+********************************************************************************
+* Summary:
+*   traceQUEUE_SEND_FROM_ISR() hook.
+*
+* Parameters:
+*   void *p_queue: Queue, semaphore or mutex
+*   uint32_t waiting: Messages in the queue
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_queue_send_from_isr(void *p_queue, uint32_t waiting)
+{
+    trace_record(TRACE_QUEUE_SEND_ISR, trace_queue_id(p_queue), waiting);
+}
+
+/*******************************************************************************
+* Function Name: app_trace_queue_receive()
+********************************************************************************
+* Summary:
+*   traceQUEUE_RECEIVE() hook, also called when a semaphore is taken.
+*
+* Parameters:
+*   void *p_queue: Queue, semaphore or mutex
+*   uint32_t waiting: Messages in the queue
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_queue_receive(void *p_queue, uint32_t waiting)
+{
+    trace_record(TRACE_QUEUE_RECEIVE, trace_queue_id(p_queue), waiting);
+}
+
+/*******************************************************************************
+* Function Name: app_trace_queue_block()
+********************************************************************************
+* Summary:
+*   traceBLOCKING_ON_QUEUE_RECEIVE() and traceBLOCKING_ON_QUEUE_SEND() hook.
+*
+* Parameters:
+*   void *p_queue: Queue, semaphore or mutex
+*   uint32_t send: 1 if a sender waits for space, 0 for a receiver
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_queue_block(void *p_queue, uint32_t send)
+{
+    trace_record(TRACE_QUEUE_BLOCK, trace_queue_id(p_queue), send);
+}
+
+/*******************************************************************************
+* Function Name: app_trace_isr_enter()
+********************************************************************************
+* Summary:
+*   Marks the start of an application interrupt handler.
+*
+* Parameters:
+*   trace_isr_t isr: Interrupt
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_isr_enter(trace_isr_t isr)
+{
+    trace_record(TRACE_ISR_ENTER, (uint8_t)isr, 0);
+}
+
+/*******************************************************************************
+* Function Name: app_trace_isr_exit()
+********************************************************************************
+* Summary:
+*   Marks the end of an application interrupt handler.
+*
+* Parameters:
+*   trace_isr_t isr: Interrupt
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_isr_exit(trace_isr_t isr)
+{
+    trace_record(TRACE_ISR_EXIT, (uint8_t)isr, 0);
+}
+
+/*******************************************************************************
+* Function Name: app_trace_span_begin()
+********************************************************************************
+* Summary:
+*   Marks the start of an application code span, such as a GATT event
+*   handler. Spans are shown on the track of the task that runs them.
+*
+* Parameters:
+*   trace_span_t span: Span
+*   uint32_t arg: Event handled in the span
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_span_begin(trace_span_t span, uint32_t arg)
+{
+    trace_record(TRACE_SPAN_BEGIN, (uint8_t)span, arg);
+}
+
+/*******************************************************************************
+* Function Name: app_trace_span_end()
+********************************************************************************
+* Summary:
+*   Marks the end of an application code span.
+*
+* Parameters:
+*   trace_span_t span: Span
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_span_end(trace_span_t span)
+{
+    trace_record(TRACE_SPAN_END, (uint8_t)span, 0);
+}
+
+/*******************************************************************************
+* Function Name: app_trace_name_queue()
+********************************************************************************
+* Summary:
+*   Gives a queue a name in the dump.
+*
+* Parameters:
+*   QueueHandle_t queue: Queue
+*   const char *p_name: Name, must stay valid
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_name_queue(QueueHandle_t queue, const char *p_name)
+{
+    uint8_t id = trace_queue_id(queue);
+
+    if (0u != id)
+    {
+        trace_queue_name[id - 1u] = p_name;
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_trace_dump()
+********************************************************************************
+* Summary:
+*   Prints the recorded events, oldest first, and starts a new recording.
+*   Recording stops during the dump. With APP_UART_TX_POLICY_DROP it is
+*   paced so that the UART buffer does not drop lines. The caller blocks for the duration of the dump.
+*
+*   TRACE begin <CPU clock Hz> <events> <events overwritten>
+*   TRACE task <id> <name>
+*   TRACE queue <id> <name>
+*   TRACE data <up to 8 events in hex>
+*   TRACE end
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_trace_dump(void)
+{
+    static const char hex[] = "0123456789abcdef";
+    char line[(TRACE_EVENTS_PER_LINE * TRACE_EVENT_LEN * 2u) + 1u];
+    uint8_t bytes[TRACE_EVENT_LEN];
+    const trace_event_t *p_event;
+    uint32_t count;
+    uint32_t first;
+    uint32_t index;
+    uint32_t pos = 0;
+    uint32_t byte;
+
+    trace_running = false;
+    count = (trace_head < TRACE_RING_EVENTS) ? trace_head : TRACE_RING_EVENTS;
+    first = trace_head - count;
+
+    printf("TRACE begin %lu %lu %lu\n", (unsigned long)SystemCoreClock,
+           (unsigned long)count, (unsigned long)first);
+    for (index = 0; index < trace_task_count; index++)
+    {
+        printf("TRACE task %lu %s\n", (unsigned long)(index + 1u),
+               pcTaskGetName(trace_task[index]));
+    }
+    for (index = 0; index < trace_queue_count; index++)
+    {
+        printf("TRACE queue %lu %s\n", (unsigned long)(index + 1u),
+               (NULL != trace_queue_name[index]) ? trace_queue_name[index] : "queue");
+    }
+
+    for (index = 0; index < count; index++)
+    {
+        p_event = &trace_ring[(first + index) & TRACE_RING_MASK];
+        bytes[0] = (uint8_t)(p_event->cycles);
+        bytes[1] = (uint8_t)(p_event->cycles >> 8);
+        bytes[2] = (uint8_t)(p_event->cycles >> 16);
+        bytes[3] = (uint8_t)(p_event->cycles >> 24);
+        bytes[4] = p_event->type;
+        bytes[5] = p_event->id;
+        bytes[6] = (uint8_t)(p_event->arg);
+        bytes[7] = (uint8_t)(p_event->arg >> 8);
+        for (byte = 0; byte < TRACE_EVENT_LEN; byte++)
+        {
+            line[pos++] = hex[bytes[byte] >> 4];
+            line[pos++] = hex[bytes[byte] & 0x0Fu];
+        }
+        if ((pos == (sizeof(line) - 1u)) || ((index + 1u) == count))
+        {
+            line[pos] = '\0';
+            printf("TRACE data %s\n", line);
+            pos = 0;
+#if (ENABLE_UART_TX_ASYNC) && (APP_UART_TX_POLICY_DROP == APP_UART_TX_POLICY)
+            vTaskDelay(pdMS_TO_TICKS(TRACE_DUMP_LINE_DELAY_MS));
+#endif
+        }
+    }
+    printf("TRACE end\n");
+
+    trace_head = 0;
+    trace_running = true;
+}
+
+#endif /* ENABLE_TRACE_RECORDER */
+
+/* [] END OF FILE */
@@ -0,0 +1,136 @@
+/******************************************************************************
+* File Name: app_trace.h
+*
+* Description: This file contains macros, enumerations and function prototypes
+*              used in app_trace.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_TRACE_H__
+#define __APP_TRACE_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <FreeRTOS.h>
+#include <queue.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 1 (DEFINES+=ENABLE_TRACE_RECORDER=1, so that FreeRTOSConfig.h sees
+ * it) to record task switches, queue operations, interrupts and GATT event
+ * handlers into a ring. Convert the dump with tools/cts_trace_to_json.py */
+#ifndef ENABLE_TRACE_RECORDER
+#define ENABLE_TRACE_RECORDER           (0u)
+#endif
+
+/* Events kept in the ring, a power of two. The oldest are overwritten */
+#ifndef TRACE_RING_EVENTS
+#define TRACE_RING_EVENTS               (512u)
+#endif
+
+/* Tasks and queues that get an id, the others share id 0 */
+#define TRACE_MAX_TASKS                 (15u)
+#define TRACE_MAX_QUEUES                (15u)
+
+/* Pause after each dump line so the UART buffer drains, only needed with
+ * APP_UART_TX_POLICY_DROP */
+#ifndef TRACE_DUMP_LINE_DELAY_MS
+#define TRACE_DUMP_LINE_DELAY_MS        (20u)
+#endif
+
+/*******************************************************************************
+*        Enumerations
+*******************************************************************************/
+/* Event types. An event is: cycle count (4), type (1), id (1) and argument
+ * (2), little endian */
+typedef enum
+{
+    TRACE_TASK_IN       = 0x01,     /* id: task */
+    TRACE_TASK_OUT      = 0x02,     /* id: task */
+    TRACE_QUEUE_SEND    = 0x03,     /* id: queue, arg: messages waiting */
+    TRACE_QUEUE_SEND_ISR = 0x04,    /* id: queue, arg: messages waiting */
+    TRACE_QUEUE_RECEIVE = 0x05,     /* id: queue, arg: messages waiting */
+    TRACE_QUEUE_BLOCK   = 0x06,     /* id: queue, arg: 0 receive, 1 send */
+    TRACE_ISR_ENTER     = 0x07,     /* id: trace_isr_t */
+    TRACE_ISR_EXIT      = 0x08,     /* id: trace_isr_t */
+    TRACE_SPAN_BEGIN    = 0x09,     /* id: trace_span_t, arg: event */
+    TRACE_SPAN_END      = 0x0A,     /* id: trace_span_t */
+} trace_event_type_t;
+
+/* Interrupts of the application */
+typedef enum
+{
+    TRACE_ISR_BUTTON    = 0x01,
+} trace_isr_t;
+
+/* Application code spans */
+typedef enum
+{
+    TRACE_SPAN_GATT_CALLBACK = 0x01,    /* arg: wiced_bt_gatt_evt_t */
+    TRACE_SPAN_MGMT_CALLBACK = 0x02,    /* arg: wiced_bt_management_evt_t */
+    TRACE_SPAN_APP_EVENT     = 0x03,    /* arg: app_event_type_t */
+} trace_span_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/* FreeRTOS trace hooks, called through the macros in FreeRTOSConfig.h */
+void app_trace_task_switched_in(void *p_task);
+void app_trace_task_switched_out(void *p_task);
+void app_trace_queue_send(void *p_queue, uint32_t waiting);
+void app_trace_queue_send_from_isr(void *p_queue, uint32_t waiting);
+void app_trace_queue_receive(void *p_queue, uint32_t waiting);
+void app_trace_queue_block(void *p_queue, uint32_t send);
+
+/* Application events */
+void app_trace_isr_enter(trace_isr_t isr);
+void app_trace_isr_exit(trace_isr_t isr);
+void app_trace_span_begin(trace_span_t span, uint32_t arg);
+void app_trace_span_end(trace_span_t span);
+
+/* Names a queue in the dump */
+void app_trace_name_queue(QueueHandle_t queue, const char *p_name);
+
+/* Prints the ring as TRACE lines and starts a new recording */
+void app_trace_dump(void);
+
+#endif      /* __APP_TRACE_H__ */
+
+/* [] END OF FILE */
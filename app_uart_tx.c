@@ -0,0 +1,402 @@
+/******************************************************************************
+* File Name: app_uart_tx.c
+*
+* Description: This file implements a non-blocking transmit path for the
+*              debug UART. Output is appended to one of two buffers while
+*              the other one is sent with cyhal_uart_write_async(), using
+*              DMA where the HAL supports it. The GCC _write() of
+*              retarget-io is replaced, so printf() returns without
+*              waiting for the UART.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_uart_tx.h"
+#include "app_bt_utils.h"
+#include "app_cmd.h"
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#include <stdio.h>
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static uint8_t             tx_buf[2][APP_UART_TX_BUF_SIZE];
+static uint32_t            tx_fill_len;         /* Bytes in the fill buffer */
+static uint8_t             tx_fill;             /* Index of the fill buffer */
+static volatile bool       tx_active;
+static bool                tx_ready;
+static app_uart_tx_stats_t tx_stats;
+static SemaphoreHandle_t   tx_space_sem;
+static StaticSemaphore_t   tx_space_sem_buf;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void tx_start_locked(void);
+static void tx_event_callback(void *callback_arg, cyhal_uart_event_t event);
+static bool tx_can_block(void);
+
+/*******************************************************************************
+* Function Name: app_uart_tx_init()
+********************************************************************************
+* Summary:
+*   Switches the retarget-io UART to asynchronous transmission. DMA is used if
+*   available, otherwise the transmit interrupt. Must be called after
+*   cy_retarget_io_init(). Until then output is sent blocking.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_uart_tx_init(void)
+{
+    if (CY_RSLT_SUCCESS != cyhal_uart_set_async_mode(&cy_retarget_io_uart_obj,
+                                                     CYHAL_ASYNC_DMA,
+                                                     APP_UART_TX_INTR_PRIORITY))
+    {
+        cyhal_uart_set_async_mode(&cy_retarget_io_uart_obj, CYHAL_ASYNC_SW,
+                                  APP_UART_TX_INTR_PRIORITY);
+    }
+    tx_space_sem = xSemaphoreCreateBinaryStatic(&tx_space_sem_buf);
+    cyhal_uart_register_callback(&cy_retarget_io_uart_obj, tx_event_callback, NULL);
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_TX_DONE,
+                            APP_UART_TX_INTR_PRIORITY, true);
+    tx_ready = true;
+}
+
+/*******************************************************************************
+* Function Name: app_uart_tx_write()
+********************************************************************************
+* Summary:
+*   Queues data for transmission. A write that fits in the free buffer space
+*   is queued as a whole, so binary frames are never split by a drop. If it
+*   does not fit, the data is dropped or the caller waits for the current
+*   transmission to finish, see APP_UART_TX_POLICY. Writes from interrupts,
+*   from tasks above APP_UART_TX_BLOCK_MAX_PRIORITY or before the scheduler
+*   runs never wait.
+*
+* Parameters:
+*   const uint8_t *p_data: Data to send
+*   uint32_t len: Number of bytes
+*   bool convert_lf: Send "\r\n" for every '\n'
+*
+* Return:
+*   uint32_t: Number of bytes queued (before LF conversion)
+*
+*******************************************************************************/
+uint32_t app_uart_tx_write(const uint8_t *p_data, uint32_t len, bool convert_lf)
+{
+    uint32_t start = cycle_counter_get();
+    uint32_t written = 0;
+    uint32_t needed;
+    uint32_t space;
+    uint32_t index;
+    uint32_t stall_us;
+    uint32_t blocked = 0;
+    uint32_t saved;
+
+    while (written < len)
+    {
+        needed = len - written;
+        if (convert_lf)
+        {
+            for (index = written; index < len; index++)
+            {
+                needed += ('\n' == p_data[index]) ? 1u : 0u;
+            }
+        }
+
+        saved = Cy_SysLib_EnterCriticalSection();
+        space = APP_UART_TX_BUF_SIZE - tx_fill_len;
+        if ((needed <= space) || ((needed > APP_UART_TX_BUF_SIZE) && (space >= 2u)))
+        {
+            /* Copy all of it, or as much as fits if it never fits at once */
+            while (written < len)
+            {
+                if ((convert_lf) && ('\n' == p_data[written]))
+                {
+                    if (space < 2u)
+                    {
+                        break;
+                    }
+                    tx_buf[tx_fill][tx_fill_len++] = '\r';
+                    space--;
+                }
+                else if (0u == space)
+                {
+                    break;
+                }
+                tx_buf[tx_fill][tx_fill_len++] = p_data[written++];
+                space--;
+            }
+            tx_start_locked();
+            Cy_SysLib_ExitCriticalSection(saved);
+            continue;
+        }
+        tx_start_locked();
+        Cy_SysLib_ExitCriticalSection(saved);
+
+        if ((APP_UART_TX_POLICY_DROP == APP_UART_TX_POLICY) || (!tx_can_block()) ||
+            (pdTRUE != xSemaphoreTake(tx_space_sem,
+                                      pdMS_TO_TICKS(APP_UART_TX_BLOCK_TIMEOUT_MS))))
+        {
+            break;
+        }
+        blocked++;
+    }
+
+    stall_us = CYCLES_TO_US(cycle_counter_get() - start);
+    saved = Cy_SysLib_EnterCriticalSection();
+    tx_stats.writes++;
+    tx_stats.bytes += written;
+    tx_stats.dropped += len - written;
+    tx_stats.blocked += blocked;
+    tx_stats.total_stall_us += stall_us;
+    if (stall_us > tx_stats.max_stall_us)
+    {
+        tx_stats.max_stall_us = stall_us;
+    }
+    Cy_SysLib_ExitCriticalSection(saved);
+    return written;
+}
+
+/*******************************************************************************
+* Function Name: app_uart_tx_get_stats()
+********************************************************************************
+* Summary:
+*   Returns the transmit statistics.
+*
+* Parameters:
+*   app_uart_tx_stats_t *p_stats: Statistics
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_uart_tx_get_stats(app_uart_tx_stats_t *p_stats)
+{
+    uint32_t saved = Cy_SysLib_EnterCriticalSection();
+    *p_stats = tx_stats;
+    Cy_SysLib_ExitCriticalSection(saved);
+}
+
+/*******************************************************************************
+* Function Name: app_uart_tx_print_stats()
+********************************************************************************
+* Summary:
+*   Prints the number of writes, the stall time per write and the bytes
+*   dropped.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void app_uart_tx_print_stats(void)
+{
+    app_uart_tx_stats_t stats;
+
+    app_uart_tx_get_stats(&stats);
+    printf("UART: %lu writes, stall avg %lu us max %lu us, %lu waits, %lu bytes dropped\n",
+           (unsigned long)stats.writes,
+           (unsigned long)((0 != stats.writes) ? (stats.total_stall_us / stats.writes) : 0u),
+           (unsigned long)stats.max_stall_us, (unsigned long)stats.blocked,
+           (unsigned long)stats.dropped);
+}
+
+/*******************************************************************************
+* Function Name: tx_start_locked()
+********************************************************************************
+* Summary:
+*   Starts sending the fill buffer if the UART is idle. The buffers swap, so
+*   new output goes to the other buffer. Called with interrupts locked.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void tx_start_locked(void)
+{
+    uint8_t drain;
+    uint32_t len;
+
+    if ((!tx_ready) || (tx_active) || (0 == tx_fill_len))
+    {
+        return;
+    }
+
+    drain = tx_fill;
+    len = tx_fill_len;
+    tx_fill ^= 1u;
+    tx_fill_len = 0;
+    tx_active = true;
+    if (CY_RSLT_SUCCESS != cyhal_uart_write_async(&cy_retarget_io_uart_obj,
+                                                  tx_buf[drain], len))
+    {
+        tx_active = false;
+        tx_stats.dropped += len;
+    }
+}
+
+/*******************************************************************************
+* Function Name: tx_event_callback()
+********************************************************************************
+* Summary:
+*   UART event handler. When a transmission is done the other buffer is sent
+*   and a writer waiting for space is released. Received data is passed to
+*   the command interface.
+*
+* Parameters:
+*   void *callback_arg: Not used
+*   cyhal_uart_event_t event: UART events
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void tx_event_callback(void *callback_arg, cyhal_uart_event_t event)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    uint32_t saved;
+
+#if (ENABLE_UART_COMMANDS)
+    /* The HAL has one event handler per UART */
+    if (0 != (event & CYHAL_UART_IRQ_RX_NOT_EMPTY))
+    {
+        app_cmd_rx_isr();
+    }
+#endif
+    if (0 == (event & CYHAL_UART_IRQ_TX_DONE))
+    {
+        return;
+    }
+
+    saved = Cy_SysLib_EnterCriticalSection();
+    tx_active = false;
+    tx_start_locked();
+    Cy_SysLib_ExitCriticalSection(saved);
+
+    xSemaphoreGiveFromISR(tx_space_sem, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/*******************************************************************************
+* Function Name: tx_can_block()
+********************************************************************************
+* Summary:
+*   Checks if the caller may wait for buffer space.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   bool: true in a task up to APP_UART_TX_BLOCK_MAX_PRIORITY with the
+*         scheduler running
+*
+*******************************************************************************/
+static bool tx_can_block(void)
+{
+    return (tx_ready) && (0u == __get_IPSR()) &&
+           (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) &&
+           (uxTaskPriorityGet(NULL) <= APP_UART_TX_BLOCK_MAX_PRIORITY);
+}
+
+#if (ENABLE_UART_TX_ASYNC) && defined(__GNUC__) && !defined(__ARMCC_VERSION)
+/*******************************************************************************
+* Function Name: _write()
+********************************************************************************
+* Summary:
+*   Replaces the weak newlib write hook of retarget-io. Output is queued for
+*   asynchronous transmission once app_uart_tx_init() was called, and sent
+*   blocking before that.
+*
+* Parameters:
+*   int fd: Not used
+*   const char *ptr: Data to write
+*   int len: Number of bytes
+*
+* Return:
+*   int: Number of bytes written
+*
+*******************************************************************************/
+int _write(int fd, const char *ptr, int len)
+{
+    int index;
+#if defined(CY_RETARGET_IO_CONVERT_LF_TO_CRLF)
+    const bool convert_lf = true;
+#else
+    const bool convert_lf = false;
+#endif
+
+    (void)fd;
+    if ((NULL == ptr) || (len <= 0))
+    {
+        return 0;
+    }
+
+    if (!tx_ready)
+    {
+        for (index = 0; index < len; index++)
+        {
+            if ((convert_lf) && ('\n' == ptr[index]))
+            {
+                cyhal_uart_putc(&cy_retarget_io_uart_obj, '\r');
+            }
+            cyhal_uart_putc(&cy_retarget_io_uart_obj, (uint8_t)ptr[index]);
+        }
+        return len;
+    }
+
+    app_uart_tx_write((const uint8_t *)ptr, (uint32_t)len, convert_lf);
+    return len;
+}
+#endif /* ENABLE_UART_TX_ASYNC */
+
+/* [] END OF FILE */
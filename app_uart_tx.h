@@ -0,0 +1,111 @@
+/******************************************************************************
+* File Name: app_uart_tx.h
+*
+* Description: This file contains macros, structures and function prototypes
+*              used in app_uart_tx.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_UART_TX_H__
+#define __APP_UART_TX_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 0 to keep the blocking transmit path of retarget-io */
+#ifndef ENABLE_UART_TX_ASYNC
+#define ENABLE_UART_TX_ASYNC            (1u)
+#endif
+
+/* Size of each of the two transmit buffers */
+#ifndef APP_UART_TX_BUF_SIZE
+#define APP_UART_TX_BUF_SIZE            (512u)
+#endif
+
+/* What a write does when the buffer is full. Writes from interrupts and
+ * from tasks above APP_UART_TX_BLOCK_MAX_PRIORITY always drop */
+#define APP_UART_TX_POLICY_DROP         (0u)
+#define APP_UART_TX_POLICY_BLOCK        (1u)
+#ifndef APP_UART_TX_POLICY
+#define APP_UART_TX_POLICY              (APP_UART_TX_POLICY_BLOCK)
+#endif
+
+/* Highest task priority that waits for buffer space. The default is the
+ * priority of the application task, so the Bluetooth stack thread and the
+ * timer task, which run above it, never wait for the UART */
+#ifndef APP_UART_TX_BLOCK_MAX_PRIORITY
+#define APP_UART_TX_BLOCK_MAX_PRIORITY  (configMAX_PRIORITIES - 3)
+#endif
+
+/* Longest wait for buffer space with APP_UART_TX_POLICY_BLOCK */
+#ifndef APP_UART_TX_BLOCK_TIMEOUT_MS
+#define APP_UART_TX_BLOCK_TIMEOUT_MS    (100u)
+#endif
+
+/* Interrupt priority of the UART and its DMA */
+#define APP_UART_TX_INTR_PRIORITY       (7u)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* Transmit statistics. Stall is the time a caller spent in a write */
+typedef struct
+{
+    uint32_t writes;
+    uint32_t bytes;
+    uint32_t dropped;               /* Bytes dropped, buffer full */
+    uint32_t blocked;               /* Waits for buffer space */
+    uint32_t max_stall_us;
+    uint64_t total_stall_us;
+} app_uart_tx_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+void     app_uart_tx_init(void);
+uint32_t app_uart_tx_write(const uint8_t *p_data, uint32_t len, bool convert_lf);
+void     app_uart_tx_get_stats(app_uart_tx_stats_t *p_stats);
+void     app_uart_tx_print_stats(void);
+
+#endif      /* __APP_UART_TX_H__ */
+
+/* [] END OF FILE */
@@ -115,6 +115,33 @@
 #define configTOTAL_HEAP_SIZE                   10240
 #define configAPPLICATION_ALLOCATED_HEAP        0
 
+/* Every heap allocation and free is reported to the application, which
+ * tracks the peak use of pvPortMalloc() and, in the zero-heap build profile
+ * (DEFINES+=ENABLE_ZERO_HEAP=1), asserts on late allocations, see
+ * app_heap.c */
+extern void app_heap_trace_malloc(void *p_block, size_t size);
+extern void app_heap_trace_free(void *p_block);
+#define traceMALLOC(pvAddress, uiSize)          app_heap_trace_malloc((pvAddress), (uiSize))
+#define traceFREE(pvAddress, uiSize)            app_heap_trace_free((pvAddress))
+
+/* Trace recorder (DEFINES+=ENABLE_TRACE_RECORDER=1): task switches and queue
+ * operations are recorded into a ring, see app_trace.c */
+#if defined(ENABLE_TRACE_RECORDER) && (ENABLE_TRACE_RECORDER)
+extern void app_trace_task_switched_in(void *p_task);
+extern void app_trace_task_switched_out(void *p_task);
+extern void app_trace_queue_send(void *p_queue, uint32_t waiting);
+extern void app_trace_queue_send_from_isr(void *p_queue, uint32_t waiting);
+extern void app_trace_queue_receive(void *p_queue, uint32_t waiting);
+extern void app_trace_queue_block(void *p_queue, uint32_t send);
+#define traceTASK_SWITCHED_IN()                 app_trace_task_switched_in((void *)pxCurrentTCB)
+#define traceTASK_SWITCHED_OUT()                app_trace_task_switched_out((void *)pxCurrentTCB)
+#define traceQUEUE_SEND(pxQueue)                app_trace_queue_send((void *)(pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)       app_trace_queue_send_from_isr((void *)(pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_RECEIVE(pxQueue)             app_trace_queue_receive((void *)(pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) app_trace_queue_block((void *)(pxQueue), 0)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)    app_trace_queue_block((void *)(pxQueue), 1)
+#endif
+
 /* Hook function related definitions. */
 #define configUSE_IDLE_HOOK                     0
 #define configUSE_TICK_HOOK                     0
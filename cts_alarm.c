@@ -0,0 +1,733 @@
+/******************************************************************************
+* File Name: cts_alarm.c
+*
+* Description: This file implements wall clock alarms on the fused CTS time.
+*              A hierarchical timing wheel keeps the alarms, so starting
+*              and cancelling an alarm take constant time. One FreeRTOS
+*              timer is set for the nearest deadline, and a step of the
+*              fused clock places the pending alarms again on the new time.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_alarm.h"
+#include <FreeRTOS.h>
+#include <timers.h>
+#include <stdio.h>
+#include <string.h>
+
+#if (ENABLE_CTS_ALARMS)
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define ALARM_SLOT_MASK                 (CTS_ALARM_SLOTS - 1u)
+#define ALARM_NONE                      (UINT64_MAX)
+#define MS_PER_SECOND                   (1000u)
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Slot lists of the wheel, one bit per non-empty slot, and the alarms that
+ * expired but were not handled yet */
+static cts_alarm_t *alarm_wheel[CTS_ALARM_LEVELS][CTS_ALARM_SLOTS];
+static uint64_t    alarm_bitmap[CTS_ALARM_LEVELS];
+static cts_alarm_t *alarm_due;
+
+/* Fused time the wheel has advanced to, and the fused offset seen then */
+static uint64_t    alarm_wheel_ms;
+static int64_t     alarm_offset_ms;
+static bool        alarm_synced;
+static uint32_t    alarm_count;
+
+/* Wakeup timer and the fused time it is set for */
+static TimerHandle_t      alarm_timer;
+static StaticTimer_t      alarm_timer_buffer;
+static uint64_t           alarm_armed_ms = ALARM_NONE;
+static cts_alarm_wakeup_t alarm_wakeup;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void alarm_timer_callback(TimerHandle_t timer);
+static bool alarm_sync(uint64_t *p_now_ms);
+static void alarm_link(cts_alarm_t *p_alarm);
+static void alarm_unlink(cts_alarm_t *p_alarm);
+static uint32_t alarm_next_distance(uint64_t bitmap, uint32_t digit, bool wrap);
+static bool alarm_next_boundary(uint32_t *p_level, uint64_t *p_boundary_ms);
+static void alarm_advance(uint64_t now_ms);
+static void alarm_rebuild(uint64_t now_ms);
+static void alarm_arm(uint64_t now_ms);
+
+/*******************************************************************************
+* Function Name: cts_alarm_init()
+********************************************************************************
+* Summary:
+*   Clears the wheel and creates the wakeup timer.
+*
+* Parameters:
+*   cts_alarm_wakeup_t wakeup: Requests a call of cts_alarm_process() in the
+*                              application task
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_alarm_init(cts_alarm_wakeup_t wakeup)
+{
+    memset(alarm_wheel, 0, sizeof(alarm_wheel));
+    memset(alarm_bitmap, 0, sizeof(alarm_bitmap));
+    alarm_due = NULL;
+    alarm_synced = false;
+    alarm_count = 0;
+    alarm_armed_ms = ALARM_NONE;
+    alarm_wakeup = wakeup;
+
+    if (NULL == alarm_timer)
+    {
+        alarm_timer = xTimerCreateStatic("alarm", 1, pdFALSE, NULL,
+                                         alarm_timer_callback, &alarm_timer_buffer);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cts_alarm_setup()
+********************************************************************************
+* Summary:
+*   Prepares an alarm before its first start.
+*
+* Parameters:
+*   cts_alarm_t *p_alarm: Alarm
+*   cts_alarm_callback_t callback: Called when the alarm expires
+*   void *p_arg: Passed to the callback in p_alarm->p_arg
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_alarm_setup(cts_alarm_t *p_alarm, cts_alarm_callback_t callback,
+                     void *p_arg)
+{
+    memset(p_alarm, 0, sizeof(*p_alarm));
+    p_alarm->callback = callback;
+    p_alarm->p_arg = p_arg;
+}
+
+/*******************************************************************************
+* Function Name: cts_alarm_start_at()
+********************************************************************************
+* Summary:
+*   Starts an alarm at a fused time, restarting it if it was started. Needs a
+*   fused time, see cts_fusion_get_time_ms(). A time in the past expires on
+*   the next cts_alarm_process().
+*
+* Parameters:
+*   cts_alarm_t *p_alarm: Alarm
+*   uint64_t expiry_ms: Fused time in milliseconds since 1970-01-01 00:00:00
+*   uint32_t period_ms: Period after the first expiry, 0 for a single alarm
+*
+* Return:
+*   bool: false if there is no fused time or the alarm is too far ahead
+*
+*******************************************************************************/
+bool cts_alarm_start_at(cts_alarm_t *p_alarm, uint64_t expiry_ms, uint32_t period_ms)
+{
+    uint64_t now_ms;
+
+    cts_alarm_cancel(p_alarm);
+
+    if ((NULL == p_alarm->callback) || (period_ms > CTS_ALARM_MAX_AHEAD_MS) ||
+        (!alarm_sync(&now_ms)))
+    {
+        return false;
+    }
+    alarm_advance(now_ms);
+    if ((expiry_ms > now_ms) && ((expiry_ms - now_ms) > CTS_ALARM_MAX_AHEAD_MS))
+    {
+        return false;
+    }
+
+    p_alarm->expiry_ms = expiry_ms;
+    p_alarm->period_ms = period_ms;
+    alarm_link(p_alarm);
+
+    if (expiry_ms < alarm_armed_ms)
+    {
+        alarm_arm(now_ms);
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: cts_alarm_start_daily()
+********************************************************************************
+* Summary:
+*   Starts an alarm at the next occurrence of a wall clock time, repeated
+*   every day. The offset to UTC is taken as given, restart the alarm when
+*   the time zone or DST of the server changes.
+*
+* Parameters:
+*   cts_alarm_t *p_alarm: Alarm
+*   uint32_t hours, minutes, seconds: Wall clock time
+*   int32_t utc_offset_s: Wall clock time minus UTC, see cts_local_time_t
+*
+* Return:
+*   bool: false if the time is invalid or there is no fused time
+*
+*******************************************************************************/
+bool cts_alarm_start_daily(cts_alarm_t *p_alarm, uint32_t hours, uint32_t minutes,
+                           uint32_t seconds, int32_t utc_offset_s)
+{
+    uint64_t now_ms;
+    int64_t  wall_ms;
+    uint32_t target_ms;
+    uint32_t ahead_ms;
+
+    if ((hours > 23u) || (minutes > 59u) || (seconds > 59u) || (!alarm_sync(&now_ms)))
+    {
+        return false;
+    }
+
+    wall_ms = (int64_t)now_ms + ((int64_t)utc_offset_s * MS_PER_SECOND);
+    target_ms = ((((hours * 60u) + minutes) * 60u) + seconds) * MS_PER_SECOND;
+    ahead_ms = (uint32_t)(((int64_t)target_ms + CTS_ALARM_MS_PER_DAY -
+                           (wall_ms % CTS_ALARM_MS_PER_DAY)) % CTS_ALARM_MS_PER_DAY);
+    if (0u == ahead_ms)
+    {
+        ahead_ms = CTS_ALARM_MS_PER_DAY;
+    }
+
+    return cts_alarm_start_at(p_alarm, now_ms + ahead_ms, CTS_ALARM_MS_PER_DAY);
+}
+
+/*******************************************************************************
+* Function Name: cts_alarm_cancel()
+********************************************************************************
+* Summary:
+*   Stops an alarm. The wakeup timer is left as it is, an early wakeup finds
+*   nothing to do.
+*
+* Parameters:
+*   cts_alarm_t *p_alarm: Alarm, started or not
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_alarm_cancel(cts_alarm_t *p_alarm)
+{
+    if (p_alarm->started)
+    {
+        alarm_unlink(p_alarm);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cts_alarm_process()
+********************************************************************************
+* Summary:
+*   Advances the wheel to the fused time, calls the callbacks of the expired
+*   alarms and sets the wakeup timer for the next one. Called on a wakeup and
+*   after each fused time update, so a clock step is seen early.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_alarm_process(void)
+{
+    cts_alarm_t *p_alarm;
+    uint64_t now_ms;
+    uint64_t periods;
+
+    if (!alarm_sync(&now_ms))
+    {
+        return;
+    }
+    alarm_advance(now_ms);
+
+    while (NULL != alarm_due)
+    {
+        p_alarm = alarm_due;
+        alarm_unlink(p_alarm);
+
+        /* Start the next period first, the callback may cancel it. Periods
+         * missed during a clock step are skipped */
+        if (0u != p_alarm->period_ms)
+        {
+            periods = (now_ms > p_alarm->expiry_ms) ?
+                      (((now_ms - p_alarm->expiry_ms) / p_alarm->period_ms) + 1u) : 1u;
+            p_alarm->expiry_ms += periods * p_alarm->period_ms;
+            alarm_link(p_alarm);
+        }
+        p_alarm->callback(p_alarm);
+    }
+
+    alarm_arm(now_ms);
+}
+
+/*******************************************************************************
+* Function Name: alarm_timer_callback()
+********************************************************************************
+* Summary:
+*   Wakeup timer expiry, runs in the FreeRTOS timer task.
+*
+* Parameters:
+*   TimerHandle_t timer: Not used
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void alarm_timer_callback(TimerHandle_t timer)
+{
+    (void)timer;
+
+    if (NULL != alarm_wakeup)
+    {
+        alarm_wakeup();
+    }
+}
+
+/*******************************************************************************
+* Function Name: alarm_sync()
+********************************************************************************
+* Summary:
+*   Reads the fused time. If the offset between fused and local time moved by
+*   more than CTS_ALARM_STEP_THRESHOLD_MS since the last call, the clock was
+*   stepped and the wheel is built again around the new time. Smaller moves
+*   are followed by the wheel as they come.
+*
+* Parameters:
+*   uint64_t *p_now_ms: Fused time
+*
+* Return:
+*   bool: false if there is no fused time
+*
+*******************************************************************************/
+static bool alarm_sync(uint64_t *p_now_ms)
+{
+    uint64_t local_ms = cts_fusion_local_ms();
+    int64_t  offset_ms;
+    int64_t  step_ms;
+
+    if (!cts_fusion_get_time_ms(local_ms, p_now_ms))
+    {
+        return false;
+    }
+
+    offset_ms = (int64_t)(*p_now_ms - local_ms);
+    if (!alarm_synced)
+    {
+        alarm_wheel_ms = *p_now_ms;
+        alarm_synced = true;
+    }
+    else
+    {
+        step_ms = offset_ms - alarm_offset_ms;
+        if ((step_ms > (int64_t)CTS_ALARM_STEP_THRESHOLD_MS) ||
+            (step_ms < -(int64_t)CTS_ALARM_STEP_THRESHOLD_MS))
+        {
+            printf("Alarm: clock step of %ld ms, %lu alarm(s) placed again\n",
+                   (long)step_ms, (unsigned long)alarm_count);
+            alarm_rebuild(*p_now_ms);
+        }
+    }
+    alarm_offset_ms = offset_ms;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: alarm_link()
+********************************************************************************
+* Summary:
+*   Adds an alarm to the wheel. The level is the highest 6-bit digit in which
+*   the expiry differs from the wheel time, the slot is that digit of the
+*   expiry. On the top level the slots wrap, as the expiry can be in the next
+*   turn of it. Expired alarms go to the due list.
+*
+* Parameters:
+*   cts_alarm_t *p_alarm: Alarm, not started
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void alarm_link(cts_alarm_t *p_alarm)
+{
+    cts_alarm_t **pp_head;
+    uint64_t key_ms = p_alarm->expiry_ms;
+    uint64_t diff;
+    uint32_t level = 0;
+
+    /* Alarms moved too far ahead by a backward clock step wait in the last
+     * slot of the top level, and are placed again when it is reached */
+    if (key_ms > (alarm_wheel_ms + CTS_ALARM_MAX_AHEAD_MS))
+    {
+        key_ms = alarm_wheel_ms + CTS_ALARM_MAX_AHEAD_MS;
+    }
+
+    if (key_ms <= alarm_wheel_ms)
+    {
+        p_alarm->level = CTS_ALARM_LEVELS;
+        p_alarm->slot = 0;
+        pp_head = &alarm_due;
+    }
+    else
+    {
+        diff = (key_ms ^ alarm_wheel_ms) >> CTS_ALARM_SLOT_BITS;
+        while ((0u != diff) && (level < (CTS_ALARM_LEVELS - 1u)))
+        {
+            diff >>= CTS_ALARM_SLOT_BITS;
+            level++;
+        }
+        p_alarm->level = (uint8_t)level;
+        p_alarm->slot = (uint8_t)((key_ms >> (CTS_ALARM_SLOT_BITS * level)) &
+                                  ALARM_SLOT_MASK);
+        pp_head = &alarm_wheel[level][p_alarm->slot];
+        alarm_bitmap[level] |= (1ull << p_alarm->slot);
+    }
+
+    p_alarm->p_prev = NULL;
+    p_alarm->p_next = *pp_head;
+    if (NULL != *pp_head)
+    {
+        (*pp_head)->p_prev = p_alarm;
+    }
+    *pp_head = p_alarm;
+    p_alarm->started = true;
+    alarm_count++;
+}
+
+/*******************************************************************************
+* Function Name: alarm_unlink()
+********************************************************************************
+* Summary:
+*   Removes an alarm from its slot or from the due list.
+*
+* Parameters:
+*   cts_alarm_t *p_alarm: Alarm, started
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void alarm_unlink(cts_alarm_t *p_alarm)
+{
+    cts_alarm_t **pp_head = (CTS_ALARM_LEVELS == p_alarm->level) ? &alarm_due :
+                            &alarm_wheel[p_alarm->level][p_alarm->slot];
+
+    if (NULL != p_alarm->p_prev)
+    {
+        p_alarm->p_prev->p_next = p_alarm->p_next;
+    }
+    else
+    {
+        *pp_head = p_alarm->p_next;
+    }
+    if (NULL != p_alarm->p_next)
+    {
+        p_alarm->p_next->p_prev = p_alarm->p_prev;
+    }
+    if ((NULL == *pp_head) && (CTS_ALARM_LEVELS != p_alarm->level))
+    {
+        alarm_bitmap[p_alarm->level] &= ~(1ull << p_alarm->slot);
+    }
+
+    p_alarm->p_next = NULL;
+    p_alarm->p_prev = NULL;
+    p_alarm->started = false;
+    alarm_count--;
+}
+
+/*******************************************************************************
+* Function Name: alarm_next_distance()
+********************************************************************************
+* Summary:
+*   Finds the first non-empty slot after the current digit of a level.
+*
+* Parameters:
+*   uint64_t bitmap: Non-empty slots of the level
+*   uint32_t digit: Digit of the wheel time on the level
+*   bool wrap: Search past slot 63 from slot 0 (top level)
+*
+* Return:
+*   uint32_t: Slots from the current one, 0 if there is none
+*
+*******************************************************************************/
+static uint32_t alarm_next_distance(uint64_t bitmap, uint32_t digit, bool wrap)
+{
+    uint64_t ahead;
+    uint32_t distance = 1;
+
+    /* Slots after the current one, moved down to bit 0 */
+    ahead = (ALARM_SLOT_MASK == digit) ? 0u : (bitmap >> (digit + 1u));
+    if (wrap)
+    {
+        /* Slots 0 to digit - 1 follow slot 63 */
+        ahead |= bitmap << (ALARM_SLOT_MASK - digit);
+        ahead &= ~(1ull << ALARM_SLOT_MASK);
+    }
+    if (0u == ahead)
+    {
+        return 0;
+    }
+
+#if defined(__GNUC__)
+    distance += (uint32_t)__builtin_ctzll(ahead);
+#else
+    while (0u == (ahead & 1u))
+    {
+        ahead >>= 1;
+        distance++;
+    }
+#endif
+    return distance;
+}
+
+/*******************************************************************************
+* Function Name: alarm_next_boundary()
+********************************************************************************
+* Summary:
+*   Finds the next time at which a slot of the wheel has to be handled. The
+*   lower levels always come first, so the first level with an occupied slot
+*   ahead gives the answer.
+*
+* Parameters:
+*   uint32_t *p_level: Level of the slot
+*   uint64_t *p_boundary_ms: Fused time at which the slot starts
+*
+* Return:
+*   bool: false if the wheel is empty
+*
+*******************************************************************************/
+static bool alarm_next_boundary(uint32_t *p_level, uint64_t *p_boundary_ms)
+{
+    uint32_t level;
+    uint32_t shift;
+    uint32_t distance;
+
+    for (level = 0; level < CTS_ALARM_LEVELS; level++)
+    {
+        if (0u == alarm_bitmap[level])
+        {
+            continue;
+        }
+        shift = CTS_ALARM_SLOT_BITS * level;
+        distance = alarm_next_distance(alarm_bitmap[level],
+                                       (uint32_t)(alarm_wheel_ms >> shift) & ALARM_SLOT_MASK,
+                                       (CTS_ALARM_LEVELS - 1u) == level);
+        if (0u != distance)
+        {
+            *p_level = level;
+            *p_boundary_ms = ((alarm_wheel_ms >> shift) + distance) << shift;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: alarm_advance()
+********************************************************************************
+* Summary:
+*   Moves the wheel time forward. Each occupied slot passed on the way is
+*   emptied and its alarms are added again: to a lower level, or to the due
+*   list from the lowest level. Empty slots are skipped using the bitmaps.
+*
+* Parameters:
+*   uint64_t now_ms: Fused time
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void alarm_advance(uint64_t now_ms)
+{
+    cts_alarm_t *p_alarm;
+    cts_alarm_t *p_next;
+    uint64_t boundary_ms;
+    uint32_t level;
+    uint32_t slot;
+
+    while (alarm_next_boundary(&level, &boundary_ms) && (boundary_ms <= now_ms))
+    {
+        alarm_wheel_ms = boundary_ms;
+        slot = (uint32_t)(boundary_ms >> (CTS_ALARM_SLOT_BITS * level)) & ALARM_SLOT_MASK;
+        p_alarm = alarm_wheel[level][slot];
+        alarm_wheel[level][slot] = NULL;
+        alarm_bitmap[level] &= ~(1ull << slot);
+
+        while (NULL != p_alarm)
+        {
+            p_next = p_alarm->p_next;
+            alarm_count--;
+            alarm_link(p_alarm);
+            p_alarm = p_next;
+        }
+    }
+
+    if (now_ms > alarm_wheel_ms)
+    {
+        alarm_wheel_ms = now_ms;
+    }
+}
+
+/*******************************************************************************
+* Function Name: alarm_rebuild()
+********************************************************************************
+* Summary:
+*   Adds all started alarms again around a new wheel time, after a clock step.
+*   Alarms passed by a forward step are due, a backward step moves them away.
+*
+* Parameters:
+*   uint64_t now_ms: Fused time after the step
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void alarm_rebuild(uint64_t now_ms)
+{
+    cts_alarm_t *p_list = alarm_due;
+    cts_alarm_t *p_alarm;
+    cts_alarm_t *p_next;
+    uint32_t level;
+    uint32_t slot;
+
+    /* Chain all alarms into one list */
+    for (level = 0; level < CTS_ALARM_LEVELS; level++)
+    {
+        for (slot = 0; (0u != alarm_bitmap[level]) && (slot < CTS_ALARM_SLOTS); slot++)
+        {
+            p_alarm = alarm_wheel[level][slot];
+            while (NULL != p_alarm)
+            {
+                p_next = p_alarm->p_next;
+                p_alarm->p_next = p_list;
+                p_list = p_alarm;
+                p_alarm = p_next;
+            }
+            alarm_wheel[level][slot] = NULL;
+            alarm_bitmap[level] &= ~(1ull << slot);
+        }
+    }
+
+    alarm_due = NULL;
+    alarm_count = 0;
+    alarm_wheel_ms = now_ms;
+    alarm_armed_ms = ALARM_NONE;
+
+    while (NULL != p_list)
+    {
+        p_next = p_list->p_next;
+        alarm_link(p_list);
+        p_list = p_next;
+    }
+}
+
+/*******************************************************************************
+* Function Name: alarm_arm()
+********************************************************************************
+* Summary:
+*   Sets the wakeup timer for the earliest alarm. Only the slot found by
+*   alarm_next_boundary() is searched for it, as all alarms in later slots
+*   expire after that slot starts.
+*
+* Parameters:
+*   uint64_t now_ms: Fused time
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void alarm_arm(uint64_t now_ms)
+{
+    cts_alarm_t *p_alarm;
+    uint64_t next_ms = ALARM_NONE;
+    uint64_t boundary_ms;
+    uint64_t sleep_ms;
+    TickType_t ticks;
+    uint32_t level;
+    uint32_t slot;
+
+    if (NULL != alarm_due)
+    {
+        next_ms = now_ms;
+    }
+    else if (alarm_next_boundary(&level, &boundary_ms))
+    {
+        slot = (uint32_t)(boundary_ms >> (CTS_ALARM_SLOT_BITS * level)) & ALARM_SLOT_MASK;
+        for (p_alarm = alarm_wheel[level][slot]; NULL != p_alarm; p_alarm = p_alarm->p_next)
+        {
+            if (p_alarm->expiry_ms < next_ms)
+            {
+                next_ms = p_alarm->expiry_ms;
+            }
+        }
+    }
+
+    alarm_armed_ms = next_ms;
+    if (NULL == alarm_timer)
+    {
+        return;
+    }
+    if (ALARM_NONE == next_ms)
+    {
+        (void)xTimerStop(alarm_timer, 0);
+        return;
+    }
+
+    sleep_ms = (next_ms > now_ms) ? (next_ms - now_ms) : 0u;
+    if (sleep_ms > CTS_ALARM_MAX_SLEEP_MS)
+    {
+        sleep_ms = CTS_ALARM_MAX_SLEEP_MS;
+        alarm_armed_ms = now_ms + sleep_ms;
+    }
+    /* Round up, the timer must not expire before the alarm */
+    ticks = (TickType_t)(((sleep_ms * configTICK_RATE_HZ) + (MS_PER_SECOND - 1u)) /
+                         MS_PER_SECOND);
+    (void)xTimerChangePeriod(alarm_timer, (0u == ticks) ? 1u : ticks, 0);
+}
+
+#endif /* ENABLE_CTS_ALARMS */
+
+/* [] END OF FILE */
@@ -0,0 +1,124 @@
+/******************************************************************************
+* File Name: cts_alarm.h
+*
+* Description: This file contains macros, structures and function prototypes
+*              used in cts_alarm.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __CTS_ALARM_H__
+#define __CTS_ALARM_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_time_fusion.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 0 to remove the wall clock alarms. They run on the fused time */
+#ifndef ENABLE_CTS_ALARMS
+#define ENABLE_CTS_ALARMS               (ENABLE_TIME_FUSION)
+#endif
+
+/* Timing wheel: CTS_ALARM_LEVELS levels of 64 slots, 1 ms per slot on the
+ * lowest level. Alarms can be set up to 63 slots of the top level ahead,
+ * 12.2 days with 5 levels */
+#define CTS_ALARM_LEVELS                (5u)
+#define CTS_ALARM_SLOT_BITS             (6u)
+#define CTS_ALARM_SLOTS                 (1u << CTS_ALARM_SLOT_BITS)
+#define CTS_ALARM_TOP_SHIFT             (CTS_ALARM_SLOT_BITS * (CTS_ALARM_LEVELS - 1u))
+#define CTS_ALARM_MAX_AHEAD_MS          (((uint64_t)CTS_ALARM_SLOTS - 1u) << CTS_ALARM_TOP_SHIFT)
+
+/* Longest time the wakeup timer is set for. The local clock drifts against
+ * the fused time, so far deadlines are converted again on the way */
+#ifndef CTS_ALARM_MAX_SLEEP_MS
+#define CTS_ALARM_MAX_SLEEP_MS          (60000u)
+#endif
+
+/* A change of the fused clock offset larger than this is a clock step, and
+ * the pending alarms are placed again on the new time */
+#ifndef CTS_ALARM_STEP_THRESHOLD_MS
+#define CTS_ALARM_STEP_THRESHOLD_MS     (500u)
+#endif
+
+#define CTS_ALARM_MS_PER_DAY            (86400000u)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+typedef struct cts_alarm cts_alarm_t;
+
+/* Called from cts_alarm_process() when an alarm expires. Periodic alarms
+ * are already started for the next period */
+typedef void (*cts_alarm_callback_t)(cts_alarm_t *p_alarm);
+
+/* An alarm. Owned by the caller, which must not change it while started.
+ * All functions below are called from the application task */
+struct cts_alarm
+{
+    cts_alarm_t          *p_next;           /* Slot list */
+    cts_alarm_t          *p_prev;
+    uint64_t             expiry_ms;         /* Fused time, ms since 1970-01-01 */
+    uint32_t             period_ms;         /* 0 for a single alarm */
+    uint8_t              level;             /* Position in the wheel */
+    uint8_t              slot;
+    bool                 started;
+    cts_alarm_callback_t callback;
+    void                 *p_arg;            /* For the callback */
+};
+
+/* Requests a call of cts_alarm_process(). Called from the timer task */
+typedef void (*cts_alarm_wakeup_t)(void);
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+void cts_alarm_init(cts_alarm_wakeup_t wakeup);
+void cts_alarm_setup(cts_alarm_t *p_alarm, cts_alarm_callback_t callback,
+                     void *p_arg);
+bool cts_alarm_start_at(cts_alarm_t *p_alarm, uint64_t expiry_ms, uint32_t period_ms);
+bool cts_alarm_start_daily(cts_alarm_t *p_alarm, uint32_t hours, uint32_t minutes,
+                           uint32_t seconds, int32_t utc_offset_s);
+void cts_alarm_cancel(cts_alarm_t *p_alarm);
+void cts_alarm_process(void);
+
+#endif      /* __CTS_ALARM_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,130 @@
+/******************************************************************************
+* File Name: cts_broadcast.c
+*
+* Description: This file builds and parses the advertising data that carries
+*              the Current Time of a broadcaster: a Service Data AD
+*              structure with the Current Time Service UUID and the 10-byte
+*              Current Time value, the same bytes a CTS server notifies. It
+*              has no Bluetooth stack dependency, so that the host
+*              simulation uses it unchanged.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_broadcast.h"
+#include <stddef.h>
+#include <string.h>
+
+/*******************************************************************************
+* Function Name: cts_broadcast_build()
+********************************************************************************
+* Summary:
+*   Writes the Service Data AD structure that carries a Current Time value.
+*
+* Parameters:
+*   const uint8_t *p_time: Current Time value, CTS_BROADCAST_TIME_LEN bytes
+*   uint8_t *p_buf: Advertising data buffer
+*   uint16_t size: Size of the buffer
+*
+* Return:
+*   uint16_t: Bytes written, 0 if the buffer is too small
+*
+*******************************************************************************/
+uint16_t cts_broadcast_build(const uint8_t *p_time, uint8_t *p_buf, uint16_t size)
+{
+    if ((NULL == p_time) || (NULL == p_buf) || (size < CTS_BROADCAST_AD_LEN))
+    {
+        return 0u;
+    }
+
+    p_buf[0] = (uint8_t)(CTS_BROADCAST_AD_LEN - 1u);
+    p_buf[1] = CTS_BROADCAST_AD_TYPE;
+    p_buf[2] = (uint8_t)(CTS_BROADCAST_UUID16 & 0xFFu);
+    p_buf[3] = (uint8_t)(CTS_BROADCAST_UUID16 >> 8u);
+    memcpy(&p_buf[4], p_time, CTS_BROADCAST_TIME_LEN);
+    return CTS_BROADCAST_AD_LEN;
+}
+
+/*******************************************************************************
+* Function Name: cts_broadcast_find_time()
+********************************************************************************
+* Summary:
+*   Walks the AD structures of advertising data for Service Data of the
+*   Current Time Service. A structure that runs past the end of the data
+*   ends the search.
+*
+* Parameters:
+*   const uint8_t *p_data: Advertising data
+*   uint16_t len: Length of the advertising data
+*   uint16_t *p_time_len: Length of the value found
+*
+* Return:
+*   const uint8_t*: Current Time value, NULL if there is none
+*
+*******************************************************************************/
+const uint8_t *cts_broadcast_find_time(const uint8_t *p_data, uint16_t len,
+                                       uint16_t *p_time_len)
+{
+    uint16_t offset = 0;
+    uint16_t ad_len;
+
+    if (NULL == p_data)
+    {
+        return NULL;
+    }
+
+    while ((offset + 1u) < len)
+    {
+        ad_len = p_data[offset];
+        if ((0u == ad_len) || ((offset + 1u + ad_len) > len))
+        {
+            break;
+        }
+        if ((CTS_BROADCAST_AD_TYPE == p_data[offset + 1u]) && (ad_len >= 3u) &&
+            (CTS_BROADCAST_UUID16 == (p_data[offset + 2u] |
+                                      ((uint16_t)p_data[offset + 3u] << 8u))))
+        {
+            *p_time_len = (uint16_t)(ad_len - 3u);
+            return &p_data[offset + 4u];
+        }
+        offset = (uint16_t)(offset + 1u + ad_len);
+    }
+    return NULL;
+}
+
+/* [] END OF FILE */
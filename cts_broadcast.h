@@ -0,0 +1,75 @@
+/******************************************************************************
+* File Name: cts_broadcast.h
+*
+* Description: This file contains macros and function prototypes used in
+*              cts_broadcast.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __CTS_BROADCAST_H__
+#define __CTS_BROADCAST_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* The time is carried as Service Data of the Current Time Service, the
+ * 16-bit UUID followed by the Current Time characteristic value */
+#define CTS_BROADCAST_AD_TYPE           (0x16u)
+#define CTS_BROADCAST_UUID16            (0x1805u)
+#define CTS_BROADCAST_TIME_LEN          (10u)
+
+/* Length, AD type, UUID and value */
+#define CTS_BROADCAST_AD_LEN            (2u + 2u + CTS_BROADCAST_TIME_LEN)
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/* Writes the Current Time Service Data AD structure, returns its length */
+uint16_t cts_broadcast_build(const uint8_t *p_time, uint8_t *p_buf, uint16_t size);
+
+/* Finds the Current Time value in advertising data, NULL if there is none */
+const uint8_t *cts_broadcast_find_time(const uint8_t *p_data, uint16_t len,
+                                       uint16_t *p_time_len);
+
+#endif      /* __CTS_BROADCAST_H__ */
+
+/* [] END OF FILE */
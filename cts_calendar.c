@@ -0,0 +1,300 @@
+/******************************************************************************
+* File Name: cts_calendar.c
+*
+* Description: This file converts between CTS dates and days since
+*              1970-01-01 without tables and with few branches, after the
+*              days_from_civil and civil_from_days algorithms of H. Hinnant.
+*              Years are shifted to start in March, so the leap day is the
+*              last day of a year, and counted in 400 year eras.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_calendar.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Days from 0000-03-01 to 1970-01-01 */
+#define DAYS_TO_EPOCH                   (719468)
+
+/* Days in a 400 year era */
+#define DAYS_PER_ERA                    (146097u)
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static char *format_digits(char *p_buf, uint32_t value, uint32_t digits);
+
+/*******************************************************************************
+* Function Name: cts_days_from_civil()
+********************************************************************************
+* Summary:
+*   Returns the number of days from 1970-01-01 to a date. Valid for years
+*   from 1 on; callers check the date with cts_calendar_check() first.
+*
+* Parameters:
+*   int32_t year: Year
+*   uint32_t month: Month, 1 to 12
+*   uint32_t day: Day of the month, 1 to 31
+*
+* Return:
+*   int32_t: Days since 1970-01-01, negative before it
+*
+*******************************************************************************/
+int32_t cts_days_from_civil(int32_t year, uint32_t month, uint32_t day)
+{
+    uint32_t y = (uint32_t)year - (month <= 2u);
+    uint32_t era = y / 400u;
+    uint32_t year_of_era = y - (era * 400u);
+    uint32_t day_of_year = (((153u * ((month + 9u) % 12u)) + 2u) / 5u) + day - 1u;
+    uint32_t day_of_era = (year_of_era * 365u) + (year_of_era / 4u) -
+                          (year_of_era / 100u) + day_of_year;
+
+    return (int32_t)((era * DAYS_PER_ERA) + day_of_era) - DAYS_TO_EPOCH;
+}
+
+/*******************************************************************************
+* Function Name: cts_civil_from_days()
+********************************************************************************
+* Summary:
+*   Returns the date a number of days after 1970-01-01. Valid from
+*   0000-03-01 on.
+*
+* Parameters:
+*   int32_t days: Days since 1970-01-01
+*   int32_t *p_year: Year
+*   uint32_t *p_month: Month, 1 to 12
+*   uint32_t *p_day: Day of the month, 1 to 31
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_civil_from_days(int32_t days, int32_t *p_year, uint32_t *p_month,
+                         uint32_t *p_day)
+{
+    uint32_t z = (uint32_t)(days + DAYS_TO_EPOCH);
+    uint32_t era = z / DAYS_PER_ERA;
+    uint32_t day_of_era = z - (era * DAYS_PER_ERA);
+    uint32_t year_of_era = (day_of_era - (day_of_era / 1460u) + (day_of_era / 36524u) -
+                            (day_of_era / 146096u)) / 365u;
+    uint32_t day_of_year = day_of_era - ((365u * year_of_era) + (year_of_era / 4u) -
+                                         (year_of_era / 100u));
+    uint32_t mp = ((5u * day_of_year) + 2u) / 153u;     /* March = 0 */
+    uint32_t month = mp + 3u - (12u * (mp >= 10u));
+
+    *p_day   = day_of_year - (((153u * mp) + 2u) / 5u) + 1u;
+    *p_month = month;
+    *p_year  = (int32_t)(year_of_era + (era * 400u) + (month <= 2u));
+}
+
+/*******************************************************************************
+* Function Name: cts_weekday_from_days()
+********************************************************************************
+* Summary:
+*   Returns the day of week of a number of days since 1970-01-01, a Thursday.
+*
+* Parameters:
+*   int32_t days: Days since 1970-01-01, from 0000-03-01 on
+*
+* Return:
+*   uint8_t: 1 = Monday to 7 = Sunday
+*
+*******************************************************************************/
+uint8_t cts_weekday_from_days(int32_t days)
+{
+    /* DAYS_TO_EPOCH + 2 is 3 modulo 7, Thursday is 4 */
+    return (uint8_t)((((uint32_t)(days + DAYS_TO_EPOCH) + 2u) % 7u) + 1u);
+}
+
+/*******************************************************************************
+* Function Name: cts_days_in_month()
+********************************************************************************
+* Summary:
+*   Returns the number of days of a month. Months alternate between 31 and 30
+*   days, with the phase changing after July.
+*
+* Parameters:
+*   int32_t year: Year
+*   uint32_t month: Month, 1 to 12
+*
+* Return:
+*   uint32_t: Days of the month
+*
+*******************************************************************************/
+uint32_t cts_days_in_month(int32_t year, uint32_t month)
+{
+    uint32_t leap = ((0 == (year & 3)) && ((0 != (year % 25)) || (0 == (year & 15))));
+
+    return (2u == month) ? (28u + leap) : (30u + ((month + (month >> 3)) & 1u));
+}
+
+/*******************************************************************************
+* Function Name: cts_calendar_check()
+********************************************************************************
+* Summary:
+*   Checks a CTS date. CTS uses 0 for an unknown year, month, day or day of
+*   week. A date with an unknown part cannot be converted, an unknown day of
+*   week is accepted.
+*
+* Parameters:
+*   int32_t year: Year, CTS_CALENDAR_YEAR_MIN to CTS_CALENDAR_YEAR_MAX
+*   uint32_t month: Month, 1 to 12
+*   uint32_t day: Day of the month
+*   uint32_t day_of_week: 1 = Monday to 7 = Sunday, 0 if unknown
+*
+* Return:
+*   cts_date_status_t: Result of the check
+*
+*******************************************************************************/
+cts_date_status_t cts_calendar_check(int32_t year, uint32_t month, uint32_t day,
+                                     uint32_t day_of_week)
+{
+    if ((0 == year) || (0u == month) || (0u == day))
+    {
+        return CTS_DATE_UNKNOWN;
+    }
+    if ((year < CTS_CALENDAR_YEAR_MIN) || (year > CTS_CALENDAR_YEAR_MAX) ||
+        (month > 12u) || (day > cts_days_in_month(year, month)) ||
+        (day_of_week > 7u))
+    {
+        return CTS_DATE_INVALID;
+    }
+    if ((0u != day_of_week) &&
+        (day_of_week != cts_weekday_from_days(cts_days_from_civil(year, month, day))))
+    {
+        return CTS_DATE_WEEKDAY_MISMATCH;
+    }
+    return CTS_DATE_VALID;
+}
+
+/*******************************************************************************
+* Function Name: cts_calendar_to_epoch_s()
+********************************************************************************
+* Summary:
+*   Returns the seconds since 1970-01-01 of a date and time.
+*
+* Parameters:
+*   int32_t year, uint32_t month, uint32_t day: Checked date
+*   uint32_t hours, uint32_t minutes, uint32_t seconds: Time of day
+*
+* Return:
+*   int64_t: Seconds since 1970-01-01
+*
+*******************************************************************************/
+int64_t cts_calendar_to_epoch_s(int32_t year, uint32_t month, uint32_t day,
+                                uint32_t hours, uint32_t minutes, uint32_t seconds)
+{
+    return ((int64_t)cts_days_from_civil(year, month, day) * CTS_CALENDAR_SECONDS_PER_DAY) +
+           (int64_t)((hours * 3600u) + (minutes * 60u) + seconds);
+}
+
+/*******************************************************************************
+* Function Name: cts_calendar_format_iso8601()
+********************************************************************************
+* Summary:
+*   Writes a time as "YYYY-MM-DDTHH:MM:SS", without printf.
+*
+* Parameters:
+*   int64_t epoch_s: Seconds since 1970-01-01, years 0 to 9999
+*   char *p_buf: Buffer of CTS_CALENDAR_ISO8601_LEN bytes
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_calendar_format_iso8601(int64_t epoch_s, char *p_buf)
+{
+    int64_t days = epoch_s / CTS_CALENDAR_SECONDS_PER_DAY;
+    int32_t day_s = (int32_t)(epoch_s - (days * CTS_CALENDAR_SECONDS_PER_DAY));
+    int32_t year;
+    uint32_t month;
+    uint32_t day;
+
+    /* Division truncates towards zero, the time of day must not be negative */
+    if (day_s < 0)
+    {
+        day_s += CTS_CALENDAR_SECONDS_PER_DAY;
+        days--;
+    }
+    cts_civil_from_days((int32_t)days, &year, &month, &day);
+
+    p_buf = format_digits(p_buf, (uint32_t)year, 4u);
+    *p_buf++ = '-';
+    p_buf = format_digits(p_buf, month, 2u);
+    *p_buf++ = '-';
+    p_buf = format_digits(p_buf, day, 2u);
+    *p_buf++ = 'T';
+    p_buf = format_digits(p_buf, (uint32_t)day_s / 3600u, 2u);
+    *p_buf++ = ':';
+    p_buf = format_digits(p_buf, ((uint32_t)day_s / 60u) % 60u, 2u);
+    *p_buf++ = ':';
+    p_buf = format_digits(p_buf, (uint32_t)day_s % 60u, 2u);
+    *p_buf = '\0';
+}
+
+/*******************************************************************************
+* Function Name: format_digits()
+********************************************************************************
+* Summary:
+*   Writes a number with a fixed number of decimal digits, zero padded.
+*
+* Parameters:
+*   char *p_buf: Output
+*   uint32_t value: Number
+*   uint32_t digits: Digits to write
+*
+* Return:
+*   char*: Position after the digits
+*
+*******************************************************************************/
+static char *format_digits(char *p_buf, uint32_t value, uint32_t digits)
+{
+    uint32_t index = digits;
+
+    while (index > 0u)
+    {
+        index--;
+        p_buf[index] = (char)('0' + (value % 10u));
+        value /= 10u;
+    }
+    return p_buf + digits;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,103 @@
+/******************************************************************************
+* File Name: cts_calendar.h
+*
+* Description: This file contains macros, enumerations and function prototypes
+*              used in cts_calendar.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __CTS_CALENDAR_H__
+#define __CTS_CALENDAR_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Years a CTS date may have. Dates are in the proleptic Gregorian calendar */
+#define CTS_CALENDAR_YEAR_MIN           (1582)
+#define CTS_CALENDAR_YEAR_MAX           (9999)
+
+/* Buffer size for "YYYY-MM-DDTHH:MM:SS" and the terminating zero */
+#define CTS_CALENDAR_ISO8601_LEN        (20u)
+
+#define CTS_CALENDAR_SECONDS_PER_DAY    (86400)
+
+/*******************************************************************************
+*        Enumerations
+*******************************************************************************/
+/* Result of checking a CTS date */
+typedef enum
+{
+    CTS_DATE_VALID,
+    CTS_DATE_UNKNOWN,               /* Year, month or day is 0 (unknown) */
+    CTS_DATE_INVALID,               /* Out of range or not a calendar date */
+    CTS_DATE_WEEKDAY_MISMATCH,      /* Day of week does not match the date */
+} cts_date_status_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/* Days since 1970-01-01 of a date in the supported range */
+int32_t cts_days_from_civil(int32_t year, uint32_t month, uint32_t day);
+
+/* Date of a number of days since 1970-01-01 */
+void cts_civil_from_days(int32_t days, int32_t *p_year, uint32_t *p_month,
+                         uint32_t *p_day);
+
+/* Day of week in the CTS encoding, 1 = Monday to 7 = Sunday */
+uint8_t cts_weekday_from_days(int32_t days);
+
+uint32_t cts_days_in_month(int32_t year, uint32_t month);
+
+/* Checks a CTS date. A day_of_week of 0 (unknown) is not checked */
+cts_date_status_t cts_calendar_check(int32_t year, uint32_t month, uint32_t day,
+                                     uint32_t day_of_week);
+
+/* Seconds since 1970-01-01 of a checked date and time */
+int64_t cts_calendar_to_epoch_s(int32_t year, uint32_t month, uint32_t day,
+                                uint32_t hours, uint32_t minutes, uint32_t seconds);
+
+/* Writes "YYYY-MM-DDTHH:MM:SS" to a buffer of CTS_CALENDAR_ISO8601_LEN */
+void cts_calendar_format_iso8601(int64_t epoch_s, char *p_buf);
+
+#endif      /* __CTS_CALENDAR_H__ */
+
+/* [] END OF FILE */
@@ -58,18 +58,83 @@
 #include "wiced_bt_dev.h"
 #include "app_bt_utils.h"
 #include "cts_client.h"
+#include "app_bt_bonding.h"
+#include "app_bt_scan.h"
+#include "app_bt_adv.h"
+#include "app_bt_pa_sync.h"
+#include "app_cts_server.h"
+#include "cts_time_fusion.h"
+#include "cts_alarm.h"
+#include "cts_calendar.h"
+#include "cts_time_history.h"
+#include "app_bin_log.h"
+#include "app_uart_tx.h"
+#include "app_heap.h"
+#include "app_latency.h"
+#include "app_trace.h"
+#include "app_metrics.h"
+#include "app_cmd.h"
 #include <stdlib.h>
+#include <string.h>
 #include "wiced_bt_uuid.h"
 #include "wiced_bt_types.h"
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define DISC_CHARS(chars)               (chars), (uint8_t)(sizeof(chars) / sizeof((chars)[0]))
+
+/* Position of CTS in discovery_table */
+#define DISCOVERY_TABLE_CTS             (0u)
+
+/* In peripheral mode every link is connected by the remote device, so with
+ * the CTS server the discovery tells a time source from a peer */
+#define CTS_SOURCE_BY_DISCOVERY         ((ENABLE_CTS_SERVER) && !(ENABLE_CENTRAL_MODE))
+
 /*******************************************************************************
 *        Variable Definitions
 *******************************************************************************/
-static uint16_t                    bt_connection_id = 0;
+static cts_conn_t                  cts_conn[CTS_TIME_SOURCES];
 static current_time_data_t         time_date_notif;
-static cts_discovery_data_t        cts_discovery_data;
-static bool                        notify_val = false;
 static bool                        button_press_for_adv = true;
 
+/* Time spent in the GATT callback and events lost on a full queue: time
+ * values that were dropped and other events that were lost */
+static uint32_t                    callback_count;
+static uint32_t                    callback_max_us;
+static uint64_t                    callback_total_us;
+static uint32_t                    app_event_dropped;
+static uint32_t                    app_event_lost;
+
+/* Services, characteristics and descriptors discovered on each server */
+static const app_bt_disc_char_t cts_disc_chars[] =
+{
+    { UUID_CHARACTERISTIC_CURRENT_TIME,               APP_BT_DISC_DESC_CCCD },
+    { UUID_CHARACTERISTIC_LOCAL_TIME_INFORMATION,     0 },
+    { UUID_CHARACTERISTIC_REFERENCE_TIME_INFORMATION, 0 },
+};
+static const app_bt_disc_char_t bas_disc_chars[] =
+{
+    { UUID_CHARACTERISTIC_BATTERY_LEVEL,              APP_BT_DISC_DESC_CCCD },
+};
+static const app_bt_disc_char_t dis_disc_chars[] =
+{
+    { UUID_CHARACTERISTIC_MANUFACTURER_NAME_STRING,   0 },
+    { UUID_CHARACTERISTIC_MODEL_NUMBER_STRING,        0 },
+    { UUID_CHARACTERISTIC_FIRMWARE_REVISION_STRING,   0 },
+};
+static const app_bt_disc_char_t gatt_disc_chars[] =
+{
+    { UUID_CHARACTERISTIC_SERVICE_CHANGED,            APP_BT_DISC_DESC_CCCD },
+    { UUID_CHARACTERISTIC_DATABASE_HASH,              0 },
+};
+static const app_bt_disc_service_t discovery_table[] =
+{
+    { UUID_SERVICE_CURRENT_TIME,       DISC_CHARS(cts_disc_chars) },
+    { UUID_SERVICE_BATTERY,            DISC_CHARS(bas_disc_chars) },
+    { UUID_SERVICE_DEVICE_INFORMATION, DISC_CHARS(dis_disc_chars) },
+    { UUID_SERVICE_GATT,               DISC_CHARS(gatt_disc_chars) },
+};
+
 /* Array to hold strings for names of days of the week */
 const char* day_of_week_str[]=
 {
@@ -87,17 +152,101 @@ const char* day_of_week_str[]=
 *        Function Prototypes
 *******************************************************************************/
 static void ble_app_init(void);
-static void print_notification_data(wiced_bt_gatt_data_t notif_data);
+static void print_notification_data(cts_conn_t *p_conn, wiced_bt_gatt_data_t notif_data,
+                                    uint64_t arrival_us);
 const  char* get_day_of_week(uint8_t day);
 static void button_interrupt_handler(void *handler_arg, cyhal_gpio_event_t event);
-static wiced_bt_gatt_status_t ble_app_write_notification_cccd(bool notify);
+static void ble_app_button_handler(const app_event_t *p_event);
+static bool ble_app_advertise(bool start);
+static uint32_t ble_app_set_notifications(bool notify);
+#if (ENABLE_UART_COMMANDS)
+static void ble_app_command_handler(const app_event_t *p_event);
+#endif
+static void app_event_post(const app_event_t *p_event);
+#if (ENABLE_APP_EVENT_QUEUE)
+static bool app_event_droppable(const app_event_t *p_event);
+#endif
+static void app_event_handle(const app_event_t *p_event);
+static bool ble_app_copy_discovery_result(wiced_bt_gatt_discovery_result_t *p_result,
+                                          app_event_t *p_event);
+static void ble_app_operation_handler(const app_event_t *p_event);
+static void ble_app_print_callback_stats(void);
+static wiced_bt_gatt_status_t ble_app_write_notification_cccd(cts_conn_t *p_conn,
+                                                              bool notify);
+static wiced_bt_gatt_status_t ble_app_start_cts_discovery(cts_conn_t *p_conn);
+static void ble_app_report_cts_ready(cts_conn_t *p_conn, bool from_bond);
+static void ble_app_read_time_info(cts_conn_t *p_conn);
+static void ble_app_time_value_handler(cts_conn_t *p_conn, wiced_bt_gatt_data_t *p_value,
+                                       uint64_t arrival_us, bool from_read);
+#if (ENABLE_CURRENT_TIME_READ)
+static bool ble_app_read_current_time(cts_conn_t *p_conn);
+#endif
+static bool ble_app_sample_to_utc(cts_conn_t *p_conn, const current_time_data_t *p_time,
+                                  int64_t *p_utc_us);
+static void ble_app_record_sample(cts_conn_t *p_conn, const current_time_data_t *p_time,
+                                  int64_t utc_us, uint64_t arrival_us);
+#if (ENABLE_NOTIFICATION_FILTER)
+static bool ble_app_notification_filter(cts_conn_t *p_conn, wiced_bt_gatt_data_t *p_value,
+                                        uint64_t arrival_us);
+#endif
+#if (ENABLE_LOCAL_TIME)
+static bool ble_app_read_local_time_info(cts_conn_t *p_conn);
+static void ble_app_local_time_reread(cts_conn_t *p_conn);
+static void ble_app_local_time_handler(cts_conn_t *p_conn, uint8_t status,
+                                       wiced_bt_gatt_data_t *p_value);
+#endif
+#if (ENABLE_TIME_FUSION)
+static void ble_app_read_reference_info(cts_conn_t *p_conn);
+static void ble_app_reference_info_handler(cts_conn_t *p_conn,
+                                           wiced_bt_gatt_data_t *p_value);
+#endif
+#if (ENABLE_CTS_ALARMS)
+static void ble_app_alarm_wakeup(void);
+#endif
+#if !(ENABLE_CENTRAL_MODE)
+static void ble_app_adv_restart(void);
+#endif
+static cts_conn_t *cts_conn_find(uint16_t conn_id);
+static cts_conn_t *cts_conn_find_by_addr(const uint8_t *bd_addr);
+static uint32_t cts_conn_count(void);
+#if (ENABLE_CTS_SERVER)
+static bool ble_app_is_server_peer(const app_event_t *p_event);
+#endif
+#if (CTS_SOURCE_BY_DISCOVERY)
+static void ble_app_source_to_peer(cts_conn_t *p_conn);
+#endif
+#if (ENABLE_BONDING)
+static void ble_app_request_pairing(const cts_conn_t *p_conn);
+static void ble_app_encryption_status_handler(const app_event_t *p_event);
+static void ble_app_pairing_complete_handler(const app_event_t *p_event);
+static bool ble_app_bond_flush_request(void);
+#endif
 
 /* GATT Event Callback Functions */
-static wiced_bt_gatt_status_t ble_app_connect_handler(wiced_bt_gatt_connection_status_t *p_conn_status);
+static wiced_bt_gatt_status_t ble_app_connect_handler(const app_event_t *p_event);
 static wiced_bt_gatt_status_t ble_app_gatt_event_callback(wiced_bt_gatt_evt_t  event,
                                                           wiced_bt_gatt_event_data_t *p_event_data);
-static wiced_bt_gatt_status_t  ble_app_service_discovery_handler(wiced_bt_gatt_discovery_complete_t *discovery_complete);
-static wiced_bt_gatt_status_t  ble_app_discovery_result_handler(wiced_bt_gatt_discovery_result_t *discovery_result);
+static wiced_bt_gatt_status_t  ble_app_service_discovery_handler(const app_event_t *p_event);
+static wiced_bt_gatt_status_t  ble_app_discovery_result_handler(const app_event_t *p_event);
+static void ble_app_discovery_done(cts_conn_t *p_conn);
+static void ble_app_cache_next(cts_conn_t *p_conn);
+#if (ENABLE_LE_2M_PHY)
+static void ble_app_request_2m_phy(cts_conn_t *p_conn);
+#endif
+static void ble_app_phy_update_handler(const app_event_t *p_event);
+#if (ENABLE_PA_SYNC)
+static void ble_app_broadcast_sync_handler(const app_event_t *p_event);
+static void ble_app_broadcast_time_handler(const app_event_t *p_event);
+static void ble_app_broadcast_retry(void);
+#endif
+#if (ENABLE_ROBUST_CACHING)
+static bool ble_app_read_db_hash(cts_conn_t *p_conn);
+static void ble_app_db_hash_handler(cts_conn_t *p_conn, uint8_t status,
+                                    wiced_bt_gatt_data_t *p_value);
+static bool ble_app_write_service_changed_cccd(cts_conn_t *p_conn);
+static void ble_app_service_changed_handler(cts_conn_t *p_conn,
+                                            wiced_bt_gatt_data_t *p_value);
+#endif
 
 /* Configure GPIO interrupt. */
 cyhal_gpio_callback_data_t button_cb_data =
@@ -127,7 +276,16 @@ wiced_result_t app_bt_management_callback(wiced_bt_management_evt_t event,
     wiced_result_t wiced_result = WICED_BT_SUCCESS;
     wiced_bt_device_address_t bda = { 0 };
     wiced_bt_ble_advert_mode_t *p_adv_mode = NULL;
+    app_event_t app_event;
+#if (ENABLE_PA_SYNC)
+    const uint8_t *p_time;
+    uint16_t time_len = 0;
+    uint64_t arrival_us;
+#endif
 
+#if (ENABLE_TRACE_RECORDER)
+    app_trace_span_begin(TRACE_SPAN_MGMT_CALLBACK, (uint32_t)event);
+#endif
     switch (event)
     {
         case BTM_ENABLED_EVT:
@@ -139,8 +297,18 @@ wiced_result_t app_bt_management_callback(wiced_bt_management_evt_t event,
                 printf("Local Bluetooth Address: ");
                 print_bd_address(bda);
 
+#if (ENABLE_BONDING)
+                /* Resolve the addresses of previously paired servers. The
+                 * store itself was loaded before the stack started */
+                app_bt_bond_init(ble_app_bond_flush_request);
+#endif
+
                 /* Perform application-specific initialization */
                 ble_app_init();
+
+                /* Start-up is over, the application runs without the heap */
+                app_heap_report();
+                app_heap_lock();
             }
             else
             {
@@ -153,6 +321,10 @@ wiced_result_t app_bt_management_callback(wiced_bt_management_evt_t event,
 
             /* Advertisement State Changed */
             p_adv_mode = &p_event_data->ble_advert_state_changed;
+#if !(ENABLE_CENTRAL_MODE)
+            /* The advertising schedule moves from high to low duty and off */
+            app_bt_adv_state_changed(*p_adv_mode);
+#else
             printf("Advertisement State Change: %s\n",
                    get_bt_advert_mode_name(*p_adv_mode));
 
@@ -166,7 +338,29 @@ wiced_result_t app_bt_management_callback(wiced_bt_management_evt_t event,
                 /* Advertisement Started */
                 printf("Advertisement started\n");
             }
+#endif
+            break;
+
+#if (ENABLE_CENTRAL_MODE) || (ENABLE_PA_SYNC)
+        case BTM_BLE_SCAN_STATE_CHANGED_EVT:
+#if (ENABLE_CENTRAL_MODE)
+            app_bt_scan_state_changed(p_event_data->ble_scan_state_changed);
+#endif
+#if (ENABLE_PA_SYNC)
+            /* A pending sync scans on its own once no scan is left, but not
+             * while the controller initiates a connection to a server */
+            if (BTM_BLE_SCAN_TYPE_NONE == p_event_data->ble_scan_state_changed)
+            {
+#if (ENABLE_CENTRAL_MODE)
+                if (!app_bt_scan_connecting())
+#endif
+                {
+                    app_bt_pa_sync_scan_stopped();
+                }
+            }
+#endif
             break;
+#endif
 
         case BTM_BLE_CONNECTION_PARAM_UPDATE:
             printf("Connection parameter update status:%d, Connection Interval: %d,"
@@ -176,8 +370,126 @@ wiced_result_t app_bt_management_callback(wiced_bt_management_evt_t event,
                    p_event_data->ble_connection_param_update.conn_latency,
                    p_event_data->ble_connection_param_update.supervision_timeout);
             break;
+
+        case BTM_BLE_PHY_UPDATE_EVT:
+            memset(&app_event, 0, sizeof(app_event));
+            app_event.type = APP_EVENT_PHY_UPDATE;
+            app_event.status = (uint8_t)p_event_data->ble_phy_update_event.status;
+            memcpy(app_event.data.phy.bd_addr,
+                   p_event_data->ble_phy_update_event.bd_address, BD_ADDR_LEN);
+            app_event.data.phy.tx_phy = p_event_data->ble_phy_update_event.tx_phy;
+            app_event.data.phy.rx_phy = p_event_data->ble_phy_update_event.rx_phy;
+            app_event_post(&app_event);
+            break;
+
+#if (ENABLE_PA_SYNC)
+        case BTM_BLE_PERIODIC_ADV_SYNC_ESTABLISHED_EVENT:
+            if (app_bt_pa_sync_established(&p_event_data->ble_periodic_adv_sync_established))
+            {
+                memset(&app_event, 0, sizeof(app_event));
+                app_event.type = APP_EVENT_BROADCAST_SYNC;
+                app_event.status = WICED_TRUE;
+                memcpy(app_event.data.link.bd_addr,
+                       p_event_data->ble_periodic_adv_sync_established.adv_addr,
+                       BD_ADDR_LEN);
+                app_event_post(&app_event);
+            }
+            break;
+
+        case BTM_BLE_PERIODIC_ADV_REPORT_EVENT:
+            /* Arrival time taken before the queue, as for notifications */
+            arrival_us = local_time_us();
+            p_time = app_bt_pa_sync_report(&p_event_data->ble_periodic_adv_report,
+                                           &time_len);
+            if (NULL != p_time)
+            {
+                memset(&app_event, 0, sizeof(app_event));
+                app_event.type = APP_EVENT_BROADCAST_TIME;
+                app_event.data.operation.arrival_us = arrival_us;
+                app_event.data.operation.len = (time_len < APP_EVENT_VALUE_LEN) ?
+                                               time_len : APP_EVENT_VALUE_LEN;
+                memcpy(app_event.data.operation.value, p_time,
+                       app_event.data.operation.len);
+                app_event_post(&app_event);
+            }
+            break;
+
+        case BTM_BLE_PERIODIC_ADV_SYNC_LOST_EVENT:
+            if (app_bt_pa_sync_lost(p_event_data->ble_periodic_adv_sync_lost.sync_handle))
+            {
+                memset(&app_event, 0, sizeof(app_event));
+                app_event.type = APP_EVENT_BROADCAST_SYNC;
+                app_event.status = WICED_FALSE;
+                app_event_post(&app_event);
+            }
+            break;
+#endif
+
+#if (ENABLE_BONDING)
+        case BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT:
+            /* No input/output capabilities, Secure Connections with bonding */
+            p_event_data->pairing_io_capabilities_ble_request.local_io_cap = BTM_IO_CAPABILITIES_NONE;
+            p_event_data->pairing_io_capabilities_ble_request.oob_data = BTM_OOB_NONE;
+            p_event_data->pairing_io_capabilities_ble_request.auth_req = BTM_LE_AUTH_REQ_SC_BOND;
+            p_event_data->pairing_io_capabilities_ble_request.max_key_size = 0x10;
+            p_event_data->pairing_io_capabilities_ble_request.init_keys = BTM_LE_KEY_PENC | BTM_LE_KEY_PID;
+            p_event_data->pairing_io_capabilities_ble_request.resp_keys = BTM_LE_KEY_PENC | BTM_LE_KEY_PID;
+            break;
+
+        case BTM_SECURITY_REQUEST_EVT:
+            wiced_bt_ble_security_grant(p_event_data->security_request.bd_addr,
+                                        WICED_BT_SUCCESS);
+            break;
+
+        case BTM_PAIRING_COMPLETE_EVT:
+            memset(&app_event, 0, sizeof(app_event));
+            app_event.type = APP_EVENT_PAIRING_COMPLETE;
+            app_event.status = (uint8_t)
+                p_event_data->pairing_complete.pairing_complete_info.ble.reason;
+            memcpy(app_event.data.link.bd_addr,
+                   p_event_data->pairing_complete.bd_addr, BD_ADDR_LEN);
+            app_event_post(&app_event);
+            break;
+
+        case BTM_ENCRYPTION_STATUS_EVT:
+            memset(&app_event, 0, sizeof(app_event));
+            app_event.type = APP_EVENT_ENCRYPTION_STATUS;
+            app_event.status = (uint8_t)p_event_data->encryption_status.result;
+            memcpy(app_event.data.link.bd_addr,
+                   p_event_data->encryption_status.bd_addr, BD_ADDR_LEN);
+            app_event_post(&app_event);
+            break;
+
+        case BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT:
+            wiced_result = app_bt_bond_save_link_keys(
+                               &p_event_data->paired_device_link_keys_update);
+            break;
+
+        case BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT:
+            /* WICED_BT_ERROR makes the stack pair again */
+            wiced_result = app_bt_bond_get_link_keys(
+                               &p_event_data->paired_device_link_keys_request);
+            break;
+
+        case BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT:
+            wiced_result = app_bt_bond_save_local_keys(
+                               &p_event_data->local_identity_keys_update);
+            break;
+
+        case BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT:
+            /* WICED_BT_ERROR makes the stack generate new keys */
+            wiced_result = app_bt_bond_get_local_keys(
+                               &p_event_data->local_identity_keys_request);
+            break;
+#endif /* ENABLE_BONDING */
+
+        default:
+            break;
     }
 
+#if (ENABLE_TRACE_RECORDER)
+    app_trace_span_end(TRACE_SPAN_MGMT_CALLBACK);
+#endif
     return wiced_result;
 }
 
@@ -202,9 +514,15 @@ static void ble_app_init(void)
     cy_rslt_t cy_result = CY_RSLT_SUCCESS;
     wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_SUCCESS;
 
+#if (ENABLE_CENTRAL_MODE)
+    printf("\n***********************************************\n");
+    printf("**Central mode: scanning for CTS servers*\n");
+    printf("***********************************************\n\n");
+#else
     printf("\n***********************************************\n");
     printf("**Discover device with \"CTS Client\" name*\n");
     printf("***********************************************\n\n");
+#endif
 
     /* Initialize GPIO for button interrupt*/
     cy_result = cyhal_gpio_init(CYBSP_USER_BTN, CYHAL_GPIO_DIR_INPUT,
@@ -231,10 +549,44 @@ static void ble_app_init(void)
             get_bt_gatt_status_name(gatt_status));
 
     /* Initialize GATT Database */
+#if (ENABLE_CTS_SERVER)
+    /* The server database adds the Current Time Service to GAP */
+    gatt_status = app_cts_server_init();
+#else
     gatt_status = wiced_bt_gatt_db_init(gatt_database, gatt_database_len, NULL);
+#endif
     printf("GATT database initialization status: %s \n",
             get_bt_gatt_status_name(gatt_status));
+
+#if (ENABLE_BONDING)
+    /* Allow the server to pair and bond with this device */
+    wiced_bt_set_pairable_mode(WICED_TRUE, WICED_FALSE);
+#endif
+#if (ENABLE_TIME_FUSION)
+    cts_fusion_init();
+#endif
+#if (ENABLE_CTS_ALARMS)
+    cts_alarm_init(ble_app_alarm_wakeup);
+#endif
+#if !(ENABLE_CENTRAL_MODE)
+    app_bt_adv_init(ble_app_adv_restart);
+#endif
+#if (ENABLE_PA_SYNC)
+    /* The broadcaster is followed regardless of the connections */
+    app_bt_pa_sync_init(ble_app_broadcast_retry);
+    (void)app_bt_pa_sync_start();
+#endif
+
+#if (ENABLE_TIME_HISTORY)
+    cts_history_init();
+    cts_history_print_footprint();
+#endif
+
+#if (ENABLE_CENTRAL_MODE)
+    printf("Press User button to start scanning.....\n");
+#else
     printf("Press User button to start advertising.....\n");
+#endif
 }
 
 /*******************************************************************************
@@ -242,7 +594,8 @@ static void ble_app_init(void)
 ********************************************************************************
 *
 * Summary:
-*   This interrupt handler notifies the button task of a button press event.
+*   This interrupt handler posts a button press event to the application
+*   task.
 *
 * Parameters:
 *   void *handler_arg:                     Not used
@@ -255,18 +608,37 @@ static void ble_app_init(void)
 void button_interrupt_handler(void *handler_arg, cyhal_gpio_event_t event)
 {
     BaseType_t xHigherPriorityTaskWoken;
+    app_event_t app_event = { .type = APP_EVENT_BUTTON };
+
+#if (ENABLE_TRACE_RECORDER)
+    app_trace_isr_enter(TRACE_ISR_BUTTON);
+#endif
+#if (ENABLE_LATENCY_TRACE)
+    app_event.data.button.isr_cycles = cycle_counter_get();
+#endif
     xHigherPriorityTaskWoken = pdFALSE;
-    vTaskNotifyGiveFromISR(button_task_handle, &xHigherPriorityTaskWoken);
+    if (pdTRUE != xQueueSendFromISR(app_event_queue, &app_event,
+                                    &xHigherPriorityTaskWoken))
+    {
+        app_event_lost++;
+    }
+#if (ENABLE_LATENCY_TRACE)
+    app_latency_isr_exit();
+#endif
+#if (ENABLE_TRACE_RECORDER)
+    app_trace_isr_exit(TRACE_ISR_BUTTON);
+#endif
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
 /*******************************************************************************
-* Function Name: button_task()
+* Function Name: app_task()
 ********************************************************************************
 *
 * Summary:
-*   This task starts Bluetooth LE advertisment on first button press and enables
-*   or disables notifications from the server upon successive button presses.
+*   This task owns the CTS state. It handles the button presses and the
+*   Bluetooth stack events that the interrupt handler and the stack callbacks
+*   post to its queue, one at a time.
 *
 * Parameters:
 *   void *pvParameters:                Not used
@@ -275,397 +647,2730 @@ void button_interrupt_handler(void *handler_arg, cyhal_gpio_event_t event)
 *   None
 *
 *******************************************************************************/
-void button_task(void *pvParameters)
+void app_task(void *pvParameters)
 {
-    wiced_result_t wiced_result = WICED_BT_ERROR;
-    wiced_bt_gatt_status_t gatt_status;
+    app_event_t app_event;
+
     for(;;)
     {
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        if(button_press_for_adv)
-        {
-            wiced_result = wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_HIGH,
-                                                         0, NULL);
-            /* Failed to start advertisement, inform user */
-            if (WICED_BT_SUCCESS != wiced_result)
-            {
-                printf("Failed to start advertisement! Error code: %X \n",
-                       wiced_result);
-            }
-        }
-        else
+        if (pdTRUE == xQueueReceive(app_event_queue, &app_event, portMAX_DELAY))
         {
-            if((cts_discovery_data.cts_service_found == true) && (bt_connection_id != 0))
-            {
-                /* Toggle the flag to enable/disable CCCD based on previous state */
-                notify_val = !notify_val;
-                gatt_status = ble_app_write_notification_cccd(notify_val);
-                if(WICED_BT_GATT_SUCCESS != gatt_status)
-                {
-                    printf("Enable/Disable notification failed! Error code: %X \n"
-                           ,gatt_status);
-                }
-            }
+            app_event_handle(&app_event);
         }
     }
 }
 
 /*******************************************************************************
-* Function Name: ble_app_gatt_event_callback()
+* Function Name: app_event_post()
 ********************************************************************************
+*
 * Summary:
-*   GATT Callback function registered with Bluetooth stack to handle GATT events.
+*   Posts an event from a Bluetooth stack callback to the application task.
+*   A time value is dropped without waiting when only the reserved slots are
+*   left, as the next one replaces it. Any other event may use the reserved
+*   slots and waits up to APP_EVENT_POST_WAIT_MS for room; if it is lost
+*   anyway, its link is disconnected so that no connection stays waiting for
+*   it.
 *
 * Parameters:
-*   wiced_bt_gatt_evt_t event : Bluetooth LE GATT event code of one byte length
-*   wiced_bt_gatt_event_data_t *p_event_data : Pointer to Bluetooth LE GATT
-*                                              event structures
+*   const app_event_t *p_event: Event to post
+*
 * Return:
-*  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e
-*                          in wiced_bt_gatt.h
+*   None
+*
 *******************************************************************************/
-static wiced_bt_gatt_status_t
-ble_app_gatt_event_callback(wiced_bt_gatt_evt_t event,
-                            wiced_bt_gatt_event_data_t *p_event_data)
+static void app_event_post(const app_event_t *p_event)
 {
-    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_SUCCESS;
-
-    /* Call the appropriate callback function based on the GATT event type, and
-     * pass the relevant event parameters to the callback function */
-    switch ( event )
+#if (ENABLE_APP_EVENT_QUEUE)
+    if (app_event_droppable(p_event))
     {
-        case GATT_CONNECTION_STATUS_EVT:
-            gatt_status = ble_app_connect_handler(&p_event_data->connection_status);
-            break;
-
-        case GATT_DISCOVERY_RESULT_EVT:
-            gatt_status = ble_app_discovery_result_handler(&p_event_data->discovery_result);
-            break;
-
-        case GATT_DISCOVERY_CPLT_EVT:
-            gatt_status = ble_app_service_discovery_handler(&p_event_data->discovery_complete);
-            break;
-
-        case GATT_OPERATION_CPLT_EVT:
-            switch (p_event_data->operation_complete.op)
-            {
-                case GATTC_OPTYPE_WRITE_WITH_RSP:
-                    /* Check if GATT operation of enable/disable notification is success. */
-                    if ((p_event_data->operation_complete.response_data.handle
-                        == (cts_discovery_data.cts_cccd_handle))
-                        && (WICED_BT_GATT_SUCCESS == p_event_data->operation_complete.status))
-                    {
-                        if(notify_val)
-                        {
-                            printf("Notifications enabled\n");
-                        }
-                        else
-                        {
-                            printf("Notifications disabled\n");
-                        }
-                    }
-                    else
-                    {
-                        printf("CCCD update failed. Error code: %d\n",
-                               p_event_data->operation_complete.status);
-                    }
-                    break;
-
-                case GATTC_OPTYPE_NOTIFICATION:
-                    /* Function call to print the time and date notifcation */
-                    print_notification_data(p_event_data->operation_complete.response_data.att_value);
-                    break;
-            }
-            break;
-
-        case GATT_APP_BUFFER_TRANSMITTED_EVT:
+        if ((uxQueueSpacesAvailable(app_event_queue) <= APP_EVENT_QUEUE_RESERVED) ||
+            (pdTRUE != xQueueSend(app_event_queue, p_event, 0)))
         {
-            vPortFree(p_event_data->buffer_xmitted.p_app_data);
-            break;
+            app_event_dropped++;
+            return;
         }
-
-        default:
-            gatt_status = WICED_BT_GATT_SUCCESS;
-            break;
     }
-
-    return gatt_status;
+    else if (pdTRUE != xQueueSend(app_event_queue, p_event,
+                                  pdMS_TO_TICKS(APP_EVENT_POST_WAIT_MS)))
+    {
+        app_event_lost++;
+        printf("Event %u lost, queue full\n", (unsigned int)p_event->type);
+        if (0 != p_event->conn_id)
+        {
+            wiced_bt_gatt_disconnect(p_event->conn_id);
+        }
+        return;
+    }
+#if (ENABLE_METRICS)
+    app_metrics_gauge_max(METRIC_GAUGE_QUEUE_PEAK,
+                          (int32_t)uxQueueMessagesWaiting(app_event_queue));
+#endif
+#else
+    /* Handle the event in the stack callback */
+    app_event_handle(p_event);
+#endif
 }
 
+#if (ENABLE_APP_EVENT_QUEUE)
 /*******************************************************************************
-* Function Name:  ble_app_connect_handler()
+* Function Name: app_event_droppable()
 ********************************************************************************
+*
 * Summary:
-*   This function handles connection status changes.
+*   Tells if an event only carries a time value that the next one replaces:
+*   a notification, an indication (already confirmed in the callback) or a
+*   broadcast report.
 *
 * Parameters:
-*   wiced_bt_gatt_connection_status_t *p_conn_status : Pointer to data that has
-*                                                      connection details
+*   const app_event_t *p_event: Event to check
 *
 * Return:
-*  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e
-*                          in wiced_bt_gatt.h
+*   bool: true if the event may be dropped on a busy queue
 *
 *******************************************************************************/
-static wiced_bt_gatt_status_t
-ble_app_connect_handler(wiced_bt_gatt_connection_status_t *p_conn_status)
+static bool app_event_droppable(const app_event_t *p_event)
 {
-    wiced_bt_gatt_status_t gatt_status =  WICED_BT_GATT_SUCCESS;
-    wiced_bt_gatt_discovery_param_t service_discovery_setup = {0};
-    if ( NULL == p_conn_status )
-    {
-        gatt_status = WICED_BT_GATT_ERROR;
-        return gatt_status;
-    }
-
-    if ( p_conn_status->connected )
-    {
-        /* Device has connected */
-        printf("Connected : BDA " );
-        print_bd_address(p_conn_status->bd_addr);
-        printf("Connection ID '%d' \n", p_conn_status->conn_id );
-
-        /* Store the connection ID */
-        bt_connection_id = p_conn_status->conn_id;
-        /* After connection, successive button presses must enable/disable
-        notification from server */
-        button_press_for_adv = false;
-
-        /* Send GATT service discovery request */
-        service_discovery_setup.s_handle = 0x01;
-        service_discovery_setup.e_handle = 0xFFFF;
-        service_discovery_setup.uuid.len = LEN_UUID_16;
-        service_discovery_setup.uuid.uu.uuid16 = UUID_SERVICE_CURRENT_TIME;
-
-        gatt_status = wiced_bt_gatt_client_send_discover(bt_connection_id,
-                                            GATT_DISCOVER_SERVICES_BY_UUID,
-                                                    &service_discovery_setup);
-        if(WICED_BT_GATT_SUCCESS != gatt_status)
-        {
-            printf("GATT Discovery request failed. Error code: %d, "
-                    "Conn id: %d\n", gatt_status, bt_connection_id);
-        }
-        else
-        {
-            printf("Service Discovery Started\n");
-        }
-    }
-    else
+    if (APP_EVENT_BROADCAST_TIME == p_event->type)
     {
-        /* Device has disconnected */
-        printf("Disconnected : BDA " );
-        print_bd_address(p_conn_status->bd_addr);
-        printf("Connection ID '%d', Reason '%s'\n", p_conn_status->conn_id,
-                get_bt_gatt_disconn_reason_name(p_conn_status->reason) );
-
-        /* Set the connection id to zero to indicate disconnected state */
-        bt_connection_id = 0;
-
-        /* Service discovery is performed upon reconnection, so reset the
-            * status of service found flag */
-        cts_discovery_data.cts_service_found = false;
-        /* First button press after disconnection must start advertisement */
-        button_press_for_adv = true;
+        return true;
     }
-    return gatt_status;
+    return ((APP_EVENT_OPERATION_CPLT == p_event->type) &&
+            ((GATTC_OPTYPE_NOTIFICATION == p_event->op) ||
+             (GATTC_OPTYPE_INDICATION == p_event->op)));
 }
+#endif
 
-/********************************************************************************
-* Function Name:  ble_app_discovery_result_handler()
-*********************************************************************************
+/*******************************************************************************
+* Function Name: app_event_handle()
+********************************************************************************
+*
 * Summary:
-*   This function handles discovery results from bluetooth stack.
+*   Dispatches an event to its handler.
 *
 * Parameters:
-*   wiced_bt_gatt_discovery_result_t *discovery_result : Pointer to data
-*   that has discovery details.
+*   const app_event_t *p_event: Event to handle
 *
 * Return:
-*  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e
-*                          in wiced_bt_gatt.h
+*   None
 *
-*********************************************************************************/
-static wiced_bt_gatt_status_t
-ble_app_discovery_result_handler(wiced_bt_gatt_discovery_result_t *discovery_result)
+*******************************************************************************/
+static void app_event_handle(const app_event_t *p_event)
 {
-    wiced_bt_gatt_status_t gatt_status =  WICED_BT_GATT_SUCCESS;
-    wiced_bt_gatt_discovery_type_t discovery_type;
-    discovery_type = discovery_result->discovery_type;
-    switch (discovery_type)
+#if (ENABLE_TRACE_RECORDER)
+    app_trace_span_begin(TRACE_SPAN_APP_EVENT, p_event->type);
+#endif
+    switch (p_event->type)
     {
-        case GATT_DISCOVER_SERVICES_BY_UUID:
-            if(UUID_SERVICE_CURRENT_TIME ==
-               discovery_result->discovery_data.group_value.service_type.uu.uuid16)
-            {
-                cts_discovery_data.cts_start_handle = discovery_result->discovery_data.group_value.s_handle;
-                cts_discovery_data.cts_end_handle = discovery_result->discovery_data.group_value.e_handle;
-                printf("CTS Service Found, Start Handle = %d, End Handle = %d \n",
-                        cts_discovery_data.cts_start_handle,
-                        cts_discovery_data.cts_end_handle);
-            }
+        case APP_EVENT_BUTTON:
+            ble_app_button_handler(p_event);
             break;
 
-        case GATT_DISCOVER_CHARACTERISTICS:
-            if(UUID_CHARACTERISTIC_CURRENT_TIME ==
-               discovery_result->discovery_data.characteristic_declaration.char_uuid.uu.uuid16)
-            {
-                cts_discovery_data.cts_char_handle = discovery_result->discovery_data.characteristic_declaration.handle;
-                cts_discovery_data.cts_char_val_handle = discovery_result->discovery_data.characteristic_declaration.val_handle;
-                printf("Current Time characteristic handle = %d, "
-                       "Current Time characteristic value handle = %d\n",
-                        cts_discovery_data.cts_char_handle,
-                        cts_discovery_data.cts_char_val_handle);
-            }
+        case APP_EVENT_CONNECTED:
+        case APP_EVENT_DISCONNECTED:
+            (void)ble_app_connect_handler(p_event);
             break;
 
-        case GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS:
-            if(UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION ==
-               discovery_result->discovery_data.char_descr_info.type.uu.uuid16)
+        case APP_EVENT_DISCOVERY_RESULT:
+            (void)ble_app_discovery_result_handler(p_event);
+            break;
+
+        case APP_EVENT_DISCOVERY_CPLT:
+            (void)ble_app_service_discovery_handler(p_event);
+            break;
+
+        case APP_EVENT_OPERATION_CPLT:
+            ble_app_operation_handler(p_event);
+            break;
+
+#if (ENABLE_BONDING)
+        case APP_EVENT_PAIRING_COMPLETE:
+            ble_app_pairing_complete_handler(p_event);
+            break;
+
+        case APP_EVENT_ENCRYPTION_STATUS:
+            ble_app_encryption_status_handler(p_event);
+            break;
+
+        case APP_EVENT_BOND_FLUSH:
+            app_bt_bond_flush();
+            break;
+#endif
+
+#if (ENABLE_CTS_ALARMS)
+        case APP_EVENT_ALARM:
+            cts_alarm_process();
+            break;
+#endif
+
+#if (ENABLE_UART_COMMANDS)
+        case APP_EVENT_COMMAND:
+            ble_app_command_handler(p_event);
+            break;
+#endif
+
+        case APP_EVENT_PHY_UPDATE:
+            ble_app_phy_update_handler(p_event);
+            break;
+
+#if (ENABLE_PA_SYNC)
+        case APP_EVENT_BROADCAST_SYNC:
+            ble_app_broadcast_sync_handler(p_event);
+            break;
+
+        case APP_EVENT_BROADCAST_RETRY:
+            (void)app_bt_pa_sync_start();
+            break;
+
+        case APP_EVENT_BROADCAST_TIME:
+            ble_app_broadcast_time_handler(p_event);
+            break;
+#endif
+
+#if (ENABLE_CTS_SERVER)
+        case APP_EVENT_ATTRIBUTE_REQUEST:
+            app_cts_server_request(p_event);
+            break;
+#endif
+
+#if !(ENABLE_CENTRAL_MODE)
+        case APP_EVENT_ADV_RESTART:
+            /* The sleep after an advertising timeout is over */
+            if (0 == cts_conn_count())
             {
-                cts_discovery_data.cts_cccd_handle = discovery_result->discovery_data.char_descr_info.handle;
-                cts_discovery_data.cts_service_found = true;
-                printf("Current Time CCCD found, Handle = %d\n",
-                        cts_discovery_data.cts_cccd_handle);
-                printf("Press User button on the kit to enable or disable "
-                        "notifications \n");
+                (void)ble_app_advertise(true);
             }
             break;
+#endif
 
         default:
             break;
-        }
-
-    return gatt_status;
+    }
+#if (ENABLE_TRACE_RECORDER)
+    app_trace_span_end(TRACE_SPAN_APP_EVENT);
+#endif
 }
 
-/********************************************************************************
-* Function Name:  ble_app_service_discovery_handler()
-*********************************************************************************
+#if (ENABLE_CTS_ALARMS)
+/*******************************************************************************
+* Function Name: ble_app_alarm_wakeup()
+********************************************************************************
+*
 * Summary:
-*   This function handles service discovery for CTS.
+*   Called from the FreeRTOS timer task when the next alarm is due. Posts an
+*   event so that the alarms are handled in the application task.
 *
 * Parameters:
-*   wiced_bt_gatt_discovery_complete_t *discovery_complete : Pointer to data
-*   that has type and status of the completed discovery.
+*   None
 *
 * Return:
-*  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e
-*                          in wiced_bt_gatt.h
+*   None
 *
-*********************************************************************************/
-static wiced_bt_gatt_status_t
-ble_app_service_discovery_handler(wiced_bt_gatt_discovery_complete_t *discovery_complete)
+*******************************************************************************/
+static void ble_app_alarm_wakeup(void)
 {
-    wiced_bt_gatt_status_t gatt_status =  WICED_BT_GATT_SUCCESS;
-    wiced_bt_gatt_discovery_param_t char_discovery_setup = {0};
-    wiced_bt_gatt_discovery_type_t discovery_type;
-    discovery_type = discovery_complete->discovery_type;
-    switch (discovery_type)
-    {
-        case GATT_DISCOVER_SERVICES_BY_UUID:
-        {
-            char_discovery_setup.s_handle = cts_discovery_data.cts_start_handle;
-            char_discovery_setup.e_handle = cts_discovery_data.cts_end_handle;
-            char_discovery_setup.uuid.uu.uuid16 = UUID_CHARACTERISTIC_CURRENT_TIME;
-            gatt_status = wiced_bt_gatt_client_send_discover(bt_connection_id,
-                                                GATT_DISCOVER_CHARACTERISTICS,
-                                                &char_discovery_setup);
-            if(WICED_BT_GATT_SUCCESS != gatt_status)
-            printf("GATT characteristics discovery failed! Error code = %d\n", gatt_status);
-            break;
-        }
-
-        case GATT_DISCOVER_CHARACTERISTICS:
-        {
-            char_discovery_setup.s_handle = cts_discovery_data.cts_start_handle;
-            char_discovery_setup.e_handle = cts_discovery_data.cts_end_handle;
-            char_discovery_setup.uuid.uu.uuid16 = UUID_CHARACTERISTIC_CURRENT_TIME;
-            gatt_status = wiced_bt_gatt_client_send_discover(bt_connection_id,
-                                               GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS,
-                                               &char_discovery_setup);
-
-            if(WICED_BT_GATT_SUCCESS != gatt_status)
-            printf("GATT CCCD discovery failed! Error code = %d\n", gatt_status);
-            break;
-        }
+    app_event_t app_event = { .type = APP_EVENT_ALARM };
 
-        default:
-            break;
+    if (pdTRUE != xQueueSend(app_event_queue, &app_event, 0))
+    {
+        app_event_lost++;
     }
-    return gatt_status;
 }
+#endif
 
+#if !(ENABLE_CENTRAL_MODE)
 /*******************************************************************************
-* Function Name: ble_app_write_notification_cccd()
+* Function Name: ble_app_adv_restart()
 ********************************************************************************
+*
 * Summary:
-*   Enable/Disable GATT notification from the server.
+*   Called from the FreeRTOS timer task when the sleep after an advertising
+*   timeout ends. Posts an event so that advertising restarts in the
+*   application task.
 *
 * Parameters:
-*   bool notify : true - to enable notifications
-*                 false - to disable notifications
+*   None
 *
 * Return:
-*   wiced_bt_gatt_status_t  : Status code from wiced_bt_gatt_status_e.
+*   None
 *
 *******************************************************************************/
-static wiced_bt_gatt_status_t ble_app_write_notification_cccd(bool notify)
+static void ble_app_adv_restart(void)
 {
-    wiced_bt_gatt_write_hdr_t  write_hdr = {0};
-    wiced_bt_gatt_status_t     gatt_status = WICED_BT_GATT_SUCCESS;
-    uint8_t * notif_val = NULL;
-
-    /* Allocate memory for data to be written on server DB and pass it to stack*/
-    notif_val = pvPortMalloc(sizeof(uint16_t)); //CCCD is two bytes
-    if (notif_val)
-    {
-        notif_val[0] = notify;
-        notif_val[1] = 0;
-        write_hdr.auth_req = GATT_AUTH_REQ_NONE;
-        write_hdr.handle = cts_discovery_data.cts_cccd_handle;
-        write_hdr.len      = LEN_UUID_16;
-        write_hdr.offset = 0;
-        gatt_status = wiced_bt_gatt_client_send_write(bt_connection_id,
-                                                      GATT_REQ_WRITE,
-                                                      &write_hdr,
-                                                      notif_val,
-                                                      NULL);
+    app_event_t app_event = { .type = APP_EVENT_ADV_RESTART };
+
+    if (pdTRUE != xQueueSend(app_event_queue, &app_event, 0))
+    {
+        app_event_lost++;
     }
-    return gatt_status;
 }
+#endif
 
 /*******************************************************************************
-* Function Name: print_notification_data()
+* Function Name: ble_app_button_handler()
 ********************************************************************************
+*
 * Summary:
-*   Parses the notification data to get date, time and other fields.
+*   Starts Bluetooth LE advertisment (or scanning in central mode) on the
+*   first button press and enables or disables notifications from the
+*   connected servers upon successive button presses.
 *
 * Parameters:
-*   wiced_bt_gatt_data_t notif_data: Notification packet from GATT server
+*   const app_event_t *p_event: Button event
 *
 * Return:
 *   None
 *
 *******************************************************************************/
-static void print_notification_data(wiced_bt_gatt_data_t notif_data)
+static void ble_app_button_handler(const app_event_t *p_event)
 {
-    time_date_notif.year          = (notif_data.p_data[1] << 8u) | notif_data.p_data[0];
-    time_date_notif.month         = notif_data.p_data[2];
-    time_date_notif.day           = notif_data.p_data[3];
-    time_date_notif.hours         = notif_data.p_data[4];
-    time_date_notif.minutes       = notif_data.p_data[5];
-    time_date_notif.seconds       = notif_data.p_data[6];
-    time_date_notif.day_of_week   = notif_data.p_data[7];
-    time_date_notif.fractions_256 = notif_data.p_data[8];
-    time_date_notif.adjust_reason = notif_data.p_data[9];
+    bool notify;
+    uint32_t index;
 
-    if(time_date_notif.adjust_reason)
+    if(button_press_for_adv)
     {
-        if((time_date_notif.adjust_reason & MANUAL_TIME_UPDATE) ==
-            MANUAL_TIME_UPDATE)
+        (void)ble_app_advertise(true);
+    }
+    else
+    {
+#if (ENABLE_LATENCY_TRACE)
+        app_latency_start(p_event->data.button.isr_cycles);
+#endif
+        /* Disable notifications if any server has them enabled, else
+         * enable them on all servers */
+        notify = true;
+        for (index = 0; index < CTS_MAX_CONNECTIONS; index++)
         {
-            printf("Time Adjust Reason: Manual Time Update\n");
-        }
+            if ((0 != cts_conn[index].conn_id) && (cts_conn[index].notify_val))
+            {
+                notify = false;
+            }
+        }
+        (void)ble_app_set_notifications(notify);
+    }
+}
+
+/*******************************************************************************
+* Function Name: ble_app_advertise()
+********************************************************************************
+*
+* Summary:
+*   Starts or stops Bluetooth LE advertisement, or scanning in central mode.
+*
+* Parameters:
+*   bool start: true to start, false to stop
+*
+* Return:
+*   bool: true if the stack accepted the request
+*
+*******************************************************************************/
+static bool ble_app_advertise(bool start)
+{
+#if (ENABLE_CENTRAL_MODE)
+    if (!start)
+    {
+        app_bt_scan_stop();
+        return true;
+    }
+#if (ENABLE_PA_SYNC)
+    /* The server scan takes the scanner over from a pending sync */
+    app_bt_pa_sync_scan_release();
+#endif
+    return (WICED_BT_SUCCESS == app_bt_scan_start());
+#else
+    if (!start)
+    {
+        app_bt_adv_stop();
+        return true;
+    }
+    return (WICED_BT_SUCCESS == app_bt_adv_start());
+#endif
+}
+
+/*******************************************************************************
+* Function Name: ble_app_set_notifications()
+********************************************************************************
+*
+* Summary:
+*   Enables or disables notifications on every connected server with CTS.
+*
+* Parameters:
+*   bool notify: true to enable, false to disable notifications
+*
+* Return:
+*   uint32_t: Number of CCCD writes sent
+*
+*******************************************************************************/
+static uint32_t ble_app_set_notifications(bool notify)
+{
+    wiced_bt_gatt_status_t gatt_status;
+    uint32_t index;
+    uint32_t sent = 0;
+
+    for (index = 0; index < CTS_MAX_CONNECTIONS; index++)
+    {
+        if((cts_conn[index].cts_discovery_data.cts_service_found == true) &&
+           (cts_conn[index].conn_id != 0))
+        {
+            cts_conn[index].notify_val = notify;
+#if (ENABLE_LATENCY_TRACE)
+            app_latency_write_begin();
+#endif
+            gatt_status = ble_app_write_notification_cccd(&cts_conn[index],
+                                                          notify);
+#if (ENABLE_LATENCY_TRACE)
+            app_latency_write_end(WICED_BT_GATT_SUCCESS == gatt_status);
+#endif
+            if(WICED_BT_GATT_SUCCESS != gatt_status)
+            {
+                printf("Enable/Disable notification failed! Error code: %X \n"
+                       ,gatt_status);
+            }
+            else
+            {
+                sent++;
+            }
+        }
+    }
+    return sent;
+}
+
+#if (ENABLE_UART_COMMANDS)
+/*******************************************************************************
+* Function Name: ble_app_command_handler()
+********************************************************************************
+*
+* Summary:
+*   Runs a command received on the debug UART and reports the result.
+*
+* Parameters:
+*   const app_event_t *p_event: Command event, the command in op
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_command_handler(const app_event_t *p_event)
+{
+    bool ok = false;
+#if (ENABLE_CURRENT_TIME_READ)
+    uint32_t index;
+#endif
+
+    switch (p_event->op)
+    {
+        case APP_CMD_ADV_START:
+        case APP_CMD_ADV_STOP:
+            ok = ble_app_advertise(APP_CMD_ADV_START == p_event->op);
+            break;
+
+        case APP_CMD_SUBSCRIBE:
+        case APP_CMD_UNSUBSCRIBE:
+            ok = (0u != ble_app_set_notifications(APP_CMD_SUBSCRIBE == p_event->op));
+            break;
+
+        case APP_CMD_READ_TIME:
+#if (ENABLE_CURRENT_TIME_READ)
+            /* Servers with a read in progress are skipped, they share the
+             * read buffer of the connection */
+            for (index = 0; index < CTS_MAX_CONNECTIONS; index++)
+            {
+                if ((0 != cts_conn[index].conn_id) &&
+                    (cts_conn[index].cts_discovery_data.cts_service_found) &&
+                    (0 == cts_conn[index].read_handle) &&
+                    ble_app_read_current_time(&cts_conn[index]))
+                {
+                    ok = true;
+                }
+            }
+#endif
+            break;
+
+        default:
+            break;
+    }
+    app_cmd_reply((app_cmd_t)p_event->op, ok);
+}
+#endif
+
+/*******************************************************************************
+* Function Name: ble_app_gatt_event_callback()
+********************************************************************************
+* Summary:
+*   GATT Callback function registered with Bluetooth stack to handle GATT events.
+*   The event data the application needs is copied into an event for the
+*   application task, so the stack thread returns without waiting for the
+*   application. The time spent in the callback is measured.
+*
+* Parameters:
+*   wiced_bt_gatt_evt_t event : Bluetooth LE GATT event code of one byte length
+*   wiced_bt_gatt_event_data_t *p_event_data : Pointer to Bluetooth LE GATT
+*                                              event structures
+* Return:
+*  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e
+*                          in wiced_bt_gatt.h
+*******************************************************************************/
+static wiced_bt_gatt_status_t
+ble_app_gatt_event_callback(wiced_bt_gatt_evt_t event,
+                            wiced_bt_gatt_event_data_t *p_event_data)
+{
+    uint32_t start_cycles = cycle_counter_get();
+    uint32_t callback_us;
+    wiced_bt_gatt_connection_status_t *p_conn_status = NULL;
+    wiced_bt_gatt_operation_complete_t *p_op = NULL;
+    app_event_t app_event;
+    bool post = true;
+
+#if (ENABLE_TRACE_RECORDER)
+    app_trace_span_begin(TRACE_SPAN_GATT_CALLBACK, (uint32_t)event);
+#endif
+    memset(&app_event, 0, sizeof(app_event));
+
+    switch ( event )
+    {
+        case GATT_CONNECTION_STATUS_EVT:
+            p_conn_status = &p_event_data->connection_status;
+            app_event.type = p_conn_status->connected ? APP_EVENT_CONNECTED :
+                                                        APP_EVENT_DISCONNECTED;
+            app_event.conn_id = p_conn_status->conn_id;
+            memcpy(app_event.data.link.bd_addr, p_conn_status->bd_addr, BD_ADDR_LEN);
+            app_event.data.link.addr_type = (uint8_t)p_conn_status->addr_type;
+            app_event.data.link.role = (uint8_t)p_conn_status->link_role;
+            app_event.data.link.reason = (uint16_t)p_conn_status->reason;
+            break;
+
+        case GATT_DISCOVERY_RESULT_EVT:
+            post = ble_app_copy_discovery_result(&p_event_data->discovery_result,
+                                                 &app_event);
+            break;
+
+        case GATT_DISCOVERY_CPLT_EVT:
+            app_event.type = APP_EVENT_DISCOVERY_CPLT;
+            app_event.conn_id = p_event_data->discovery_complete.conn_id;
+            app_event.op = (uint8_t)p_event_data->discovery_complete.discovery_type;
+            app_event.status = (uint8_t)p_event_data->discovery_complete.status;
+            break;
+
+        case GATT_OPERATION_CPLT_EVT:
+            /* Timestamp notifications as early as possible. The stack does
+             * not expose the connection event anchor, so the arrival in this
+             * callback is the closest local reference */
+            app_event.data.operation.arrival_us = local_time_us();
+            app_event.data.operation.arrival_cycles = start_cycles;
+            p_op = &p_event_data->operation_complete;
+            app_event.type = APP_EVENT_OPERATION_CPLT;
+            app_event.conn_id = p_op->conn_id;
+            app_event.op = (uint8_t)p_op->op;
+            app_event.status = (uint8_t)p_op->status;
+#if (ENABLE_METRICS)
+            /* Counted before the queue, which may drop the event */
+            if (GATTC_OPTYPE_NOTIFICATION == p_op->op)
+            {
+                app_metrics_inc(METRIC_NOTIFICATIONS);
+            }
+#endif
+            if (GATTC_OPTYPE_WRITE_WITH_RSP == p_op->op)
+            {
+                app_event.data.operation.handle = p_op->response_data.handle;
+            }
+            else
+            {
+                if (GATTC_OPTYPE_INDICATION == p_op->op)
+                {
+                    /* Confirm at once, the server sends nothing else until
+                     * then */
+                    wiced_bt_gatt_client_send_indication_confirm(p_op->conn_id,
+                        p_op->response_data.att_value.handle);
+                }
+                app_event.data.operation.handle = p_op->response_data.att_value.handle;
+                app_event.data.operation.len =
+                    (p_op->response_data.att_value.len < APP_EVENT_VALUE_LEN) ?
+                    p_op->response_data.att_value.len : APP_EVENT_VALUE_LEN;
+                if (NULL != p_op->response_data.att_value.p_data)
+                {
+                    memcpy(app_event.data.operation.value,
+                           p_op->response_data.att_value.p_data,
+                           app_event.data.operation.len);
+                }
+            }
+            break;
+
+#if (ENABLE_CTS_SERVER)
+        case GATT_ATTRIBUTE_REQUEST_EVT:
+            /* Answered from the application task, which owns the fused
+             * time */
+            post = app_cts_server_copy_request(&p_event_data->attribute_request,
+                                               &app_event);
+            break;
+#endif
+
+        case GATT_APP_BUFFER_TRANSMITTED_EVT:
+            /* Write data is sent from the connection's own buffer. The
+             * server buffers are shared by several peers and counted */
+#if (ENABLE_CTS_SERVER)
+            app_cts_server_buffer_transmitted(p_event_data->buffer_xmitted.p_app_ctxt);
+#endif
+            post = false;
+            break;
+
+        default:
+            post = false;
+            break;
+    }
+
+    if (post)
+    {
+        app_event_post(&app_event);
+    }
+
+    callback_us = CYCLES_TO_US(cycle_counter_get() - start_cycles);
+    callback_count++;
+    callback_total_us += callback_us;
+    if (callback_us > callback_max_us)
+    {
+        callback_max_us = callback_us;
+    }
+#if (ENABLE_TRACE_RECORDER)
+    app_trace_span_end(TRACE_SPAN_GATT_CALLBACK);
+#endif
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: ble_app_copy_discovery_result()
+********************************************************************************
+* Summary:
+*   Copies the UUID and handles of a discovered service, characteristic or
+*   descriptor into an event for the application task.
+*
+* Parameters:
+*   wiced_bt_gatt_discovery_result_t *p_result: Discovery result of the stack
+*   app_event_t *p_event: Event to fill
+*
+* Return:
+*   bool: false if the discovery type is not used by the application
+*
+*******************************************************************************/
+static bool ble_app_copy_discovery_result(wiced_bt_gatt_discovery_result_t *p_result,
+                                          app_event_t *p_event)
+{
+    wiced_bt_gatt_discovery_data_t *p_data = &p_result->discovery_data;
+    wiced_bt_uuid_t *p_uuid = NULL;
+
+    p_event->type = APP_EVENT_DISCOVERY_RESULT;
+    p_event->conn_id = p_result->conn_id;
+    p_event->op = (uint8_t)p_result->discovery_type;
+
+    switch (p_result->discovery_type)
+    {
+        case GATT_DISCOVER_SERVICES_ALL:
+        case GATT_DISCOVER_SERVICES_BY_UUID:
+            p_uuid = &p_data->group_value.service_type;
+            p_event->data.discovery.handle = p_data->group_value.s_handle;
+            p_event->data.discovery.end_handle = p_data->group_value.e_handle;
+            break;
+
+        case GATT_DISCOVER_CHARACTERISTICS:
+            p_uuid = &p_data->characteristic_declaration.char_uuid;
+            p_event->data.discovery.handle = p_data->characteristic_declaration.handle;
+            p_event->data.discovery.end_handle = p_data->characteristic_declaration.val_handle;
+            p_event->data.discovery.properties =
+                p_data->characteristic_declaration.characteristic_properties;
+            break;
+
+        case GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS:
+            p_uuid = &p_data->char_descr_info.type;
+            p_event->data.discovery.handle = p_data->char_descr_info.handle;
+            break;
+
+        default:
+            return false;
+    }
+
+    if (LEN_UUID_16 == p_uuid->len)
+    {
+        p_event->data.discovery.uuid16 = p_uuid->uu.uuid16;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ble_app_operation_handler()
+********************************************************************************
+* Summary:
+*   Handles a completed GATT operation: the CCCD write, a notification or a
+*   read of the Reference Time Information.
+*
+* Parameters:
+*   const app_event_t *p_event: Operation complete event
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_operation_handler(const app_event_t *p_event)
+{
+    cts_conn_t *p_conn = cts_conn_find(p_event->conn_id);
+    wiced_bt_gatt_data_t value;
+
+    if ((0 == p_event->conn_id) || (NULL == p_conn))
+    {
+        return;
+    }
+
+    /* Value as the stack passed it, pointing at the copy in the event */
+    value.handle = p_event->data.operation.handle;
+    value.offset = 0;
+    value.len    = p_event->data.operation.len;
+    value.p_data = (uint8_t *)p_event->data.operation.value;
+
+    switch (p_event->op)
+    {
+        case GATTC_OPTYPE_WRITE_WITH_RSP:
+#if (ENABLE_ROBUST_CACHING)
+            if ((GATT_CACHE_STEP_SUBSCRIBE == p_conn->cache_step) &&
+                (p_event->data.operation.handle ==
+                 p_conn->cts_discovery_data.gatt_svc_changed_cccd_handle))
+            {
+                printf("Service Changed indications %s\n",
+                       (WICED_BT_GATT_SUCCESS == p_event->status) ? "enabled" : "failed");
+                ble_app_cache_next(p_conn);
+                break;
+            }
+#endif
+#if (ENABLE_LATENCY_TRACE)
+            if (p_event->data.operation.handle ==
+                p_conn->cts_discovery_data.cts_cccd_handle)
+            {
+                app_latency_response(p_event->data.operation.arrival_cycles,
+                                     p_event->data.operation.arrival_us);
+            }
+#endif
+            /* Check if GATT operation of enable/disable notification is success. */
+            if ((p_event->data.operation.handle
+                == (p_conn->cts_discovery_data.cts_cccd_handle))
+                && (WICED_BT_GATT_SUCCESS == p_event->status))
+            {
+                if(p_conn->notify_val)
+                {
+                    printf("Notifications enabled\n");
+                }
+                else
+                {
+                    printf("Notifications disabled\n");
+                }
+#if (ENABLE_BONDING)
+                /* A bonded server keeps this CCCD value across
+                 * reconnections */
+                app_bt_bond_update_cts_cache(p_conn->bd_addr,
+                                             &p_conn->cts_discovery_data,
+                                             p_conn->notify_val);
+#endif
+            }
+            else
+            {
+#if (ENABLE_METRICS)
+                if (p_event->data.operation.handle ==
+                    p_conn->cts_discovery_data.cts_cccd_handle)
+                {
+                    app_metrics_inc(METRIC_CCCD_WRITE_FAILURES);
+                }
+#endif
+                printf("CCCD update failed. Error code: %d\n", p_event->status);
+            }
+            break;
+
+        case GATTC_OPTYPE_NOTIFICATION:
+            ble_app_time_value_handler(p_conn, &value, p_event->data.operation.arrival_us,
+                                       false);
+            break;
+
+#if (ENABLE_ROBUST_CACHING)
+        case GATTC_OPTYPE_INDICATION:
+            if (p_event->data.operation.handle ==
+                p_conn->cts_discovery_data.gatt_svc_changed_val_handle)
+            {
+                ble_app_service_changed_handler(p_conn, &value);
+            }
+            break;
+#endif
+
+        case GATTC_OPTYPE_READ_HANDLE:
+#if (ENABLE_CURRENT_TIME_READ)
+            if ((0 != p_conn->read_handle) &&
+                (p_conn->read_handle == p_conn->cts_discovery_data.cts_char_val_handle))
+            {
+                p_conn->read_handle = 0;
+                if (WICED_BT_GATT_SUCCESS == p_event->status)
+                {
+                    ble_app_time_value_handler(p_conn, &value,
+                                               p_event->data.operation.arrival_us, true);
+                }
+                if (p_conn->ref_info_pending)
+                {
+                    p_conn->ref_info_pending = false;
+#if (ENABLE_TIME_FUSION)
+                    ble_app_read_reference_info(p_conn);
+#endif
+                }
+                break;
+            }
+#endif
+#if (ENABLE_ROBUST_CACHING)
+            if ((0 != p_conn->read_handle) &&
+                (p_conn->read_handle == p_conn->cts_discovery_data.gatt_db_hash_val_handle))
+            {
+                p_conn->read_handle = 0;
+                ble_app_db_hash_handler(p_conn, p_event->status, &value);
+                break;
+            }
+#endif
+#if (ENABLE_LOCAL_TIME)
+            if ((0 != p_conn->read_handle) &&
+                (p_conn->read_handle == p_conn->cts_discovery_data.cts_local_time_val_handle))
+            {
+                p_conn->read_handle = 0;
+                ble_app_local_time_handler(p_conn, p_event->status, &value);
+                break;
+            }
+#endif
+            p_conn->read_handle = 0;
+#if (ENABLE_TIME_FUSION)
+            if (WICED_BT_GATT_SUCCESS == p_event->status)
+            {
+                ble_app_reference_info_handler(p_conn, &value);
+            }
+#endif
+            break;
+
+        default:
+            break;
+    }
+
+#if (ENABLE_LOCAL_TIME)
+    /* A time zone or DST change notified during another read */
+    ble_app_local_time_reread(p_conn);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: ble_app_print_callback_stats()
+********************************************************************************
+* Summary:
+*   Prints the time spent in the GATT callback and the events dropped on a
+*   full application queue.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_print_callback_stats(void)
+{
+    printf("GATT callback: %lu calls, avg %lu us, max %lu us, %lu values dropped, "
+           "%lu events lost\n",
+           (unsigned long)callback_count,
+           (unsigned long)((0 != callback_count) ? (callback_total_us / callback_count) : 0u),
+           (unsigned long)callback_max_us, (unsigned long)app_event_dropped,
+           (unsigned long)app_event_lost);
+}
+
+/*******************************************************************************
+* Function Name:  ble_app_connect_handler()
+********************************************************************************
+* Summary:
+*   This function handles connection status changes.
+*
+* Parameters:
+*   const app_event_t *p_event : Connected or disconnected event
+*
+* Return:
+*  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e
+*                          in wiced_bt_gatt.h
+*
+*******************************************************************************/
+static wiced_bt_gatt_status_t
+ble_app_connect_handler(const app_event_t *p_event)
+{
+    wiced_bt_gatt_status_t gatt_status =  WICED_BT_GATT_SUCCESS;
+    cts_conn_t *p_conn = NULL;
+#if (ENABLE_BONDING)
+    bond_info_t bond;
+    wiced_bt_ble_sec_action_type_t sec_act = BTM_BLE_SEC_ENCRYPT;
+    wiced_result_t sec_result;
+#endif
+    if ( APP_EVENT_CONNECTED == p_event->type )
+    {
+        /* Device has connected */
+#if (ENABLE_BINARY_OUTPUT)
+        app_bin_log_connect(p_event->conn_id, p_event->data.link.bd_addr,
+                            (uint8_t)p_event->data.link.addr_type);
+#else
+        printf("Connected : BDA " );
+        print_bd_address((uint8_t *)p_event->data.link.bd_addr);
+        printf("Connection ID '%d' \n", p_event->conn_id );
+#endif
+
+#if !(ENABLE_CENTRAL_MODE)
+        app_bt_adv_connection_up();
+#endif
+#if (ENABLE_METRICS)
+        app_metrics_inc(METRIC_CONNECTS);
+        app_metrics_gauge_add(METRIC_GAUGE_CONNECTIONS, 1);
+#endif
+
+#if (ENABLE_CTS_SERVER)
+        if (ble_app_is_server_peer(p_event))
+        {
+            /* A peer of the CTS server takes no time source slot and gets
+             * no CTS discovery and no security request */
+            if (!app_cts_server_connected(p_event->conn_id))
+            {
+                printf("No free CTS server peer slot, disconnecting\n");
+                wiced_bt_gatt_disconnect(p_event->conn_id);
+                return WICED_BT_GATT_NO_RESOURCES;
+            }
+            printf("CTS server peer, %lu of %u\n",
+                   (unsigned long)app_cts_server_peer_count(), CTS_SERVER_MAX_PEERS);
+#if !(ENABLE_CENTRAL_MODE)
+            if (app_cts_server_peer_count() < CTS_SERVER_MAX_PEERS)
+            {
+                (void)ble_app_advertise(true);
+            }
+#endif
+            return gatt_status;
+        }
+#endif
+
+#if (ENABLE_CENTRAL_MODE)
+        /* A time source, possibly the server the scan is connecting to */
+        app_bt_scan_connection_up(p_event->data.link.bd_addr);
+#endif
+
+        /* Store the connection ID in a free connection slot */
+        p_conn = cts_conn_find(0);
+        if (NULL == p_conn)
+        {
+            printf("No free connection slot, disconnecting\n");
+            wiced_bt_gatt_disconnect(p_event->conn_id);
+            return WICED_BT_GATT_NO_RESOURCES;
+        }
+        memset(p_conn, 0, sizeof(*p_conn));
+        p_conn->conn_id = p_event->conn_id;
+        p_conn->addr_type = p_event->data.link.addr_type;
+        /* After connection, successive button presses must enable/disable
+        notification from server */
+        button_press_for_adv = false;
+
+        memcpy(p_conn->bd_addr, p_event->data.link.bd_addr, BD_ADDR_LEN);
+        p_conn->connection_start_tick = xTaskGetTickCount();
+        p_conn->gatt_request_count = 0;
+        /* Every link starts on the LE 1M PHY */
+        p_conn->tx_phy = APP_BT_PHY_1M;
+        p_conn->rx_phy = APP_BT_PHY_1M;
+#if (ENABLE_LE_2M_PHY)
+        /* Ask for 2M before the discovery, so that it can run on 2M */
+        ble_app_request_2m_phy(p_conn);
+#endif
+        /* Server does not notify a new (non bonded) client */
+        p_conn->notify_val = false;
+#if (CTS_SOURCE_BY_DISCOVERY)
+        /* Until the discovery shows whether the link offers CTS, it is also
+         * a peer of the CTS server and may subscribe meanwhile */
+        (void)app_cts_server_connected(p_conn->conn_id);
+#endif
+
+#if (ENABLE_BONDING)
+        if (app_bt_bond_find(p_conn->bd_addr, &bond))
+        {
+#if (CTS_SOURCE_BY_DISCOVERY)
+            /* Only time sources are bonded */
+            app_cts_server_disconnected(p_conn->conn_id);
+#endif
+            /* Bonded server: encrypt the link with the stored keys. With
+             * known handles the cached ones are reused once the link is
+             * encrypted instead of discovering them again */
+            p_conn->cts_restore_pending = bond.cts_handles.cts_service_found;
+            printf("Bonded server, requesting encryption\n");
+            sec_result = wiced_bt_dev_set_encryption(p_conn->bd_addr,
+                                                     BT_TRANSPORT_LE, &sec_act);
+            if (WICED_BT_PENDING != sec_result)
+            {
+                /* No encryption status event follows, so the handles are
+                 * discovered rather than waiting for it */
+                printf("Encryption request failed: %d\n", (int)sec_result);
+                p_conn->cts_restore_pending = false;
+            }
+        }
+        else
+        {
+            p_conn->cts_restore_pending = false;
+#if !(CTS_SOURCE_BY_DISCOVERY)
+            /* A peer is not bonded, so pairing waits for the discovery */
+            ble_app_request_pairing(p_conn);
+#endif
+        }
+        if (!p_conn->cts_restore_pending)
+        {
+            gatt_status = ble_app_start_cts_discovery(p_conn);
+        }
+#else
+        gatt_status = ble_app_start_cts_discovery(p_conn);
+#endif
+
+#if (ENABLE_CENTRAL_MODE)
+        /* Keep looking for further servers while connection slots are free */
+        if (cts_conn_count() < CTS_MAX_CONNECTIONS)
+        {
+            (void)ble_app_advertise(true);
+        }
+#if (ENABLE_PA_SYNC)
+        else
+        {
+            app_bt_pa_sync_scan_resume();
+        }
+#endif
+#elif (ENABLE_CTS_SERVER)
+        /* Stay connectable for further time sources and peers while slots
+         * are free */
+        if ((cts_conn_count() < CTS_MAX_CONNECTIONS) ||
+            (app_cts_server_peer_count() < CTS_SERVER_MAX_PEERS))
+        {
+            (void)ble_app_advertise(true);
+        }
+#endif
+    }
+    else
+    {
+        /* Device has disconnected */
+#if (ENABLE_BINARY_OUTPUT)
+        app_bin_log_disconnect(p_event->conn_id, p_event->data.link.reason);
+#else
+        printf("Disconnected : BDA " );
+        print_bd_address((uint8_t *)p_event->data.link.bd_addr);
+        printf("Connection ID '%d', Reason '%s'\n", p_event->conn_id,
+                get_bt_gatt_disconn_reason_name(
+                    (wiced_bt_gatt_disconn_reason_t)p_event->data.link.reason) );
+#endif
+#if (ENABLE_METRICS)
+        app_metrics_disconnect(p_event->data.link.reason);
+        app_metrics_gauge_add(METRIC_GAUGE_CONNECTIONS, -1);
+#endif
+
+#if (ENABLE_CENTRAL_MODE)
+        /* Either a connection attempt to a scanned server failed or the
+         * server can be scanned for again */
+        app_bt_scan_connection_down(p_event->data.link.bd_addr);
+#if (ENABLE_PA_SYNC)
+        app_bt_pa_sync_scan_resume();
+#endif
+#endif
+
+        p_conn = cts_conn_find(p_event->conn_id);
+        if (NULL != p_conn)
+        {
+#if (ENABLE_TIME_FUSION)
+            /* The time of this server no longer takes part in the fusion */
+            cts_fusion_remove_server(p_conn->conn_id);
+#endif
+            /* Set the connection id to zero to indicate disconnected state */
+            p_conn->conn_id = 0;
+
+            /* Service discovery is performed upon reconnection, so reset the
+                * status of service found flag */
+            p_conn->cts_discovery_data.cts_service_found = false;
+            p_conn->cts_restore_pending = false;
+        }
+#if (ENABLE_CTS_SERVER)
+        app_cts_server_disconnected(p_event->conn_id);
+#if !(ENABLE_CENTRAL_MODE)
+        /* Connectable again for the free slot while other links are up */
+        if ((0 != cts_conn_count()) || (0 != app_cts_server_peer_count()))
+        {
+            (void)ble_app_advertise(true);
+        }
+#endif
+#endif
+        ble_app_print_callback_stats();
+#if !(ENABLE_CENTRAL_MODE)
+        app_bt_adv_print_stats();
+#endif
+#if (ENABLE_CTS_SERVER)
+        app_cts_server_print_stats();
+#endif
+#if (ENABLE_METRICS)
+        app_metrics_print();
+#endif
+#if (ENABLE_LATENCY_TRACE)
+        /* The write responses of this server will not arrive */
+        app_latency_abort();
+        app_latency_report();
+#endif
+#if (ENABLE_UART_TX_ASYNC)
+        app_uart_tx_print_stats();
+#endif
+#if (ENABLE_ZERO_HEAP)
+        app_heap_report();
+#endif
+#if (ENABLE_TRACE_RECORDER)
+        app_trace_dump();
+#endif
+        /* First button press after the last disconnection must start
+         * advertisement */
+        button_press_for_adv = (0 == cts_conn_count());
+    }
+    return gatt_status;
+}
+
+/********************************************************************************
+* Function Name:  ble_app_discovery_result_handler()
+*********************************************************************************
+* Summary:
+*   This function adds discovery results from bluetooth stack to the handle
+*   map of the connection.
+*
+* Parameters:
+*   const app_event_t *p_event : Discovery result event
+*
+* Return:
+*  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e
+*                          in wiced_bt_gatt.h
+*
+*********************************************************************************/
+static wiced_bt_gatt_status_t
+ble_app_discovery_result_handler(const app_event_t *p_event)
+{
+    cts_conn_t *p_conn = cts_conn_find(p_event->conn_id);
+    if (NULL == p_conn)
+    {
+        return WICED_BT_GATT_ERROR;
+    }
+    app_bt_disc_result(&p_conn->discovery, p_event->op, p_event->data.discovery.uuid16,
+                       p_event->data.discovery.handle, p_event->data.discovery.end_handle,
+                       p_event->data.discovery.properties);
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/********************************************************************************
+* Function Name:  ble_app_service_discovery_handler()
+*********************************************************************************
+* Summary:
+*   This function handles the end of a discovery procedure. The discovery
+*   engine sends the next request until the handle map is complete.
+*
+* Parameters:
+*   const app_event_t *p_event : Discovery complete event
+*
+* Return:
+*  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e
+*                          in wiced_bt_gatt.h
+*
+*********************************************************************************/
+static wiced_bt_gatt_status_t
+ble_app_service_discovery_handler(const app_event_t *p_event)
+{
+    cts_conn_t *p_conn = cts_conn_find(p_event->conn_id);
+    if (NULL == p_conn)
+    {
+        return WICED_BT_GATT_ERROR;
+    }
+#if (ENABLE_METRICS)
+    if (WICED_BT_GATT_SUCCESS != p_event->status)
+    {
+        app_metrics_inc(METRIC_DISCOVERY_FAILURES);
+    }
+#endif
+    if (app_bt_disc_complete(&p_conn->discovery, p_event->op, p_event->status))
+    {
+        ble_app_discovery_done(p_conn);
+    }
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: ble_app_discovery_done()
+********************************************************************************
+* Summary:
+*   Takes the CTS handles from the handle map of a finished discovery and
+*   reports the handles found.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_discovery_done(cts_conn_t *p_conn)
+{
+    cts_discovery_data_t *p_cts = &p_conn->cts_discovery_data;
+    const app_bt_disc_t *p_disc = &p_conn->discovery;
+    const app_bt_disc_char_handles_t *p_char;
+
+    p_conn->gatt_request_count += p_disc->requests;
+    p_conn->discovery_ms = (uint32_t)((xTaskGetTickCount() - p_conn->connection_start_tick) *
+                                      portTICK_PERIOD_MS);
+    memset(p_cts, 0, sizeof(*p_cts));
+    p_cts->cts_start_handle = p_disc->services[DISCOVERY_TABLE_CTS].start_handle;
+    p_cts->cts_end_handle = p_disc->services[DISCOVERY_TABLE_CTS].end_handle;
+
+    p_char = app_bt_disc_find_char(p_disc, UUID_SERVICE_CURRENT_TIME,
+                                   UUID_CHARACTERISTIC_CURRENT_TIME);
+    if (NULL != p_char)
+    {
+        p_cts->cts_char_handle = p_char->decl_handle;
+        p_cts->cts_char_val_handle = p_char->val_handle;
+        p_cts->cts_cccd_handle = p_char->desc_handle[0];
+    }
+    p_char = app_bt_disc_find_char(p_disc, UUID_SERVICE_CURRENT_TIME,
+                                   UUID_CHARACTERISTIC_REFERENCE_TIME_INFORMATION);
+    if (NULL != p_char)
+    {
+        p_cts->cts_ref_time_val_handle = p_char->val_handle;
+    }
+    p_char = app_bt_disc_find_char(p_disc, UUID_SERVICE_CURRENT_TIME,
+                                   UUID_CHARACTERISTIC_LOCAL_TIME_INFORMATION);
+    if (NULL != p_char)
+    {
+        p_cts->cts_local_time_val_handle = p_char->val_handle;
+    }
+    p_char = app_bt_disc_find_char(p_disc, UUID_SERVICE_GATT,
+                                   UUID_CHARACTERISTIC_SERVICE_CHANGED);
+    if (NULL != p_char)
+    {
+        p_cts->gatt_svc_changed_val_handle = p_char->val_handle;
+        p_cts->gatt_svc_changed_cccd_handle = p_char->desc_handle[0];
+    }
+    p_char = app_bt_disc_find_char(p_disc, UUID_SERVICE_GATT,
+                                   UUID_CHARACTERISTIC_DATABASE_HASH);
+    if (NULL != p_char)
+    {
+        p_cts->gatt_db_hash_val_handle = p_char->val_handle;
+    }
+
+#if (ENABLE_BINARY_OUTPUT)
+    app_bin_log_discovery(p_conn->conn_id, UUID_SERVICE_CURRENT_TIME,
+                          p_cts->cts_start_handle, p_cts->cts_end_handle);
+    app_bin_log_discovery(p_conn->conn_id, UUID_CHARACTERISTIC_CURRENT_TIME,
+                          p_cts->cts_char_handle, p_cts->cts_char_val_handle);
+    app_bin_log_discovery(p_conn->conn_id, UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
+                          p_cts->cts_cccd_handle, 0);
+#else
+    app_bt_disc_print(p_disc);
+#endif
+    printf("Conn %d: discovery done %lu ms after connection, PHY TX %s RX %s\n",
+           p_conn->conn_id, (unsigned long)p_conn->discovery_ms,
+           get_bt_phy_name(p_conn->tx_phy), get_bt_phy_name(p_conn->rx_phy));
+
+    if (0 == p_cts->cts_cccd_handle)
+    {
+        printf("Current Time Service with notifications not found\n");
+#if (CTS_SOURCE_BY_DISCOVERY)
+        ble_app_source_to_peer(p_conn);
+#elif (ENABLE_METRICS)
+        app_metrics_inc(METRIC_DISCOVERY_FAILURES);
+#endif
+        return;
+    }
+    p_cts->cts_service_found = true;
+#if (CTS_SOURCE_BY_DISCOVERY)
+    /* The link offers the time, so it is no peer */
+    app_cts_server_disconnected(p_conn->conn_id);
+#if (ENABLE_BONDING)
+    if (!app_bt_bond_find(p_conn->bd_addr, NULL))
+    {
+        ble_app_request_pairing(p_conn);
+    }
+#endif
+#endif
+    printf("Press User button on the kit to enable or disable "
+            "notifications \n");
+    p_conn->cache_step = GATT_CACHE_STEP_NONE;
+    ble_app_cache_next(p_conn);
+}
+
+/*******************************************************************************
+* Function Name: ble_app_cache_next()
+********************************************************************************
+* Summary:
+*   Runs the steps after a discovery one request at a time: the Database
+*   Hash is read and Service Changed indications are enabled, so that the
+*   cached handles can be checked on the next connection. CTS is reported
+*   ready and the handles are cached after the last step.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_cache_next(cts_conn_t *p_conn)
+{
+#if (ENABLE_ROBUST_CACHING)
+    switch (p_conn->cache_step)
+    {
+        case GATT_CACHE_STEP_NONE:
+            p_conn->cache_step = GATT_CACHE_STEP_READ_HASH;
+            if (ble_app_read_db_hash(p_conn))
+            {
+                return;
+            }
+            /* The server has no Database Hash */
+            /* fall through */
+
+        case GATT_CACHE_STEP_READ_HASH:
+            p_conn->cache_step = GATT_CACHE_STEP_SUBSCRIBE;
+            if (ble_app_write_service_changed_cccd(p_conn))
+            {
+                return;
+            }
+            break;
+
+        default:
+            break;
+    }
+#endif
+    p_conn->cache_step = GATT_CACHE_STEP_DONE;
+    ble_app_report_cts_ready(p_conn, false);
+#if (ENABLE_BONDING)
+    app_bt_bond_update_cts_cache(p_conn->bd_addr, &p_conn->cts_discovery_data,
+                                 p_conn->notify_val);
+#endif
+}
+
+#if (ENABLE_LE_2M_PHY)
+/*******************************************************************************
+* Function Name: ble_app_request_2m_phy()
+********************************************************************************
+* Summary:
+*   Asks the controller to move the link to the LE 2M PHY in both directions.
+*   The server may refuse, the link then stays on 1M. The result arrives with
+*   BTM_BLE_PHY_UPDATE_EVT.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_request_2m_phy(cts_conn_t *p_conn)
+{
+    wiced_bt_ble_phy_preferences_t phy_preferences;
+    wiced_result_t wiced_result;
+
+    memset(&phy_preferences, 0, sizeof(phy_preferences));
+    memcpy(phy_preferences.remote_bd_addr, p_conn->bd_addr, BD_ADDR_LEN);
+    phy_preferences.all_phys = 0;
+    phy_preferences.tx_phys = BTM_BLE_PREFER_2M_PHY;
+    phy_preferences.rx_phys = BTM_BLE_PREFER_2M_PHY;
+    phy_preferences.phy_opts = BTM_BLE_PREFER_CODED_PHY_NONE;
+    wiced_result = wiced_bt_ble_set_phy(&phy_preferences);
+    if (WICED_BT_SUCCESS != wiced_result)
+    {
+        printf("Conn %d: 2M PHY request failed! Error code: %X\n", p_conn->conn_id,
+               wiced_result);
+    }
+}
+#endif
+
+/*******************************************************************************
+* Function Name: ble_app_phy_update_handler()
+********************************************************************************
+* Summary:
+*   Stores the PHY of a link after a PHY update, requested by either side.
+*
+* Parameters:
+*   const app_event_t *p_event: PHY update event
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_phy_update_handler(const app_event_t *p_event)
+{
+    cts_conn_t *p_conn = cts_conn_find_by_addr(p_event->data.phy.bd_addr);
+
+    if (NULL == p_conn)
+    {
+        return;
+    }
+    if (WICED_BT_SUCCESS != p_event->status)
+    {
+        printf("Conn %d: PHY update failed, status %d, staying on TX %s RX %s\n",
+               p_conn->conn_id, p_event->status, get_bt_phy_name(p_conn->tx_phy),
+               get_bt_phy_name(p_conn->rx_phy));
+        return;
+    }
+    p_conn->tx_phy = p_event->data.phy.tx_phy;
+    p_conn->rx_phy = p_event->data.phy.rx_phy;
+    printf("Conn %d: PHY TX %s RX %s, %lu ms after connection\n", p_conn->conn_id,
+           get_bt_phy_name(p_conn->tx_phy), get_bt_phy_name(p_conn->rx_phy),
+           (unsigned long)((xTaskGetTickCount() - p_conn->connection_start_tick) *
+                           portTICK_PERIOD_MS));
+}
+
+#if (ENABLE_PA_SYNC)
+/*******************************************************************************
+* Function Name: ble_app_broadcast_sync_handler()
+********************************************************************************
+* Summary:
+*   Sets up the time source of the broadcaster when the sync to its periodic
+*   advertising is established, and removes it when the sync is lost.
+*
+* Parameters:
+*   const app_event_t *p_event: Broadcast sync event, status WICED_TRUE when
+*                               the sync was established
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_broadcast_sync_handler(const app_event_t *p_event)
+{
+    cts_conn_t *p_conn = &cts_conn[CTS_BROADCAST_SLOT];
+
+    if (WICED_TRUE == p_event->status)
+    {
+        memset(p_conn, 0, sizeof(*p_conn));
+        p_conn->conn_id = CTS_BROADCAST_CONN_ID;
+        memcpy(p_conn->bd_addr, p_event->data.link.bd_addr, BD_ADDR_LEN);
+        p_conn->connection_start_tick = xTaskGetTickCount();
+        return;
+    }
+
+#if (ENABLE_TIME_FUSION)
+    /* The time of the broadcaster no longer takes part in the fusion */
+    cts_fusion_remove_server(p_conn->conn_id);
+#endif
+    p_conn->conn_id = 0;
+}
+
+/*******************************************************************************
+* Function Name: ble_app_broadcast_time_handler()
+********************************************************************************
+* Summary:
+*   Handles the Current Time of a periodic advertising report like a
+*   notification, so that the filter, the decoder and the synchronization
+*   statistics of print_notification_data() apply to the broadcaster too.
+*
+* Parameters:
+*   const app_event_t *p_event: Broadcast time event
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_broadcast_time_handler(const app_event_t *p_event)
+{
+    cts_conn_t *p_conn = &cts_conn[CTS_BROADCAST_SLOT];
+    wiced_bt_gatt_data_t value;
+
+    if (CTS_BROADCAST_CONN_ID != p_conn->conn_id)
+    {
+        return;
+    }
+
+    value.p_data = (uint8_t *)p_event->data.operation.value;
+    value.len = p_event->data.operation.len;
+    ble_app_time_value_handler(p_conn, &value, p_event->data.operation.arrival_us, false);
+}
+
+/*******************************************************************************
+* Function Name: ble_app_broadcast_retry()
+********************************************************************************
+* Summary:
+*   Called from the FreeRTOS timer task when a failed sync to the broadcaster
+*   is due to be retried. Posts an event so that the sync is requested again
+*   in the application task.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_broadcast_retry(void)
+{
+    app_event_t app_event = { .type = APP_EVENT_BROADCAST_RETRY };
+
+    if (pdTRUE != xQueueSend(app_event_queue, &app_event, 0))
+    {
+        app_event_lost++;
+    }
+}
+#endif
+
+#if (ENABLE_ROBUST_CACHING)
+/*******************************************************************************
+* Function Name: ble_app_read_db_hash()
+********************************************************************************
+* Summary:
+*   Reads the Database Hash of a server. It changes whenever the server's
+*   database changes.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*
+* Return:
+*   bool: true if the read was sent
+*
+*******************************************************************************/
+static bool ble_app_read_db_hash(cts_conn_t *p_conn)
+{
+    wiced_bt_gatt_status_t gatt_status;
+
+    if (0 == p_conn->cts_discovery_data.gatt_db_hash_val_handle)
+    {
+        return false;
+    }
+
+    gatt_status = wiced_bt_gatt_client_send_read_handle(p_conn->conn_id,
+                      p_conn->cts_discovery_data.gatt_db_hash_val_handle, 0,
+                      p_conn->read_buf, sizeof(p_conn->read_buf),
+                      GATT_AUTH_REQ_NONE);
+    p_conn->gatt_request_count++;
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Database Hash read failed! Error code: %d\n", gatt_status);
+        return false;
+    }
+    p_conn->read_handle = p_conn->cts_discovery_data.gatt_db_hash_val_handle;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ble_app_db_hash_handler()
+********************************************************************************
+* Summary:
+*   Handles the Database Hash read. After a discovery the hash is kept with
+*   the handles. On a bonded reconnection it is compared with the cached
+*   hash: the cached handles are used if it matches, otherwise the server is
+*   discovered again.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*   uint8_t status: Status of the read
+*   wiced_bt_gatt_data_t *p_value: Hash read from the server
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_db_hash_handler(cts_conn_t *p_conn, uint8_t status,
+                                    wiced_bt_gatt_data_t *p_value)
+{
+    cts_discovery_data_t *p_cts = &p_conn->cts_discovery_data;
+    bool valid = (WICED_BT_GATT_SUCCESS == status) && (GATT_DB_HASH_LEN == p_value->len);
+
+    if (GATT_CACHE_STEP_CHECK_HASH == p_conn->cache_step)
+    {
+        if (valid && (0 == memcmp(p_cts->gatt_db_hash, p_value->p_data, GATT_DB_HASH_LEN)))
+        {
+            p_conn->cache_step = GATT_CACHE_STEP_DONE;
+            printf("Database Hash unchanged, cached handles used\n");
+            ble_app_report_cts_ready(p_conn, true);
+            printf("Notifications %s (restored from bond)\n",
+                   p_conn->notify_val ? "enabled" : "disabled");
+            return;
+        }
+        printf("Database Hash changed, discovering the server again\n");
+        memset(p_cts, 0, sizeof(*p_cts));
+        p_conn->notify_val = false;
+        ble_app_start_cts_discovery(p_conn);
+        return;
+    }
+
+    p_cts->gatt_db_hash_valid = valid;
+    if (valid)
+    {
+        memcpy(p_cts->gatt_db_hash, p_value->p_data, GATT_DB_HASH_LEN);
+    }
+    ble_app_cache_next(p_conn);
+}
+
+/*******************************************************************************
+* Function Name: ble_app_write_service_changed_cccd()
+********************************************************************************
+* Summary:
+*   Enables Service Changed indications of a server. A bonded server keeps
+*   the setting, so this is only needed after a discovery.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*
+* Return:
+*   bool: true if the write was sent
+*
+*******************************************************************************/
+static bool ble_app_write_service_changed_cccd(cts_conn_t *p_conn)
+{
+    wiced_bt_gatt_write_hdr_t write_hdr = {0};
+    wiced_bt_gatt_status_t    gatt_status;
+
+    if (0 == p_conn->cts_discovery_data.gatt_svc_changed_cccd_handle)
+    {
+        return false;
+    }
+
+    p_conn->sc_cccd_buf[0] = GATT_CLIENT_CONFIG_INDICATION;
+    p_conn->sc_cccd_buf[1] = 0;
+    write_hdr.auth_req = GATT_AUTH_REQ_NONE;
+    write_hdr.handle = p_conn->cts_discovery_data.gatt_svc_changed_cccd_handle;
+    write_hdr.len = sizeof(p_conn->sc_cccd_buf);
+    write_hdr.offset = 0;
+    gatt_status = wiced_bt_gatt_client_send_write(p_conn->conn_id, GATT_REQ_WRITE,
+                                                  &write_hdr, p_conn->sc_cccd_buf, NULL);
+    p_conn->gatt_request_count++;
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Service Changed CCCD write failed! Error code: %d\n", gatt_status);
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ble_app_service_changed_handler()
+********************************************************************************
+* Summary:
+*   Handles a Service Changed indication. The handles of the server may have
+*   moved, so the cached ones are dropped and the server is discovered again.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*   wiced_bt_gatt_data_t *p_value: Start and end of the changed handle range
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_service_changed_handler(cts_conn_t *p_conn,
+                                            wiced_bt_gatt_data_t *p_value)
+{
+    if (p_value->len >= 4u)
+    {
+        printf("Service Changed: handles %d-%d\n",
+               p_value->p_data[0] | (p_value->p_data[1] << 8),
+               p_value->p_data[2] | (p_value->p_data[3] << 8));
+    }
+
+    memset(&p_conn->cts_discovery_data, 0, sizeof(p_conn->cts_discovery_data));
+    p_conn->notify_val = false;
+#if (ENABLE_BONDING)
+    /* A reconnection must not use the old handles */
+    app_bt_bond_update_cts_cache(p_conn->bd_addr, &p_conn->cts_discovery_data, false);
+#endif
+    ble_app_start_cts_discovery(p_conn);
+}
+#endif /* ENABLE_ROBUST_CACHING */
+
+/*******************************************************************************
+* Function Name: ble_app_write_notification_cccd()
+********************************************************************************
+* Summary:
+*   Enable/Disable GATT notification from the server.
+*
+* Parameters:
+*   cts_conn_t *p_conn : Connection to the server
+*   bool notify : true - to enable notifications
+*                 false - to disable notifications
+*
+* Return:
+*   wiced_bt_gatt_status_t  : Status code from wiced_bt_gatt_status_e.
+*
+*******************************************************************************/
+static wiced_bt_gatt_status_t ble_app_write_notification_cccd(cts_conn_t *p_conn,
+                                                              bool notify)
+{
+    wiced_bt_gatt_write_hdr_t  write_hdr = {0};
+    wiced_bt_gatt_status_t     gatt_status = WICED_BT_GATT_SUCCESS;
+
+    /* The stack sends the value from this buffer after the call returns, so
+     * it lives in the connection state rather than on the stack */
+    p_conn->cccd_buf[0] = notify;
+    p_conn->cccd_buf[1] = 0;
+    write_hdr.auth_req = GATT_AUTH_REQ_NONE;
+    write_hdr.handle = p_conn->cts_discovery_data.cts_cccd_handle;
+    write_hdr.len      = sizeof(p_conn->cccd_buf);
+    write_hdr.offset = 0;
+    gatt_status = wiced_bt_gatt_client_send_write(p_conn->conn_id,
+                                                  GATT_REQ_WRITE,
+                                                  &write_hdr,
+                                                  p_conn->cccd_buf,
+                                                  NULL);
+    p_conn->gatt_request_count++;
+#if (ENABLE_METRICS)
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        app_metrics_inc(METRIC_CCCD_WRITE_FAILURES);
+    }
+#endif
+    return gatt_status;
+}
+
+/*******************************************************************************
+* Function Name: ble_app_start_cts_discovery()
+********************************************************************************
+* Summary:
+*   Starts the discovery of the services in discovery_table: the Current Time
+*   Service, and the Battery and Device Information services if the server
+*   has them.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*
+* Return:
+*   wiced_bt_gatt_status_t  : Status code from wiced_bt_gatt_status_e.
+*
+*******************************************************************************/
+static wiced_bt_gatt_status_t ble_app_start_cts_discovery(cts_conn_t *p_conn)
+{
+    wiced_bt_gatt_status_t gatt_status;
+
+    gatt_status = app_bt_disc_start(&p_conn->discovery, p_conn->conn_id, discovery_table,
+                                    (uint8_t)(sizeof(discovery_table) /
+                                              sizeof(discovery_table[0])));
+    if(WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+#if (ENABLE_METRICS)
+        app_metrics_inc(METRIC_DISCOVERY_FAILURES);
+#endif
+        printf("GATT Discovery request failed. Error code: %d, "
+                "Conn id: %d\n", gatt_status, p_conn->conn_id);
+    }
+    else
+    {
+        printf("Service Discovery Started\n");
+    }
+    return gatt_status;
+}
+
+#if (ENABLE_BONDING)
+/*******************************************************************************
+* Function Name: ble_app_encryption_status_handler()
+********************************************************************************
+* Summary:
+*   Handles the result of link encryption. For a bonded server the cached CTS
+*   handles and CCCD state are restored, so notifications resume without
+*   service discovery or a CCCD write. If encryption fails the handles are
+*   discovered again.
+*
+* Parameters:
+*   const app_event_t *p_event: Encryption status event
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_encryption_status_handler(const app_event_t *p_event)
+{
+    bond_info_t bond;
+    cts_conn_t *p_conn = cts_conn_find_by_addr(p_event->data.link.bd_addr);
+
+    printf("Encryption status: %s\n",
+           (WICED_BT_SUCCESS == p_event->status) ? "Encrypted" : "Failed");
+
+    if ((NULL == p_conn) || (!p_conn->cts_restore_pending))
+    {
+        return;
+    }
+    p_conn->cts_restore_pending = false;
+
+    if ((WICED_BT_SUCCESS == p_event->status) &&
+        app_bt_bond_find(p_conn->bd_addr, &bond))
+    {
+        memcpy(&p_conn->cts_discovery_data, &bond.cts_handles,
+               sizeof(p_conn->cts_discovery_data));
+        p_conn->notify_val = bond.notify_enabled;
+#if (ENABLE_ROBUST_CACHING)
+        /* One hash read confirms that the cached handles are still valid */
+        if (p_conn->cts_discovery_data.gatt_db_hash_valid)
+        {
+            p_conn->cache_step = GATT_CACHE_STEP_CHECK_HASH;
+            if (ble_app_read_db_hash(p_conn))
+            {
+                return;
+            }
+        }
+#endif
+        p_conn->cache_step = GATT_CACHE_STEP_DONE;
+        ble_app_report_cts_ready(p_conn, true);
+        printf("Notifications %s (restored from bond)\n",
+               p_conn->notify_val ? "enabled" : "disabled");
+    }
+    else
+    {
+        /* Bond no longer valid on the server, fall back to discovery */
+        ble_app_start_cts_discovery(p_conn);
+    }
+}
+
+/*******************************************************************************
+* Function Name: ble_app_request_pairing()
+********************************************************************************
+* Summary:
+*   Sends a security request to a time source without a bond, which starts
+*   pairing and bonding.
+*
+* Parameters:
+*   const cts_conn_t *p_conn: Connection to the time source
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_request_pairing(const cts_conn_t *p_conn)
+{
+    if (WICED_BT_PENDING != wiced_bt_dev_sec_bond((uint8_t *)p_conn->bd_addr,
+                                                  p_conn->addr_type,
+                                                  BT_TRANSPORT_LE, 0, NULL))
+    {
+        printf("Security request failed\n");
+    }
+}
+
+/*******************************************************************************
+* Function Name: ble_app_bond_flush_request()
+********************************************************************************
+* Summary:
+*   Called when the bond store changed, mostly from the management callback
+*   in the stack thread. Posts an event so that the store is written to
+*   flash in the application task. Also called from the application task
+*   itself, so it never waits for the queue.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   bool: true if the event was posted
+*
+*******************************************************************************/
+static bool ble_app_bond_flush_request(void)
+{
+    app_event_t app_event = { .type = APP_EVENT_BOND_FLUSH };
+
+    if (pdTRUE != xQueueSend(app_event_queue, &app_event, 0))
+    {
+        app_event_lost++;
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ble_app_pairing_complete_handler()
+********************************************************************************
+* Summary:
+*   Handles the end of pairing. CTS handles discovered before the bond existed
+*   are cached now.
+*
+* Parameters:
+*   const app_event_t *p_event: Pairing complete event
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_pairing_complete_handler(const app_event_t *p_event)
+{
+    cts_conn_t *p_conn = cts_conn_find_by_addr(p_event->data.link.bd_addr);
+
+    printf("Pairing complete, status: %s\n",
+           get_bt_smp_status_name((wiced_bt_smp_status_t)p_event->status));
+    if ((NULL != p_conn) && (p_conn->cts_discovery_data.cts_service_found))
+    {
+        app_bt_bond_update_cts_cache(p_conn->bd_addr,
+                                     &p_conn->cts_discovery_data,
+                                     p_conn->notify_val);
+    }
+}
+#endif /* ENABLE_BONDING */
+
+/*******************************************************************************
+* Function Name: ble_app_report_cts_ready()
+********************************************************************************
+* Summary:
+*   Prints the time from connection until the CTS handles were available and
+*   the number of GATT requests that were sent for it. A bonded reconnection
+*   needs no discovery and no CCCD write. Then reads the Local Time
+*   Information, the Current Time and the Reference Time Information of the
+*   server.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*   bool from_bond: true if the handles were restored from the bond store
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_report_cts_ready(cts_conn_t *p_conn, bool from_bond)
+{
+    printf("Conn %d: CTS ready %s: %lu ms after connection, %lu GATT request(s)%s\n",
+           p_conn->conn_id, from_bond ? "from bond" : "after discovery",
+           (unsigned long)((xTaskGetTickCount() - p_conn->connection_start_tick) *
+                           portTICK_PERIOD_MS),
+           (unsigned long)p_conn->gatt_request_count,
+           from_bond ? "" : ", CCCD write pending");
+
+#if (ENABLE_LOCAL_TIME)
+    /* The time zone first, so that the first time can be converted to UTC.
+     * The time and accuracy follow */
+    if (ble_app_read_local_time_info(p_conn))
+    {
+        p_conn->time_info_pending = true;
+        return;
+    }
+#endif
+    ble_app_read_time_info(p_conn);
+}
+
+/*******************************************************************************
+* Function Name: ble_app_read_time_info()
+********************************************************************************
+* Summary:
+*   Reads the Current Time and Reference Time Information of a server, one
+*   after the other.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_read_time_info(cts_conn_t *p_conn)
+{
+#if (ENABLE_CURRENT_TIME_READ)
+    /* One read at a time, the Reference Time Information follows */
+    if (ble_app_read_current_time(p_conn))
+    {
+        p_conn->ref_info_pending = true;
+        return;
+    }
+#endif
+#if (ENABLE_TIME_FUSION)
+    /* The accuracy of the server weights its time in the fusion */
+    ble_app_read_reference_info(p_conn);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: ble_app_time_value_handler()
+********************************************************************************
+* Summary:
+*   Handles a Current Time value, notified or read. Both take the same path
+*   through the notification filter and the time handling. The time from
+*   connection to the first valid time is reported, and with the read
+*   enabled also the time to the first notification, which is what the
+*   client would have waited without it.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*   wiced_bt_gatt_data_t *p_value: Current Time value
+*   uint64_t arrival_us: Local time the value arrived
+*   bool from_read: true for a read response, false for a notification
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_time_value_handler(cts_conn_t *p_conn, wiced_bt_gatt_data_t *p_value,
+                                       uint64_t arrival_us, bool from_read)
+{
+    uint32_t elapsed_ms = (uint32_t)((xTaskGetTickCount() - p_conn->connection_start_tick) *
+                                     portTICK_PERIOD_MS);
+    current_time_data_t time_data;
+    int64_t epoch_us;
+
+    if ((0u == p_conn->first_notif_ms) && (!from_read))
+    {
+        p_conn->first_notif_ms = (0u != elapsed_ms) ? elapsed_ms : 1u;
+        if (0u != p_conn->first_time_ms)
+        {
+            printf("Conn %d: first notification %lu ms after connection, "
+                   "the read gave the time %lu ms earlier\n", p_conn->conn_id,
+                   (unsigned long)p_conn->first_notif_ms,
+                   (unsigned long)(p_conn->first_notif_ms - p_conn->first_time_ms));
+        }
+    }
+    if ((0u == p_conn->first_time_ms) &&
+        cts_decode_current_time(p_value->p_data, p_value->len, &time_data) &&
+        cts_time_to_epoch_us(&time_data, &epoch_us))
+    {
+        p_conn->first_time_ms = (0u != elapsed_ms) ? elapsed_ms : 1u;
+        printf("Conn %d: first valid time %lu ms after connection, from %s\n",
+               p_conn->conn_id, (unsigned long)p_conn->first_time_ms,
+               from_read ? "read" : "notification");
+    }
+
+#if (ENABLE_NOTIFICATION_FILTER)
+    /* Drop notifications that only confirm the expected time. Reads are
+     * always printed */
+    if ((!from_read) && (!ble_app_notification_filter(p_conn, p_value, arrival_us)))
+    {
+        return;
+    }
+#endif
+    /* Function call to print the time and date notifcation */
+    print_notification_data(p_conn, *p_value, arrival_us);
+}
+
+#if (ENABLE_CURRENT_TIME_READ)
+/*******************************************************************************
+* Function Name: ble_app_read_current_time()
+********************************************************************************
+* Summary:
+*   Reads the Current Time of a server, so that the client has a time before
+*   the first notification.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*
+* Return:
+*   bool: true if the read was sent
+*
+*******************************************************************************/
+static bool ble_app_read_current_time(cts_conn_t *p_conn)
+{
+    wiced_bt_gatt_status_t gatt_status;
+
+    if (0 == p_conn->cts_discovery_data.cts_char_val_handle)
+    {
+        return false;
+    }
+
+    gatt_status = wiced_bt_gatt_client_send_read_handle(p_conn->conn_id,
+                      p_conn->cts_discovery_data.cts_char_val_handle, 0,
+                      p_conn->read_buf, sizeof(p_conn->read_buf),
+                      GATT_AUTH_REQ_NONE);
+    p_conn->gatt_request_count++;
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Current Time read failed! Error code: %d\n", gatt_status);
+        return false;
+    }
+    p_conn->read_handle = p_conn->cts_discovery_data.cts_char_val_handle;
+    return true;
+}
+#endif
+
+#if (ENABLE_LOCAL_TIME)
+/*******************************************************************************
+* Function Name: ble_app_read_local_time_info()
+********************************************************************************
+* Summary:
+*   Reads the optional Local Time Information characteristic of a server.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*
+* Return:
+*   bool: true if the read was sent
+*
+*******************************************************************************/
+static bool ble_app_read_local_time_info(cts_conn_t *p_conn)
+{
+    wiced_bt_gatt_status_t gatt_status;
+
+    if (0 == p_conn->cts_discovery_data.cts_local_time_val_handle)
+    {
+        return false;
+    }
+
+    gatt_status = wiced_bt_gatt_client_send_read_handle(p_conn->conn_id,
+                      p_conn->cts_discovery_data.cts_local_time_val_handle, 0,
+                      p_conn->read_buf, sizeof(p_conn->read_buf),
+                      GATT_AUTH_REQ_NONE);
+    p_conn->gatt_request_count++;
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Local Time Information read failed! Error code: %d\n",
+               gatt_status);
+        return false;
+    }
+    p_conn->read_handle = p_conn->cts_discovery_data.cts_local_time_val_handle;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ble_app_local_time_handler()
+********************************************************************************
+* Summary:
+*   Stores the Local Time Information read from a server. Its offset to UTC
+*   is computed here once, so local time conversions need no further reads.
+*   Then reads the Current Time and Reference Time Information if they wait
+*   for this read.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*   uint8_t status: Status of the read
+*   wiced_bt_gatt_data_t *p_value: Characteristic value read
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_local_time_handler(cts_conn_t *p_conn, uint8_t status,
+                                       wiced_bt_gatt_data_t *p_value)
+{
+    cts_local_time_t info;
+
+    if ((WICED_BT_GATT_SUCCESS == status) &&
+        cts_local_time_decode(p_value->p_data, p_value->len, &info))
+    {
+        taskENTER_CRITICAL();
+        p_conn->local_time = info;
+        taskEXIT_CRITICAL();
+#if !(ENABLE_BINARY_OUTPUT)
+        printf("Conn %d: ", p_conn->conn_id);
+        cts_local_time_print(&info);
+#endif
+    }
+    else
+    {
+        printf("Conn %d: Local Time Information not available, time not used\n",
+               p_conn->conn_id);
+    }
+
+    if (p_conn->time_info_pending)
+    {
+        p_conn->time_info_pending = false;
+        ble_app_read_time_info(p_conn);
+    }
+}
+
+/*******************************************************************************
+* Function Name: ble_app_local_time_reread()
+********************************************************************************
+* Summary:
+*   Reads the Local Time Information again after a time zone or DST change,
+*   as soon as no other read is in progress.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_local_time_reread(cts_conn_t *p_conn)
+{
+    if (p_conn->local_time_reread && (0 == p_conn->read_handle) &&
+        ble_app_read_local_time_info(p_conn))
+    {
+        p_conn->local_time_reread = false;
+    }
+}
+#endif /* ENABLE_LOCAL_TIME */
+
+#if (ENABLE_TIME_FUSION)
+/*******************************************************************************
+* Function Name: ble_app_read_reference_info()
+********************************************************************************
+* Summary:
+*   Reads the optional Reference Time Information characteristic of a server.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_read_reference_info(cts_conn_t *p_conn)
+{
+    wiced_bt_gatt_status_t gatt_status;
+
+    if (0 == p_conn->cts_discovery_data.cts_ref_time_val_handle)
+    {
+        /* Server accuracy stays at CTS_FUSION_DEFAULT_ACCURACY_MS */
+        return;
+    }
+
+    gatt_status = wiced_bt_gatt_client_send_read_handle(p_conn->conn_id,
+                      p_conn->cts_discovery_data.cts_ref_time_val_handle, 0,
+                      p_conn->read_buf, sizeof(p_conn->read_buf),
+                      GATT_AUTH_REQ_NONE);
+    p_conn->gatt_request_count++;
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Reference Time Information read failed! Error code: %d\n",
+               gatt_status);
+        return;
+    }
+    p_conn->read_handle = p_conn->cts_discovery_data.cts_ref_time_val_handle;
+}
+
+/*******************************************************************************
+* Function Name: ble_app_reference_info_handler()
+********************************************************************************
+* Summary:
+*   Passes the Reference Time Information read from a server to the fusion.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection to the server
+*   wiced_bt_gatt_data_t *p_value: Characteristic value read
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_reference_info_handler(cts_conn_t *p_conn,
+                                           wiced_bt_gatt_data_t *p_value)
+{
+    cts_reference_info_t info;
+
+    if ((p_value->handle != p_conn->cts_discovery_data.cts_ref_time_val_handle) ||
+        (p_value->len < sizeof(info)))
+    {
+        return;
+    }
+
+    info.time_source        = p_value->p_data[0];
+    info.accuracy           = p_value->p_data[1];
+    info.days_since_update  = p_value->p_data[2];
+    info.hours_since_update = p_value->p_data[3];
+    cts_fusion_set_reference_info(p_conn->conn_id, &info);
+
+    printf("Conn %d: time source %d, accuracy %d/8 s, updated %d days %d hours ago\n",
+           p_conn->conn_id, info.time_source, info.accuracy,
+           info.days_since_update, info.hours_since_update);
+}
+#endif /* ENABLE_TIME_FUSION */
+
+/*******************************************************************************
+* Function Name: cts_conn_find()
+********************************************************************************
+* Summary:
+*   Finds the state of a connection. A conn_id of 0 returns a free slot.
+*
+* Parameters:
+*   uint16_t conn_id: Connection ID
+*
+* Return:
+*   cts_conn_t*: Connection state or NULL if not found
+*
+*******************************************************************************/
+static cts_conn_t *cts_conn_find(uint16_t conn_id)
+{
+    uint32_t index;
+
+    for (index = 0; index < CTS_MAX_CONNECTIONS; index++)
+    {
+        if (conn_id == cts_conn[index].conn_id)
+        {
+            return &cts_conn[index];
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: cts_conn_find_by_addr()
+********************************************************************************
+* Summary:
+*   Finds the state of the connection to a server by its address.
+*
+* Parameters:
+*   const uint8_t *bd_addr: Address of the server
+*
+* Return:
+*   cts_conn_t*: Connection state or NULL if not connected
+*
+*******************************************************************************/
+static cts_conn_t *cts_conn_find_by_addr(const uint8_t *bd_addr)
+{
+    uint32_t index;
+
+    for (index = 0; index < CTS_MAX_CONNECTIONS; index++)
+    {
+        if ((0 != cts_conn[index].conn_id) &&
+            (0 == memcmp(cts_conn[index].bd_addr, bd_addr, BD_ADDR_LEN)))
+        {
+            return &cts_conn[index];
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: cts_conn_count()
+********************************************************************************
+* Summary:
+*   Returns the number of connected servers.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   uint32_t: Number of connections
+*
+*******************************************************************************/
+static uint32_t cts_conn_count(void)
+{
+    uint32_t index;
+    uint32_t count = 0;
+
+    for (index = 0; index < CTS_MAX_CONNECTIONS; index++)
+    {
+        if (0 != cts_conn[index].conn_id)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+#if (ENABLE_CTS_SERVER)
+/*******************************************************************************
+* Function Name: ble_app_is_server_peer()
+********************************************************************************
+* Summary:
+*   Tells a new link to a peer of the CTS server from a link to a time
+*   source. In central mode the time sources are the links the scan
+*   connected, and a device that connected to us is a peer. In peripheral
+*   mode every link is connected by the remote device: it takes a free time
+*   source slot until its discovery shows whether it offers CTS, and only
+*   links that find the slots taken are peers from the start.
+*
+* Parameters:
+*   const app_event_t *p_event: Connected event
+*
+* Return:
+*   bool: true if the link is a peer of the CTS server
+*
+*******************************************************************************/
+static bool ble_app_is_server_peer(const app_event_t *p_event)
+{
+#if (ENABLE_CENTRAL_MODE)
+    return (HCI_ROLE_PERIPHERAL == p_event->data.link.role);
+#else
+    (void)p_event;
+    return (cts_conn_count() >= CTS_MAX_CONNECTIONS);
+#endif
+}
+#endif
+
+#if (CTS_SOURCE_BY_DISCOVERY)
+/*******************************************************************************
+* Function Name: ble_app_source_to_peer()
+********************************************************************************
+* Summary:
+*   Moves a link whose discovery found no CTS from its time source slot to
+*   the peers of the CTS server, and advertises again for a time source.
+*   The link is disconnected when no peer slot is free.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection that offers no time
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_source_to_peer(cts_conn_t *p_conn)
+{
+    uint16_t conn_id = p_conn->conn_id;
+
+    p_conn->conn_id = 0;
+    p_conn->cts_restore_pending = false;
+    if (!app_cts_server_connected(conn_id))
+    {
+        printf("No free CTS server peer slot, disconnecting\n");
+        wiced_bt_gatt_disconnect(conn_id);
+        return;
+    }
+    printf("Conn %d is a CTS server peer, %lu of %u\n", conn_id,
+           (unsigned long)app_cts_server_peer_count(), CTS_SERVER_MAX_PEERS);
+    (void)ble_app_advertise(true);
+}
+#endif
+
+#if (ENABLE_NOTIFICATION_FILTER)
+/*******************************************************************************
+* Function Name: ble_app_notification_filter()
+********************************************************************************
+* Summary:
+*   Decides if a notification carries new information. The time expected from
+*   the previous notification is its offset to the local clock, corrected by
+*   the measured drift. A notification passes if it deviates from this by
+*   more than CTS_FILTER_THRESHOLD_US, has an adjust reason set, is the first
+*   one or is the first after CTS_FILTER_REFRESH_MS. A dropped notification
+*   still updates the synchronization statistics.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection the notification was received on
+*   wiced_bt_gatt_data_t *p_value: Notification packet from GATT server
+*   uint64_t arrival_us: Local time the notification arrived at
+*
+* Return:
+*   bool: true if the notification must be processed
+*
+*******************************************************************************/
+static bool ble_app_notification_filter(cts_conn_t *p_conn, wiced_bt_gatt_data_t *p_value,
+                                        uint64_t arrival_us)
+{
+    cts_sync_stats_t *p_stats = &p_conn->sync_stats;
+    current_time_data_t time;
+    int64_t server_us;
+    int64_t deviation_us;
+    bool process = true;
+
+    p_conn->notif_count++;
+
+    if ((cts_decode_current_time(p_value->p_data, p_value->len, &time)) &&
+        (ble_app_sample_to_utc(p_conn, &time, &server_us)) &&
+        (0 == time.adjust_reason) && (0 != p_stats->samples) &&
+        ((arrival_us - p_conn->notif_pass_us) < (CTS_FILTER_REFRESH_MS * 1000ull)))
+    {
+        deviation_us = server_us - ((int64_t)arrival_us + p_stats->offset_us +
+                       (((int64_t)p_stats->drift_ppb *
+                         (int64_t)(arrival_us - p_stats->local_us)) / 1000000000ll));
+        if ((deviation_us <= (int64_t)CTS_FILTER_THRESHOLD_US) &&
+            (deviation_us >= -(int64_t)CTS_FILTER_THRESHOLD_US))
+        {
+            process = false;
+            ble_app_record_sample(p_conn, &time, server_us, arrival_us);
+            p_conn->notif_filtered++;
+        }
+    }
+
+    if (process)
+    {
+        p_conn->notif_pass_us = arrival_us;
+        if (0 != p_conn->notif_filtered)
+        {
+            printf("Conn %d: %lu of %lu notifications filtered\n", p_conn->conn_id,
+                   (unsigned long)p_conn->notif_filtered,
+                   (unsigned long)p_conn->notif_count);
+        }
+    }
+    return process;
+}
+#endif /* ENABLE_NOTIFICATION_FILTER */
+
+/*******************************************************************************
+* Function Name: ble_app_sample_to_utc()
+********************************************************************************
+* Summary:
+*   Converts the Current Time of a server, which is its local time, to UTC
+*   with the Local Time Information of the server. A server without that
+*   characteristic is taken to send UTC. A sample is not used while the
+*   Local Time Information is not valid: before it was read, while it is
+*   read again after a time zone or DST change, or if the time zone is
+*   unknown.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection the sample was received on
+*   const current_time_data_t *p_time: Decoded Current Time
+*   int64_t *p_utc_us: Server time in UTC, us since 1970-01-01
+*
+* Return:
+*   bool: true if the sample can be recorded and fused
+*
+*******************************************************************************/
+static bool ble_app_sample_to_utc(cts_conn_t *p_conn, const current_time_data_t *p_time,
+                                  int64_t *p_utc_us)
+{
+    int64_t server_us;
+
+    if (!cts_time_to_epoch_us(p_time, &server_us))
+    {
+        return false;
+    }
+#if (ENABLE_LOCAL_TIME)
+    if (0 != p_conn->cts_discovery_data.cts_local_time_val_handle)
+    {
+        if (!p_conn->local_time.valid)
+        {
+            return false;
+        }
+        server_us = cts_local_time_to_utc_us(&p_conn->local_time, server_us);
+    }
+#endif
+    *p_utc_us = server_us;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ble_app_record_sample()
+********************************************************************************
+* Summary:
+*   Adds a received time sample to the synchronization statistics of the
+*   connection and to the time history. Called for every valid notification,
+*   including the ones dropped by the notification filter.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection the sample was received on
+*   const current_time_data_t *p_time: Decoded Current Time
+*   int64_t utc_us: Server time in UTC, us since 1970-01-01
+*   uint64_t arrival_us: Local time the notification arrived at
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void ble_app_record_sample(cts_conn_t *p_conn, const current_time_data_t *p_time,
+                                  int64_t utc_us, uint64_t arrival_us)
+{
+    taskENTER_CRITICAL();
+    cts_sync_stats_update(&p_conn->sync_stats, utc_us, arrival_us,
+                          (0 != p_time->adjust_reason));
+    taskEXIT_CRITICAL();
+
+#if (ENABLE_TIME_HISTORY)
+    cts_history_add((uint8_t)(p_conn - cts_conn), utc_us / 1000, arrival_us / 1000u,
+                    p_time->adjust_reason);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: cts_client_get_sync_quality()
+********************************************************************************
+* Summary:
+*   Returns the synchronization quality of a connected server. Safe to call
+*   from any task.
+*
+* Parameters:
+*   uint16_t conn_id: Connection ID of the server
+*   cts_sync_quality_t *p_quality: Quality snapshot
+*
+* Return:
+*   bool: false if the server is not connected or sent no time yet
+*
+*******************************************************************************/
+bool cts_client_get_sync_quality(uint16_t conn_id, cts_sync_quality_t *p_quality)
+{
+    cts_sync_stats_t stats;
+    cts_conn_t *p_conn;
+
+    if (0 == conn_id)
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    p_conn = cts_conn_find(conn_id);
+    if (NULL != p_conn)
+    {
+        stats = p_conn->sync_stats;
+    }
+    taskEXIT_CRITICAL();
+
+    if ((NULL == p_conn) || (0 == stats.samples))
+    {
+        return false;
+    }
+    cts_sync_stats_get_quality(&stats, local_time_us(), p_quality);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: cts_client_get_local_time()
+********************************************************************************
+* Summary:
+*   Returns the time zone and DST offset of a connected server, with the
+*   offset of its local time to UTC. Safe to call from any task.
+*
+* Parameters:
+*   uint16_t conn_id: Connection ID of the server
+*   cts_local_time_t *p_info: Local Time Information
+*
+* Return:
+*   bool: false if the server is not connected or its time zone is not known
+*
+*******************************************************************************/
+bool cts_client_get_local_time(uint16_t conn_id, cts_local_time_t *p_info)
+{
+    cts_conn_t *p_conn;
+    bool valid = false;
+
+    if (0 == conn_id)
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    p_conn = cts_conn_find(conn_id);
+    if (NULL != p_conn)
+    {
+        *p_info = p_conn->local_time;
+        valid = p_conn->local_time.valid;
+    }
+    taskEXIT_CRITICAL();
+
+    return valid;
+}
+
+/*******************************************************************************
+* Function Name: cts_decode_current_time()
+********************************************************************************
+* Summary:
+*   Decodes a Current Time characteristic value.
+*
+* Parameters:
+*   const uint8_t *p_data: Characteristic value
+*   uint16_t len: Length of the value
+*   current_time_data_t *p_time: Decoded time
+*
+* Return:
+*   bool: false if the value is too short
+*
+*******************************************************************************/
+bool cts_decode_current_time(const uint8_t *p_data, uint16_t len,
+                             current_time_data_t *p_time)
+{
+    if ((NULL == p_data) || (len < CTS_CURRENT_TIME_LEN))
+    {
+        return false;
+    }
+
+    p_time->year          = (p_data[1] << 8u) | p_data[0];
+    p_time->month         = p_data[2];
+    p_time->day           = p_data[3];
+    p_time->hours         = p_data[4];
+    p_time->minutes       = p_data[5];
+    p_time->seconds       = p_data[6];
+    p_time->day_of_week   = p_data[7];
+    p_time->fractions_256 = p_data[8];
+    p_time->adjust_reason = p_data[9];
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: cts_time_to_epoch_us()
+********************************************************************************
+* Summary:
+*   Converts a Current Time sample to microseconds since 1970-01-01. A day of
+*   week that does not match the date does not prevent the conversion.
+*
+* Parameters:
+*   const current_time_data_t *p_time: Decoded Current Time
+*   int64_t *p_epoch_us: Converted time
+*
+* Return:
+*   bool: false if the date is unknown (zero fields) or invalid
+*
+*******************************************************************************/
+bool cts_time_to_epoch_us(const current_time_data_t *p_time, int64_t *p_epoch_us)
+{
+    cts_date_status_t status = cts_calendar_check(p_time->year, p_time->month,
+                                                  p_time->day, p_time->day_of_week);
+
+    if (((CTS_DATE_VALID != status) && (CTS_DATE_WEEKDAY_MISMATCH != status)) ||
+        (p_time->hours > 23u) || (p_time->minutes > 59u) || (p_time->seconds > 59u))
+    {
+        return false;
+    }
+
+    *p_epoch_us = (cts_calendar_to_epoch_s(p_time->year, p_time->month, p_time->day,
+                                           p_time->hours, p_time->minutes,
+                                           p_time->seconds) * 1000000) +
+                  (((int64_t)p_time->fractions_256 * 1000000) / 256);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: print_notification_data()
+********************************************************************************
+* Summary:
+*   Parses the notification data to get date, time and other fields.
+*
+* Parameters:
+*   cts_conn_t *p_conn: Connection the notification was received on
+*   wiced_bt_gatt_data_t notif_data: Notification packet from GATT server
+*   uint64_t arrival_us: Local time the notification arrived at
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void print_notification_data(cts_conn_t *p_conn, wiced_bt_gatt_data_t notif_data,
+                                    uint64_t arrival_us)
+{
+    int64_t utc_us;
+    bool utc_valid;
+    cts_sync_quality_t quality = {0};
+#if !(ENABLE_BINARY_OUTPUT)
+    int64_t server_us;
+    bool server_us_valid;
+    char iso_time[CTS_CALENDAR_ISO8601_LEN];
+#endif
+
+    if (!cts_decode_current_time(notif_data.p_data, notif_data.len, &time_date_notif))
+    {
+#if (ENABLE_METRICS)
+        app_metrics_inc(METRIC_DECODE_ERRORS);
+#endif
+        printf("Invalid Current Time notification, length %d\n", notif_data.len);
+        return;
+    }
+
+#if (ENABLE_LOCAL_TIME)
+    /* The offset of the server time to UTC changed. The old offset is not
+     * used from here on, the samples wait until it was read again */
+    if ((0 != (time_date_notif.adjust_reason & (CHANGE_OF_TIME_ZONE | CHANGE_OF_DST))) &&
+        (0 != p_conn->cts_discovery_data.cts_local_time_val_handle))
+    {
+        taskENTER_CRITICAL();
+        p_conn->local_time.valid = false;
+        taskEXIT_CRITICAL();
+        p_conn->local_time_reread = true;
+    }
+    ble_app_local_time_reread(p_conn);
+#endif
+
+#if !(ENABLE_BINARY_OUTPUT)
+    server_us_valid = cts_time_to_epoch_us(&time_date_notif, &server_us);
+#endif
+    utc_valid = ble_app_sample_to_utc(p_conn, &time_date_notif, &utc_us);
+    if (utc_valid)
+    {
+#if (ENABLE_TIME_FUSION)
+        cts_fusion_add_sample(p_conn->conn_id, utc_us, time_date_notif.adjust_reason,
+                              arrival_us / 1000u);
+#endif
+#if (ENABLE_CTS_ALARMS)
+        /* Moves the pending alarms if the fused time was stepped */
+        cts_alarm_process();
+#endif
+#if (ENABLE_CTS_SERVER)
+        /* Passes a step of the fused time on to the subscribed peers */
+        app_cts_server_time_updated();
+#endif
+        ble_app_record_sample(p_conn, &time_date_notif, utc_us, arrival_us);
+        cts_sync_stats_get_quality(&p_conn->sync_stats, arrival_us, &quality);
+#if !(ENABLE_BINARY_OUTPUT)
+        printf("Sync: jitter %lu us, drift %ld ppb, error +/- %lu us, %lu step(s)\n",
+               (unsigned long)quality.jitter_us, (long)quality.drift_ppb,
+               (unsigned long)quality.error_us, (unsigned long)quality.steps);
+#endif
+    }
+#if !(ENABLE_BINARY_OUTPUT)
+    else if (server_us_valid)
+    {
+        printf("Conn %d: no valid Local Time Information, time not used\n",
+               p_conn->conn_id);
+    }
+#endif
+
+#if (ENABLE_BINARY_OUTPUT)
+    app_bin_log_time(p_conn->conn_id, notif_data.p_data, notif_data.len,
+                     quality.error_us);
+#else
+    if(time_date_notif.adjust_reason)
+    {
+        if((time_date_notif.adjust_reason & MANUAL_TIME_UPDATE) ==
+            MANUAL_TIME_UPDATE)
+        {
+            printf("Time Adjust Reason: Manual Time Update\n");
+        }
         if((time_date_notif.adjust_reason & EXTERNAL_REFERENCE_TIME_UPDATE) ==
             EXTERNAL_REFERENCE_TIME_UPDATE)
         {
@@ -688,7 +3393,27 @@ static void print_notification_data(wiced_bt_gatt_data_t notif_data)
     printf("Time (HH:MM:SS): %d:%d:%d \n", time_date_notif.hours,
                                            time_date_notif.minutes,
                                            time_date_notif.seconds);
+    if (server_us_valid)
+    {
+        cts_calendar_format_iso8601(server_us / 1000000, iso_time);
+        printf("Local time (ISO 8601): %s\n", iso_time);
+        if (utc_valid)
+        {
+            /* The server sends local time */
+            cts_calendar_format_iso8601(utc_us / 1000000, iso_time);
+            printf("UTC (ISO 8601): %sZ\n", iso_time);
+        }
+    }
+    if (CTS_DATE_WEEKDAY_MISMATCH == cts_calendar_check(time_date_notif.year,
+                                                        time_date_notif.month,
+                                                        time_date_notif.day,
+                                                        time_date_notif.day_of_week))
+    {
+        printf("Day of the week %s does not match the date\n",
+               get_day_of_week(time_date_notif.day_of_week));
+    }
     printf("Day of the week = %s\n\n", get_day_of_week(time_date_notif.day_of_week));
+#endif /* ENABLE_BINARY_OUTPUT */
 }
 
 /*******************************************************************************
@@ -39,21 +39,123 @@
 * so agrees to indemnify Cypress against all liability.
 *******************************************************************************/
 
+#ifndef __CTS_CLIENT_H__
+#define __CTS_CLIENT_H__
+
 /*******************************************************************************
 *        Header Files
 *******************************************************************************/
 #include "wiced_bt_dev.h"
+#include "cts_sync_stats.h"
+#include "cts_local_time.h"
+#include "app_bt_discovery.h"
 #include <FreeRTOS.h>
 #include <task.h>
+#include <queue.h>
 
 /*******************************************************************************
 *        Macro Definitions
 *******************************************************************************/
-/* Macros for button interrupt and button task */
 /* Interrupt priority for the GPIO connected to the user button */
 #define BUTTON_INTERRUPT_PRIORITY       (7u)
-#define BUTTON_TASK_PRIORITY            (configMAX_PRIORITIES - 1)
-#define BUTTON_TASK_STACK_SIZE          (configMINIMAL_STACK_SIZE * 8)
+
+/* Macros for the application task. It runs below the Bluetooth stack tasks,
+ * which use CY_RTOS_PRIORITY_HIGH and above */
+#define APP_TASK_PRIORITY               (configMAX_PRIORITIES - 3)
+#define APP_TASK_STACK_SIZE             (configMINIMAL_STACK_SIZE * 8)
+
+/* Number of events the application task queue holds */
+#ifndef APP_EVENT_QUEUE_LEN
+#define APP_EVENT_QUEUE_LEN             (16u)
+#endif
+
+/* Queue slots that time values (notifications, indications and broadcast
+ * reports) may not take, so that connection, discovery and security events
+ * always find room */
+#ifndef APP_EVENT_QUEUE_RESERVED
+#define APP_EVENT_QUEUE_RESERVED        (4u)
+#endif
+
+/* Time a stack callback waits for a free slot for an event that must not be
+ * lost. A link whose event is lost anyway is disconnected */
+#ifndef APP_EVENT_POST_WAIT_MS
+#define APP_EVENT_POST_WAIT_MS          (50u)
+#endif
+
+/* Set to 0 to handle Bluetooth stack events inside the stack callbacks
+ * instead of the application task, to compare the callback time */
+#ifndef ENABLE_APP_EVENT_QUEUE
+#define ENABLE_APP_EVENT_QUEUE          (1u)
+#endif
+
+/* Set to 1 to scan for and connect to CTS servers (GAP Central) instead of
+ * advertising and waiting for a server to connect (GAP Peripheral) */
+#ifndef ENABLE_CENTRAL_MODE
+#define ENABLE_CENTRAL_MODE             (0u)
+#endif
+
+/* Number of CTS servers the client can be connected to at the same time */
+#ifndef CTS_MAX_CONNECTIONS
+#if (ENABLE_CENTRAL_MODE)
+#define CTS_MAX_CONNECTIONS             (3u)
+#else
+#define CTS_MAX_CONNECTIONS             (1u)
+#endif
+#endif
+
+/* Set to 0 to process every notification. Otherwise notifications that
+ * match the time expected from the previous one (within
+ * CTS_FILTER_THRESHOLD_US, no adjust reason) are only counted. One
+ * notification per CTS_FILTER_REFRESH_MS passes regardless */
+#ifndef ENABLE_NOTIFICATION_FILTER
+#define ENABLE_NOTIFICATION_FILTER      (1u)
+#endif
+#ifndef CTS_FILTER_THRESHOLD_US
+#define CTS_FILTER_THRESHOLD_US         (50000u)
+#endif
+#ifndef CTS_FILTER_REFRESH_MS
+#define CTS_FILTER_REFRESH_MS           (60000u)
+#endif
+
+/* Set to 0 to wait for the first notification instead of reading the
+ * Current Time once CTS is ready. Servers may notify only on a change or
+ * once a minute */
+#ifndef ENABLE_CURRENT_TIME_READ
+#define ENABLE_CURRENT_TIME_READ        (1u)
+#endif
+
+/* Set to 0 to stay on the LE 1M PHY. Otherwise the client asks for the LE
+ * 2M PHY in both directions after connecting, which halves the air time of
+ * every packet if the server supports it */
+#ifndef ENABLE_LE_2M_PHY
+#define ENABLE_LE_2M_PHY                (1u)
+#endif
+
+/* Set to 1 to also take the time from the periodic advertising of a time
+ * broadcaster, without a connection (app_bt_pa_sync.c) */
+#ifndef ENABLE_PA_SYNC
+#define ENABLE_PA_SYNC                  (0u)
+#endif
+
+/* Time sources: the servers connected over GATT and, with ENABLE_PA_SYNC,
+ * the broadcaster. It has the slot after the connections and a connection
+ * ID the stack does not assign */
+#define CTS_TIME_SOURCES                (CTS_MAX_CONNECTIONS + ((ENABLE_PA_SYNC) ? 1u : 0u))
+#define CTS_BROADCAST_SLOT              (CTS_MAX_CONNECTIONS)
+#define CTS_BROADCAST_CONN_ID           (0xFFFFu)
+
+/* Length of the Current Time characteristic value */
+#define CTS_CURRENT_TIME_LEN            (10u)
+
+/* Length of the Database Hash characteristic value */
+#define GATT_DB_HASH_LEN                (16u)
+#ifndef UUID_CHARACTERISTIC_DATABASE_HASH
+#define UUID_CHARACTERISTIC_DATABASE_HASH (0x2B2A)
+#endif
+
+/* Longest characteristic value passed to the application task, the
+ * Database Hash */
+#define APP_EVENT_VALUE_LEN             (GATT_DB_HASH_LEN)
 
 /*******************************************************************************
 *        Enumerations
@@ -68,6 +170,38 @@ typedef enum
     CHANGE_OF_DST = 0x08,
 }adjust_reason_bits_t;
 
+/* Events processed by the application task */
+typedef enum
+{
+    APP_EVENT_BUTTON,
+    APP_EVENT_CONNECTED,
+    APP_EVENT_DISCONNECTED,
+    APP_EVENT_DISCOVERY_RESULT,
+    APP_EVENT_DISCOVERY_CPLT,
+    APP_EVENT_OPERATION_CPLT,
+    APP_EVENT_PAIRING_COMPLETE,
+    APP_EVENT_ENCRYPTION_STATUS,
+    APP_EVENT_ALARM,
+    APP_EVENT_COMMAND,
+    APP_EVENT_PHY_UPDATE,
+    APP_EVENT_ADV_RESTART,
+    APP_EVENT_BROADCAST_SYNC,
+    APP_EVENT_BROADCAST_TIME,
+    APP_EVENT_BROADCAST_RETRY,
+    APP_EVENT_ATTRIBUTE_REQUEST,
+    APP_EVENT_BOND_FLUSH,
+}app_event_type_t;
+
+/* Steps that make a GATT cache usable after discovery or reconnection */
+typedef enum
+{
+    GATT_CACHE_STEP_NONE,
+    GATT_CACHE_STEP_READ_HASH,      /* Hash read after discovery */
+    GATT_CACHE_STEP_SUBSCRIBE,      /* Service Changed CCCD write */
+    GATT_CACHE_STEP_CHECK_HASH,     /* Hash read to confirm a bonded cache */
+    GATT_CACHE_STEP_DONE,
+}gatt_cache_step_t;
+
 /*******************************************************************************
 *        Structures
 *******************************************************************************/
@@ -91,19 +225,149 @@ typedef struct
     uint16_t cts_char_handle;
     uint16_t cts_char_val_handle;
     uint16_t cts_cccd_handle;
+    uint16_t cts_ref_time_val_handle;
+    uint16_t cts_local_time_val_handle;
     bool cts_service_found;
+    /* Generic Attribute service, used to detect changes of the server's
+     * database */
+    uint16_t gatt_svc_changed_val_handle;
+    uint16_t gatt_svc_changed_cccd_handle;
+    uint16_t gatt_db_hash_val_handle;
+    bool     gatt_db_hash_valid;
+    uint8_t  gatt_db_hash[GATT_DB_HASH_LEN];
 } cts_discovery_data_t;
+
+/* State kept per connected CTS server */
+typedef struct
+{
+    uint16_t                    conn_id;
+    wiced_bt_device_address_t   bd_addr;
+    wiced_bt_ble_address_type_t addr_type;
+    cts_discovery_data_t        cts_discovery_data;
+    /* Handles of all services in the discovery table */
+    app_bt_disc_t               discovery;
+    bool                        notify_val;
+    bool                        cts_restore_pending;
+    /* Time from connection until CTS is usable, and the GATT requests sent */
+    TickType_t                  connection_start_tick;
+    uint32_t                    gatt_request_count;
+    /* Buffer for characteristic values read from the server, the handle
+     * of the read in progress, the Current Time and Reference Time
+     * Information reads that wait for the Local Time Information, and the
+     * Reference Time Information read that waits for the Current Time */
+    uint8_t                     read_buf[APP_EVENT_VALUE_LEN];
+    uint16_t                    read_handle;
+    bool                        ref_info_pending;
+    bool                        time_info_pending;
+    /* Local Time Information to read again once the read in progress
+     * completes, after a time zone or DST change */
+    bool                        local_time_reread;
+    /* Time from connection until the first valid time and the first
+     * notification, 0 until then */
+    uint32_t                    first_time_ms;
+    uint32_t                    first_notif_ms;
+    /* Time zone and DST of the server */
+    cts_local_time_t            local_time;
+    /* Value written to the CCCD of the server */
+    uint8_t                     cccd_buf[2];
+    /* Robust caching state and the value written to the Service Changed
+     * CCCD */
+    uint8_t                     cache_step;
+    uint8_t                     sc_cccd_buf[2];
+    /* Offset, jitter and drift of the time received from the server */
+    cts_sync_stats_t            sync_stats;
+    /* PHY of the link in each direction, 1M until an update, and the time
+     * from connection until the handle map was complete */
+    uint8_t                     tx_phy;
+    uint8_t                     rx_phy;
+    uint32_t                    discovery_ms;
+    /* Notification filter counters */
+    uint32_t                    notif_count;
+    uint32_t                    notif_filtered;
+    uint64_t                    notif_pass_us;
+} cts_conn_t;
+
+/* Event posted to the application task. Holds a copy of the stack event
+ * data the task needs, as the stack data is only valid in the callback */
+typedef struct
+{
+    uint8_t  type;                  /* app_event_type_t */
+    uint8_t  op;                    /* Discovery type, GATT operation,
+                                     * ATT opcode or app_cmd_t */
+    uint8_t  status;                /* GATT status or encryption result */
+    uint16_t conn_id;
+    union
+    {
+        struct
+        {
+            wiced_bt_device_address_t bd_addr;
+            uint8_t  addr_type;
+            uint8_t  role;          /* HCI_ROLE_ of the local device */
+            uint16_t reason;        /* wiced_bt_gatt_disconn_reason_t */
+        } link;
+        struct
+        {
+            uint32_t isr_cycles;    /* Cycle count at the interrupt entry */
+        } button;
+        struct
+        {
+            wiced_bt_device_address_t bd_addr;
+            uint8_t  tx_phy;        /* APP_BT_PHY_ values */
+            uint8_t  rx_phy;
+        } phy;
+        struct
+        {
+            uint16_t uuid16;        /* 0 for 128-bit UUIDs */
+            uint16_t handle;        /* Start, declaration or descriptor handle */
+            uint16_t end_handle;    /* End or value handle */
+            uint8_t  properties;    /* Characteristic properties */
+        } discovery;
+        struct
+        {
+            uint64_t arrival_us;
+            uint32_t arrival_cycles;
+            uint16_t handle;
+            uint16_t len;
+            uint8_t  value[APP_EVENT_VALUE_LEN];
+        } operation;
+        struct
+        {
+            uint16_t handle;        /* Attribute or start handle */
+            uint16_t end_handle;    /* End handle of a read by type */
+            uint16_t offset;
+            uint16_t uuid16;        /* Type of a read by type */
+            uint16_t len;           /* Written or requested length, or MTU */
+            uint8_t  value[APP_EVENT_VALUE_LEN];
+        } request;
+    } data;
+} app_event_t;
 /*******************************************************************************
  * Extern variables
  ******************************************************************************/
-extern TaskHandle_t  button_task_handle;
+extern TaskHandle_t  app_task_handle;
+extern QueueHandle_t app_event_queue;
 
 /*******************************************************************************
 *        Function Prototypes
 *******************************************************************************/
 /* FreeRTOS task functions */
-void button_task (void *pvParameters);
+void app_task (void *pvParameters);
 
 /* Callback function for Bluetooth stack management events */
 wiced_bt_dev_status_t app_bt_management_callback(wiced_bt_management_evt_t event,
                                                  wiced_bt_management_evt_data_t *p_event_data);
+
+/* Returns the synchronization quality of a connected server */
+bool cts_client_get_sync_quality(uint16_t conn_id, cts_sync_quality_t *p_quality);
+
+/* Returns the time zone and DST offset of a connected server */
+bool cts_client_get_local_time(uint16_t conn_id, cts_local_time_t *p_info);
+
+/* Decodes a Current Time characteristic value */
+bool cts_decode_current_time(const uint8_t *p_data, uint16_t len,
+                             current_time_data_t *p_time);
+
+/* Converts a Current Time sample to microseconds since 1970-01-01 */
+bool cts_time_to_epoch_us(const current_time_data_t *p_time, int64_t *p_epoch_us);
+
+#endif      /* __CTS_CLIENT_H__ */
@@ -0,0 +1,214 @@
+/******************************************************************************
+* File Name: cts_local_time.c
+*
+* Description: This file decodes the Local Time Information of a CTS server
+*              and converts between the local time it sends and UTC.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_local_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Valid time zone range, UTC-12:00 to UTC+14:00 */
+#define TIME_ZONE_MIN                   (-48)
+#define TIME_ZONE_MAX                   (56)
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void print_offset(int32_t offset_s);
+
+/*******************************************************************************
+* Function Name: cts_local_time_decode()
+********************************************************************************
+* Summary:
+*   Decodes a Local Time Information value and computes the offset of local
+*   time to UTC. An unknown DST offset counts as no DST. With an unknown time
+*   zone the offset cannot be used.
+*
+* Parameters:
+*   const uint8_t *p_data: Characteristic value
+*   uint16_t len: Length of the value
+*   cts_local_time_t *p_info: Decoded information
+*
+* Return:
+*   bool: false if the value is malformed
+*
+*******************************************************************************/
+bool cts_local_time_decode(const uint8_t *p_data, uint16_t len,
+                           cts_local_time_t *p_info)
+{
+    int8_t time_zone;
+    uint8_t dst_offset;
+
+    if ((NULL == p_data) || (len < CTS_LOCAL_TIME_INFO_LEN))
+    {
+        return false;
+    }
+
+    time_zone  = (int8_t)p_data[0];
+    dst_offset = p_data[1];
+    if ((CTS_TIME_ZONE_UNKNOWN != time_zone) &&
+        ((time_zone < TIME_ZONE_MIN) || (time_zone > TIME_ZONE_MAX)))
+    {
+        return false;
+    }
+    if ((0u != dst_offset) && (2u != dst_offset) && (4u != dst_offset) &&
+        (8u != dst_offset) && (CTS_DST_OFFSET_UNKNOWN != dst_offset))
+    {
+        return false;
+    }
+
+    p_info->time_zone    = time_zone;
+    p_info->dst_offset   = dst_offset;
+    p_info->valid        = (CTS_TIME_ZONE_UNKNOWN != time_zone);
+    p_info->utc_offset_s = 0;
+    if (p_info->valid)
+    {
+        p_info->utc_offset_s = (int32_t)time_zone * CTS_LOCAL_TIME_STEP_S;
+        if (CTS_DST_OFFSET_UNKNOWN != dst_offset)
+        {
+            p_info->utc_offset_s += (int32_t)dst_offset * CTS_LOCAL_TIME_STEP_S;
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: cts_local_time_to_utc_us()
+********************************************************************************
+* Summary:
+*   Converts the local time of a server to UTC.
+*
+* Parameters:
+*   const cts_local_time_t *p_info: Local Time Information of the server
+*   int64_t local_us: Local time, us since 1970-01-01
+*
+* Return:
+*   int64_t: UTC, us since 1970-01-01. Unchanged if the time zone is unknown
+*
+*******************************************************************************/
+int64_t cts_local_time_to_utc_us(const cts_local_time_t *p_info, int64_t local_us)
+{
+    return local_us - ((int64_t)p_info->utc_offset_s * 1000000);
+}
+
+/*******************************************************************************
+* Function Name: cts_local_time_from_utc_us()
+********************************************************************************
+* Summary:
+*   Converts UTC to the local time of a server.
+*
+* Parameters:
+*   const cts_local_time_t *p_info: Local Time Information of the server
+*   int64_t utc_us: UTC, us since 1970-01-01
+*
+* Return:
+*   int64_t: Local time, us since 1970-01-01
+*
+*******************************************************************************/
+int64_t cts_local_time_from_utc_us(const cts_local_time_t *p_info, int64_t utc_us)
+{
+    return utc_us + ((int64_t)p_info->utc_offset_s * 1000000);
+}
+
+/*******************************************************************************
+* Function Name: cts_local_time_print()
+********************************************************************************
+* Summary:
+*   Prints the time zone and DST offset, for example "UTC+01:00, DST +01:00".
+*
+* Parameters:
+*   const cts_local_time_t *p_info: Local Time Information
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_local_time_print(const cts_local_time_t *p_info)
+{
+    printf("Time zone: ");
+    if (CTS_TIME_ZONE_UNKNOWN == p_info->time_zone)
+    {
+        printf("unknown");
+    }
+    else
+    {
+        printf("UTC");
+        print_offset((int32_t)p_info->time_zone * CTS_LOCAL_TIME_STEP_S);
+    }
+
+    printf(", DST ");
+    if (CTS_DST_OFFSET_UNKNOWN == p_info->dst_offset)
+    {
+        printf("unknown\n");
+    }
+    else
+    {
+        print_offset((int32_t)p_info->dst_offset * CTS_LOCAL_TIME_STEP_S);
+        printf("\n");
+    }
+}
+
+/*******************************************************************************
+* Function Name: print_offset()
+********************************************************************************
+* Summary:
+*   Prints an offset as +HH:MM or -HH:MM.
+*
+* Parameters:
+*   int32_t offset_s: Offset in seconds
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void print_offset(int32_t offset_s)
+{
+    int32_t minutes = abs(offset_s) / 60;
+
+    printf("%c%02ld:%02ld", (offset_s < 0) ? '-' : '+',
+           (long)(minutes / 60), (long)(minutes % 60));
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,93 @@
+/******************************************************************************
+* File Name: cts_local_time.h
+*
+* Description: This file contains macros, structures and function prototypes
+*              used in cts_local_time.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __CTS_LOCAL_TIME_H__
+#define __CTS_LOCAL_TIME_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 0 to ignore the Local Time Information of the servers */
+#ifndef ENABLE_LOCAL_TIME
+#define ENABLE_LOCAL_TIME               (1u)
+#endif
+
+/* Length of the Local Time Information characteristic value */
+#define CTS_LOCAL_TIME_INFO_LEN         (2u)
+
+/* Time zone and DST offset are given in steps of 15 minutes */
+#define CTS_LOCAL_TIME_STEP_S           (15 * 60)
+
+/* Values for an unknown time zone or DST offset */
+#define CTS_TIME_ZONE_UNKNOWN           (-128)
+#define CTS_DST_OFFSET_UNKNOWN          (255u)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* Local Time Information of a server. The offset of local time to UTC is
+ * computed when the value is decoded, so conversions need no division */
+typedef struct
+{
+    int8_t   time_zone;             /* 15 minute steps, CTS_TIME_ZONE_UNKNOWN */
+    uint8_t  dst_offset;            /* 15 minute steps, CTS_DST_OFFSET_UNKNOWN */
+    bool     valid;                 /* Time zone known, offset usable */
+    int32_t  utc_offset_s;          /* Local time minus UTC, DST included */
+} cts_local_time_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+bool cts_local_time_decode(const uint8_t *p_data, uint16_t len,
+                           cts_local_time_t *p_info);
+int64_t cts_local_time_to_utc_us(const cts_local_time_t *p_info, int64_t local_us);
+int64_t cts_local_time_from_utc_us(const cts_local_time_t *p_info, int64_t utc_us);
+void cts_local_time_print(const cts_local_time_t *p_info);
+
+#endif      /* __CTS_LOCAL_TIME_H__ */
+
+/* [] END OF FILE */
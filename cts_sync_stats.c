@@ -0,0 +1,184 @@
+/******************************************************************************
+* File Name: cts_sync_stats.c
+*
+* Description: This file keeps rolling statistics of the time received from a
+*              CTS server: offset to the local clock, jitter between
+*              successive notifications and drift of the server clock.
+*              They are combined into an estimated error that other tasks
+*              can query.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_sync_stats.h"
+#include <string.h>
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static uint64_t sync_abs(int64_t value);
+
+/*******************************************************************************
+* Function Name: cts_sync_stats_reset()
+********************************************************************************
+* Summary:
+*   Clears the statistics, for example on a new connection.
+*
+* Parameters:
+*   cts_sync_stats_t *p_stats: Statistics of a server
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_sync_stats_reset(cts_sync_stats_t *p_stats)
+{
+    memset(p_stats, 0, sizeof(*p_stats));
+}
+
+/*******************************************************************************
+* Function Name: cts_sync_stats_update()
+********************************************************************************
+* Summary:
+*   Adds a server time sample. The offset change since the previous sample
+*   updates the jitter. The offset change since the drift baseline gives the
+*   drift. A time step (adjust reason set or offset change above
+*   CTS_SYNC_STEP_THRESHOLD_US) restarts the drift baseline and is not
+*   counted as jitter.
+*
+* Parameters:
+*   cts_sync_stats_t *p_stats: Statistics of a server
+*   int64_t server_us: Server time in microseconds
+*   uint64_t local_us: Local arrival time, see local_time_us()
+*   bool time_adjusted: true if the server reported an adjust reason
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_sync_stats_update(cts_sync_stats_t *p_stats, int64_t server_us,
+                           uint64_t local_us, bool time_adjusted)
+{
+    int64_t offset_us = server_us - (int64_t)local_us;
+    uint64_t delta_us;
+    uint64_t span_us;
+
+    if (0 == p_stats->samples)
+    {
+        p_stats->base_offset_us = offset_us;
+        p_stats->base_local_us = local_us;
+    }
+    else
+    {
+        delta_us = sync_abs(offset_us - p_stats->offset_us);
+        if ((time_adjusted) || (delta_us > CTS_SYNC_STEP_THRESHOLD_US))
+        {
+            p_stats->steps++;
+            p_stats->base_offset_us = offset_us;
+            p_stats->base_local_us = local_us;
+        }
+        else
+        {
+            /* J += (|D| - J) / 16 */
+            p_stats->jitter_x16_us += (uint32_t)delta_us - (p_stats->jitter_x16_us >> 4);
+
+            span_us = local_us - p_stats->base_local_us;
+            if (span_us >= CTS_SYNC_MIN_DRIFT_SPAN_US)
+            {
+                p_stats->drift_ppb = (int32_t)(((offset_us - p_stats->base_offset_us) *
+                                                1000000000ll) / (int64_t)span_us);
+            }
+        }
+    }
+
+    p_stats->offset_us = offset_us;
+    p_stats->local_us = local_us;
+    p_stats->samples++;
+}
+
+/*******************************************************************************
+* Function Name: cts_sync_stats_get_quality()
+********************************************************************************
+* Summary:
+*   Returns the synchronization quality of a server. The error estimate is
+*   half the server time resolution plus the jitter, plus the drift over the
+*   time since the last sample.
+*
+* Parameters:
+*   const cts_sync_stats_t *p_stats: Statistics of a server
+*   uint64_t now_us: Current local time, see local_time_us()
+*   cts_sync_quality_t *p_quality: Quality snapshot
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_sync_stats_get_quality(const cts_sync_stats_t *p_stats, uint64_t now_us,
+                                cts_sync_quality_t *p_quality)
+{
+    uint64_t age_us = (now_us > p_stats->local_us) ? (now_us - p_stats->local_us) : 0u;
+
+    p_quality->samples = p_stats->samples;
+    p_quality->steps = p_stats->steps;
+    p_quality->jitter_us = p_stats->jitter_x16_us >> 4;
+    p_quality->drift_ppb = p_stats->drift_ppb;
+    p_quality->age_ms = (uint32_t)(age_us / 1000u);
+    p_quality->error_us = (CTS_SYNC_RESOLUTION_US / 2u) + p_quality->jitter_us +
+                          (uint32_t)((sync_abs(p_stats->drift_ppb) * age_us) /
+                                     1000000000ull);
+}
+
+/*******************************************************************************
+* Function Name: sync_abs()
+********************************************************************************
+* Summary:
+*   Returns the absolute value of a signed 64-bit value.
+*
+* Parameters:
+*   int64_t value: Value
+*
+* Return:
+*   uint64_t: Absolute value
+*
+*******************************************************************************/
+static uint64_t sync_abs(int64_t value)
+{
+    return (value < 0) ? (uint64_t)(-value) : (uint64_t)value;
+}
+
+/* [] END OF FILE */
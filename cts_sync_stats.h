@@ -0,0 +1,106 @@
+/******************************************************************************
+* File Name: cts_sync_stats.h
+*
+* Description: This file contains macros, structures and function prototypes
+*              used in cts_sync_stats.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __CTS_SYNC_STATS_H__
+#define __CTS_SYNC_STATS_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Resolution of the server time (fractions_256) in microseconds */
+#define CTS_SYNC_RESOLUTION_US          (3906u)
+
+/* An offset change larger than this is a time step, not jitter */
+#ifndef CTS_SYNC_STEP_THRESHOLD_US
+#define CTS_SYNC_STEP_THRESHOLD_US      (500000u)
+#endif
+
+/* Minimum time between the drift baseline and a sample before the drift is
+ * estimated. Shorter spans are dominated by the server time resolution */
+#ifndef CTS_SYNC_MIN_DRIFT_SPAN_US
+#define CTS_SYNC_MIN_DRIFT_SPAN_US      (60000000u)
+#endif
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* Rolling synchronization statistics of one server */
+typedef struct
+{
+    uint32_t samples;
+    uint32_t steps;                 /* Time steps seen since connection */
+    int64_t  offset_us;             /* Last server time minus local time */
+    uint64_t local_us;              /* Local arrival time of the last sample */
+    int64_t  base_offset_us;        /* Drift baseline */
+    uint64_t base_local_us;
+    uint32_t jitter_x16_us;         /* RFC 3550 style jitter, scaled by 16 */
+    int32_t  drift_ppb;
+} cts_sync_stats_t;
+
+/* Snapshot of the synchronization quality */
+typedef struct
+{
+    uint32_t samples;
+    uint32_t steps;
+    uint32_t jitter_us;
+    int32_t  drift_ppb;
+    uint32_t error_us;              /* Estimated error of the server time now */
+    uint32_t age_ms;                /* Time since the last sample */
+} cts_sync_quality_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+void cts_sync_stats_reset(cts_sync_stats_t *p_stats);
+void cts_sync_stats_update(cts_sync_stats_t *p_stats, int64_t server_us,
+                           uint64_t local_us, bool time_adjusted);
+void cts_sync_stats_get_quality(const cts_sync_stats_t *p_stats, uint64_t now_us,
+                                cts_sync_quality_t *p_quality);
+
+#endif      /* __CTS_SYNC_STATS_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,532 @@
+/******************************************************************************
+* File Name: cts_time_fusion.c
+*
+* Description: This file implements the fusion of the time received from
+*              several CTS servers. Each server sample is turned into an
+*              interval of possible offsets between server and local time,
+*              sized by the server's Reference Time Information accuracy
+*              and its adjust reason history. Marzullo's algorithm selects
+*              the offset range agreed by most servers and rejects the
+*              servers outside of it (falsetickers).
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_time_fusion.h"
+#include "app_bt_utils.h"
+#include "app_bin_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define MS_PER_SECOND                   (1000u)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* Start or end of a server's offset interval */
+typedef struct
+{
+    int64_t offset_ms;
+    int8_t  type;                   /* -1: interval start, +1: interval end */
+} cts_fusion_edge_t;
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static cts_fusion_server_t fusion_servers[CTS_FUSION_MAX_SERVERS];
+static cts_fusion_edge_t   fusion_edges[2u * CTS_FUSION_MAX_SERVERS];
+static cts_fusion_result_t fusion_result;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static cts_fusion_server_t *fusion_find_server(uint16_t server_id, bool create);
+static uint32_t fusion_server_error_ms(const cts_fusion_server_t *p_server,
+                                       uint64_t now_ms);
+static int  fusion_edge_compare(const void *p_a, const void *p_b);
+static void fusion_update(uint64_t now_ms);
+
+/*******************************************************************************
+* Function Name: cts_fusion_init()
+********************************************************************************
+* Summary:
+*   Clears all server state and the fused result.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_fusion_init(void)
+{
+    memset(fusion_servers, 0, sizeof(fusion_servers));
+    memset(&fusion_result, 0, sizeof(fusion_result));
+}
+
+/*******************************************************************************
+* Function Name: cts_fusion_add_sample()
+********************************************************************************
+* Summary:
+*   Adds a time sample of a server and recomputes the fused time. The caller
+*   converts the Current Time of the server to UTC first.
+*
+* Parameters:
+*   uint16_t server_id: Identifies the server (connection ID)
+*   int64_t utc_us: Time of the server in UTC, us since 1970-01-01
+*   uint8_t adjust_reason: Adjust Reason of the Current Time
+*   uint64_t local_ms: Local time at which the sample was received
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_fusion_add_sample(uint16_t server_id, int64_t utc_us, uint8_t adjust_reason,
+                           uint64_t local_ms)
+{
+    cts_fusion_server_t *p_server = fusion_find_server(server_id, true);
+
+    if (NULL == p_server)
+    {
+        return;
+    }
+
+    if (adjust_reason & MANUAL_TIME_UPDATE)
+    {
+        p_server->manual_updates++;
+    }
+    if (adjust_reason & EXTERNAL_REFERENCE_TIME_UPDATE)
+    {
+        /* Server was just synchronized to its reference */
+        p_server->external_updates++;
+        p_server->since_update_s = 0;
+    }
+
+    p_server->offset_ms = (utc_us / 1000) - (int64_t)local_ms;
+    p_server->sample_local_ms = local_ms;
+    p_server->has_sample = true;
+    p_server->samples++;
+
+    fusion_update(local_ms);
+}
+
+/*******************************************************************************
+* Function Name: cts_fusion_set_reference_info()
+********************************************************************************
+* Summary:
+*   Sets the accuracy of a server from its Reference Time Information.
+*
+* Parameters:
+*   uint16_t server_id: Identifies the server (connection ID)
+*   const cts_reference_info_t *p_info: Reference Time Information
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_fusion_set_reference_info(uint16_t server_id,
+                                   const cts_reference_info_t *p_info)
+{
+    cts_fusion_server_t *p_server = fusion_find_server(server_id, true);
+
+    if (NULL == p_server)
+    {
+        return;
+    }
+
+    if (p_info->accuracy >= CTS_RTI_ACCURACY_OUT_OF_RANGE)
+    {
+        p_server->accuracy_ms = CTS_FUSION_DEFAULT_ACCURACY_MS;
+    }
+    else
+    {
+        /* Accuracy is given in steps of 125 ms */
+        p_server->accuracy_ms = (uint32_t)p_info->accuracy * 125u;
+    }
+    p_server->since_update_s = ((uint32_t)p_info->days_since_update * 86400u) +
+                               ((uint32_t)p_info->hours_since_update * 3600u);
+}
+
+/*******************************************************************************
+* Function Name: cts_fusion_remove_server()
+********************************************************************************
+* Summary:
+*   Forgets a server, for example after disconnection, and recomputes the
+*   fused time from the remaining servers.
+*
+* Parameters:
+*   uint16_t server_id: Identifies the server (connection ID)
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_fusion_remove_server(uint16_t server_id)
+{
+    cts_fusion_server_t *p_server = fusion_find_server(server_id, false);
+
+    if (NULL != p_server)
+    {
+        memset(p_server, 0, sizeof(*p_server));
+        fusion_update(cts_fusion_local_ms());
+    }
+}
+
+/*******************************************************************************
+* Function Name: cts_fusion_get_result()
+********************************************************************************
+* Summary:
+*   Returns the result of the last fusion.
+*
+* Parameters:
+*   cts_fusion_result_t *p_result: Buffer for the result
+*
+* Return:
+*   bool: true if a fused time is available
+*
+*******************************************************************************/
+bool cts_fusion_get_result(cts_fusion_result_t *p_result)
+{
+    *p_result = fusion_result;
+    return fusion_result.valid;
+}
+
+/*******************************************************************************
+* Function Name: cts_fusion_get_time_ms()
+********************************************************************************
+* Summary:
+*   Converts a local time to server time using the fused offset.
+*
+* Parameters:
+*   uint64_t local_ms: Local time, see cts_fusion_local_ms()
+*   uint64_t *p_epoch_ms: Time in milliseconds since 1970-01-01 00:00:00
+*
+* Return:
+*   bool: true if a fused time is available
+*
+*******************************************************************************/
+bool cts_fusion_get_time_ms(uint64_t local_ms, uint64_t *p_epoch_ms)
+{
+    if (!fusion_result.valid)
+    {
+        return false;
+    }
+    *p_epoch_ms = (uint64_t)((int64_t)local_ms + fusion_result.offset_ms);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: cts_fusion_local_ms()
+********************************************************************************
+* Summary:
+*   Returns the local monotonic time in milliseconds, see local_time_us().
+*
+* Parameters:
+*   None
+*
+* Return:
+*   uint64_t: Milliseconds since the scheduler started
+*
+*******************************************************************************/
+uint64_t cts_fusion_local_ms(void)
+{
+    return local_time_us() / 1000u;
+}
+
+/*******************************************************************************
+* Function Name: fusion_update()
+********************************************************************************
+* Summary:
+*   Runs Marzullo's algorithm over the offset intervals of all servers with a
+*   recent sample. Sorting the 2N interval edges dominates, so an update costs
+*   O(N log N). The fused offset is the error weighted mean of the servers
+*   that agree (truechimers), limited to the agreed interval, or the middle
+*   of that interval if all their errors are too large to weight.
+*
+* Parameters:
+*   uint64_t now_ms: Current local time
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void fusion_update(uint64_t now_ms)
+{
+    cts_fusion_server_t *p_server;
+    uint32_t index;
+    uint32_t edges = 0;
+    uint32_t servers = 0;
+    int32_t count = 0;
+    int32_t best = 0;
+    int64_t best_low = 0;
+    int64_t best_high = 0;
+    uint32_t error_ms;
+    uint32_t min_error_ms = UINT32_MAX;
+    int64_t weighted_sum = 0;
+    int64_t weight_total = 0;
+    int64_t weight;
+    int64_t error_units;
+    int64_t offset;
+
+    /* Build the interval edges */
+    for (index = 0; index < CTS_FUSION_MAX_SERVERS; index++)
+    {
+        p_server = &fusion_servers[index];
+        p_server->falseticker = false;
+        if ((!p_server->in_use) || (!p_server->has_sample) ||
+            ((now_ms - p_server->sample_local_ms) > CTS_FUSION_MAX_SAMPLE_AGE_MS))
+        {
+            continue;
+        }
+        error_ms = fusion_server_error_ms(p_server, now_ms);
+        fusion_edges[edges].offset_ms = p_server->offset_ms - error_ms;
+        fusion_edges[edges++].type = -1;
+        fusion_edges[edges].offset_ms = p_server->offset_ms + error_ms;
+        fusion_edges[edges++].type = 1;
+        servers++;
+
+        /* Fallback interval if no majority exists */
+        if (error_ms < min_error_ms)
+        {
+            min_error_ms = error_ms;
+            best_low = p_server->offset_ms - error_ms;
+            best_high = p_server->offset_ms + error_ms;
+        }
+    }
+
+    fusion_result.servers = (uint8_t)servers;
+    if (0 == servers)
+    {
+        fusion_result.valid = false;
+        return;
+    }
+
+    /* Find the offset range covered by most intervals */
+    qsort(fusion_edges, edges, sizeof(fusion_edges[0]), fusion_edge_compare);
+    for (index = 0; index + 1u < edges; index++)
+    {
+        count -= fusion_edges[index].type;
+        if (count > best)
+        {
+            best = count;
+            best_low = fusion_edges[index].offset_ms;
+            best_high = fusion_edges[index + 1u].offset_ms;
+        }
+    }
+
+    /* Without a majority, trust only the most accurate server */
+    if ((servers > 1u) && ((uint32_t)best * 2u <= servers))
+    {
+        best = 0;
+        for (index = 0; index < CTS_FUSION_MAX_SERVERS; index++)
+        {
+            p_server = &fusion_servers[index];
+            if ((p_server->in_use) && (p_server->has_sample) &&
+                (fusion_server_error_ms(p_server, now_ms) == min_error_ms))
+            {
+                best_low = p_server->offset_ms - min_error_ms;
+                best_high = p_server->offset_ms + min_error_ms;
+                break;
+            }
+        }
+    }
+
+    /* Weighted mean of the servers that overlap the agreed range */
+    best = 0;
+    for (index = 0; index < CTS_FUSION_MAX_SERVERS; index++)
+    {
+        p_server = &fusion_servers[index];
+        if ((!p_server->in_use) || (!p_server->has_sample) ||
+            ((now_ms - p_server->sample_local_ms) > CTS_FUSION_MAX_SAMPLE_AGE_MS))
+        {
+            continue;
+        }
+        error_ms = fusion_server_error_ms(p_server, now_ms);
+        if (((p_server->offset_ms - (int64_t)error_ms) > best_high) ||
+            ((p_server->offset_ms + (int64_t)error_ms) < best_low))
+        {
+            p_server->falseticker = true;
+            continue;
+        }
+        error_units = (int64_t)(error_ms / CTS_FUSION_WEIGHT_UNIT_MS);
+        weight = CTS_FUSION_WEIGHT_SCALE / (error_units * error_units + 1);
+        weighted_sum += (p_server->offset_ms - best_low) * weight;
+        weight_total += weight;
+        best++;
+    }
+
+    offset = (weight_total > 0) ? (best_low + (weighted_sum / weight_total)) :
+                                  (best_low + ((best_high - best_low) / 2));
+    if (offset < best_low)
+    {
+        offset = best_low;
+    }
+    if (offset > best_high)
+    {
+        offset = best_high;
+    }
+
+    fusion_result.valid = true;
+    fusion_result.offset_ms = offset;
+    fusion_result.error_ms = (uint32_t)(((offset - best_low) > (best_high - offset)) ?
+                                        (offset - best_low) : (best_high - offset));
+    fusion_result.truechimers = (uint8_t)best;
+
+#if !(ENABLE_BINARY_OUTPUT)
+    if (servers > 1u)
+    {
+        printf("Time fusion: %u of %u servers agree, error +/- %lu ms\n",
+               fusion_result.truechimers, fusion_result.servers,
+               (unsigned long)fusion_result.error_ms);
+        for (index = 0; index < CTS_FUSION_MAX_SERVERS; index++)
+        {
+            if (fusion_servers[index].falseticker)
+            {
+                printf("Time fusion: server on conn %d rejected as falseticker\n",
+                       fusion_servers[index].server_id);
+            }
+        }
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: fusion_server_error_ms()
+********************************************************************************
+* Summary:
+*   Returns the half width of the offset interval of a server.
+*
+* Parameters:
+*   const cts_fusion_server_t *p_server: Server state
+*   uint64_t now_ms: Current local time
+*
+* Return:
+*   uint32_t: Maximum error of the server's offset in milliseconds
+*
+*******************************************************************************/
+static uint32_t fusion_server_error_ms(const cts_fusion_server_t *p_server,
+                                       uint64_t now_ms)
+{
+    uint64_t drift_base_ms = (now_ms - p_server->sample_local_ms) +
+                             ((uint64_t)p_server->since_update_s * MS_PER_SECOND);
+    uint32_t manual = (p_server->manual_updates < CTS_FUSION_MAX_MANUAL_PENALTY) ?
+                      p_server->manual_updates : CTS_FUSION_MAX_MANUAL_PENALTY;
+
+    return p_server->accuracy_ms + CTS_FUSION_TRANSPORT_ERROR_MS +
+           (uint32_t)((drift_base_ms * CTS_FUSION_DRIFT_PPM) / 1000000u) +
+           (manual * CTS_FUSION_MANUAL_PENALTY_MS);
+}
+
+/*******************************************************************************
+* Function Name: fusion_edge_compare()
+********************************************************************************
+* Summary:
+*   qsort() comparison of interval edges. At equal offsets interval starts
+*   sort before ends so that touching intervals count as overlapping.
+*
+* Parameters:
+*   const void *p_a, const void *p_b: Edges to compare
+*
+* Return:
+*   int: Negative, zero or positive as for qsort()
+*
+*******************************************************************************/
+static int fusion_edge_compare(const void *p_a, const void *p_b)
+{
+    const cts_fusion_edge_t *p_edge_a = (const cts_fusion_edge_t *)p_a;
+    const cts_fusion_edge_t *p_edge_b = (const cts_fusion_edge_t *)p_b;
+
+    if (p_edge_a->offset_ms != p_edge_b->offset_ms)
+    {
+        return (p_edge_a->offset_ms < p_edge_b->offset_ms) ? -1 : 1;
+    }
+    return p_edge_a->type - p_edge_b->type;
+}
+
+/*******************************************************************************
+* Function Name: fusion_find_server()
+********************************************************************************
+* Summary:
+*   Finds the state of a server, optionally allocating a free entry.
+*
+* Parameters:
+*   uint16_t server_id: Identifies the server (connection ID)
+*   bool create: Allocate an entry if the server is not known
+*
+* Return:
+*   cts_fusion_server_t*: Server state or NULL
+*
+*******************************************************************************/
+static cts_fusion_server_t *fusion_find_server(uint16_t server_id, bool create)
+{
+    uint32_t index;
+    cts_fusion_server_t *p_free = NULL;
+
+    for (index = 0; index < CTS_FUSION_MAX_SERVERS; index++)
+    {
+        if (fusion_servers[index].in_use)
+        {
+            if (server_id == fusion_servers[index].server_id)
+            {
+                return &fusion_servers[index];
+            }
+        }
+        else if (NULL == p_free)
+        {
+            p_free = &fusion_servers[index];
+        }
+    }
+
+    if ((!create) || (NULL == p_free))
+    {
+        return NULL;
+    }
+
+    memset(p_free, 0, sizeof(*p_free));
+    p_free->in_use = true;
+    p_free->server_id = server_id;
+    p_free->accuracy_ms = CTS_FUSION_DEFAULT_ACCURACY_MS;
+    return p_free;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,142 @@
+/******************************************************************************
+* File Name: cts_time_fusion.h
+*
+* Description: This file contains macros, structures and function prototypes
+*              used by cts_time_fusion.c, which combines the time received
+*              from several CTS servers into one time source.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __CTS_TIME_FUSION_H__
+#define __CTS_TIME_FUSION_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_client.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 0 to disable combining the time of several servers */
+#ifndef ENABLE_TIME_FUSION
+#define ENABLE_TIME_FUSION              (1u)
+#endif
+
+/* Number of servers tracked by the fusion engine */
+#define CTS_FUSION_MAX_SERVERS          (CTS_TIME_SOURCES)
+
+/* Error budget of a sample, in milliseconds:
+ * - accuracy assumed when the server has no Reference Time Information
+ * - resolution of fractions_256 plus notification delivery delay
+ * - local/server clock drift applied to the age of a sample and to the time
+ *   since the server's last reference update
+ * - penalty per manual time update seen from the server */
+#define CTS_FUSION_DEFAULT_ACCURACY_MS  (1000u)
+#define CTS_FUSION_TRANSPORT_ERROR_MS   (50u)
+#define CTS_FUSION_DRIFT_PPM            (50u)
+#define CTS_FUSION_MANUAL_PENALTY_MS    (500u)
+#define CTS_FUSION_MAX_MANUAL_PENALTY   (8u)
+
+/* Weight of a server in the fused offset: CTS_FUSION_WEIGHT_SCALE divided
+ * by the squared error in units of CTS_FUSION_WEIGHT_UNIT_MS, plus one.
+ * Non-zero for errors up to about 1.8 hours */
+#define CTS_FUSION_WEIGHT_UNIT_MS       (100u)
+#define CTS_FUSION_WEIGHT_SCALE         (1ll << 32)
+
+/* Samples older than this are not used */
+#define CTS_FUSION_MAX_SAMPLE_AGE_MS    (10u * 60u * 1000u)
+
+/* Reference Time Information accuracy values with special meaning */
+#define CTS_RTI_ACCURACY_OUT_OF_RANGE   (254u)
+#define CTS_RTI_ACCURACY_UNKNOWN        (255u)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* Reference Time Information characteristic (0x2A14) */
+typedef struct
+{
+    uint8_t time_source;
+    uint8_t accuracy;               /* Drift in 1/8 s since last update */
+    uint8_t days_since_update;
+    uint8_t hours_since_update;
+} cts_reference_info_t;
+
+/* State kept per server */
+typedef struct
+{
+    bool     in_use;
+    bool     has_sample;
+    uint16_t server_id;
+    int64_t  offset_ms;             /* Server time minus local time */
+    uint64_t sample_local_ms;
+    uint32_t accuracy_ms;
+    uint32_t since_update_s;
+    uint32_t manual_updates;
+    uint32_t external_updates;
+    uint32_t samples;
+    bool     falseticker;
+} cts_fusion_server_t;
+
+/* Result of the last fusion */
+typedef struct
+{
+    bool     valid;
+    int64_t  offset_ms;             /* Add to local time to get UTC epoch ms */
+    uint32_t error_ms;              /* Half width of the agreed interval */
+    uint8_t  servers;
+    uint8_t  truechimers;
+} cts_fusion_result_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+void cts_fusion_init(void);
+void cts_fusion_add_sample(uint16_t server_id, int64_t utc_us, uint8_t adjust_reason,
+                           uint64_t local_ms);
+void cts_fusion_set_reference_info(uint16_t server_id,
+                                   const cts_reference_info_t *p_info);
+void cts_fusion_remove_server(uint16_t server_id);
+bool cts_fusion_get_result(cts_fusion_result_t *p_result);
+bool cts_fusion_get_time_ms(uint64_t local_ms, uint64_t *p_epoch_ms);
+uint64_t cts_fusion_local_ms(void);
+
+#endif      /* __CTS_TIME_FUSION_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,511 @@
+/******************************************************************************
+* File Name: cts_time_history.c
+*
+* Description: This file keeps a history of the received time samples for
+*              later analysis. Samples are delta encoded against the base
+*              times of their block, six bytes per sample, and can be looked
+*              up by local arrival time with a binary search.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_time_history.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Range of the deltas stored per sample */
+#define HISTORY_MAX_LOCAL_DELTA_MS      (0xFFFFFFu)
+#define HISTORY_MIN_OFFSET_DELTA_MS     (INT16_MIN)
+#define HISTORY_MAX_OFFSET_DELTA_MS     (INT16_MAX)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* Block of samples. A packed sample holds:
+ * - bytes 0..2: arrival time minus base_local_ms, in ms
+ * - bytes 3..4: (server time - arrival time) minus base_offset_ms, in ms
+ * - byte 5:     adjust reason (bits 0..3) and server slot (bits 4..7) */
+typedef struct
+{
+    uint64_t base_local_ms;
+    int64_t  base_offset_ms;
+    uint32_t first_seq;
+    uint16_t count;
+    uint8_t  entries[CTS_HISTORY_BLOCK_SIZE][CTS_HISTORY_ENTRY_SIZE];
+} history_block_t;
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static history_block_t history_blocks[CTS_HISTORY_BLOCKS];
+static uint32_t        history_oldest;      /* Ring index of the oldest block */
+static uint32_t        history_used;        /* Number of blocks in use */
+static uint32_t        history_next_seq;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static history_block_t *history_block(uint32_t position);
+static uint32_t history_local_delta(const history_block_t *p_block, uint32_t index);
+static bool history_find_locked(uint64_t local_ms, uint32_t *p_seq);
+static bool history_get_locked(uint32_t seq, cts_history_sample_t *p_sample);
+
+/*******************************************************************************
+* Function Name: cts_history_init()
+********************************************************************************
+* Summary:
+*   Clears the history.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_history_init(void)
+{
+    taskENTER_CRITICAL();
+    history_oldest = 0;
+    history_used = 0;
+    history_next_seq = 0;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+* Function Name: cts_history_add()
+********************************************************************************
+* Summary:
+*   Appends a sample. A new block is started when the current one is full or
+*   a delta does not fit, for example after a time step of the server.
+*
+* Parameters:
+*   uint8_t server: Connection slot of the server (0..15)
+*   int64_t server_ms: Server time, ms since 1970-01-01
+*   uint64_t local_ms: Local arrival time, must not decrease
+*   uint8_t adjust_reason: Adjust reason of the sample
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_history_add(uint8_t server, int64_t server_ms, uint64_t local_ms,
+                     uint8_t adjust_reason)
+{
+    history_block_t *p_block = NULL;
+    int64_t offset_ms;
+    int64_t offset_delta = 0;
+    uint32_t local_delta = 0;
+    uint64_t last_ms;
+    uint8_t *p_entry;
+
+    taskENTER_CRITICAL();
+    if (0 != history_used)
+    {
+        /* The newest block always holds at least one sample */
+        p_block = history_block(history_used - 1u);
+        last_ms = p_block->base_local_ms +
+                  history_local_delta(p_block, p_block->count - 1u);
+        if (local_ms < last_ms)
+        {
+            /* Keep the history sorted by arrival time */
+            local_ms = last_ms;
+        }
+    }
+
+    /* Taken after the clamp, so that the sample keeps its server time */
+    offset_ms = server_ms - (int64_t)local_ms;
+    if (NULL != p_block)
+    {
+        offset_delta = offset_ms - p_block->base_offset_ms;
+        if ((CTS_HISTORY_BLOCK_SIZE == p_block->count) ||
+            ((local_ms - p_block->base_local_ms) > HISTORY_MAX_LOCAL_DELTA_MS) ||
+            (offset_delta < HISTORY_MIN_OFFSET_DELTA_MS) ||
+            (offset_delta > HISTORY_MAX_OFFSET_DELTA_MS))
+        {
+            p_block = NULL;
+        }
+    }
+
+    if (NULL == p_block)
+    {
+        if (CTS_HISTORY_BLOCKS == history_used)
+        {
+            /* Drop the oldest block */
+            history_oldest = (history_oldest + 1u) % CTS_HISTORY_BLOCKS;
+            history_used--;
+        }
+        p_block = history_block(history_used);
+        history_used++;
+        p_block->base_local_ms = local_ms;
+        p_block->base_offset_ms = offset_ms;
+        p_block->first_seq = history_next_seq;
+        p_block->count = 0;
+        offset_delta = 0;
+    }
+
+    local_delta = (uint32_t)(local_ms - p_block->base_local_ms);
+    p_entry = p_block->entries[p_block->count];
+    p_entry[0] = (uint8_t)(local_delta);
+    p_entry[1] = (uint8_t)(local_delta >> 8u);
+    p_entry[2] = (uint8_t)(local_delta >> 16u);
+    p_entry[3] = (uint8_t)((uint16_t)(int16_t)offset_delta);
+    p_entry[4] = (uint8_t)((uint16_t)(int16_t)offset_delta >> 8u);
+    p_entry[5] = (uint8_t)((adjust_reason & 0x0Fu) | (server << 4u));
+    p_block->count++;
+    history_next_seq++;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+* Function Name: cts_history_find()
+********************************************************************************
+* Summary:
+*   Finds the first sample that arrived at or after a local time. Binary
+*   search over the blocks and then within the block, O(log n).
+*
+* Parameters:
+*   uint64_t local_ms: Local time to search for
+*   uint32_t *p_seq: Sequence number of the sample found
+*
+* Return:
+*   bool: false if no sample arrived at or after local_ms
+*
+*******************************************************************************/
+bool cts_history_find(uint64_t local_ms, uint32_t *p_seq)
+{
+    bool found;
+
+    taskENTER_CRITICAL();
+    found = history_find_locked(local_ms, p_seq);
+    taskEXIT_CRITICAL();
+
+    return found;
+}
+
+/*******************************************************************************
+* Function Name: cts_history_get()
+********************************************************************************
+* Summary:
+*   Decodes the sample with a sequence number.
+*
+* Parameters:
+*   uint32_t seq: Sequence number of the sample
+*   cts_history_sample_t *p_sample: Decoded sample
+*
+* Return:
+*   bool: false if the sample is not (or no longer) in the history
+*
+*******************************************************************************/
+bool cts_history_get(uint32_t seq, cts_history_sample_t *p_sample)
+{
+    bool found;
+
+    taskENTER_CRITICAL();
+    found = history_get_locked(seq, p_sample);
+    taskEXIT_CRITICAL();
+
+    return found;
+}
+
+/*******************************************************************************
+* Function Name: cts_history_export()
+********************************************************************************
+* Summary:
+*   Streams the samples that arrived in a local time range to a callback, one
+*   sample at a time, so no export buffer is needed. Interrupts are only
+*   locked while a single sample is decoded.
+*
+* Parameters:
+*   uint64_t from_ms: Start of the range (inclusive)
+*   uint64_t to_ms: End of the range (inclusive)
+*   cts_history_export_cb_t callback: Receives the samples, returns false to
+*                                     stop the export
+*   void *p_context: Passed to the callback
+*
+* Return:
+*   uint32_t: Number of samples exported
+*
+*******************************************************************************/
+uint32_t cts_history_export(uint64_t from_ms, uint64_t to_ms,
+                            cts_history_export_cb_t callback, void *p_context)
+{
+    cts_history_sample_t sample;
+    uint32_t seq;
+    uint32_t exported = 0;
+
+    if (!cts_history_find(from_ms, &seq))
+    {
+        return 0;
+    }
+
+    while ((cts_history_get(seq, &sample)) && (sample.local_ms <= to_ms))
+    {
+        exported++;
+        if (!callback(&sample, p_context))
+        {
+            break;
+        }
+        seq++;
+    }
+    return exported;
+}
+
+/*******************************************************************************
+* Function Name: cts_history_count()
+********************************************************************************
+* Summary:
+*   Returns the number of samples in the history.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   uint32_t: Number of samples
+*
+*******************************************************************************/
+uint32_t cts_history_count(void)
+{
+    uint32_t count = 0;
+
+    taskENTER_CRITICAL();
+    if (0 != history_used)
+    {
+        count = history_next_seq - history_block(0)->first_seq;
+    }
+    taskEXIT_CRITICAL();
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: cts_history_print_footprint()
+********************************************************************************
+* Summary:
+*   Prints the capacity and RAM use of the history.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void cts_history_print_footprint(void)
+{
+    uint32_t capacity = CTS_HISTORY_BLOCKS * CTS_HISTORY_BLOCK_SIZE;
+    uint32_t per_sample_x100 = (uint32_t)((sizeof(history_blocks) * 100u) / capacity);
+
+    printf("Time history: %lu samples in %lu bytes, %lu.%02lu bytes/sample\n",
+           (unsigned long)capacity, (unsigned long)sizeof(history_blocks),
+           (unsigned long)(per_sample_x100 / 100u),
+           (unsigned long)(per_sample_x100 % 100u));
+}
+
+/*******************************************************************************
+* Function Name: history_block()
+********************************************************************************
+* Summary:
+*   Returns a block by its position, 0 being the oldest block.
+*
+* Parameters:
+*   uint32_t position: Position of the block
+*
+* Return:
+*   history_block_t*: Block
+*
+*******************************************************************************/
+static history_block_t *history_block(uint32_t position)
+{
+    return &history_blocks[(history_oldest + position) % CTS_HISTORY_BLOCKS];
+}
+
+/*******************************************************************************
+* Function Name: history_local_delta()
+********************************************************************************
+* Summary:
+*   Returns the arrival time delta of a sample in a block.
+*
+* Parameters:
+*   const history_block_t *p_block: Block
+*   uint32_t index: Index of the sample in the block
+*
+* Return:
+*   uint32_t: Arrival time minus the block base, in ms
+*
+*******************************************************************************/
+static uint32_t history_local_delta(const history_block_t *p_block, uint32_t index)
+{
+    const uint8_t *p_entry = p_block->entries[index];
+
+    return (uint32_t)p_entry[0] | ((uint32_t)p_entry[1] << 8u) |
+           ((uint32_t)p_entry[2] << 16u);
+}
+
+/*******************************************************************************
+* Function Name: history_find_locked()
+********************************************************************************
+* Summary:
+*   See cts_history_find(). Called with interrupts locked.
+*
+* Parameters:
+*   uint64_t local_ms: Local time to search for
+*   uint32_t *p_seq: Sequence number of the sample found
+*
+* Return:
+*   bool: false if no sample arrived at or after local_ms
+*
+*******************************************************************************/
+static bool history_find_locked(uint64_t local_ms, uint32_t *p_seq)
+{
+    history_block_t *p_block;
+    uint32_t low = 0;
+    uint32_t high;
+    uint32_t mid;
+    uint64_t delta;
+
+    if (0 == history_used)
+    {
+        return false;
+    }
+
+    /* Last block starting before local_ms. Samples clamped to the same
+     * arrival time can end one block and start the next */
+    high = history_used;
+    while ((high - low) > 1u)
+    {
+        mid = low + ((high - low) / 2u);
+        if (history_block(mid)->base_local_ms < local_ms)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    p_block = history_block(low);
+    if (local_ms <= p_block->base_local_ms)
+    {
+        *p_seq = p_block->first_seq;
+        return true;
+    }
+
+    /* First sample in the block at or after local_ms */
+    delta = local_ms - p_block->base_local_ms;
+    low = 0;
+    high = p_block->count;
+    while (low < high)
+    {
+        mid = low + ((high - low) / 2u);
+        if (history_local_delta(p_block, mid) < delta)
+        {
+            low = mid + 1u;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    *p_seq = p_block->first_seq + low;
+    return (*p_seq < history_next_seq);
+}
+
+/*******************************************************************************
+* Function Name: history_get_locked()
+********************************************************************************
+* Summary:
+*   See cts_history_get(). Called with interrupts locked.
+*
+* Parameters:
+*   uint32_t seq: Sequence number of the sample
+*   cts_history_sample_t *p_sample: Decoded sample
+*
+* Return:
+*   bool: false if the sample is not in the history
+*
+*******************************************************************************/
+static bool history_get_locked(uint32_t seq, cts_history_sample_t *p_sample)
+{
+    history_block_t *p_block;
+    const uint8_t *p_entry;
+    uint32_t low = 0;
+    uint32_t high = history_used;
+    uint32_t mid;
+    int16_t offset_delta;
+
+    if ((0 == history_used) || (seq < history_block(0)->first_seq) ||
+        (seq >= history_next_seq))
+    {
+        return false;
+    }
+
+    /* Last block starting at or before seq */
+    while ((high - low) > 1u)
+    {
+        mid = low + ((high - low) / 2u);
+        if (history_block(mid)->first_seq <= seq)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    p_block = history_block(low);
+    p_entry = p_block->entries[seq - p_block->first_seq];
+
+    offset_delta = (int16_t)((uint16_t)p_entry[3] | ((uint16_t)p_entry[4] << 8u));
+    p_sample->seq = seq;
+    p_sample->local_ms = p_block->base_local_ms +
+                         history_local_delta(p_block, seq - p_block->first_seq);
+    p_sample->server_ms = (int64_t)p_sample->local_ms + p_block->base_offset_ms +
+                          offset_delta;
+    p_sample->adjust_reason = p_entry[5] & 0x0Fu;
+    p_sample->server = p_entry[5] >> 4u;
+    return true;
+}
+
+/* [] END OF FILE */
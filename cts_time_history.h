@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name: cts_time_history.h
+*
+* Description: This file contains macros, structures and function prototypes
+*              used in cts_time_history.c file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __CTS_TIME_HISTORY_H__
+#define __CTS_TIME_HISTORY_H__
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 0 to disable the history of received time samples */
+#ifndef ENABLE_TIME_HISTORY
+#define ENABLE_TIME_HISTORY             (1u)
+#endif
+
+/* The history is a ring of blocks. Each block holds the base times of its
+ * first sample and up to CTS_HISTORY_BLOCK_SIZE samples as deltas. When the
+ * ring is full, the oldest block is dropped as a whole */
+#ifndef CTS_HISTORY_BLOCKS
+#define CTS_HISTORY_BLOCKS              (16u)
+#endif
+#ifndef CTS_HISTORY_BLOCK_SIZE
+#define CTS_HISTORY_BLOCK_SIZE          (256u)
+#endif
+
+/* Size of one packed sample in bytes */
+#define CTS_HISTORY_ENTRY_SIZE          (6u)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* Decoded history sample */
+typedef struct
+{
+    uint32_t seq;                   /* Sequence number of the sample */
+    uint64_t local_ms;              /* Local arrival time */
+    int64_t  server_ms;             /* Server time, ms since 1970-01-01 */
+    uint8_t  adjust_reason;
+    uint8_t  server;                /* Connection slot of the server */
+} cts_history_sample_t;
+
+/* Called for every sample of an export */
+typedef bool (*cts_history_export_cb_t)(const cts_history_sample_t *p_sample,
+                                        void *p_context);
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+void     cts_history_init(void);
+void     cts_history_add(uint8_t server, int64_t server_ms, uint64_t local_ms,
+                         uint8_t adjust_reason);
+bool     cts_history_find(uint64_t local_ms, uint32_t *p_seq);
+bool     cts_history_get(uint32_t seq, cts_history_sample_t *p_sample);
+uint32_t cts_history_export(uint64_t from_ms, uint64_t to_ms,
+                            cts_history_export_cb_t callback, void *p_context);
+uint32_t cts_history_count(void);
+void     cts_history_print_footprint(void);
+
+#endif      /* __CTS_TIME_HISTORY_H__ */
+
+/* [] END OF FILE */
@@ -53,7 +53,15 @@
 #include "cy_retarget_io.h"
 #include <FreeRTOS.h>
 #include <task.h>
+#include <queue.h>
 #include "cts_client.h"
+#include "app_bt_scan.h"
+#include "app_bt_adv.h"
+#include "app_bt_bonding.h"
+#include "app_bt_utils.h"
+#include "app_uart_tx.h"
+#include "app_trace.h"
+#include "app_cmd.h"
 
 /*******************************************************************************
 *        Variable Definitions
@@ -61,9 +69,18 @@
 /* This enables RTOS aware debugging. */
 volatile int uxTopUsedPriority;
 
-/* FreeRTOS task handle for button task. Button task is used to start advertisment
- * or enable/disable notification from peer */
-TaskHandle_t  button_task_handle;
+/* FreeRTOS task handle for the application task. It owns the CTS state and
+ * handles button presses and Bluetooth stack events */
+TaskHandle_t  app_task_handle;
+
+/* Stack and control block of the application task */
+static StackType_t  app_task_stack[APP_TASK_STACK_SIZE];
+static StaticTask_t app_task_tcb;
+
+/* Queue of events for the application task */
+QueueHandle_t app_event_queue;
+static StaticQueue_t app_event_queue_buf;
+static uint8_t app_event_queue_storage[APP_EVENT_QUEUE_LEN * sizeof(app_event_t)];
 
 /******************************************************************************
  *                          Function Definitions
@@ -78,7 +95,7 @@ int main()
 {
     cy_rslt_t cy_result;
     wiced_result_t wiced_result;
-    BaseType_t rtos_result;
+    const wiced_bt_cfg_settings_t *p_bt_cfg = &wiced_bt_cfg_settings;
 
     /* This enables RTOS aware debugging in OpenOCD. */
     uxTopUsedPriority = configMAX_PRIORITIES - 1;
@@ -98,6 +115,14 @@ int main()
     cy_retarget_io_init(CYBSP_DEBUG_UART_TX, CYBSP_DEBUG_UART_RX,
                         CY_RETARGET_IO_BAUDRATE);
 
+    /* Cycle counter used for timing measurements */
+    cycle_counter_init();
+
+#if (ENABLE_UART_TX_ASYNC)
+    /* Send debug output without blocking the printing task */
+    app_uart_tx_init();
+#endif
+
     printf("**********************AnyCloud Example*************************\n");
     printf("**** Current Time Service (CTS) - Client Application Start ****\n");
     printf("***************************************************************\n\n");
@@ -105,9 +130,24 @@ int main()
     /* Configure platform specific settings for the BT device */
     cybt_platform_config_init(&cybsp_bt_platform_cfg);
 
+#if (ENABLE_CENTRAL_MODE)
+    /* Use a RAM copy of the configuration so that scan profiles can be
+     * applied at run time */
+    p_bt_cfg = app_bt_scan_cfg_init(&wiced_bt_cfg_settings);
+#else
+    /* Use a RAM copy of the configuration so that the advertising schedule
+     * can be applied at run time */
+    p_bt_cfg = app_bt_adv_cfg_init(&wiced_bt_cfg_settings);
+#endif
+
+#if (ENABLE_BONDING)
+    /* The stack asks for the local identity keys before it is enabled, so
+     * the bond store must be loaded first */
+    (void)app_bt_bond_load();
+#endif
+
     /* Register call back and configuration with stack */
-    wiced_result = wiced_bt_stack_init(app_bt_management_callback,
-                                       &wiced_bt_cfg_settings);
+    wiced_result = wiced_bt_stack_init(app_bt_management_callback, p_bt_cfg);
 
     /* Check if stack initialization was successful */
     if( WICED_BT_SUCCESS == wiced_result)
@@ -120,14 +160,28 @@ int main()
         CY_ASSERT(0);
     }
 
-    /* Create Button Task for processing button presses */
-     rtos_result = xTaskCreate(button_task,"button_task", BUTTON_TASK_STACK_SIZE,
-                               NULL, BUTTON_TASK_PRIORITY, &button_task_handle);
-    if( pdPASS != rtos_result)
+    /* Create the application task and its event queue. The queue exists
+     * before the stack or the button can post to it */
+    app_event_queue = xQueueCreateStatic(APP_EVENT_QUEUE_LEN, sizeof(app_event_t),
+                                         app_event_queue_storage,
+                                         &app_event_queue_buf);
+    app_task_handle = xTaskCreateStatic(app_task, "app_task",
+                                        APP_TASK_STACK_SIZE, NULL,
+                                        APP_TASK_PRIORITY,
+                                        app_task_stack, &app_task_tcb);
+    if ((NULL == app_event_queue) || (NULL == app_task_handle))
     {
-        printf("Failed to create Button task! \n");
+        printf("Failed to create application task! \n");
         CY_ASSERT(0);
     }
+#if (ENABLE_TRACE_RECORDER)
+    app_trace_name_queue(app_event_queue, "app_event");
+#endif
+
+#if (ENABLE_UART_COMMANDS)
+    /* Commands on the debug UART, for scripted control */
+    app_cmd_init();
+#endif
 
     /* Start the FreeRTOS scheduler */
     vTaskStartScheduler();
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Decodes the binary output of the CTS client (ENABLE_BINARY_OUTPUT = 1).
+
+Frames are COBS encoded records delimited by zero bytes. A record is:
+type (1), sequence number (1), local time in ms (4), payload and the
+CRC-16/CCITT-FALSE of all previous bytes (2), little endian. Bytes that do
+not form a valid frame, such as text printed by the firmware, are shown as
+text.
+
+Usage:
+    cts_bin_decode.py /dev/ttyACM0 [baudrate]   (needs pyserial)
+    cts_bin_decode.py capture.bin
+    cts_bin_decode.py - < capture.bin
+"""
+
+import os
+import struct
+import sys
+
+RECORD_CONNECT = 0x01
+RECORD_DISCONNECT = 0x02
+RECORD_DISCOVERY = 0x03
+RECORD_TIME = 0x04
+
+DAYS = ["UNKNOWN", "MONDAY", "TUESDAY", "WEDNESDAY", "THURSDAY", "FRIDAY",
+        "SATURDAY", "SUNDAY"]
+ADJUST_REASONS = ["Manual", "External reference", "Time zone", "DST"]
+
+
+def crc16_ccitt(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    index = 0
+    while index < len(data):
+        code = data[index]
+        end = index + code
+        if code == 0 or end > len(data):
+            return None
+        out += data[index + 1:end]
+        index = end
+        if code < 0xFF and index < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def format_time(value):
+    year, month, day, hours, minutes, seconds, dow, frac, adjust = \
+        struct.unpack("<HBBBBBBBB", value)
+    reasons = [name for bit, name in enumerate(ADJUST_REASONS) if adjust & (1 << bit)]
+    text = "%04d-%02d-%02d %02d:%02d:%02d.%03d %s" % (
+        year, month, day, hours, minutes, seconds, frac * 1000 // 256,
+        DAYS[dow] if dow < len(DAYS) else "?")
+    if reasons:
+        text += " adjust: " + ", ".join(reasons)
+    return text
+
+
+def format_record(record):
+    rtype, seq, time_ms = struct.unpack_from("<BBI", record)
+    payload = record[6:-2]
+    head = "[%10.3f s #%3d]" % (time_ms / 1000.0, seq)
+    if rtype == RECORD_CONNECT and len(payload) == 9:
+        conn_id = struct.unpack_from("<H", payload)[0]
+        addr = ":".join("%02X" % b for b in payload[2:8])
+        return "%s connect conn %d %s type %d" % (head, conn_id, addr, payload[8])
+    if rtype == RECORD_DISCONNECT and len(payload) == 4:
+        conn_id, reason = struct.unpack("<HH", payload)
+        return "%s disconnect conn %d reason 0x%04X" % (head, conn_id, reason)
+    if rtype == RECORD_DISCOVERY and len(payload) == 8:
+        conn_id, uuid, handle, handle2 = struct.unpack("<HHHH", payload)
+        return "%s discovery conn %d uuid 0x%04X handle %d/%d" % (
+            head, conn_id, uuid, handle, handle2)
+    if rtype == RECORD_TIME and len(payload) == 16:
+        conn_id = struct.unpack_from("<H", payload)[0]
+        error_us = struct.unpack_from("<I", payload, 12)[0]
+        return "%s time conn %d %s +/- %d us" % (
+            head, conn_id, format_time(payload[2:12]), error_us)
+    return "%s type 0x%02X payload %s" % (head, rtype, payload.hex())
+
+
+def open_input(name, baudrate):
+    if name == "-":
+        return sys.stdin.buffer
+    if os.path.isfile(name):
+        return open(name, "rb")
+    import serial  # pylint: disable=import-outside-toplevel
+    return serial.Serial(name, baudrate, timeout=1)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 1
+    stream = open_input(sys.argv[1], int(sys.argv[2]) if len(sys.argv) > 2 else 115200)
+    frame = bytearray()
+    records = 0
+    frame_bytes = 0
+    try:
+        while True:
+            chunk = stream.read(1)
+            if not chunk:
+                if not hasattr(stream, "in_waiting"):
+                    break
+                continue
+            if chunk[0] != 0:
+                frame += chunk
+                continue
+            if frame:
+                record = cobs_decode(bytes(frame))
+                if (record is not None and len(record) >= 8 and
+                        crc16_ccitt(record[:-2]) == struct.unpack("<H", record[-2:])[0]):
+                    print(format_record(record))
+                    records += 1
+                    frame_bytes += len(frame) + 2
+                else:
+                    text = frame.decode("ascii", "replace").strip()
+                    if text:
+                        print(text)
+            frame = bytearray()
+    except KeyboardInterrupt:
+        pass
+    if records:
+        print("%d records, %.1f bytes per record" % (records, frame_bytes / records),
+              file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
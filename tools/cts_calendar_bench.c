@@ -0,0 +1,313 @@
+/******************************************************************************
+* File Name: cts_calendar_bench.c
+*
+* Description: Host test and benchmark of the calendar conversions in
+*              cts_calendar.c. Checks every day from 1582 to 9999 against a
+*              day by day count and the C library, then times the conversions
+*              of 100 million dates.
+*
+*              gcc -O2 -I. -o cts_calendar_bench tools/cts_calendar_bench.c cts_calendar.c
+*              ./cts_calendar_bench [number of dates]
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_calendar.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define DEFAULT_DATES                   (100000000ull)
+
+/* Number of failures printed before the rest are only counted */
+#define MAX_REPORTED_FAILURES           (10u)
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static uint32_t failures;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void fail(const char *p_what, int64_t value);
+static int  is_leap(int32_t year);
+static void check_all_days(void);
+static void check_dates(void);
+static void check_iso8601(void);
+static double now_s(void);
+static void benchmark(uint64_t dates);
+
+int main(int argc, char *argv[])
+{
+    uint64_t dates = DEFAULT_DATES;
+
+    if (argc > 1)
+    {
+        dates = strtoull(argv[1], NULL, 0);
+    }
+
+    check_all_days();
+    check_dates();
+    check_iso8601();
+    printf("Checks: %s (%u failures)\n", (0u == failures) ? "passed" : "FAILED", failures);
+
+    benchmark(dates);
+    return (0u == failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void fail(const char *p_what, int64_t value)
+{
+    if (failures < MAX_REPORTED_FAILURES)
+    {
+        printf("FAIL: %s (%" PRId64 ")\n", p_what, value);
+    }
+    failures++;
+}
+
+static int is_leap(int32_t year)
+{
+    return ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+}
+
+/* Walks day by day from 1582-01-01 to 9999-12-31 with a plain calendar and
+ * compares both directions and the day of week */
+static void check_all_days(void)
+{
+    static const uint32_t month_days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    int32_t days = cts_days_from_civil(CTS_CALENDAR_YEAR_MIN, 1u, 1u);
+    uint8_t weekday = cts_weekday_from_days(days);
+    int32_t year;
+    uint32_t month;
+    uint32_t day;
+    int32_t y;
+    uint32_t m;
+    uint32_t d;
+    uint32_t dim;
+
+    /* Fixed points: 1970-01-01 was a Thursday, 1582-10-15 and 9999-12-31
+     * are Fridays */
+    if (0 != cts_days_from_civil(1970, 1u, 1u))
+    {
+        fail("1970-01-01 is not day 0", cts_days_from_civil(1970, 1u, 1u));
+    }
+    if (4u != cts_weekday_from_days(0))
+    {
+        fail("1970-01-01 is not a Thursday", cts_weekday_from_days(0));
+    }
+    if (5u != cts_weekday_from_days(cts_days_from_civil(1582, 10u, 15u)))
+    {
+        fail("1582-10-15 is not a Friday", 0);
+    }
+    if (5u != cts_weekday_from_days(cts_days_from_civil(9999, 12u, 31u)))
+    {
+        fail("9999-12-31 is not a Friday", 0);
+    }
+    if (11017 != cts_days_from_civil(2000, 3u, 1u))
+    {
+        fail("2000-03-01 is not day 11017", cts_days_from_civil(2000, 3u, 1u));
+    }
+
+    for (year = CTS_CALENDAR_YEAR_MIN; year <= CTS_CALENDAR_YEAR_MAX; year++)
+    {
+        for (month = 1u; month <= 12u; month++)
+        {
+            dim = month_days[month - 1u] + (((2u == month) && is_leap(year)) ? 1u : 0u);
+            if (dim != cts_days_in_month(year, month))
+            {
+                fail("days in month", (int64_t)year * 100 + month);
+            }
+            for (day = 1u; day <= dim; day++)
+            {
+                if (days != cts_days_from_civil(year, month, day))
+                {
+                    fail("days_from_civil", days);
+                }
+                cts_civil_from_days(days, &y, &m, &d);
+                if ((y != year) || (m != month) || (d != day))
+                {
+                    fail("civil_from_days", days);
+                }
+                if (weekday != cts_weekday_from_days(days))
+                {
+                    fail("weekday", days);
+                }
+                if (CTS_DATE_VALID != cts_calendar_check(year, month, day, weekday))
+                {
+                    fail("valid date rejected", days);
+                }
+                days++;
+                weekday = (uint8_t)((weekday % 7u) + 1u);
+            }
+        }
+    }
+}
+
+/* Unknown, invalid and mismatching dates */
+static void check_dates(void)
+{
+    static const struct
+    {
+        int32_t year;
+        uint32_t month;
+        uint32_t day;
+        uint32_t day_of_week;
+        cts_date_status_t status;
+    } cases[] =
+    {
+        {0,     0u,  0u,  0u, CTS_DATE_UNKNOWN},
+        {2024,  0u,  15u, 0u, CTS_DATE_UNKNOWN},
+        {2024,  6u,  0u,  0u, CTS_DATE_UNKNOWN},
+        {0,     6u,  15u, 6u, CTS_DATE_UNKNOWN},
+        {2024,  6u,  15u, 0u, CTS_DATE_VALID},
+        {2024,  6u,  15u, 6u, CTS_DATE_VALID},
+        {2024,  6u,  15u, 5u, CTS_DATE_WEEKDAY_MISMATCH},
+        {2024,  6u,  15u, 8u, CTS_DATE_INVALID},
+        {2024,  13u, 1u,  0u, CTS_DATE_INVALID},
+        {2024,  4u,  31u, 0u, CTS_DATE_INVALID},
+        {1900,  2u,  29u, 0u, CTS_DATE_INVALID},
+        {2000,  2u,  29u, 2u, CTS_DATE_VALID},
+        {1581,  12u, 31u, 0u, CTS_DATE_INVALID},
+        {10000, 1u,  1u,  0u, CTS_DATE_INVALID},
+    };
+    size_t index;
+
+    for (index = 0; index < (sizeof(cases) / sizeof(cases[0])); index++)
+    {
+        if (cases[index].status != cts_calendar_check(cases[index].year,
+                                                      cases[index].month,
+                                                      cases[index].day,
+                                                      cases[index].day_of_week))
+        {
+            fail("date check case", (int64_t)index);
+        }
+    }
+}
+
+/* Compares the ISO 8601 output with gmtime() of the C library */
+static void check_iso8601(void)
+{
+    int64_t first = cts_calendar_to_epoch_s(1582, 10u, 15u, 0u, 0u, 0u);
+    int64_t last = cts_calendar_to_epoch_s(9999, 12u, 31u, 23u, 59u, 59u);
+    int64_t step = (last - first) / 1000003;
+    char expected[80];
+    char text[CTS_CALENDAR_ISO8601_LEN];
+    int64_t epoch_s;
+    time_t t;
+    struct tm tm;
+
+    if (sizeof(time_t) < 8u)
+    {
+        printf("time_t is 32 bits, ISO 8601 check skipped\n");
+        return;
+    }
+    for (epoch_s = first; epoch_s <= last; epoch_s += step)
+    {
+        t = (time_t)epoch_s;
+        gmtime_r(&t, &tm);
+        snprintf(expected, sizeof(expected), "%04d-%02d-%02dT%02d:%02d:%02d",
+                 tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                 tm.tm_hour, tm.tm_min, tm.tm_sec);
+        cts_calendar_format_iso8601(epoch_s, text);
+        if (0 != strcmp(expected, text))
+        {
+            fail("ISO 8601", epoch_s);
+        }
+    }
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+/* Converts dates spread over the whole supported range in both directions */
+static void benchmark(uint64_t dates)
+{
+    int32_t first = cts_days_from_civil(CTS_CALENDAR_YEAR_MIN, 1u, 1u);
+    uint32_t span = (uint32_t)(cts_days_from_civil(CTS_CALENDAR_YEAR_MAX, 12u, 31u) - first + 1);
+    uint32_t stride = 7919u;            /* Prime, visits the range out of order */
+    uint32_t offset = 0;
+    uint64_t checksum = 0;
+    uint64_t index;
+    int32_t year;
+    uint32_t month;
+    uint32_t day;
+    double start;
+    double civil_s;
+    double days_s;
+
+    start = now_s();
+    for (index = 0; index < dates; index++)
+    {
+        cts_civil_from_days(first + (int32_t)offset, &year, &month, &day);
+        checksum += (uint32_t)year + month + day;
+        offset += stride;
+        offset -= (offset >= span) ? span : 0u;
+    }
+    civil_s = now_s() - start;
+
+    start = now_s();
+    year = CTS_CALENDAR_YEAR_MIN;
+    month = 1u;
+    day = 1u;
+    for (index = 0; index < dates; index++)
+    {
+        checksum += (uint32_t)cts_days_from_civil(year, month, day);
+        day = (day % 28u) + 1u;
+        month = (month % 12u) + 1u;
+        year = (year < CTS_CALENDAR_YEAR_MAX) ? (year + 1) : CTS_CALENDAR_YEAR_MIN;
+    }
+    days_s = now_s() - start;
+
+    printf("civil_from_days: %" PRIu64 " dates in %.3f s, %.2f ns/date\n",
+           dates, civil_s, (civil_s * 1e9) / (double)dates);
+    printf("days_from_civil: %" PRIu64 " dates in %.3f s, %.2f ns/date\n",
+           dates, days_s, (days_s * 1e9) / (double)dates);
+    printf("Checksum: %" PRIu64 "\n", checksum);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,498 @@
+/******************************************************************************
+* File Name: cts_history_check.c
+*
+* Description: Host check of the time history in cts_time_history.c. Adds
+*              three times the capacity of samples with arrival time gaps
+*              and server clock steps that start new blocks, and compares
+*              cts_history_get(), cts_history_find() and cts_history_export()
+*              with a plain array of every sample added.
+*
+*              gcc -O2 -Itools/sim -I. -o cts_history_check tools/cts_history_check.c cts_time_history.c
+*              ./cts_history_check [seed]
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_time_history.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define HISTORY_CAPACITY                (CTS_HISTORY_BLOCKS * CTS_HISTORY_BLOCK_SIZE)
+#define TOTAL_SAMPLES                   (3u * HISTORY_CAPACITY)
+
+/* The history is compared in full every CHECK_INTERVAL samples */
+#define CHECK_INTERVAL                  (97u)
+
+/* Limits of a block, as in cts_time_history.c */
+#define MAX_LOCAL_DELTA_MS              (0xFFFFFFull)
+#define MIN_OFFSET_DELTA_MS             (INT16_MIN)
+#define MAX_OFFSET_DELTA_MS             (INT16_MAX)
+
+/* Number of failures printed before the rest are only counted */
+#define MAX_REPORTED_FAILURES           (10u)
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+/* Sample as it must come back from the history */
+typedef struct
+{
+    uint64_t local_ms;
+    int64_t  server_ms;
+    uint8_t  adjust_reason;
+    uint8_t  server;
+} expected_sample_t;
+
+/* Export state */
+typedef struct
+{
+    uint32_t next_seq;              /* Sequence number expected next */
+    uint32_t received;
+    uint32_t stop_after;            /* Returns false after this many samples */
+} export_context_t;
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static uint32_t          failures;
+static uint64_t          random_state;
+static expected_sample_t expected[TOTAL_SAMPLES];
+static uint32_t          expected_count;
+
+/* First sequence numbers of the blocks the history must hold, oldest first */
+static uint32_t          block_first[CTS_HISTORY_BLOCKS];
+static uint32_t          block_oldest;
+static uint32_t          block_used;
+static uint32_t          block_size;
+static uint64_t          block_base_local_ms;
+static int64_t           block_base_offset_ms;
+
+/* Number of samples that started a block for each reason */
+static uint32_t          blocks_full;
+static uint32_t          blocks_gap;
+static uint32_t          blocks_step;
+static uint32_t          samples_clamped;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void     fail(const char *p_what, int64_t value);
+static uint32_t random_next(void);
+static void     add_sample(uint8_t server, int64_t server_ms, uint64_t local_ms,
+                           uint8_t adjust_reason);
+static uint32_t oldest_seq(void);
+static uint32_t lower_bound(uint64_t local_ms);
+static void     check_empty(void);
+static void     check_get(void);
+static void     check_find(void);
+static bool     export_cb(const cts_history_sample_t *p_sample, void *p_context);
+static void     check_export_range(uint64_t from_ms, uint64_t to_ms, uint32_t stop_after);
+static void     check_export(void);
+static void     check_history(void);
+
+int main(int argc, char *argv[])
+{
+    uint64_t local_ms = 1000u;
+    int64_t offset_ms = 1700000000000ll;
+    uint32_t index;
+    uint32_t value;
+    int64_t step_ms;
+
+    random_state = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1u;
+
+    cts_history_init();
+    check_empty();
+
+    for (index = 0; index < TOTAL_SAMPLES; index++)
+    {
+        value = random_next();
+        if (0u == (value % 1499u))
+        {
+            /* Gap in the arrivals, longer than a block can span */
+            local_ms += MAX_LOCAL_DELTA_MS + 1u + (random_next() % 3600000u);
+        }
+        else if ((0u == (value % 211u)) && (local_ms > 5000u))
+        {
+            /* Arrival time before the previous sample */
+            local_ms -= 1u + (random_next() % 4000u);
+        }
+        else
+        {
+            local_ms += 900u + (random_next() % 200u);
+        }
+
+        value = random_next();
+        if (0u == (value % 1103u))
+        {
+            /* Manual clock step of the server, ahead or back */
+            step_ms = (int64_t)(MAX_OFFSET_DELTA_MS + 1) + (random_next() % 86400000u);
+            offset_ms += (0u != (value & 0x100u)) ? step_ms : -step_ms;
+        }
+        else if (0u == (value % 137u))
+        {
+            /* Step that just fits into a block */
+            offset_ms += (0u != (value & 0x100u)) ? 30000 : -30000;
+        }
+        else
+        {
+            /* Drift */
+            offset_ms += (int64_t)(random_next() % 41u) - 20;
+        }
+
+        add_sample((uint8_t)(random_next() & 0x0Fu), offset_ms + (int64_t)local_ms,
+                   local_ms, (uint8_t)random_next());
+
+        if ((0u == (index % CHECK_INTERVAL)) || ((index + 1u) == TOTAL_SAMPLES))
+        {
+            check_history();
+        }
+    }
+
+    if ((0u == blocks_gap) || (0u == blocks_step) || (0u == blocks_full) ||
+        (0u == samples_clamped))
+    {
+        fail("a block rule was not exercised", 0);
+    }
+    printf("Samples: %" PRIu32 ", kept %" PRIu32 ", clamped %" PRIu32 "\n",
+           expected_count, cts_history_count(), samples_clamped);
+    printf("New blocks: %" PRIu32 " full, %" PRIu32 " gap, %" PRIu32 " clock step\n",
+           blocks_full, blocks_gap, blocks_step);
+
+    cts_history_init();
+    check_empty();
+
+    printf("Checks: %s (%" PRIu32 " failures)\n",
+           (0u == failures) ? "passed" : "FAILED", failures);
+    return (0u == failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void fail(const char *p_what, int64_t value)
+{
+    if (failures < MAX_REPORTED_FAILURES)
+    {
+        printf("FAIL: %s (%" PRId64 ")\n", p_what, value);
+    }
+    failures++;
+}
+
+/* xorshift64* */
+static uint32_t random_next(void)
+{
+    random_state ^= random_state >> 12u;
+    random_state ^= random_state << 25u;
+    random_state ^= random_state >> 27u;
+    return (uint32_t)((random_state * 2685821657736338717ull) >> 32u);
+}
+
+/* Adds a sample to the history and to the expected samples, and tracks the
+ * blocks the history must start */
+static void add_sample(uint8_t server, int64_t server_ms, uint64_t local_ms,
+                       uint8_t adjust_reason)
+{
+    expected_sample_t *p_expected = &expected[expected_count];
+    int64_t offset_ms;
+    int64_t offset_delta;
+    bool new_block = (0u == block_used);
+
+    cts_history_add(server, server_ms, local_ms, adjust_reason);
+
+    if ((0u != expected_count) && (local_ms < expected[expected_count - 1u].local_ms))
+    {
+        local_ms = expected[expected_count - 1u].local_ms;
+        samples_clamped++;
+    }
+    offset_ms = server_ms - (int64_t)local_ms;
+    p_expected->local_ms = local_ms;
+    p_expected->server_ms = server_ms;
+    p_expected->adjust_reason = adjust_reason & 0x0Fu;
+    p_expected->server = server;
+
+    if (!new_block)
+    {
+        offset_delta = offset_ms - block_base_offset_ms;
+        if (CTS_HISTORY_BLOCK_SIZE == block_size)
+        {
+            blocks_full++;
+            new_block = true;
+        }
+        else if ((local_ms - block_base_local_ms) > MAX_LOCAL_DELTA_MS)
+        {
+            blocks_gap++;
+            new_block = true;
+        }
+        else if ((offset_delta < MIN_OFFSET_DELTA_MS) || (offset_delta > MAX_OFFSET_DELTA_MS))
+        {
+            blocks_step++;
+            new_block = true;
+        }
+    }
+
+    if (new_block)
+    {
+        if (CTS_HISTORY_BLOCKS == block_used)
+        {
+            block_oldest = (block_oldest + 1u) % CTS_HISTORY_BLOCKS;
+            block_used--;
+        }
+        block_first[(block_oldest + block_used) % CTS_HISTORY_BLOCKS] = expected_count;
+        block_used++;
+        block_size = 0;
+        block_base_local_ms = local_ms;
+        block_base_offset_ms = offset_ms;
+    }
+    block_size++;
+    expected_count++;
+}
+
+static uint32_t oldest_seq(void)
+{
+    return (0u == block_used) ? 0u : block_first[block_oldest];
+}
+
+/* First kept sample that arrived at or after local_ms, expected_count if none */
+static uint32_t lower_bound(uint64_t local_ms)
+{
+    uint32_t low = oldest_seq();
+    uint32_t high = expected_count;
+    uint32_t mid;
+
+    while (low < high)
+    {
+        mid = low + ((high - low) / 2u);
+        if (expected[mid].local_ms < local_ms)
+        {
+            low = mid + 1u;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/* An empty history finds and exports nothing */
+static void check_empty(void)
+{
+    cts_history_sample_t sample;
+    export_context_t context = {0u, 0u, UINT32_MAX};
+    uint32_t seq;
+
+    if (0u != cts_history_count())
+    {
+        fail("empty history count", cts_history_count());
+    }
+    if (cts_history_find(0u, &seq))
+    {
+        fail("empty history find", seq);
+    }
+    if (cts_history_get(0u, &sample))
+    {
+        fail("empty history get", 0);
+    }
+    if (0u != cts_history_export(0u, UINT64_MAX, export_cb, &context))
+    {
+        fail("empty history export", context.received);
+    }
+}
+
+/* Every kept sample decodes to the sample added, the dropped ones and the
+ * next one are not found */
+static void check_get(void)
+{
+    cts_history_sample_t sample;
+    uint32_t oldest = oldest_seq();
+    uint32_t seq;
+
+    if ((expected_count - oldest) != cts_history_count())
+    {
+        fail("count", (int64_t)cts_history_count() - (int64_t)(expected_count - oldest));
+    }
+    if ((0u != oldest) && cts_history_get(oldest - 1u, &sample))
+    {
+        fail("dropped sample still kept", oldest - 1u);
+    }
+    if (cts_history_get(expected_count, &sample))
+    {
+        fail("sample after the newest", expected_count);
+    }
+
+    for (seq = oldest; seq < expected_count; seq++)
+    {
+        if (!cts_history_get(seq, &sample))
+        {
+            fail("kept sample not found", seq);
+            continue;
+        }
+        if ((sample.seq != seq) ||
+            (sample.local_ms != expected[seq].local_ms) ||
+            (sample.server_ms != expected[seq].server_ms) ||
+            (sample.adjust_reason != expected[seq].adjust_reason) ||
+            (sample.server != expected[seq].server))
+        {
+            fail("sample round trip", seq);
+        }
+    }
+}
+
+/* Searches at, just before and just after every kept arrival time, before
+ * the oldest and after the newest sample */
+static void check_find(void)
+{
+    uint32_t oldest = oldest_seq();
+    uint64_t queries[3];
+    uint64_t local_ms;
+    uint32_t expected_seq;
+    uint32_t seq;
+    uint32_t index;
+    uint32_t query;
+
+    for (index = oldest; index < expected_count; index++)
+    {
+        local_ms = expected[index].local_ms;
+        queries[0] = local_ms - 1u;
+        queries[1] = local_ms;
+        queries[2] = local_ms + 1u;
+        for (query = 0; query < 3u; query++)
+        {
+            expected_seq = lower_bound(queries[query]);
+            if (!cts_history_find(queries[query], &seq))
+            {
+                if (expected_seq != expected_count)
+                {
+                    fail("find missed a sample", (int64_t)queries[query]);
+                }
+            }
+            else if (seq != expected_seq)
+            {
+                fail("find", (int64_t)seq - (int64_t)expected_seq);
+            }
+        }
+    }
+
+    if (!cts_history_find(0u, &seq) || (seq != oldest))
+    {
+        fail("find before the oldest sample", oldest);
+    }
+    if (cts_history_find(expected[expected_count - 1u].local_ms + 1u, &seq))
+    {
+        fail("find after the newest sample", seq);
+    }
+}
+
+static bool export_cb(const cts_history_sample_t *p_sample, void *p_context)
+{
+    export_context_t *p_export = (export_context_t *)p_context;
+
+    if (p_sample->seq != p_export->next_seq)
+    {
+        fail("export order", (int64_t)p_sample->seq - (int64_t)p_export->next_seq);
+    }
+    else if ((p_sample->local_ms != expected[p_sample->seq].local_ms) ||
+             (p_sample->server_ms != expected[p_sample->seq].server_ms))
+    {
+        fail("export sample", p_sample->seq);
+    }
+    p_export->next_seq = p_sample->seq + 1u;
+    p_export->received++;
+    return p_export->received < p_export->stop_after;
+}
+
+/* Exports a range and compares it with the expected samples in the range */
+static void check_export_range(uint64_t from_ms, uint64_t to_ms, uint32_t stop_after)
+{
+    export_context_t context;
+    uint32_t first = lower_bound(from_ms);
+    uint32_t count = 0;
+    uint32_t exported;
+
+    while (((first + count) < expected_count) && (expected[first + count].local_ms <= to_ms))
+    {
+        count++;
+    }
+    if (count > stop_after)
+    {
+        count = stop_after;
+    }
+
+    context.next_seq = first;
+    context.received = 0;
+    context.stop_after = stop_after;
+    exported = cts_history_export(from_ms, to_ms, export_cb, &context);
+    if ((exported != count) || (context.received != count))
+    {
+        fail("export count", (int64_t)exported - (int64_t)count);
+    }
+}
+
+static void check_export(void)
+{
+    uint32_t oldest = oldest_seq();
+    uint32_t span = expected_count - oldest;
+    uint32_t first;
+    uint32_t last;
+    uint32_t index;
+
+    /* Everything, everything from a later start and a stop by the callback */
+    check_export_range(0u, UINT64_MAX, UINT32_MAX);
+    check_export_range(expected[expected_count - 1u].local_ms + 1u, UINT64_MAX, UINT32_MAX);
+    check_export_range(0u, UINT64_MAX, 1u + (random_next() % span));
+
+    for (index = 0; index < 16u; index++)
+    {
+        first = oldest + (random_next() % span);
+        last = first + (random_next() % (expected_count - first));
+        check_export_range(expected[first].local_ms + (random_next() % 3u) - 1u,
+                           expected[last].local_ms + (random_next() % 3u) - 1u,
+                           UINT32_MAX);
+    }
+}
+
+static void check_history(void)
+{
+    check_get();
+    check_find();
+    check_export();
+}
+
+/* [] END OF FILE */
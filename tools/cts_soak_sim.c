@@ -0,0 +1,1278 @@
+/******************************************************************************
+* File Name: cts_soak_sim.c
+*
+* Description: Host soak test of the CTS time pipeline in virtual time. The
+*              time fusion, sync statistics, time history and alarm wheel run
+*              unchanged against simulated CTS servers. The FreeRTOS tick and
+*              timers (tools/sim), the servers' notifications, clock
+*              corrections, manual steps and disconnections are events on one
+*              discrete-event queue, so a month of 1 Hz notifications runs in
+*              seconds. The same seed gives the same run. A radio timing
+*              model gives the discovery duration and the radio-on time of
+*              the simulated links on the LE 1M and 2M PHYs.
+*
+*              With a number of receivers, one broadcaster sends its time in
+*              periodic advertising instead, and every receiver follows the
+*              train, parses the reports with cts_broadcast.c and keeps the
+*              synchronization statistics of its own clock.
+*
+*              gcc -O2 -DENABLE_CENTRAL_MODE=1 -DENABLE_BINARY_OUTPUT=1 -Itools/sim -I. \
+*                  -o cts_soak_sim tools/cts_soak_sim.c cts_time_fusion.c cts_alarm.c \
+*                  cts_sync_stats.c cts_time_history.c cts_calendar.c cts_broadcast.c
+*              ./cts_soak_sim [days] [seed] [receivers]
+*
+*              ENABLE_CENTRAL_MODE gives the fusion three servers.
+*              ENABLE_BINARY_OUTPUT turns off its text output per sample.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "cts_client.h"
+#include "cts_time_fusion.h"
+#include "cts_alarm.h"
+#include "cts_sync_stats.h"
+#include "cts_time_history.h"
+#include "cts_calendar.h"
+#include "cts_broadcast.h"
+#include "app_bt_utils.h"
+#include <timers.h>
+#include <task.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if (CTS_FUSION_MAX_SERVERS < 3u)
+#error "Build with -DENABLE_CENTRAL_MODE=1 to simulate three servers"
+#endif
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define DEFAULT_DAYS                    (30u)
+#define DEFAULT_SEED                    (1u)
+
+#define SIM_SERVERS                     (3u)
+#define US_PER_S                        (1000000ll)
+#define US_PER_DAY                      (86400ll * US_PER_S)
+
+/* 2026-01-01T00:00:00Z */
+#define SIM_START_EPOCH_S               (1767225600ll)
+
+/* Local clock error against true time */
+#define SIM_LOCAL_DRIFT_PPM             (-35)
+
+/* Link: connection interval, share of notifications sent one connection
+ * event later, time from connection to the first notification */
+#define SIM_CONN_INTERVAL_US            (30000u)
+#define SIM_RETRANSMIT_PERCENT          (5u)
+#define SIM_SETUP_US                    (1500000u)
+
+/* Servers: clock drift between corrections, correction error and interval,
+ * time up and down between disconnections */
+#define SIM_SERVER_DRIFT_PPB            (2000)
+#define SIM_RESYNC_ERROR_US             (5000)
+#define SIM_RESYNC_INTERVAL_S           (6u * 3600u)
+#define SIM_MIN_UP_S                    (3600u)
+#define SIM_MAX_UP_S                    (12u * 3600u)
+#define SIM_MIN_DOWN_S                  (2u)
+#define SIM_MAX_DOWN_S                  (120u)
+
+/* The last server is set by hand now and then, by up to this much, until its
+ * next correction */
+#define SIM_STEP_SERVER                 (SIM_SERVERS - 1u)
+#define SIM_MAX_STEP_S                  (30u)
+#define SIM_MIN_STEP_INTERVAL_S         (86400u)
+#define SIM_MAX_STEP_INTERVAL_S         (5u * 86400u)
+
+/* Time from the alarm timer to cts_alarm_process() in the application task */
+#define SIM_APP_LATENCY_US              (200u)
+
+#define SIM_EVENT_QUEUE_LEN             (32u)
+#define SIM_MAX_TIMERS                  (2u)
+
+/* Alarm deadlines missed by more than this are counted as late */
+#define SIM_LATE_LIMIT_MS               (10)
+
+/* Radio timing model: LL header, CRC and access address of a PDU, the
+ * preamble per PHY, the inter frame space and the radio ramp-up per
+ * connection event. The L2CAP header adds 4 bytes to every ATT PDU */
+#define SIM_PDU_OVERHEAD_BYTES          (2u + 3u + 4u)
+#define SIM_L2CAP_HEADER_BYTES          (4u)
+#define SIM_T_IFS_US                    (150u)
+#define SIM_RADIO_RAMP_US               (40u)
+
+/* Connection events from the LL_PHY_REQ to the PHY update instant */
+#define SIM_PHY_INSTANT_EVENTS          (6u)
+
+/* Current Time notification: opcode, handle and value */
+#define SIM_NOTIFY_ATT_BYTES            (3u + 10u)
+
+/* Broadcast mode. The receivers sync to the periodic advertising train as
+ * app_bt_pa_sync.c does, with the same skip and timeout */
+#define SIM_MAX_RECEIVERS               (1000u)
+#define SIM_PA_INTERVAL_US              (1000000u)
+#define SIM_PA_SKIP                     (4u)
+#define SIM_PA_TIMEOUT_US               (10000000u)
+#define SIM_PA_LOSS_PERCENT             (10u)
+
+/* Scan time until a receiver sees the SyncInfo of the broadcaster again */
+#define SIM_PA_MIN_RESYNC_US            (500000u)
+#define SIM_PA_MAX_RESYNC_US            (3000000u)
+
+/* Report from the controller to the application task */
+#define SIM_PA_MIN_LATENCY_US           (200u)
+#define SIM_PA_MAX_LATENCY_US           (1200u)
+
+/* Events that keep the adjust reason after the broadcaster corrected its
+ * clock, so that receivers that skip events see it */
+#define SIM_PA_ADJUST_EVENTS            (2u * (SIM_PA_SKIP + 1u))
+
+/* Receiver clocks, and the window widening around a receive */
+#define SIM_RECEIVER_DRIFT_PPM          (50)
+#define SIM_PA_RX_WINDOW_US             (100u)
+
+/* AUX_SYNC_IND header, and the extended advertising that points to the train:
+ * ADV_EXT_IND on the three primary channels and AUX_ADV_IND with SyncInfo */
+#define SIM_PA_HEADER_BYTES             (2u)
+#define SIM_ADV_EXT_IND_BYTES           (9u)
+#define SIM_AUX_ADV_IND_BYTES           (27u)
+
+/*******************************************************************************
+*        Enumerations
+*******************************************************************************/
+typedef enum
+{
+    SIM_EV_NOTIFY,                  /* Notification reaches the client */
+    SIM_EV_DISCONNECT,
+    SIM_EV_CONNECT,
+    SIM_EV_RESYNC,                  /* Server corrects its clock */
+    SIM_EV_STEP,                    /* Server time is set by hand */
+    SIM_EV_TIMER,                   /* FreeRTOS timer expires, not queued */
+    SIM_EV_ALARM_PROCESS,           /* Application task runs the alarms */
+    SIM_EV_DAY,                     /* Daily report */
+} sim_event_type_t;
+
+/*******************************************************************************
+*        Structures
+*******************************************************************************/
+typedef struct
+{
+    int64_t        time_us;         /* Local time of the event */
+    uint64_t       seq;             /* Orders events at the same time */
+    uint8_t        type;            /* sim_event_type_t */
+    uint8_t        server;
+    uint16_t       conn_id;         /* Connection the event belongs to */
+    StaticTimer_t  *p_timer;
+} sim_event_t;
+
+typedef struct
+{
+    int32_t        drift_ppb;
+    int64_t        offset_us;       /* Error after the last correction */
+    int64_t        step_us;         /* Manual step in effect */
+    int64_t        sync_true_us;    /* True time of the last correction */
+    uint8_t        adjust_reason;   /* For the next notification */
+    bool           connected;
+    uint16_t       conn_id;
+    int64_t        anchor_us;       /* A connection event of the link */
+    int64_t        notify_s;        /* Server time in the next notification */
+    uint32_t       notifications;
+    uint32_t       disconnects;
+    uint32_t       steps;
+    int64_t        connected_us;    /* Start of the connection */
+    cts_sync_stats_t stats;
+} sim_server_t;
+
+/* ATT request and response of the client after a connection, with the
+ * default ATT MTU of 23 bytes */
+typedef struct
+{
+    uint8_t        request_bytes;
+    uint8_t        response_bytes;
+} sim_att_exchange_t;
+
+typedef struct
+{
+    const char     *p_name;
+    uint64_t       deadline_ms;     /* Deadline of the next expiry */
+    uint32_t       fired;
+    uint32_t       skipped;
+    uint32_t       early;
+    uint32_t       late;
+    int64_t        max_early_ms;
+    int64_t        max_late_ms;
+} sim_alarm_stats_t;
+
+/* A receiver of the broadcast, its clock and the sync to the train */
+typedef struct
+{
+    int32_t        drift_ppm;
+    int64_t        offset_us;       /* Local clock minus true time at start */
+    bool           synced;
+    uint64_t       next_event;      /* Train event it receives next */
+    int64_t        last_rx_us;      /* True time of the last received event */
+    int64_t        outage_start_us; /* Out of range of the broadcaster */
+    int64_t        outage_end_us;
+    uint32_t       received;
+    uint32_t       missed;
+    uint32_t       losses;
+    int64_t        scan_us;         /* Time spent looking for the train */
+    cts_sync_stats_t stats;
+} sim_receiver_t;
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+uint32_t SystemCoreClock = 96000000u;
+
+static sim_event_t  sim_queue[SIM_EVENT_QUEUE_LEN];
+static uint32_t     sim_queue_len;
+static uint64_t     sim_seq;
+static int64_t      sim_now_us;
+static StaticTimer_t *sim_timers[SIM_MAX_TIMERS];
+static uint32_t     sim_timer_count;
+static uint64_t     sim_random_state;
+
+static sim_server_t sim_servers[SIM_SERVERS];
+static sim_receiver_t sim_receivers[SIM_MAX_RECEIVERS];
+static uint16_t     sim_next_conn_id = 1;
+
+static cts_alarm_t       minute_alarm;
+static cts_alarm_t       daily_alarm;
+static sim_alarm_stats_t minute_stats = { .p_name = "minute" };
+static sim_alarm_stats_t daily_stats = { .p_name = "daily 03:00" };
+static bool              alarms_started;
+
+/* Per day and whole run */
+static uint32_t     day_notifications;
+static int64_t      day_max_error_ms;
+static uint32_t     day_max_bound_ms;
+static uint32_t     total_notifications;
+static uint32_t     notify_decode_errors;
+static uint32_t     out_of_bound;
+static int64_t      max_error_ms;
+static uint64_t     digest = 0xCBF29CE484222325ull;
+
+/* Link activity for the radio timing model */
+static uint32_t     sim_connections;
+static uint32_t     sim_retransmits;
+static int64_t      sim_link_us;
+
+/* A server with the Current Time, Battery, Device Information and Generic
+ * Attribute services, as cts_client.c discovers it: services, characteristics
+ * in two ranges, descriptors, then the Database Hash read, the Service
+ * Changed CCCD write, the Current Time, Local Time and Reference Time reads
+ * and the notification CCCD write */
+static const sim_att_exchange_t sim_connect_exchanges[] =
+{
+    { 7, 20 }, { 7, 14 }, { 7, 5 },
+    { 7, 23 }, { 7, 23 }, { 7, 16 }, { 7, 23 }, { 7, 9 }, { 7, 5 },
+    { 5, 10 },
+    { 3, 17 }, { 5, 1 }, { 3, 11 }, { 3, 3 }, { 3, 5 }, { 5, 1 },
+};
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static uint64_t sim_random(void);
+static uint32_t sim_random_range(uint32_t low, uint32_t high);
+static void sim_schedule(int64_t time_us, sim_event_type_t type, uint8_t server,
+                         uint16_t conn_id);
+static bool sim_next(sim_event_t *p_event);
+static int64_t sim_true_us(int64_t local_us);
+static int64_t sim_server_us(const sim_server_t *p_server, int64_t true_us);
+static void sim_digest(uint64_t value);
+static void sim_connect(uint8_t index);
+static void sim_schedule_notification(uint8_t index);
+static void sim_notify(uint8_t index);
+static void sim_alarm_wakeup(void);
+static void sim_alarm_callback(cts_alarm_t *p_alarm);
+static void sim_start_alarms(void);
+static void sim_day_report(uint32_t day);
+static uint32_t sim_pdu_us(uint8_t phy, uint32_t payload_bytes);
+static uint32_t sim_conn_event_us(uint8_t phy, uint32_t central_bytes,
+                                  uint32_t peripheral_bytes);
+static void sim_connect_model(uint8_t phy, uint32_t *p_duration_us, uint32_t *p_radio_us);
+static void sim_radio_report(void);
+static int sim_broadcast(uint32_t days, uint64_t seed, uint32_t receivers);
+static int64_t sim_encode_time(int64_t server_us, uint8_t adjust_reason, uint8_t *p_value);
+static void sim_receiver_outage(sim_receiver_t *p_receiver, int64_t true_us);
+static void sim_receiver_resync(sim_receiver_t *p_receiver, int64_t true_us);
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t days = DEFAULT_DAYS;
+    uint64_t seed = DEFAULT_SEED;
+    uint32_t receivers = 0;
+    uint32_t day = 0;
+    uint32_t index;
+    uint32_t failures;
+    sim_event_t event;
+    clock_t start = clock();
+    double elapsed_s;
+
+    if (argc > 1)
+    {
+        days = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2)
+    {
+        seed = strtoull(argv[2], NULL, 0);
+    }
+    if (argc > 3)
+    {
+        receivers = (uint32_t)strtoul(argv[3], NULL, 0);
+    }
+    sim_random_state = (0u != seed) ? seed : DEFAULT_SEED;
+
+    if (0u != receivers)
+    {
+        return sim_broadcast(days, seed, (receivers < SIM_MAX_RECEIVERS) ?
+                                         receivers : SIM_MAX_RECEIVERS);
+    }
+
+    cts_fusion_init();
+    cts_history_init();
+    cts_alarm_init(sim_alarm_wakeup);
+    cts_alarm_setup(&minute_alarm, sim_alarm_callback, &minute_stats);
+    cts_alarm_setup(&daily_alarm, sim_alarm_callback, &daily_stats);
+
+    for (index = 0; index < SIM_SERVERS; index++)
+    {
+        sim_servers[index].drift_ppb = (int32_t)sim_random_range(0, 2u * SIM_SERVER_DRIFT_PPB) -
+                                       SIM_SERVER_DRIFT_PPB;
+        sim_servers[index].offset_us = (int64_t)sim_random_range(0, 2u * SIM_RESYNC_ERROR_US) -
+                                       SIM_RESYNC_ERROR_US;
+        sim_connect((uint8_t)index);
+        sim_schedule((int64_t)sim_random_range(1u, SIM_RESYNC_INTERVAL_S) * US_PER_S,
+                     SIM_EV_RESYNC, (uint8_t)index, 0);
+    }
+    sim_schedule((int64_t)sim_random_range(SIM_MIN_STEP_INTERVAL_S, SIM_MAX_STEP_INTERVAL_S) *
+                 US_PER_S, SIM_EV_STEP, SIM_STEP_SERVER, 0);
+    sim_schedule(US_PER_DAY, SIM_EV_DAY, 0, 0);
+
+    printf("Soak: %u days, seed %" PRIu64 ", local clock %d ppm\n", days, seed,
+           SIM_LOCAL_DRIFT_PPM);
+    while ((day < days) && sim_next(&event))
+    {
+        sim_now_us = event.time_us;
+        switch (event.type)
+        {
+            case SIM_EV_NOTIFY:
+                if (sim_servers[event.server].connected &&
+                    (sim_servers[event.server].conn_id == event.conn_id))
+                {
+                    sim_notify(event.server);
+                }
+                break;
+
+            case SIM_EV_DISCONNECT:
+                sim_servers[event.server].connected = false;
+                sim_servers[event.server].disconnects++;
+                sim_link_us += sim_now_us - sim_servers[event.server].connected_us;
+                cts_fusion_remove_server(sim_servers[event.server].conn_id);
+                sim_schedule(sim_now_us + (int64_t)sim_random_range(SIM_MIN_DOWN_S,
+                                                                    SIM_MAX_DOWN_S) * US_PER_S,
+                             SIM_EV_CONNECT, event.server, 0);
+                break;
+
+            case SIM_EV_CONNECT:
+                sim_connect(event.server);
+                break;
+
+            case SIM_EV_RESYNC:
+                sim_servers[event.server].sync_true_us = sim_true_us(sim_now_us);
+                sim_servers[event.server].offset_us =
+                    (int64_t)sim_random_range(0, 2u * SIM_RESYNC_ERROR_US) - SIM_RESYNC_ERROR_US;
+                sim_servers[event.server].step_us = 0;
+                sim_servers[event.server].adjust_reason |= EXTERNAL_REFERENCE_TIME_UPDATE;
+                sim_schedule(sim_now_us + (int64_t)SIM_RESYNC_INTERVAL_S * US_PER_S,
+                             SIM_EV_RESYNC, event.server, 0);
+                break;
+
+            case SIM_EV_STEP:
+                sim_servers[event.server].step_us =
+                    ((int64_t)sim_random_range(1u, SIM_MAX_STEP_S) * US_PER_S) *
+                    ((0u != (sim_random() & 1u)) ? 1 : -1);
+                sim_servers[event.server].adjust_reason |= MANUAL_TIME_UPDATE;
+                sim_servers[event.server].steps++;
+                sim_schedule(sim_now_us +
+                             (int64_t)sim_random_range(SIM_MIN_STEP_INTERVAL_S,
+                                                       SIM_MAX_STEP_INTERVAL_S) * US_PER_S,
+                             SIM_EV_STEP, event.server, 0);
+                break;
+
+            case SIM_EV_TIMER:
+                event.p_timer->active = false;
+                event.p_timer->callback(event.p_timer);
+                break;
+
+            case SIM_EV_ALARM_PROCESS:
+                cts_alarm_process();
+                break;
+
+            case SIM_EV_DAY:
+                sim_day_report(++day);
+                sim_schedule(sim_now_us + US_PER_DAY, SIM_EV_DAY, 0, 0);
+                break;
+
+            default:
+                break;
+        }
+    }
+    elapsed_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+    for (index = 0; index < SIM_SERVERS; index++)
+    {
+        if (sim_servers[index].connected)
+        {
+            sim_link_us += sim_now_us - sim_servers[index].connected_us;
+        }
+    }
+
+    printf("Notifications: %u (%u not decoded), fused time outside its error bound: %u, "
+           "max error %" PRId64 " ms\n",
+           total_notifications, notify_decode_errors, out_of_bound, max_error_ms);
+    for (index = 0; index < SIM_SERVERS; index++)
+    {
+        printf("Server %u: drift %d ppb, %u notifications, %u disconnects, %u manual steps\n",
+               index, sim_servers[index].drift_ppb, sim_servers[index].notifications,
+               sim_servers[index].disconnects, sim_servers[index].steps);
+    }
+    printf("Alarms: minute %u fired, %u skipped, %u early (max %" PRId64 " ms), "
+           "%u late (max %" PRId64 " ms)\n",
+           minute_stats.fired, minute_stats.skipped, minute_stats.early,
+           minute_stats.max_early_ms, minute_stats.late, minute_stats.max_late_ms);
+    printf("        daily %u fired, %u skipped, %u early (max %" PRId64 " ms), "
+           "%u late (max %" PRId64 " ms)\n",
+           daily_stats.fired, daily_stats.skipped, daily_stats.early,
+           daily_stats.max_early_ms, daily_stats.late, daily_stats.max_late_ms);
+    printf("History: %u samples kept\n", cts_history_count());
+    sim_radio_report();
+    printf("Digest: %016" PRIx64 "\n", digest);
+
+    failures = minute_stats.early + daily_stats.early + out_of_bound + notify_decode_errors +
+               (((days > 1u) && (daily_stats.fired < (days - 1u))) ? 1u : 0u);
+    printf("Soak: %s, %u simulated days in %.2f s\n", (0u == failures) ? "passed" : "FAILED",
+           day, elapsed_s);
+    return (0u == failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* xorshift64*, the only source of randomness */
+static uint64_t sim_random(void)
+{
+    sim_random_state ^= sim_random_state >> 12;
+    sim_random_state ^= sim_random_state << 25;
+    sim_random_state ^= sim_random_state >> 27;
+    return sim_random_state * 0x2545F4914F6CDD1Dull;
+}
+
+static uint32_t sim_random_range(uint32_t low, uint32_t high)
+{
+    return low + (uint32_t)(sim_random() % ((uint64_t)high - low + 1u));
+}
+
+/* Binary min-heap ordered by time, then by the order of scheduling */
+static bool sim_before(const sim_event_t *p_a, const sim_event_t *p_b)
+{
+    return (p_a->time_us < p_b->time_us) ||
+           ((p_a->time_us == p_b->time_us) && (p_a->seq < p_b->seq));
+}
+
+static void sim_schedule(int64_t time_us, sim_event_type_t type, uint8_t server,
+                         uint16_t conn_id)
+{
+    sim_event_t event = { time_us, sim_seq++, (uint8_t)type, server, conn_id, NULL };
+    uint32_t pos = sim_queue_len++;
+
+    if (sim_queue_len > SIM_EVENT_QUEUE_LEN)
+    {
+        printf("Event queue full\n");
+        exit(EXIT_FAILURE);
+    }
+    while ((pos > 0u) && sim_before(&event, &sim_queue[(pos - 1u) / 2u]))
+    {
+        sim_queue[pos] = sim_queue[(pos - 1u) / 2u];
+        pos = (pos - 1u) / 2u;
+    }
+    sim_queue[pos] = event;
+}
+
+/* Returns the earliest event, a queued one or a timer expiry */
+static bool sim_next(sim_event_t *p_event)
+{
+    sim_event_t last;
+    sim_event_t timer = { 0 };
+    uint32_t pos = 0;
+    uint32_t child;
+    uint32_t index;
+
+    for (index = 0; index < sim_timer_count; index++)
+    {
+        if (sim_timers[index]->active &&
+            ((NULL == timer.p_timer) || (sim_timers[index]->expiry_us < timer.time_us)))
+        {
+            timer.time_us = sim_timers[index]->expiry_us;
+            timer.seq = sim_timers[index]->seq;
+            timer.type = SIM_EV_TIMER;
+            timer.p_timer = sim_timers[index];
+        }
+    }
+    if ((NULL != timer.p_timer) &&
+        ((0u == sim_queue_len) || sim_before(&timer, &sim_queue[0])))
+    {
+        *p_event = timer;
+        return true;
+    }
+
+    if (0u == sim_queue_len)
+    {
+        return false;
+    }
+    *p_event = sim_queue[0];
+    last = sim_queue[--sim_queue_len];
+    for (;;)
+    {
+        child = (2u * pos) + 1u;
+        if (child >= sim_queue_len)
+        {
+            break;
+        }
+        if (((child + 1u) < sim_queue_len) && sim_before(&sim_queue[child + 1u], &sim_queue[child]))
+        {
+            child++;
+        }
+        if (!sim_before(&sim_queue[child], &last))
+        {
+            break;
+        }
+        sim_queue[pos] = sim_queue[child];
+        pos = child;
+    }
+    sim_queue[pos] = last;
+    return true;
+}
+
+/* True UTC in us for a local time. The local clock is the simulation clock */
+static int64_t sim_true_us(int64_t local_us)
+{
+    return (SIM_START_EPOCH_S * US_PER_S) + local_us +
+           ((local_us * SIM_LOCAL_DRIFT_PPM) / US_PER_S);
+}
+
+static int64_t sim_server_us(const sim_server_t *p_server, int64_t true_us)
+{
+    return true_us + p_server->offset_us + p_server->step_us +
+           (((true_us - p_server->sync_true_us) * p_server->drift_ppb) / 1000000000ll);
+}
+
+/* FNV-1a over the alarm expiries, to compare runs */
+static void sim_digest(uint64_t value)
+{
+    uint32_t byte;
+
+    for (byte = 0; byte < 8u; byte++)
+    {
+        digest ^= (value >> (8u * byte)) & 0xFFu;
+        digest *= 0x100000001B3ull;
+    }
+}
+
+static void sim_connect(uint8_t index)
+{
+    sim_server_t *p_server = &sim_servers[index];
+
+    p_server->connected = true;
+    p_server->connected_us = sim_now_us;
+    sim_connections++;
+    p_server->conn_id = sim_next_conn_id++;
+    if (0u == sim_next_conn_id)
+    {
+        sim_next_conn_id = 1;
+    }
+    p_server->anchor_us = sim_now_us + (int64_t)sim_random_range(0, SIM_CONN_INTERVAL_US);
+    cts_sync_stats_reset(&p_server->stats);
+    if (0 == p_server->sync_true_us)
+    {
+        p_server->sync_true_us = sim_true_us(sim_now_us);
+    }
+
+    sim_now_us += SIM_SETUP_US;
+    sim_schedule_notification(index);
+    sim_now_us -= SIM_SETUP_US;
+    sim_schedule(sim_now_us + (int64_t)sim_random_range(SIM_MIN_UP_S, SIM_MAX_UP_S) * US_PER_S,
+                 SIM_EV_DISCONNECT, index, 0);
+}
+
+/* The server notifies at its next full second, in the first connection event
+ * after that */
+static void sim_schedule_notification(uint8_t index)
+{
+    sim_server_t *p_server = &sim_servers[index];
+    int64_t server_us = sim_server_us(p_server, sim_true_us(sim_now_us));
+    int64_t send_us = sim_now_us + (US_PER_S - (server_us % US_PER_S));
+    int64_t events = (send_us - p_server->anchor_us + SIM_CONN_INTERVAL_US - 1) /
+                     SIM_CONN_INTERVAL_US;
+
+    p_server->notify_s = (server_us / US_PER_S) + 1;
+    if (sim_random_range(1u, 100u) <= SIM_RETRANSMIT_PERCENT)
+    {
+        events++;
+        sim_retransmits++;
+    }
+    sim_schedule(p_server->anchor_us + (events * SIM_CONN_INTERVAL_US), SIM_EV_NOTIFY,
+                 index, p_server->conn_id);
+}
+
+static void sim_notify(uint8_t index)
+{
+    sim_server_t *p_server = &sim_servers[index];
+    int64_t true_us = sim_true_us(sim_now_us);
+    uint8_t value[CTS_CURRENT_TIME_LEN];
+    current_time_data_t time;
+    int64_t sent_us;
+    int64_t server_us;
+    cts_fusion_result_t result;
+    uint64_t fused_ms;
+    int64_t error_ms;
+
+    /* The value goes through the decoder of the client. The servers send no
+     * Local Time Information, so the decoded time is already UTC */
+    sent_us = sim_encode_time(p_server->notify_s * US_PER_S, p_server->adjust_reason, value);
+    p_server->adjust_reason = 0;
+    if (!cts_decode_current_time(value, sizeof(value), &time) ||
+        !cts_time_to_epoch_us(&time, &server_us) || (server_us != sent_us))
+    {
+        notify_decode_errors++;
+        sim_schedule_notification(index);
+        return;
+    }
+
+    /* As cts_client.c does for a notification that passes the filter */
+    cts_sync_stats_update(&p_server->stats, server_us, (uint64_t)sim_now_us,
+                          (0 != time.adjust_reason));
+    cts_history_add(index, server_us / 1000, (uint64_t)sim_now_us / 1000u, time.adjust_reason);
+    cts_fusion_add_sample(p_server->conn_id, server_us, time.adjust_reason,
+                          (uint64_t)sim_now_us / 1000u);
+    cts_alarm_process();
+
+    p_server->notifications++;
+    day_notifications++;
+    total_notifications++;
+
+    if (cts_fusion_get_result(&result) &&
+        cts_fusion_get_time_ms((uint64_t)sim_now_us / 1000u, &fused_ms))
+    {
+        error_ms = (int64_t)fused_ms - (true_us / 1000);
+        if (llabs(error_ms) > llabs(day_max_error_ms))
+        {
+            day_max_error_ms = error_ms;
+        }
+        if (llabs(error_ms) > llabs(max_error_ms))
+        {
+            max_error_ms = error_ms;
+        }
+        if (result.error_ms > day_max_bound_ms)
+        {
+            day_max_bound_ms = result.error_ms;
+        }
+        if (llabs(error_ms) > (int64_t)result.error_ms)
+        {
+            out_of_bound++;
+        }
+        if (!alarms_started)
+        {
+            sim_start_alarms();
+        }
+    }
+
+    sim_schedule_notification(index);
+}
+
+/* Called by the wheel from the FreeRTOS timer callback */
+static void sim_alarm_wakeup(void)
+{
+    sim_schedule(sim_now_us + SIM_APP_LATENCY_US, SIM_EV_ALARM_PROCESS, 0, 0);
+}
+
+static void sim_start_alarms(void)
+{
+    uint64_t now_ms;
+
+    if (!cts_fusion_get_time_ms((uint64_t)sim_now_us / 1000u, &now_ms))
+    {
+        return;
+    }
+    minute_stats.deadline_ms = ((now_ms / 60000u) + 1u) * 60000u;
+    (void)cts_alarm_start_at(&minute_alarm, minute_stats.deadline_ms, 60000u);
+    (void)cts_alarm_start_daily(&daily_alarm, 3u, 0u, 0u, 0);
+    daily_stats.deadline_ms = daily_alarm.expiry_ms;
+    alarms_started = true;
+}
+
+/* Compares the true time of an expiry with its deadline. An alarm may fire
+ * early by as much as the fused time is off, so the bound is the fusion
+ * error */
+static void sim_alarm_callback(cts_alarm_t *p_alarm)
+{
+    sim_alarm_stats_t *p_stats = (sim_alarm_stats_t *)p_alarm->p_arg;
+    int64_t true_ms = sim_true_us(sim_now_us) / 1000;
+    int64_t late_ms = true_ms - (int64_t)p_stats->deadline_ms;
+    cts_fusion_result_t result;
+    int64_t bound_ms = 0;
+
+    if (cts_fusion_get_result(&result))
+    {
+        bound_ms = result.error_ms;
+    }
+
+    p_stats->fired++;
+    if ((late_ms < 0) && (-late_ms > p_stats->max_early_ms))
+    {
+        p_stats->max_early_ms = -late_ms;
+    }
+    if (late_ms < -bound_ms)
+    {
+        p_stats->early++;
+    }
+    if (late_ms > p_stats->max_late_ms)
+    {
+        p_stats->max_late_ms = late_ms;
+    }
+    if (late_ms > (bound_ms + SIM_LATE_LIMIT_MS))
+    {
+        p_stats->late++;
+    }
+    p_stats->skipped += (uint32_t)(((p_alarm->expiry_ms - p_stats->deadline_ms) /
+                                    p_alarm->period_ms) - 1u);
+    p_stats->deadline_ms = p_alarm->expiry_ms;
+
+    sim_digest((uint64_t)sim_now_us);
+}
+
+static void sim_day_report(uint32_t day)
+{
+    char date[32];
+
+    cts_calendar_format_iso8601(sim_true_us(sim_now_us) / US_PER_S, date);
+    printf("Day %3u %s: %u notifications, fused error max %" PRId64 " ms "
+           "(bound up to %u ms), alarms %u minute, %u daily\n",
+           day, date, day_notifications, day_max_error_ms, day_max_bound_ms,
+           minute_stats.fired, daily_stats.fired);
+    day_notifications = 0;
+    day_max_error_ms = 0;
+    day_max_bound_ms = 0;
+}
+
+/* Air time of a PDU with the given LL payload */
+static uint32_t sim_pdu_us(uint8_t phy, uint32_t payload_bytes)
+{
+    if (APP_BT_PHY_2M == phy)
+    {
+        return (2u + SIM_PDU_OVERHEAD_BYTES + payload_bytes) * 4u;
+    }
+    return (1u + SIM_PDU_OVERHEAD_BYTES + payload_bytes) * 8u;
+}
+
+/* Radio-on time of a connection event with one PDU in each direction, 0 for
+ * an empty PDU */
+static uint32_t sim_conn_event_us(uint8_t phy, uint32_t central_bytes,
+                                  uint32_t peripheral_bytes)
+{
+    return SIM_RADIO_RAMP_US + sim_pdu_us(phy, central_bytes) + SIM_T_IFS_US +
+           sim_pdu_us(phy, peripheral_bytes);
+}
+
+/* Time from connection until the notification CCCD is written, and the
+ * radio-on time of those connection events. A request goes out in one
+ * connection event and its response comes back in the next. For 2M the
+ * PHY update procedure runs on 1M first, and the link changes PHY at its
+ * instant while the exchanges go on */
+static void sim_connect_model(uint8_t phy, uint32_t *p_duration_us, uint32_t *p_radio_us)
+{
+    uint32_t exchanges = (uint32_t)(sizeof(sim_connect_exchanges) /
+                                    sizeof(sim_connect_exchanges[0]));
+    uint32_t index;
+    uint32_t event = 0;
+    uint8_t event_phy;
+
+    *p_radio_us = 0;
+    if (APP_BT_PHY_2M == phy)
+    {
+        /* LL_PHY_REQ and LL_PHY_RSP, then LL_PHY_UPDATE_IND */
+        *p_radio_us += sim_conn_event_us(APP_BT_PHY_1M, 2u, 2u) +
+                       sim_conn_event_us(APP_BT_PHY_1M, 5u, 0u);
+    }
+    for (index = 0; index < exchanges; index++)
+    {
+        event_phy = ((APP_BT_PHY_2M == phy) && (event >= SIM_PHY_INSTANT_EVENTS)) ?
+                    APP_BT_PHY_2M : APP_BT_PHY_1M;
+        *p_radio_us += sim_conn_event_us(event_phy, sim_connect_exchanges[index].request_bytes +
+                                                    SIM_L2CAP_HEADER_BYTES, 0u);
+        event++;
+        event_phy = ((APP_BT_PHY_2M == phy) && (event >= SIM_PHY_INSTANT_EVENTS)) ?
+                    APP_BT_PHY_2M : APP_BT_PHY_1M;
+        *p_radio_us += sim_conn_event_us(event_phy, 0u,
+                                         sim_connect_exchanges[index].response_bytes +
+                                         SIM_L2CAP_HEADER_BYTES);
+        event++;
+    }
+    *p_duration_us = event * SIM_CONN_INTERVAL_US;
+}
+
+/* One broadcaster and the receivers that follow its periodic advertising
+ * train. The broadcaster builds the advertising data of each event once, and
+ * every receiver that listens to the event parses and decodes it as
+ * app_bt_pa_sync.c and cts_client.c do. Before each sample, a receiver
+ * predicts the broadcast time from its statistics, to check the error
+ * bound the client reports */
+static int sim_broadcast(uint32_t days, uint64_t seed, uint32_t receivers)
+{
+    sim_server_t broadcaster = { 0 };
+    sim_receiver_t *p_receiver;
+    uint64_t events = ((uint64_t)days * US_PER_DAY) / SIM_PA_INTERVAL_US;
+    uint64_t event;
+    int64_t true_us;
+    int64_t start_us = SIM_START_EPOCH_S * US_PER_S;
+    int64_t next_resync_us;
+    uint32_t adjust_events = 0;
+    uint8_t value[CTS_BROADCAST_TIME_LEN];
+    uint8_t adv[31];
+    uint16_t adv_len;
+    int64_t sent_us;
+    uint32_t index;
+    const uint8_t *p_time;
+    uint16_t time_len;
+    current_time_data_t time;
+    int64_t server_us;
+    int64_t local_us;
+    int64_t error_us;
+    cts_sync_quality_t quality;
+    uint64_t listens = 0;
+    uint64_t predictions = 0;
+    uint64_t out_of_bound_samples = 0;
+    int64_t max_error_us = 0;
+    uint32_t decode_errors = 0;
+    uint32_t silent = 0;
+    uint32_t min_received = UINT32_MAX;
+    uint32_t max_losses = 0;
+    uint64_t received = 0;
+    uint64_t losses = 0;
+    int64_t scan_us = 0;
+    uint32_t broadcaster_event_us;
+    uint32_t listen_us;
+    uint64_t link_event_us;
+    double run_days = (double)days;
+    clock_t start = clock();
+    bool ok;
+
+    broadcaster.drift_ppb = (int32_t)sim_random_range(0, 2u * SIM_SERVER_DRIFT_PPB) -
+                            SIM_SERVER_DRIFT_PPB;
+    broadcaster.offset_us = (int64_t)sim_random_range(0, 2u * SIM_RESYNC_ERROR_US) -
+                            SIM_RESYNC_ERROR_US;
+    broadcaster.sync_true_us = start_us;
+    next_resync_us = start_us + (int64_t)SIM_RESYNC_INTERVAL_S * US_PER_S;
+
+    for (index = 0; index < receivers; index++)
+    {
+        p_receiver = &sim_receivers[index];
+        memset(p_receiver, 0, sizeof(*p_receiver));
+        p_receiver->drift_ppm = (int32_t)sim_random_range(0, 2u * SIM_RECEIVER_DRIFT_PPM) -
+                                SIM_RECEIVER_DRIFT_PPM;
+        p_receiver->offset_us = (int64_t)sim_random_range(0, 1000000u);
+        sim_receiver_outage(p_receiver, start_us);
+        sim_receiver_resync(p_receiver, start_us);
+    }
+
+    printf("Broadcast: %u receivers, %u days, seed %" PRIu64 ", interval %u ms, "
+           "skip %u, %u%% loss\n", receivers, days, seed, SIM_PA_INTERVAL_US / 1000u,
+           SIM_PA_SKIP, SIM_PA_LOSS_PERCENT);
+
+    for (event = 0; event < events; event++)
+    {
+        true_us = start_us + (int64_t)(event * SIM_PA_INTERVAL_US);
+        if (true_us >= next_resync_us)
+        {
+            broadcaster.sync_true_us = true_us;
+            broadcaster.offset_us = (int64_t)sim_random_range(0, 2u * SIM_RESYNC_ERROR_US) -
+                                    SIM_RESYNC_ERROR_US;
+            next_resync_us += (int64_t)SIM_RESYNC_INTERVAL_S * US_PER_S;
+            adjust_events = SIM_PA_ADJUST_EVENTS;
+        }
+
+        /* One advertising data for all receivers */
+        sent_us = sim_encode_time(sim_server_us(&broadcaster, true_us),
+                                  (0u != adjust_events) ? EXTERNAL_REFERENCE_TIME_UPDATE : 0u,
+                                  value);
+        adv_len = cts_broadcast_build(value, adv, (uint16_t)sizeof(adv));
+        if (0u != adjust_events)
+        {
+            adjust_events--;
+        }
+
+        for (index = 0; index < receivers; index++)
+        {
+            p_receiver = &sim_receivers[index];
+            if (p_receiver->next_event != event)
+            {
+                continue;
+            }
+
+            if (!p_receiver->synced)
+            {
+                /* Found the train again, cts_client.c starts a new source */
+                if ((true_us >= p_receiver->outage_start_us) &&
+                    (true_us < p_receiver->outage_end_us))
+                {
+                    sim_receiver_resync(p_receiver, true_us);
+                    continue;
+                }
+                p_receiver->synced = true;
+                p_receiver->last_rx_us = true_us;
+                cts_sync_stats_reset(&p_receiver->stats);
+            }
+            listens++;
+
+            if (true_us >= p_receiver->outage_end_us)
+            {
+                sim_receiver_outage(p_receiver, true_us);
+            }
+            if ((true_us >= p_receiver->outage_start_us) ||
+                (sim_random_range(1u, 100u) <= SIM_PA_LOSS_PERCENT))
+            {
+                /* Missed, the controller listens to the next event */
+                p_receiver->missed++;
+                if ((true_us + (int64_t)SIM_PA_INTERVAL_US - p_receiver->last_rx_us) >
+                    (int64_t)SIM_PA_TIMEOUT_US)
+                {
+                    p_receiver->synced = false;
+                    p_receiver->losses++;
+                    sim_receiver_resync(p_receiver, true_us);
+                }
+                else
+                {
+                    p_receiver->next_event = event + 1u;
+                }
+                continue;
+            }
+
+            p_receiver->received++;
+            p_receiver->last_rx_us = true_us;
+            p_receiver->next_event = event + 1u + SIM_PA_SKIP;
+            local_us = true_us - start_us + p_receiver->offset_us +
+                       (((true_us - start_us) * p_receiver->drift_ppm) / US_PER_S) +
+                       (int64_t)sim_random_range(SIM_PA_MIN_LATENCY_US, SIM_PA_MAX_LATENCY_US);
+
+            time_len = 0;
+            p_time = cts_broadcast_find_time(adv, adv_len, &time_len);
+            if ((NULL == p_time) || !cts_decode_current_time(p_time, time_len, &time) ||
+                !cts_time_to_epoch_us(&time, &server_us))
+            {
+                decode_errors++;
+                continue;
+            }
+            if (server_us != sent_us)
+            {
+                decode_errors++;
+            }
+
+            if ((0u != p_receiver->stats.samples) && (0u == time.adjust_reason))
+            {
+                cts_sync_stats_get_quality(&p_receiver->stats, (uint64_t)local_us, &quality);
+                error_us = local_us + p_receiver->stats.offset_us - server_us;
+                predictions++;
+                if (llabs(error_us) > llabs(max_error_us))
+                {
+                    max_error_us = error_us;
+                }
+                if (llabs(error_us) > (int64_t)quality.error_us)
+                {
+                    out_of_bound_samples++;
+                }
+            }
+            cts_sync_stats_update(&p_receiver->stats, server_us, (uint64_t)local_us,
+                                  (0u != time.adjust_reason));
+        }
+    }
+
+    for (index = 0; index < receivers; index++)
+    {
+        p_receiver = &sim_receivers[index];
+        received += p_receiver->received;
+        losses += p_receiver->losses;
+        scan_us += p_receiver->scan_us;
+        if (p_receiver->received < min_received)
+        {
+            min_received = p_receiver->received;
+        }
+        if (p_receiver->losses > max_losses)
+        {
+            max_losses = p_receiver->losses;
+        }
+        if (0u == p_receiver->received)
+        {
+            silent++;
+        }
+    }
+
+    /* The broadcaster's radio time does not depend on the receivers. A link
+     * per receiver costs the server a connection event every interval and
+     * one notification per second */
+    broadcaster_event_us = SIM_RADIO_RAMP_US +
+                           sim_pdu_us(APP_BT_PHY_1M, SIM_PA_HEADER_BYTES + CTS_BROADCAST_AD_LEN) +
+                           (3u * (SIM_RADIO_RAMP_US +
+                                  sim_pdu_us(APP_BT_PHY_1M, SIM_ADV_EXT_IND_BYTES))) +
+                           SIM_RADIO_RAMP_US + sim_pdu_us(APP_BT_PHY_1M, SIM_AUX_ADV_IND_BYTES);
+    listen_us = SIM_RADIO_RAMP_US + SIM_PA_RX_WINDOW_US +
+                sim_pdu_us(APP_BT_PHY_1M, SIM_PA_HEADER_BYTES + CTS_BROADCAST_AD_LEN);
+    link_event_us = (((uint64_t)US_PER_DAY / SIM_CONN_INTERVAL_US) - 86400u) *
+                    sim_conn_event_us(APP_BT_PHY_1M, 0u, 0u) +
+                    (86400u * (uint64_t)sim_conn_event_us(APP_BT_PHY_1M, 0u,
+                                                          SIM_NOTIFY_ATT_BYTES +
+                                                          SIM_L2CAP_HEADER_BYTES));
+
+    printf("Broadcaster: %" PRIu64 " events, drift %d ppb, radio-on %.1f s per day "
+           "for any number of receivers\n", events, broadcaster.drift_ppb,
+           (double)broadcaster_event_us * (double)(US_PER_DAY / SIM_PA_INTERVAL_US) / 1e6);
+    printf("Receivers: %" PRIu64 " listens, %" PRIu64 " received, at least %u each, "
+           "%u without any; %" PRIu64 " syncs lost (up to %u per receiver), "
+           "%u decode errors\n", listens, received, min_received, silent, losses,
+           max_losses, decode_errors);
+    printf("Prediction of the next broadcast: %" PRIu64 " samples, max error %" PRId64 " us, "
+           "%" PRIu64 " outside the error bound (%.3f%%)\n", predictions, max_error_us,
+           out_of_bound_samples,
+           (0u != predictions) ? ((double)out_of_bound_samples * 100.0 / predictions) : 0.0);
+    printf("Radio per receiver: %.1f s per day listening and %.1f s scanning; "
+           "a connection instead: %.1f s per day at each end, %.1f s at the server "
+           "for all\n",
+           (double)listens * listen_us / 1e6 / run_days / receivers,
+           (double)scan_us / 1e6 / run_days / receivers,
+           (double)link_event_us / 1e6,
+           (double)link_event_us * receivers / 1e6);
+
+    ok = (0u == decode_errors) && (0u == silent);
+    printf("Broadcast: %s, %u simulated days in %.2f s\n", ok ? "passed" : "FAILED", days,
+           (double)(clock() - start) / CLOCKS_PER_SEC);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* Current Time value of a server time, rounded to 1/256 s. Returns the time
+ * the value decodes to */
+static int64_t sim_encode_time(int64_t server_us, uint8_t adjust_reason, uint8_t *p_value)
+{
+    int64_t units = ((server_us * 256) + (US_PER_S / 2)) / US_PER_S;
+    int64_t server_s = units / 256;
+    int32_t days = (int32_t)(server_s / 86400);
+    uint32_t second_of_day = (uint32_t)(server_s % 86400);
+    int32_t year;
+    uint32_t month;
+    uint32_t day;
+
+    cts_civil_from_days(days, &year, &month, &day);
+    p_value[0] = (uint8_t)((uint32_t)year & 0xFFu);
+    p_value[1] = (uint8_t)((uint32_t)year >> 8u);
+    p_value[2] = (uint8_t)month;
+    p_value[3] = (uint8_t)day;
+    p_value[4] = (uint8_t)(second_of_day / 3600u);
+    p_value[5] = (uint8_t)((second_of_day / 60u) % 60u);
+    p_value[6] = (uint8_t)(second_of_day % 60u);
+    p_value[7] = cts_weekday_from_days(days);
+    p_value[8] = (uint8_t)(units % 256);
+    p_value[9] = adjust_reason;
+    return (units * US_PER_S) / 256;
+}
+
+/* Plans the next time the receiver is out of range, once the last one is
+ * over */
+static void sim_receiver_outage(sim_receiver_t *p_receiver, int64_t true_us)
+{
+    p_receiver->outage_start_us = true_us +
+        (int64_t)sim_random_range(SIM_MIN_UP_S, SIM_MAX_UP_S) * US_PER_S;
+    p_receiver->outage_end_us = p_receiver->outage_start_us +
+        (int64_t)sim_random_range(SIM_MIN_DOWN_S, SIM_MAX_DOWN_S) * US_PER_S;
+}
+
+/* Scans for the SyncInfo of the broadcaster, until after the outage if the
+ * receiver is out of range */
+static void sim_receiver_resync(sim_receiver_t *p_receiver, int64_t true_us)
+{
+    int64_t from_us = (true_us < p_receiver->outage_start_us) ? true_us :
+                      (true_us > p_receiver->outage_end_us) ? true_us :
+                      p_receiver->outage_end_us;
+    int64_t found_us = from_us + (int64_t)sim_random_range(SIM_PA_MIN_RESYNC_US,
+                                                           SIM_PA_MAX_RESYNC_US);
+    int64_t start_us = SIM_START_EPOCH_S * US_PER_S;
+
+    p_receiver->scan_us += found_us - true_us;
+    p_receiver->next_event = (uint64_t)((found_us - start_us + SIM_PA_INTERVAL_US - 1) /
+                                        SIM_PA_INTERVAL_US);
+}
+
+/* Discovery duration and radio-on time of the simulated links on each PHY.
+ * Every connection runs the exchanges of sim_connect_exchanges, every
+ * notification and retransmission takes one connection event, and all
+ * other connection events carry empty PDUs */
+static void sim_radio_report(void)
+{
+    static const uint8_t phys[] = { APP_BT_PHY_1M, APP_BT_PHY_2M };
+    uint32_t index;
+    uint32_t duration_us;
+    uint32_t connect_radio_us;
+    uint64_t events = (uint64_t)sim_link_us / SIM_CONN_INTERVAL_US;
+    uint64_t busy_events;
+    uint64_t radio_us;
+    double link_days = (double)sim_link_us / (double)US_PER_DAY;
+
+    sim_connect_model(APP_BT_PHY_2M, &duration_us, &connect_radio_us);
+    busy_events = ((uint64_t)sim_connections * (duration_us / SIM_CONN_INTERVAL_US)) +
+                  total_notifications + sim_retransmits;
+    events = (events > busy_events) ? (events - busy_events) : 0u;
+
+    printf("Radio model: %u connections, %.1f link days, %u ms interval, "
+           "%u retransmissions\n", sim_connections, link_days,
+           SIM_CONN_INTERVAL_US / 1000u, sim_retransmits);
+    for (index = 0; index < (sizeof(phys) / sizeof(phys[0])); index++)
+    {
+        sim_connect_model(phys[index], &duration_us, &connect_radio_us);
+        radio_us = ((uint64_t)sim_connections * connect_radio_us) +
+                   (((uint64_t)total_notifications + sim_retransmits) *
+                    sim_conn_event_us(phys[index], 0u,
+                                      SIM_NOTIFY_ATT_BYTES + SIM_L2CAP_HEADER_BYTES)) +
+                   (events * sim_conn_event_us(phys[index], 0u, 0u));
+        printf("  %s: connection to CCCD write %u ms, %u us radio-on; "
+               "radio-on %.1f s per link day (%.3f%%)\n",
+               (APP_BT_PHY_2M == phys[index]) ? "2M" : "1M", duration_us / 1000u, connect_radio_us,
+               (link_days > 0.0) ? ((double)radio_us / 1e6 / link_days) : 0.0,
+               (sim_link_us > 0) ? ((double)radio_us * 100.0 / (double)sim_link_us) : 0.0);
+    }
+}
+
+/* FreeRTOS stand-ins on the simulation clock, see tools/sim */
+uint64_t local_time_us(void)
+{
+    return (uint64_t)sim_now_us;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)((uint64_t)sim_now_us / (US_PER_S / configTICK_RATE_HZ));
+}
+
+TimerHandle_t xTimerCreateStatic(const char *p_name, TickType_t period,
+                                 UBaseType_t auto_reload, void *p_id,
+                                 TimerCallbackFunction_t callback,
+                                 StaticTimer_t *p_buffer)
+{
+    (void)p_name;
+    (void)period;
+    (void)auto_reload;
+
+    memset(p_buffer, 0, sizeof(*p_buffer));
+    p_buffer->callback = callback;
+    p_buffer->p_id = p_id;
+    if (sim_timer_count >= SIM_MAX_TIMERS)
+    {
+        return NULL;
+    }
+    sim_timers[sim_timer_count++] = p_buffer;
+    return p_buffer;
+}
+
+/* Starts the timer: it expires when the tick count has advanced by period */
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t wait)
+{
+    int64_t tick_us = US_PER_S / configTICK_RATE_HZ;
+
+    (void)wait;
+    timer->expiry_us = ((int64_t)xTaskGetTickCount() + period) * tick_us;
+    timer->seq = sim_seq++;
+    timer->active = true;
+    return pdPASS;
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t wait)
+{
+    (void)wait;
+    timer->active = false;
+    return pdPASS;
+}
+
+/* Same as in cts_client.c, which needs the Bluetooth stack */
+bool cts_decode_current_time(const uint8_t *p_data, uint16_t len,
+                             current_time_data_t *p_time)
+{
+    if ((NULL == p_data) || (len < CTS_CURRENT_TIME_LEN))
+    {
+        return false;
+    }
+
+    p_time->year          = (p_data[1] << 8u) | p_data[0];
+    p_time->month         = p_data[2];
+    p_time->day           = p_data[3];
+    p_time->hours         = p_data[4];
+    p_time->minutes       = p_data[5];
+    p_time->seconds       = p_data[6];
+    p_time->day_of_week   = p_data[7];
+    p_time->fractions_256 = p_data[8];
+    p_time->adjust_reason = p_data[9];
+    return true;
+}
+
+bool cts_time_to_epoch_us(const current_time_data_t *p_time, int64_t *p_epoch_us)
+{
+    cts_date_status_t status = cts_calendar_check(p_time->year, p_time->month,
+                                                  p_time->day, p_time->day_of_week);
+
+    if (((CTS_DATE_VALID != status) && (CTS_DATE_WEEKDAY_MISMATCH != status)) ||
+        (p_time->hours > 23u) || (p_time->minutes > 59u) || (p_time->seconds > 59u))
+    {
+        return false;
+    }
+
+    *p_epoch_us = (cts_calendar_to_epoch_s(p_time->year, p_time->month, p_time->day,
+                                           p_time->hours, p_time->minutes,
+                                           p_time->seconds) * 1000000) +
+                  (((int64_t)p_time->fractions_256 * 1000000) / 256);
+    return true;
+}
+
+/* [] END OF FILE */
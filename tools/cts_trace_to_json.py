@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""Converts the trace dump of the CTS client (ENABLE_TRACE_RECORDER = 1) to
+the Chrome trace event format, for Perfetto (ui.perfetto.dev) or
+chrome://tracing.
+
+The firmware prints the dump on every disconnection as text lines:
+    TRACE begin <CPU clock Hz> <events> <events overwritten>
+    TRACE task <id> <name>
+    TRACE queue <id> <name>
+    TRACE data <events in hex>
+    TRACE end
+An event is: cycle count (4), type (1), id (1) and argument (2), little
+endian. Other lines of the capture are ignored. Every dump becomes one
+process in the timeline, with a CPU track showing the running task, one
+track per task for the GATT and application event handlers, one for the
+button interrupt and a counter per queue.
+
+The cycle counter stops while the CPU sleeps, so idle time in deep sleep
+does not appear in the timeline.
+
+Usage:
+    cts_trace_to_json.py capture.log [trace.json]
+    cts_trace_to_json.py - < capture.log > trace.json
+"""
+
+import json
+import struct
+import sys
+
+TASK_IN = 0x01
+TASK_OUT = 0x02
+QUEUE_SEND = 0x03
+QUEUE_SEND_ISR = 0x04
+QUEUE_RECEIVE = 0x05
+QUEUE_BLOCK = 0x06
+ISR_ENTER = 0x07
+ISR_EXIT = 0x08
+SPAN_BEGIN = 0x09
+SPAN_END = 0x0A
+
+ISR_NAMES = {1: "button"}
+SPAN_NAMES = {1: "gatt_callback", 2: "mgmt_callback", 3: "app_event"}
+# app_event_type_t in cts_client.h
+APP_EVENT_NAMES = ["BUTTON", "CONNECTED", "DISCONNECTED", "DISCOVERY_RESULT",
+                   "DISCOVERY_CPLT", "OPERATION_CPLT", "PAIRING_COMPLETE",
+                   "ENCRYPTION_STATUS", "ALARM", "COMMAND",
+                   "PHY_UPDATE", "ADV_RESTART", "BROADCAST_SYNC",
+                   "BROADCAST_TIME", "ATTRIBUTE_REQUEST"]
+
+CPU_TID = 0
+ISR_TID_BASE = 100
+TASK_TID_BASE = 1000
+
+
+def span_name(span, arg):
+    name = SPAN_NAMES.get(span, "span %d" % span)
+    if span == 3 and arg < len(APP_EVENT_NAMES):
+        return "%s %s" % (name, APP_EVENT_NAMES[arg])
+    return "%s %d" % (name, arg)
+
+
+class Dump:
+    """One TRACE begin ... TRACE end block."""
+
+    def __init__(self, clock_hz, overwritten):
+        self.clock_hz = clock_hz
+        self.overwritten = overwritten
+        self.tasks = {}
+        self.queues = {}
+        self.data = bytearray()
+
+    def events(self):
+        for offset in range(0, len(self.data) - 7, 8):
+            yield struct.unpack_from("<IBBH", self.data, offset)
+
+
+def read_dumps(stream):
+    dumps = []
+    dump = None
+    for raw in stream:
+        line = raw.decode("ascii", "replace") if isinstance(raw, bytes) else raw
+        index = line.find("TRACE ")
+        if index < 0:
+            continue
+        fields = line[index:].split()
+        if len(fields) < 2:
+            continue
+        try:
+            if fields[1] == "begin":
+                dump = Dump(int(fields[2]), int(fields[4]))
+            elif dump is None:
+                continue
+            elif fields[1] == "task":
+                dump.tasks[int(fields[2])] = " ".join(fields[3:])
+            elif fields[1] == "queue":
+                dump.queues[int(fields[2])] = " ".join(fields[3:])
+            elif fields[1] == "data" and len(fields) > 2:
+                dump.data += bytes.fromhex(fields[2])
+            elif fields[1] == "end":
+                dumps.append(dump)
+                dump = None
+        except (IndexError, ValueError):
+            # A line garbled on the UART, drop the dump
+            dump = None
+    return dumps
+
+
+def convert(dump, pid, out):
+    tasks = dict(dump.tasks)
+    queues = dict(dump.queues)
+    open_slices = {}
+    current_tid = CPU_TID
+    last_cycles = None
+    elapsed = 0
+    ts = 0.0
+
+    def task_name(task_id):
+        return tasks.get(task_id, "task %d" % task_id)
+
+    def queue_name(queue_id):
+        return queues.get(queue_id, "queue %d" % queue_id)
+
+    def begin(tid, name, args=None):
+        event = {"ph": "B", "pid": pid, "tid": tid, "ts": ts, "name": name}
+        if args:
+            event["args"] = args
+        out.append(event)
+        open_slices.setdefault(tid, []).append(name)
+
+    def end(tid):
+        if open_slices.get(tid):
+            open_slices[tid].pop()
+            out.append({"ph": "E", "pid": pid, "tid": tid, "ts": ts})
+
+    for cycles, etype, eid, arg in dump.events():
+        if last_cycles is not None:
+            elapsed += (cycles - last_cycles) & 0xFFFFFFFF
+        last_cycles = cycles
+        ts = round(elapsed * 1e6 / dump.clock_hz, 3)
+
+        if etype == TASK_IN:
+            begin(CPU_TID, task_name(eid))
+            current_tid = TASK_TID_BASE + eid
+            tasks.setdefault(eid, "task %d" % eid)
+        elif etype == TASK_OUT:
+            end(CPU_TID)
+        elif etype in (QUEUE_SEND, QUEUE_SEND_ISR, QUEUE_RECEIVE):
+            # The hooks run before the queue updates its message count
+            waiting = arg - 1 if etype == QUEUE_RECEIVE else arg + 1
+            out.append({"ph": "C", "pid": pid, "ts": ts, "name": queue_name(eid),
+                        "args": {"waiting": max(waiting, 0)}})
+        elif etype == QUEUE_BLOCK:
+            out.append({"ph": "i", "s": "t", "pid": pid, "tid": current_tid, "ts": ts,
+                        "name": "block on %s %s" % (queue_name(eid),
+                                                    "send" if arg else "receive")})
+        elif etype == ISR_ENTER:
+            begin(ISR_TID_BASE + eid, ISR_NAMES.get(eid, "isr %d" % eid))
+        elif etype == ISR_EXIT:
+            end(ISR_TID_BASE + eid)
+        elif etype == SPAN_BEGIN:
+            begin(current_tid, span_name(eid, arg), {"event": arg})
+        elif etype == SPAN_END:
+            end(current_tid)
+
+    # Close what was still running when the dump was taken
+    for tid, names in open_slices.items():
+        for _ in names:
+            out.append({"ph": "E", "pid": pid, "tid": tid, "ts": ts})
+
+    out.append({"ph": "M", "pid": pid, "name": "process_name",
+                "args": {"name": "dump %d (%d events overwritten)" % (pid, dump.overwritten)}})
+    out.append({"ph": "M", "pid": pid, "tid": CPU_TID, "name": "thread_name",
+                "args": {"name": "CPU"}})
+    for task_id in tasks:
+        out.append({"ph": "M", "pid": pid, "tid": TASK_TID_BASE + task_id,
+                    "name": "thread_name", "args": {"name": task_name(task_id)}})
+    for isr_id, name in ISR_NAMES.items():
+        out.append({"ph": "M", "pid": pid, "tid": ISR_TID_BASE + isr_id,
+                    "name": "thread_name", "args": {"name": "ISR " + name}})
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 1
+    if sys.argv[1] == "-":
+        dumps = read_dumps(sys.stdin)
+    else:
+        with open(sys.argv[1], "rb") as stream:
+            dumps = read_dumps(stream)
+    if not dumps:
+        print("No complete TRACE dump found", file=sys.stderr)
+        return 1
+
+    events = []
+    for pid, dump in enumerate(dumps, 1):
+        convert(dump, pid, events)
+    result = {"traceEvents": events, "displayTimeUnit": "ns"}
+
+    if len(sys.argv) > 2:
+        with open(sys.argv[2], "w") as output:
+            json.dump(result, output)
+    else:
+        json.dump(result, sys.stdout)
+    print("%d dumps, %d trace events" % (len(dumps), len(events)), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,68 @@
+/******************************************************************************
+* File Name: FreeRTOS.h
+*
+* Description: Virtual-time stand-in for the FreeRTOS kernel header, used by
+*              tools/cts_soak_sim.c. The tick follows the simulation clock and
+*              critical sections are empty, as the simulation is single
+*              threaded.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __SIM_FREERTOS_H__
+#define __SIM_FREERTOS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t      TickType_t;
+typedef long          BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdFALSE                         (0)
+#define pdTRUE                          (1)
+#define pdPASS                          (pdTRUE)
+#define portMAX_DELAY                   ((TickType_t)0xFFFFFFFFu)
+#define configTICK_RATE_HZ              (1000u)
+#define configMAX_PRIORITIES            (7)
+#define configMINIMAL_STACK_SIZE        (128u)
+#define pdMS_TO_TICKS(ms)               ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000u))
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#endif      /* __SIM_FREERTOS_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,71 @@
+/******************************************************************************
+* File Name: timers.h
+*
+* Description: Virtual-time stand-in for the FreeRTOS software timer header,
+*              used by tools/cts_soak_sim.c. A started timer is an event on
+*              the simulation event queue.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __SIM_TIMERS_H__
+#define __SIM_TIMERS_H__
+
+#include "FreeRTOS.h"
+#include <stdbool.h>
+
+typedef struct sim_timer *TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t timer);
+
+/* A timer. Like a FreeRTOS timer, starting it again replaces its expiry */
+typedef struct sim_timer
+{
+    TimerCallbackFunction_t callback;
+    void                    *p_id;
+    int64_t                 expiry_us;
+    uint64_t                seq;
+    bool                    active;
+} StaticTimer_t;
+
+TimerHandle_t xTimerCreateStatic(const char *p_name, TickType_t period,
+                                 UBaseType_t auto_reload, void *p_id,
+                                 TimerCallbackFunction_t callback,
+                                 StaticTimer_t *p_buffer);
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t wait);
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t wait);
+
+#endif      /* __SIM_TIMERS_H__ */
+
+/* [] END OF FILE */